@@ -216,6 +216,9 @@ Boolean ReadSignal(const char * FName,DRCFloat * Dst,const int InitWindow,
 		return True;
 	}
 
+/* Dimensione dei blocchi di conversione per la scrittura su disco */
+#define WSBlockSize 4096
+
 /* Scrive il segnale indicato su disco */
 Boolean WriteSignal(const char * FName,const DRCFloat * Src,const int SSize,
 	const IFileType FType)
@@ -223,9 +226,11 @@ Boolean WriteSignal(const char * FName,const DRCFloat * Src,const int SSize,
 		/* File gestione IO */
 		FILE * IOF;
 		int I;
-		DRCFileDouble RWD;
-		DRCFileFloat RWF;
-		DRCFileInt RWI;
+		int J;
+		int N;
+		DRCFileDouble RWD[WSBlockSize];
+		DRCFileFloat RWF[WSBlockSize];
+		DRCFileInt RWI[WSBlockSize];
 
 		/* Apre il file di output */
 		if ((IOF = fopen(FName,"wb")) == NULL)
@@ -234,48 +239,53 @@ Boolean WriteSignal(const char * FName,const DRCFloat * Src,const int SSize,
 				return False;
 			}
 
-		/* Salva la risposta risultante */
-		switch (FType)
+		/* Salva la risposta risultante, convertendo il segnale a blocchi */
+		for (I = 0; I < SSize; I += N)
 			{
-				case PcmFloat64Bit:
-					for (I = 0; I < SSize; I++)
-						{
-							RWD = (DRCFileDouble) Src[I];
-							if (fwrite((void *) &RWD,sizeof(DRCFileDouble),1,IOF) != 1)
+				N = (SSize - I < WSBlockSize) ? SSize - I : WSBlockSize;
+				switch (FType)
+					{
+						case PcmFloat64Bit:
+							for (J = 0; J < N; J++)
+								RWD[J] = (DRCFileDouble) Src[I + J];
+							if (fwrite((void *) RWD,sizeof(DRCFileDouble),N,IOF) != (size_t) N)
 								{
 									perror("\nError writing ouput file");
+									fclose(IOF);
 									return False;
 								}
-						}
-				break;
+						break;
 
-				case PcmFloat32Bit:
-					for (I = 0; I < SSize; I++)
-						{
-							RWF = (DRCFileFloat) Src[I];
-							if (fwrite((void *) &RWF,sizeof(DRCFileFloat),1,IOF) != 1)
+						case PcmFloat32Bit:
+							for (J = 0; J < N; J++)
+								RWF[J] = (DRCFileFloat) Src[I + J];
+							if (fwrite((void *) RWF,sizeof(DRCFileFloat),N,IOF) != (size_t) N)
 								{
 									perror("\nError writing ouput file");
+									fclose(IOF);
 									return False;
 								}
-						}
-				break;
+						break;
 
-				case PcmInt16Bit:
-					for (I = 0; I < SSize; I++)
-						{
-							RWI = (DRCFileInt) floor(0.5 + Src[I]);
-							if (fwrite((void *) &RWI,sizeof(DRCFileInt),1,IOF) != 1)
+						case PcmInt16Bit:
+							for (J = 0; J < N; J++)
+								RWI[J] = (DRCFileInt) floor(0.5 + Src[I + J]);
+							if (fwrite((void *) RWI,sizeof(DRCFileInt),N,IOF) != (size_t) N)
 								{
 									perror("\nError writing ouput file");
+									fclose(IOF);
 									return False;
 								}
-						}
-				break;
+						break;
+					}
 			}
 
-		/* Chiude il file */
-		fclose(IOF);
+		/* Chiude il file, verificando la scrittura dei dati bufferizzati */
+		if (fclose(IOF) != 0)
+			{
+				perror("\nError writing ouput file");
+				return False;
+			}
 
 		/* Operazione completata */
 		return True;
@@ -346,33 +356,49 @@ Boolean OverwriteSignal(const char * FName,const DRCFloat * Src,const int SSize,
 	}
 
 /* Calcola l'autocorrelazione del segnale S */
-Boolean AutoCorrelation(DLReal * S, int N)
+/* Modello sul tipo floating point usato per il calcolo */
+template <class T>
+static Boolean TAutoCorrelation(DLReal * S, int N)
 	{
-		DLComplex * C;
+		std::complex<T> * C;
 		int I;
 
-		if ((C = new DLComplex[N]) == NULL)
+		if ((C = new std::complex<T>[N]) == NULL)
 			return False;
 
 		for (I = 0; I < N; I++)
-			C[I] = S[I];
+			C[I] = (T) S[I];
 
-		Fft(C,N);
+		TFft(C,N);
 
 		for (I = 0; I < N; I++)
 			/* C[I] = C[I] * std::conj(C[I]); */
 			C[I] = std::real(C[I]) * std::real(C[I]) + std::imag(C[I]) * std::imag(C[I]);
 
-		IFft(C,N);
+		TIFft(C,N);
 
 		for (I = 0; I < N; I++)
-			S[I] = std::real(C[I]) / N;
+			S[I] = (DLReal) (std::real(C[I]) / N);
 
 		delete[] C;
 
 		return True;
 	}
 
+Boolean AutoCorrelation(DLReal * S, int N)
+	{
+		return TAutoCorrelation<DLReal>(S,N);
+	}
+
+/* Versione con precisione di calcolo Prec */
+Boolean AutoCorrelation(DLReal * S, int N, const DLPrecisionType Prec)
+	{
+		if (DLUseAltReal(Prec) == True)
+			return TAutoCorrelation<DLAltReal>(S,N);
+		else
+			return TAutoCorrelation<DLReal>(S,N);
+	}
+
 /* Calcola la cross correlazione tra S1 e S2 */
 /* XC deve avere lunghezza 2N - 1 */
 Boolean CrossCorrelation(DLReal * S1, DLReal * S2, int N, DLReal * XC)
@@ -69,6 +69,9 @@
 	/* Calcola l'autocorrelazione del sgnale S */
 	Boolean AutoCorrelation(DLReal * S, int N);
 
+	/* Versione con precisione di calcolo Prec */
+	Boolean AutoCorrelation(DLReal * S, int N, const DLPrecisionType Prec);
+
 	/* Calcola la cross correlazione tra S1 e S2 */
 	/* XC deve avere lunghezza 2N - 1 */
 	Boolean CrossCorrelation(DLReal * S1, DLReal * S2, int N, DLReal * XC);
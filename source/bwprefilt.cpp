@@ -30,7 +30,10 @@
 #include "convol.h"
 #include "fir.h"
 #include "level.h"
-
+#include "dspalloc.h"
+#include "fft.h"
+#include "lowmem.h"
+
 /* Memory leaks debugger */
 #ifdef DebugMLeaks
 	#include "debug_new.h"
@@ -52,6 +55,9 @@ DLReal IntPow(DLReal X,unsigned int N)
     return(Pow);
   }
 
+/* Numero di bande elaborate in un unico gruppo di trasformate */
+#define BWBatchBands 4
+
 /* Prefiltratura a bande di un segnale */
 void BWPreFilt(const DLReal * InImp, const int IBS, const int FBS,
 	const int FilterLen, const int BandSplit, const DLReal WindowExponent,
@@ -59,25 +65,30 @@ void BWPreFilt(const DLReal * InImp, const int IBS, const int FBS,
 	const int WindowGap, DLReal * OutImp,
 	const WindowType WType, const BWPPrefilteringType BWPType)
 	{
-		/* Array risultati parziali */
-		DLReal * COut;
-
 		/* Array filtro FIR */
 		DLReal * FIRFilter;
 
 		/* Array finestratura segnale di ingresso */
 		DLReal * CIn;
 
-		/* Array temporanei convoluzione */
-		DLComplex * CA;
-		DLComplex * CB;
+		/* Array convoluzione del gruppo di bande, filtro e segnale
+		alternati */
+		DLComplex * CM;
+		DLComplex * CP[2 * BWBatchBands];
 
 		/* Numero banda corrente */
 		int Band;
 
+		/* Dimensione del gruppo di bande e numero di bande nel gruppo */
+		int BB;
+		int NB;
+		int J;
+
 		/* Estremi della banda. */
 		DLReal BLow;
 		DLReal BHigh;
+		DLReal BL[BWBatchBands];
+		DLReal BH[BWBatchBands];
 
 		/* Larghezza banda */
 		DLReal BWidth;
@@ -89,8 +100,10 @@ void BWPreFilt(const DLReal * InImp, const int IBS, const int FBS,
   	/* Posizione finestra su segnale */
 		int WStart;
 		int WLen;
+		int WL[BWBatchBands];
 		int I;
 		int OBS;
+		int FS;
 
 		/* Coefficienti calcolo finestra su segnale */
 		DLReal A;
@@ -105,16 +118,21 @@ void BWPreFilt(const DLReal * InImp, const int IBS, const int FBS,
 		FilterEnd = (2 * EndFreq) / SampleFreq;
 
 		/* Alloca gli array temporanei */
-		CIn = new DLReal[IBS];
-		COut = new DLReal[OBS];
-		FIRFilter = new DLReal[FilterLen];
+		CIn = DSPRealAlloc(IBS);
+		FIRFilter = DSPRealAlloc(FilterLen);
 
 		/* Calcola la dimensione degli array di appoggio convoluzione */
-    for (I = 1; I < OBS; I <<= 1);
+    for (FS = 1; FS < OBS; FS <<= 1);
+
+		/* Le bande sono convolute a gruppi, con le trasformate di filtro e
+		segnale di tutto il gruppo calcolate insieme, una banda alla volta
+		in modalit a ridotto consumo di memoria */
+		BB = (LMEnabled() == True) ? 1 : BWBatchBands;
 
 		/* Alloca gli array di appoggio convoluzione */
-		CA = new DLComplex[I];
-		CB = new DLComplex[I];
+		CM = DSPComplexAlloc(2 * BB * FS);
+		for (J = 0; J < 2 * BB; J++)
+			CP[J] = &CM[J * FS];
 
 		/* Imposta i parametri iniziali */
 		Band = 0;
@@ -142,105 +160,127 @@ void BWPreFilt(const DLReal * InImp, const int IBS, const int FBS,
 				break;
 			}
 
-		/* Ciclo sulle bande */
+		/* Ciclo sui gruppi di bande */
 		while (BHigh < FilterEnd)
 			{
-				/* Calcola gli estremi banda */
-				if (Band == 0)
-					BLow = 0;
-				else
-					BLow = (DLReal) (FilterBegin * IntPow(BWidth,Band - 1));
-
-				BHigh = (DLReal) (FilterBegin * IntPow(BWidth,Band));
-				if (BHigh > FilterEnd)
-					BHigh = 1.0;
-
-				/* Verifica la banda di finestratura */
-				if (Band == 0)
-					WLen = IBS;
-				else
+				/* Ciclo sulle bande del gruppo */
+				for (NB = 0; NB < BB && BHigh < FilterEnd; NB++)
 					{
-						/* Verifica il tipo di curva di prefiltratura */
-						switch (BWPType)
+						/* Calcola gli estremi banda */
+						if (Band == 0)
+							BLow = 0;
+						else
+							BLow = (DLReal) (FilterBegin * IntPow(BWidth,Band - 1));
+
+						BHigh = (DLReal) (FilterBegin * IntPow(BWidth,Band));
+						if (BHigh > FilterEnd)
+							BHigh = 1.0;
+
+						/* Verifica la banda di finestratura */
+						if (Band == 0)
+							WLen = IBS;
+						else
 							{
-								/* Proporzionale */
-								case BWPProportional:
-									/* Calcola l'intervallo di finestratura */
-									WLen = 1 + (int) (ceil(0.5 / (A * pow(BHigh + Q,WindowExponent))) * 2);
-								break;
-
-								/* Bilineare */
-								case BWPBilinear:
-									/* Calcola l'intervallo di finestratura */
-									WLen = 1 + (int) (ceil(0.5 * (FBS + A * (1.0 - ((BHigh - FilterBegin) /
-										(B - (BHigh - FilterBegin) * Q))))) * 2);
-								break;
+								/* Verifica il tipo di curva di prefiltratura */
+								switch (BWPType)
+									{
+										/* Proporzionale */
+										case BWPProportional:
+											/* Calcola l'intervallo di finestratura */
+											WLen = 1 + (int) (ceil(0.5 / (A * pow(BHigh + Q,WindowExponent))) * 2);
+										break;
+
+										/* Bilineare */
+										case BWPBilinear:
+											/* Calcola l'intervallo di finestratura */
+											WLen = 1 + (int) (ceil(0.5 * (FBS + A * (1.0 - ((BHigh - FilterBegin) /
+												(B - (BHigh - FilterBegin) * Q))))) * 2);
+										break;
+									}
 							}
-					}
-
-				/* Controlla che non vi siano errori di arrotondamento */
-				if (WLen >= IBS)
-					WLen = ((IBS / 2) * 2) - 1;
-				if (WLen < FBS)
-					WLen = FBS;
-
-				/* Calcola il punto di partenza */
-				WStart = (IBS - WLen) / 2;
-
-				/* Riporta la banda */
-				printf("Band: %3d, %7.1f - %7.1f Hz, FIR, ", (int) Band,
-					(double) (BLow * SampleFreq) / 2, (double) (BHigh * SampleFreq) / 2);
-				fflush(stdout);
 
-				printf("wind: %6d, ", (int) WLen);
-				fflush(stdout);
-
-				/* Effettua la finestratura del segnale */
-				for (I = 0; I < IBS; I++)
-					CIn[I] = InImp[I];
-				if (WindowGap > WLen)
-					SpacedBlackmanWindow(&CIn[WStart],WLen,WindowGap,WType);
-				else
-					if (WLen > 2)
-						SpacedBlackmanWindow(&CIn[WStart],WLen,WLen - 2,WType);
-					else
-						SpacedBlackmanWindow(&CIn[WStart],WLen,0,WType);
-
-				/* Azzeramento parte esterna alla finestra */
-				if (WType != WRight)
-					for (I = 0; I < WStart; I++)
-						CIn[I] = 0;
-				if (WType != WLeft)
-					for (I = WStart + WLen; I < IBS; I++)
-						CIn[I] = 0;
-
-				/* Calcola il filtro passa banda */
-				BandPassFir(FIRFilter,FilterLen,BLow,BHigh);
-				BlackmanWindow(FIRFilter,FilterLen);
-
-				printf("conv, ");
-				fflush(stdout);
-
-				/* Effettua la convoluzione tra segnale e filtro */
-				DFftConvolve(FIRFilter,FilterLen,CIn,IBS,COut,CA,CB);
+						/* Controlla che non vi siano errori di arrotondamento */
+						if (WLen >= IBS)
+							WLen = ((IBS / 2) * 2) - 1;
+						if (WLen < FBS)
+							WLen = FBS;
+
+						/* Calcola il punto di partenza */
+						WStart = (IBS - WLen) / 2;
+
+						/* Effettua la finestratura del segnale */
+						for (I = 0; I < IBS; I++)
+							CIn[I] = InImp[I];
+						if (WindowGap > WLen)
+							SpacedBlackmanWindow(&CIn[WStart],WLen,WindowGap,WType);
+						else
+							if (WLen > 2)
+								SpacedBlackmanWindow(&CIn[WStart],WLen,WLen - 2,WType);
+							else
+								SpacedBlackmanWindow(&CIn[WStart],WLen,0,WType);
+
+						/* Azzeramento parte esterna alla finestra */
+						if (WType != WRight)
+							for (I = 0; I < WStart; I++)
+								CIn[I] = 0;
+						if (WType != WLeft)
+							for (I = WStart + WLen; I < IBS; I++)
+								CIn[I] = 0;
+
+						/* Calcola il filtro passa banda */
+						BandPassFir(FIRFilter,FilterLen,BLow,BHigh);
+						BlackmanWindow(FIRFilter,FilterLen);
+
+						/* Prepara filtro e segnale per la convoluzione */
+						for (I = 0; I < FilterLen; I++)
+							CP[2 * NB][I] = FIRFilter[I];
+						for (I = FilterLen; I < FS; I++)
+							CP[2 * NB][I] = 0;
+						for (I = 0; I < IBS; I++)
+							CP[2 * NB + 1][I] = CIn[I];
+						for (I = IBS; I < FS; I++)
+							CP[2 * NB + 1][I] = 0;
+
+						/* Salva i parametri per il riepilogo */
+						BL[NB] = BLow;
+						BH[NB] = BHigh;
+						WL[NB] = WLen;
+
+						Band++;
+					}
 
-				printf("sum, ");
-				fflush(stdout);
+				/* Effettua la convoluzione tra segnale e filtro per tutte
+				le bande del gruppo */
+				FftBatch(CP,2 * NB,FS);
+				for (J = 0; J < NB; J++)
+					{
+						for (I = 0; I < FS; I++)
+							CP[2 * J][I] *= CP[2 * J + 1][I];
+						CP[J] = CP[2 * J];
+					}
+				IFftBatch(CP,NB,FS);
 
-				/* Aggiunge il segnale al segnale risultante */
-				for (I = 0; I < OBS; I++)
-					OutImp[I] += COut[I];
+				/* Aggiunge i segnali al segnale risultante, nell'ordine
+				delle bande */
+				for (J = 0; J < NB; J++)
+					{
+						for (I = 0; I < OBS; I++)
+							OutImp[I] += CP[J][I].real();
 
-				printf("done.\n");
+						/* Riporta la banda */
+						printf("Band: %3d, %7.1f - %7.1f Hz, FIR, wind: %6d, conv, sum, done.\n",
+							(int) (Band - NB + J),(double) (BL[J] * SampleFreq) / 2,
+							(double) (BH[J] * SampleFreq) / 2,(int) WL[J]);
+					}
 				fflush(stdout);
 
-				Band++;
+				/* Ripristina i puntatori agli array di appoggio */
+				for (J = 0; J < 2 * BB; J++)
+					CP[J] = &CM[J * FS];
 			}
 
 		/* Dealloca gli array intermedi */
-		delete[] CIn;
-		delete[] COut;
-		delete[] FIRFilter;
-		delete[] CA;
-		delete[] CB;
+		DSPFree(CIn);
+		DSPFree(FIRFilter);
+		DSPFree(CM);
 	}
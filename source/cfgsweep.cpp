@@ -0,0 +1,644 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Elaborazione di pi configurazioni in una singola esecuzione */
+
+/* Inclusioni */
+#include "cfgsweep.h"
+#include "baselib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifndef _WIN32
+	#include <unistd.h>
+	#include <dirent.h>
+	#include <sys/types.h>
+	#include <sys/wait.h>
+#else
+	#include <getopt.h>
+#endif
+
+/* Memory leaks debugger */
+#ifdef DebugMLeaks
+	#include "debug_new.h"
+#endif
+
+/* Opzione numero di elaborazioni parallele, gestita solo dal driver */
+static const char CSJobsSwitch[] = "--SweepJobs=";
+
+/* Opzione directory cache */
+static const char CSCacheSwitch[] = "--BCCacheDir";
+
+/* Parametro con pi valori */
+typedef struct
+	{
+		char * Name;
+		char ** Values;
+		int NValues;
+	}
+CSSweepType;
+
+/* Piano di esecuzione */
+typedef struct
+	{
+		/* Opzioni comuni a tutte le elaborazioni */
+		char ** FixedArgs;
+		int NFixed;
+
+		/* File di configurazione */
+		char ** Files;
+		int NFiles;
+
+		/* Parametri con pi valori */
+		CSSweepType * Sweeps;
+		int NSweeps;
+
+		/* Numero di elaborazioni parallele */
+		int Jobs;
+
+		/* Directory cache */
+		Boolean HasCache;
+	}
+CSPlanType;
+
+/* String duplication */
+static char * CSDString(const char * S, const size_t L)
+	{
+		char * DS;
+		if ((DS = (char *) malloc(sizeof(char) * (1 + L))) == NULL)
+			return NULL;
+		strncpy(DS,S,L);
+		DS[L] = '\0';
+		return DS;
+	}
+
+/* Recupera la posizione del parametro di configurazione con il nome indicato */
+static int CSFindParm(const CfgParameter * CfgParmsDef, const char * Name, const size_t L)
+	{
+		int I;
+
+		for (I = 0;CfgParmsDef[I].PType != CfgEnd;I++)
+			if (strlen(CfgParmsDef[I].PName) == L && strncmp(CfgParmsDef[I].PName,Name,L) == 0)
+				return I;
+
+		return -1;
+	}
+
+/* Verifica se l'opzione richiede il valore nell'argomento successivo */
+static Boolean CSSplitOption(const char * Arg)
+	{
+		return (strncmp(Arg,"--",2) == 0 && strchr(Arg,'=') == NULL &&
+			strcmp(Arg,"--help") != 0) ? True : False;
+	}
+
+/* Suddivide una lista di valori separati da virgola */
+static Boolean CSSplitValues(const char * List, CSSweepType * Sweep)
+	{
+		const char * P;
+		const char * E;
+		int I;
+
+		/* Conta i valori */
+		Sweep->NValues = 1;
+		for (P = List;*P != '\0';P++)
+			if (*P == ',')
+				Sweep->NValues++;
+
+		/* Alloca la lista */
+		if ((Sweep->Values = (char **) malloc(Sweep->NValues * sizeof(char *))) == NULL)
+			return False;
+
+		/* Estrae i valori */
+		for (I = 0,P = List;I < Sweep->NValues;I++)
+			{
+				if ((E = strchr(P,',')) == NULL)
+					E = P + strlen(P);
+				if ((Sweep->Values[I] = CSDString(P,E - P)) == NULL)
+					return False;
+				P = E + 1;
+			}
+
+		return True;
+	}
+
+/* Costruisce il piano di esecuzione a partire dalla linea di comando */
+static Boolean CSBuildPlan(int argc, char * argv[], const CfgParameter * CfgParmsDef,
+	CSPlanType * Plan)
+	{
+		const char * Eq;
+		int P;
+		int I;
+
+		Plan->NFixed = 0;
+		Plan->NFiles = 0;
+		Plan->NSweeps = 0;
+		Plan->Jobs = 0;
+		Plan->HasCache = False;
+		if ((Plan->FixedArgs = (char **) malloc(argc * sizeof(char *))) == NULL)
+			return False;
+		if ((Plan->Files = (char **) malloc(argc * sizeof(char *))) == NULL)
+			return False;
+		if ((Plan->Sweeps = (CSSweepType *) malloc(argc * sizeof(CSSweepType))) == NULL)
+			return False;
+
+		for (I = 1;I < argc;I++)
+			{
+				/* File di configurazione */
+				if (strncmp(argv[I],"--",2) != 0)
+					{
+						Plan->Files[Plan->NFiles++] = argv[I];
+						continue;
+					}
+
+				/* Numero di elaborazioni parallele */
+				if (strncmp(argv[I],CSJobsSwitch,strlen(CSJobsSwitch)) == 0)
+					{
+						Plan->Jobs = atoi(&argv[I][strlen(CSJobsSwitch)]);
+						continue;
+					}
+
+				/* Directory cache impostata dall'utente */
+				if (strncmp(argv[I],CSCacheSwitch,strlen(CSCacheSwitch)) == 0)
+					Plan->HasCache = True;
+
+				/* Opzione con valore separato */
+				if (CSSplitOption(argv[I]) == True)
+					{
+						Plan->FixedArgs[Plan->NFixed++] = argv[I];
+						if (I + 1 < argc)
+							Plan->FixedArgs[Plan->NFixed++] = argv[++I];
+						continue;
+					}
+
+				/* Verifica se si tratta di un parametro numerico con pi valori */
+				Eq = strchr(argv[I],'=');
+				P = (Eq == NULL) ? -1 : CSFindParm(CfgParmsDef,&argv[I][2],Eq - &argv[I][2]);
+				if (P >= 0 && strchr(Eq,',') != NULL &&
+					(CfgParmsDef[P].PType == CfgInt || CfgParmsDef[P].PType == DRCCfgFloat))
+					{
+						Plan->Sweeps[Plan->NSweeps].Name = CfgParmsDef[P].PName;
+						if (CSSplitValues(Eq + 1,&Plan->Sweeps[Plan->NSweeps]) == False)
+							return False;
+						Plan->NSweeps++;
+					}
+				else
+					Plan->FixedArgs[Plan->NFixed++] = argv[I];
+			}
+
+		return True;
+	}
+
+#ifndef _WIN32
+
+/* Verifica se uno dei file di configurazione definisce la directory
+cache, nel qual caso la directory temporanea non viene usata per non
+sostituire quella definita dall'utente */
+static Boolean CSFilesHaveCache(const CSPlanType * Plan, const CfgParameter * CfgParmsDef)
+	{
+		Boolean Res;
+		char * Dir;
+		int P;
+		int I;
+
+		if ((P = CSFindParm(CfgParmsDef,"BCCacheDir",strlen("BCCacheDir"))) < 0)
+			return False;
+
+		Res = False;
+		for (I = 0;I < Plan->NFiles && Res == False;I++)
+			{
+				if (CfgParse(Plan->Files[I],(CfgParameter *) CfgParmsDef,CfgSimple) > 0)
+					{
+						Dir = *((char **) CfgParmsDef[P].PValue);
+						if (Dir != NULL && Dir[0] != '\0')
+							Res = True;
+					}
+				CfgFree(CfgParmsDef);
+			}
+
+		return Res;
+	}
+
+#endif
+
+/* Verifica se la linea di comando richiede pi elaborazioni */
+Boolean CSIsSweep(int argc, char * argv[], const CfgParameter * CfgParmsDef)
+	{
+		CSPlanType Plan;
+		Boolean Res;
+		int I;
+		int J;
+
+		if (CSBuildPlan(argc,argv,CfgParmsDef,&Plan) == False)
+			return False;
+		Res = (Plan.NFiles > 1 || Plan.NSweeps > 0) ? True : False;
+
+		/* Dealloca il piano di esecuzione */
+		for (I = 0;I < Plan.NSweeps;I++)
+			{
+				for (J = 0;J < Plan.Sweeps[I].NValues;J++)
+					free(Plan.Sweeps[I].Values[J]);
+				free(Plan.Sweeps[I].Values);
+			}
+		free(Plan.Sweeps);
+		free(Plan.Files);
+		free(Plan.FixedArgs);
+
+		return Res;
+	}
+
+/* Aggiunge una stringa all'identificativo della elaborazione */
+static void CSTagAppend(char * Tag, const char * S, const size_t L)
+	{
+		size_t T;
+
+		if (Tag[0] != '\0')
+			strcat(Tag,"-");
+		T = strlen(Tag);
+		memcpy(&Tag[T],S,L);
+		Tag[T + L] = '\0';
+	}
+
+/* Costruisce la linea di comando e l'identificativo della elaborazione B */
+static Boolean CSBuildRun(const CSPlanType * Plan, const int B, char * Argv0,
+	const char * CacheDir, char *** RArgv, int * RArgc, char ** RTag)
+	{
+		const char * F;
+		const char * S;
+		const char * E;
+		size_t TL;
+		size_t VL;
+		int V;
+		int N;
+		int I;
+		int J;
+
+		/* Alloca la linea di comando */
+		if ((*RArgv = (char **) malloc((Plan->NFixed + Plan->NSweeps + 4) * sizeof(char *))) == NULL)
+			return False;
+
+		/* Alloca l'identificativo */
+		F = Plan->Files[B % Plan->NFiles];
+		TL = strlen(F) + 1;
+		for (I = 0;I < Plan->NSweeps;I++)
+			{
+				for (J = 0,VL = 0;J < Plan->Sweeps[I].NValues;J++)
+					if (strlen(Plan->Sweeps[I].Values[J]) > VL)
+						VL = strlen(Plan->Sweeps[I].Values[J]);
+				TL += strlen(Plan->Sweeps[I].Name) + VL + 1;
+			}
+		if ((*RTag = (char *) malloc(TL)) == NULL)
+			return False;
+		(*RTag)[0] = '\0';
+
+		/* Opzioni comuni */
+		N = 0;
+		(*RArgv)[N++] = Argv0;
+		for (I = 0;I < Plan->NFixed;I++)
+			(*RArgv)[N++] = Plan->FixedArgs[I];
+
+		/* Identificativo del file di configurazione, senza percorso ed estensione */
+		if (Plan->NFiles > 1)
+			{
+				S = F;
+				if ((E = strrchr(S,'/')) != NULL)
+					S = E + 1;
+				if ((E = strrchr(S,'\\')) != NULL)
+					S = E + 1;
+				if ((E = strrchr(S,'.')) == NULL)
+					E = S + strlen(S);
+				CSTagAppend(*RTag,S,E - S);
+			}
+
+		/* Valori dei parametri */
+		for (I = 0,V = B / Plan->NFiles;I < Plan->NSweeps;I++)
+			{
+				S = Plan->Sweeps[I].Values[V % Plan->Sweeps[I].NValues];
+				V /= Plan->Sweeps[I].NValues;
+				if (((*RArgv)[N] = (char *) malloc(strlen(Plan->Sweeps[I].Name) + strlen(S) + 4)) == NULL)
+					return False;
+				sprintf((*RArgv)[N++],"--%s=%s",Plan->Sweeps[I].Name,S);
+				CSTagAppend(*RTag,Plan->Sweeps[I].Name,strlen(Plan->Sweeps[I].Name));
+				strcat(*RTag,S);
+			}
+
+		/* Directory cache condivisa */
+		if (CacheDir != NULL)
+			{
+				if (((*RArgv)[N] = (char *) malloc(strlen(CSCacheSwitch) + strlen(CacheDir) + 2)) == NULL)
+					return False;
+				sprintf((*RArgv)[N++],"%s=%s",CSCacheSwitch,CacheDir);
+			}
+
+		/* File di configurazione */
+		(*RArgv)[N++] = (char *) F;
+		(*RArgv)[N] = NULL;
+		*RArgc = N;
+
+		return True;
+	}
+
+/* Dealloca la linea di comando di una elaborazione */
+static void CSFreeRun(const CSPlanType * Plan, char ** RArgv, const int RArgc, char * Tag)
+	{
+		int I;
+
+		/* Solo i valori dei parametri e la directory cache sono allocati */
+		for (I = Plan->NFixed + 1;I < RArgc - 1;I++)
+			free(RArgv[I]);
+		free(RArgv);
+		free(Tag);
+	}
+
+#ifndef _WIN32
+
+/* Avvia una elaborazione in un processo separato */
+static pid_t CSStartRun(const CSPlanType * Plan, const int B, const int NRuns, char * Argv0,
+	const char * CacheDir, CSMainType Main)
+	{
+		char ** RArgv;
+		int RArgc;
+		char * Tag;
+		char * LogName;
+		pid_t PId;
+
+		if (CSBuildRun(Plan,B,Argv0,CacheDir,&RArgv,&RArgc,&Tag) == False)
+			return -1;
+		if ((LogName = (char *) malloc(strlen(Tag) + 5)) == NULL)
+			return -1;
+		sprintf(LogName,"%s.log",Tag);
+
+		printf("Run %d/%d: %s, log file: %s\n",B + 1,NRuns,Tag,LogName);
+		fflush(stdout);
+
+		PId = fork();
+		if (PId == 0)
+			{
+				/* Processo figlio, ridirige l'output sul file di log */
+				if (freopen(LogName,"w",stdout) == NULL)
+					exit(1);
+				dup2(fileno(stdout),fileno(stderr));
+				exit(Main(RArgc,RArgv,Tag));
+			}
+
+		free(LogName);
+		CSFreeRun(Plan,RArgv,RArgc,Tag);
+		return PId;
+	}
+
+/* Rimuove la directory cache temporanea */
+static void CSRemoveCache(const char * CacheDir)
+	{
+		DIR * D;
+		struct dirent * DE;
+		char * FName;
+
+		if ((D = opendir(CacheDir)) != NULL)
+			{
+				while ((DE = readdir(D)) != NULL)
+					{
+						if (strcmp(DE->d_name,".") == 0 || strcmp(DE->d_name,"..") == 0)
+							continue;
+						if ((FName = (char *) malloc(strlen(CacheDir) + strlen(DE->d_name) + 2)) == NULL)
+							break;
+						sprintf(FName,"%s/%s",CacheDir,DE->d_name);
+						remove(FName);
+						free(FName);
+					}
+				closedir(D);
+			}
+		rmdir(CacheDir);
+	}
+
+#endif
+
+/* Esegue tutte le elaborazioni richieste */
+int CSRun(int argc, char * argv[], const CfgParameter * CfgParmsDef,
+	CSMainType Main)
+	{
+		CSPlanType Plan;
+		int NRuns;
+		int Failed;
+		int I;
+		time_t CStart;
+		#ifndef _WIN32
+			char CacheDir[] = "/tmp/drc-cache-XXXXXX";
+			char * CDir;
+			pid_t * PIds;
+			pid_t PId;
+			int Running;
+			int Next;
+			int Status;
+		#else
+			char ** RArgv;
+			int RArgc;
+			char * Tag;
+		#endif
+
+		/* Costruisce il piano di esecuzione */
+		if (CSBuildPlan(argc,argv,CfgParmsDef,&Plan) == False)
+			{
+				sputs("Memory allocation failed.");
+				return 1;
+			}
+		if (Plan.NFiles == 0)
+			{
+				sputs("No configuration file supplied.");
+				return 1;
+			}
+
+		/* Determina il numero di elaborazioni */
+		NRuns = Plan.NFiles;
+		for (I = 0;I < Plan.NSweeps;I++)
+			NRuns *= Plan.Sweeps[I].NValues;
+
+		CStart = time(NULL);
+		Failed = 0;
+
+		#ifndef _WIN32
+			/* Determina il numero di elaborazioni parallele */
+			if (Plan.Jobs <= 0)
+				Plan.Jobs = (int) sysconf(_SC_NPROCESSORS_ONLN);
+			if (Plan.Jobs <= 0)
+				Plan.Jobs = 1;
+			printf("Configuration sweep: %d runs, %d parallel jobs.\n",NRuns,Plan.Jobs);
+			fflush(stdout);
+
+			/* Crea una directory cache temporanea se non definita dall'utente,
+			sulla linea di comando o nei file di configurazione */
+			CDir = NULL;
+			if (Plan.HasCache == False)
+				Plan.HasCache = CSFilesHaveCache(&Plan,CfgParmsDef);
+			if (Plan.HasCache == False)
+				{
+					if ((CDir = mkdtemp(CacheDir)) == NULL)
+						sputs("!!Warning: unable to create the cache directory, common stages will not be shared.");
+					else
+						sputsp("Shared stage cache directory: ",CDir);
+				}
+
+			if ((PIds = (pid_t *) malloc(NRuns * sizeof(pid_t))) == NULL)
+				{
+					sputs("Memory allocation failed.");
+					return 1;
+				}
+
+			/* La prima elaborazione viene eseguita da sola per popolare
+			la cache con le fasi comuni */
+			Next = 0;
+			Running = 0;
+			while (Next < NRuns || Running > 0)
+				{
+					/* Avvia le elaborazioni fino al limite di parallelismo */
+					while (Next < NRuns && Running < (Next == 0 ? 1 : Plan.Jobs) &&
+						!(Next == 1 && Running > 0))
+						{
+							PIds[Next] = CSStartRun(&Plan,Next,NRuns,argv[0],CDir,Main);
+							if (PIds[Next] < 0)
+								{
+									sputs("Unable to start the run.");
+									Failed++;
+								}
+							else
+								Running++;
+							Next++;
+						}
+
+					/* Attende il completamento di una elaborazione */
+					if (Running == 0)
+						continue;
+					if ((PId = wait(&Status)) < 0)
+						break;
+					Running--;
+					for (I = 0;I < Next;I++)
+						if (PIds[I] == PId)
+							{
+								if (WIFEXITED(Status) && WEXITSTATUS(Status) == 0)
+									printf("Run %d/%d completed.\n",I + 1,NRuns);
+								else
+									{
+										printf("Run %d/%d failed.\n",I + 1,NRuns);
+										Failed++;
+									}
+								fflush(stdout);
+							}
+				}
+			free(PIds);
+
+			/* Rimuove la directory cache temporanea */
+			if (CDir != NULL)
+				CSRemoveCache(CDir);
+		#else
+			/* Esecuzione sequenziale */
+			printf("Configuration sweep: %d runs.\n",NRuns);
+			fflush(stdout);
+			for (I = 0;I < NRuns;I++)
+				{
+					if (CSBuildRun(&Plan,I,argv[0],NULL,&RArgv,&RArgc,&Tag) == False)
+						{
+							sputs("Memory allocation failed.");
+							return 1;
+						}
+					printf("Run %d/%d: %s\n",I + 1,NRuns,Tag);
+					fflush(stdout);
+					optind = 0;
+					if (Main(RArgc,RArgv,Tag) != 0)
+						Failed++;
+					CSFreeRun(&Plan,RArgv,RArgc,Tag);
+				}
+		#endif
+
+		printf("Configuration sweep completed, %d runs failed.\n",Failed);
+		printf("Total sweep time: %lu s\n",(unsigned long int) (time(NULL) - CStart));
+		fflush(stdout);
+
+		return Failed;
+	}
+
+/* Inserisce l'identificativo prima dell'estensione del nome file */
+char * CSTagFileName(const char * FName, const char * Tag)
+	{
+		const char * Ext;
+		const char * S;
+		char * TName;
+
+		/* Cerca l'estensione nel nome file */
+		S = FName;
+		if ((Ext = strrchr(S,'/')) != NULL)
+			S = Ext + 1;
+		if ((Ext = strrchr(S,'\\')) != NULL)
+			S = Ext + 1;
+		if ((Ext = strrchr(S,'.')) == NULL)
+			Ext = S + strlen(S);
+
+		if ((TName = (char *) malloc(strlen(FName) + strlen(Tag) + 2)) == NULL)
+			return NULL;
+		strncpy(TName,FName,Ext - FName);
+		sprintf(&TName[Ext - FName],"-%s%s",Tag,Ext);
+
+		return TName;
+	}
+
+/* Aggiunge l'identificativo della elaborazione ai file di output */
+Boolean CSApplyTag(const CfgParameter * CfgParmsDef, const char * Tag)
+	{
+		char ** PValue;
+		char * TName;
+		size_t L;
+		int I;
+
+		for (I = 0;CfgParmsDef[I].PType != CfgEnd;I++)
+			{
+				if (CfgParmsDef[I].PType != CfgString)
+					continue;
+				PValue = (char **) CfgParmsDef[I].PValue;
+				if (*PValue == NULL)
+					continue;
+
+				/* Il file di sovrascrittura non pu essere condiviso */
+				if (strcmp(CfgParmsDef[I].PName,"TCOWFile") == 0)
+					{
+						sputs("!!Warning: TCOWFile ignored in configuration sweep mode.");
+						free(*PValue);
+						*PValue = NULL;
+						continue;
+					}
+
+				/* Verifica se si tratta di un file di output */
+				L = strlen(CfgParmsDef[I].PName);
+				if ((L < 7 || strcmp(&CfgParmsDef[I].PName[L - 7],"OutFile") != 0) &&
+					strcmp(CfgParmsDef[I].PName,"MCFilterFile") != 0 &&
+					strcmp(CfgParmsDef[I].PName,"PTFilterFile") != 0)
+					continue;
+
+				/* Sostituisce il nome del file */
+				if ((TName = CSTagFileName(*PValue,Tag)) == NULL)
+					return False;
+				free(*PValue);
+				*PValue = TName;
+			}
+
+		return True;
+	}
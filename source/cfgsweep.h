@@ -0,0 +1,61 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Elaborazione di pi configurazioni in una singola esecuzione */
+
+/* La modalit viene attivata fornendo pi file di configurazione o
+parametri numerici a linea di comando con pi valori separati da virgola,
+ad esempio --MPWindowExponent=0.9,1.0,1.1. Viene eseguita un'elaborazione
+per ogni combinazione di file e valori. Le fasi comuni vengono condivise
+tramite la cache dei risultati intermedi (BCCacheDir): la prima
+combinazione viene eseguita da sola, le rimanenti in parallelo. */
+
+#ifndef CfgSweep_h
+	#define CfgSweep_h
+
+	/* Inclusioni */
+	#include "boolean.h"
+	#include "cfgparse.h"
+
+	/* Procedura di elaborazione di una singola configurazione */
+	typedef int (* CSMainType)(int argc, char * argv[], const char * Tag);
+
+	/* Verifica se la linea di comando richiede pi elaborazioni */
+	Boolean CSIsSweep(int argc, char * argv[], const CfgParameter * CfgParmsDef);
+
+	/* Esegue tutte le elaborazioni richieste, ritorna il numero
+	di elaborazioni fallite */
+	int CSRun(int argc, char * argv[], const CfgParameter * CfgParmsDef,
+		CSMainType Main);
+
+	/* Aggiunge l'identificativo della elaborazione ai file di output */
+	Boolean CSApplyTag(const CfgParameter * CfgParmsDef, const char * Tag);
+
+	/* Inserisce l'identificativo prima dell'estensione del nome file,
+	ritorna il nuovo nome, da deallocare con free, o NULL in caso di
+	memoria insufficiente */
+	char * CSTagFileName(const char * FName, const char * Tag);
+
+#endif
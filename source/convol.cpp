@@ -34,6 +34,9 @@
 
 #include "convol.h"
 #include "fft.h"
+#include "dspalloc.h"
+#include "perfmon.h"
+#include <math.h>
 
 /* Memory leaks debugger */
 #ifdef DebugMLeaks
@@ -94,6 +97,10 @@ Boolean DFftConvolve(const DLReal * A,unsigned int NA,const DLReal * B,
     unsigned int FS;
     DLComplex * FA;
     DLComplex * FB;
+    double Start = 0;
+
+    if (PMEnabled() == True)
+      Start = PMTime();
 
     L = NA + NB - 1;
 
@@ -102,15 +109,15 @@ Boolean DFftConvolve(const DLReal * A,unsigned int NA,const DLReal * B,
     if (CA != NULL)
       FA = CA;
     else
-      if ((FA = new DLComplex[FS]) == NULL)
+      if ((FA = DSPComplexAlloc(FS)) == NULL)
         return(False);
     if (CB != NULL)
       FB = CB;
     else
-      if ((FB = new DLComplex[FS]) == NULL)
+      if ((FB = DSPComplexAlloc(FS)) == NULL)
         {
-          if (CA != NULL)
-            delete[](FA);
+          if (CA == NULL)
+            DSPFree(FA);
           return(False);
         }
 
@@ -137,13 +144,105 @@ Boolean DFftConvolve(const DLReal * A,unsigned int NA,const DLReal * B,
       R[I] = FA[I].real();
 
     if (CA == NULL)
-      delete[] FA;
+      DSPFree(FA);
     if (CB == NULL)
-      delete[] FB;
+      DSPFree(FB);
+
+    PMCountConvolve(NA,NB,Start);
 
     return(True);
   }
 
+Boolean DFftConvolveSpectrum(const DLReal * A,unsigned int NA,const DLReal * B,
+	unsigned int NB,unsigned int Delay,DLReal * R,DLComplex * P,unsigned int FS)
+  {
+    unsigned int I;
+    unsigned int L;
+    DLComplex * FB;
+    double Start = 0;
+
+    if (PMEnabled() == True)
+      Start = PMTime();
+
+    L = NA + NB - 1;
+    if (Delay + L > FS)
+      return(False);
+
+    if ((FB = DSPComplexAlloc(FS)) == NULL)
+      return(False);
+
+    for(I = 0;I < Delay;I++)
+      P[I] = 0;
+    for(I = 0;I < NA;I++)
+      P[Delay + I] = A[I];
+    for(I = Delay + NA;I < FS;I++)
+      P[I] = 0;
+
+    Fft(P,FS);
+
+    for(I = 0;I < NB;I++)
+      FB[I] = B[I];
+    for(I = NB;I < FS;I++)
+      FB[I] = 0;
+
+    Fft(FB,FS);
+
+    for(I = 0;I < FS;I++)
+      P[I] *= FB[I];
+
+    /* Il risultato nel dominio del tempo viene calcolato su una copia
+    per lasciare inalterato lo spettro */
+    if (R != NULL)
+      {
+        for(I = 0;I < FS;I++)
+          FB[I] = P[I];
+
+        IFft(FB,FS);
+
+        for(I = 0;I < L;I++)
+          R[I] = FB[Delay + I].real();
+      }
+
+    DSPFree(FB);
+
+    PMCountConvolve(NA,NB,Start);
+
+    return(True);
+  }
+
+/* Costo stimato di una trasformata su N punti */
+static double DFftCost(unsigned int N)
+  {
+    if (N < 2)
+      return(0);
+    return(N * log((double) N));
+  }
+
+Boolean DFftConvolveHandoff(unsigned int NA,unsigned int NB,unsigned int Delay,
+	unsigned int FS,Boolean TimeDomain)
+  {
+    unsigned int L;
+    unsigned int CS;
+    double DCost;
+    double HCost;
+
+    L = NA + NB - 1;
+    if (Delay + L > FS)
+      return(False);
+
+    for(CS = 1;CS < L;CS <<= 1);
+
+    /* Convoluzione su CS punti seguita dalla trasformata del risultato */
+    DCost = 3 * DFftCost(CS) + DFftCost(FS);
+
+    /* Convoluzione su FS punti con eventuale antitrasformata */
+    HCost = 2 * DFftCost(FS);
+    if (TimeDomain == True)
+      HCost += DFftCost(FS);
+
+    return((HCost < DCost) ? True : False);
+  }
+
 Boolean DFftConvolve(const DLComplex * A,unsigned int NA,const DLComplex * B,
 	unsigned int NB, DLComplex * R,DLComplex * CA,DLComplex * CB)
   {
@@ -152,6 +251,10 @@ Boolean DFftConvolve(const DLComplex * A,unsigned int NA,const DLComplex * B,
     unsigned int FS;
     DLComplex * FA;
     DLComplex * FB;
+    double Start = 0;
+
+    if (PMEnabled() == True)
+      Start = PMTime();
 
     L = NA + NB - 1;
 
@@ -160,15 +263,15 @@ Boolean DFftConvolve(const DLComplex * A,unsigned int NA,const DLComplex * B,
     if (CA != NULL)
       FA = CA;
     else
-      if ((FA = new DLComplex[FS]) == NULL)
+      if ((FA = DSPComplexAlloc(FS)) == NULL)
         return(False);
     if (CB != NULL)
       FB = CB;
     else
-      if ((FB = new DLComplex[FS]) == NULL)
+      if ((FB = DSPComplexAlloc(FS)) == NULL)
         {
-          if (CA != NULL)
-            delete[](FA);
+          if (CA == NULL)
+            DSPFree(FA);
           return(False);
         }
 
@@ -196,9 +299,11 @@ Boolean DFftConvolve(const DLComplex * A,unsigned int NA,const DLComplex * B,
       R[I] = FA[I];
 
     if (CA == NULL)
-      delete[] FA;
+      DSPFree(FA);
     if (CB == NULL)
-      delete[] FB;
+      DSPFree(FB);
+
+    PMCountConvolve(NA,NB,Start);
 
     return(True);
   }
@@ -213,6 +318,10 @@ Boolean OAFftConvolve(const DLReal * A,unsigned int NA,const DLReal * B,
     DLComplex * FB;
     Boolean FAAlloc;
     Boolean FBAlloc;
+    double Start = 0;
+
+    if (PMEnabled() == True)
+      Start = PMTime();
 
     if (NA <= NB)
       {
@@ -234,7 +343,7 @@ Boolean OAFftConvolve(const DLReal * A,unsigned int NA,const DLReal * B,
 
 		if (CA == NULL)
 			{
-		    if ((FA = new DLComplex[FS]) == NULL)
+		    if ((FA = DSPComplexAlloc(FS)) == NULL)
 					return(False);
 				FAAlloc = True;
 			}
@@ -246,10 +355,10 @@ Boolean OAFftConvolve(const DLReal * A,unsigned int NA,const DLReal * B,
 
 		if (CB == NULL)
 			{
-		    if ((FB = new DLComplex[FS]) == NULL)
+		    if ((FB = DSPComplexAlloc(FS)) == NULL)
 		      {
 		      	if (FAAlloc == True)
-		        	delete[](FA);
+		        	DSPFree(FA);
 		        return(False);
 		      }
 		    FBAlloc = True;
@@ -293,9 +402,11 @@ Boolean OAFftConvolve(const DLReal * A,unsigned int NA,const DLReal * B,
       }
 
 		if (FAAlloc == True)
-    	delete[] FA;
+    	DSPFree(FA);
 		if (FBAlloc == True)
-    	delete[] FB;
+    	DSPFree(FB);
+
+    PMCountConvolve(NA,NB,Start);
 
     return(True);
   }
@@ -310,6 +421,10 @@ Boolean OAFftConvolve(const DLComplex * A,unsigned int NA,const DLComplex * B,
     DLComplex * FB;
     Boolean FAAlloc;
     Boolean FBAlloc;
+    double Start = 0;
+
+    if (PMEnabled() == True)
+      Start = PMTime();
 
     if (NA <= NB)
       {
@@ -331,7 +446,7 @@ Boolean OAFftConvolve(const DLComplex * A,unsigned int NA,const DLComplex * B,
 
 		if (CA == NULL)
 			{
-		    if ((FA = new DLComplex[FS]) == NULL)
+		    if ((FA = DSPComplexAlloc(FS)) == NULL)
 					return(False);
 				FAAlloc = True;
 			}
@@ -343,10 +458,10 @@ Boolean OAFftConvolve(const DLComplex * A,unsigned int NA,const DLComplex * B,
 
 		if (CB == NULL)
 			{
-		    if ((FB = new DLComplex[FS]) == NULL)
+		    if ((FB = DSPComplexAlloc(FS)) == NULL)
 		      {
 		      	if (FAAlloc == True)
-		        	delete[](FA);
+		        	DSPFree(FA);
 		        return(False);
 		      }
 		    FBAlloc = True;
@@ -390,9 +505,11 @@ Boolean OAFftConvolve(const DLComplex * A,unsigned int NA,const DLComplex * B,
       }
 
 		if (FAAlloc == True)
-    	delete[] FA;
+    	DSPFree(FA);
 		if (FBAlloc == True)
-    	delete[] FB;
+    	DSPFree(FB);
+
+    PMCountConvolve(NA,NB,Start);
 
     return(True);
   }
@@ -54,6 +54,25 @@
   Boolean DFftConvolve(const DLComplex * A,unsigned int NA,const DLComplex * B,
 	unsigned int NB, DLComplex * R,DLComplex * CA = NULL,DLComplex * CB = NULL);
 
+  // Effettua la convoluzione come DFftConvolve su FS punti, con
+  // FS >= Delay+NA+NB-1, lasciando in P la trasformata su FS punti del
+  // risultato ritardato di Delay campioni. In questo modo la fase di
+  // elaborazione successiva puo` usare direttamente lo spettro P senza
+  // copia, riempimento e trasformata del segnale.
+  // Il risultato nel dominio del tempo, senza ritardo, viene posto in R
+  // solo se R e` diverso da NULL.
+  // Richiede l' allocazione di un array temporaneo e ritorna False in
+  // caso di memoria insufficiente.
+  Boolean DFftConvolveSpectrum(const DLReal * A,unsigned int NA,const DLReal * B,
+    unsigned int NB,unsigned int Delay,DLReal * R,DLComplex * P,unsigned int FS);
+
+  // Ritorna True se il calcolo con DFftConvolveSpectrum su FS punti
+  // risulta meno costoso della convoluzione con DFftConvolve seguita
+  // dalla trasformata su FS punti del risultato. TimeDomain indica se e`
+  // comunque richiesto il risultato nel dominio del tempo.
+  Boolean DFftConvolveHandoff(unsigned int NA,unsigned int NB,unsigned int Delay,
+    unsigned int FS,Boolean TimeDomain);
+
   // Effettua la convoluzione usando l' Fft col metodo overlap-add.
   // Questo sistema puo`, in alcunni casi, risultare piu` veloce del
   // metodo standard.
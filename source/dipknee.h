@@ -0,0 +1,128 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Limitazione valli con ginocchio morbido, condivisa tra DRC e lsconv */
+
+/* Le funzioni operano su coppie (reale, immaginario) consecutive, come
+nei vettori DLComplex o nel formato halfcomplex di Ooura, e sono modelli
+sul tipo floating point, poiche' DRC e lsconv definiscono DLReal in modo
+diverso. Il modulo e la fase vengono modificati senza funzioni
+trascendenti: il nuovo valore e' il valore originale moltiplicato per un
+guadagno reale, i cicli sono privi di salti e vengono vettorizzati dal
+compilatore. */
+
+#ifndef DipKnee_h
+	#define DipKnee_h
+
+	/* Inclusioni */
+	#include <math.h>
+
+	/* Livello limitato con ginocchio morbido per un modulo Abs inferiore
+	a SLevel, con SLevel livello di inizio e GFactor = SLevel - livello minimo */
+	template <class T>
+	inline T DKSoftLevel(const T Abs,const T SLevel,const T GFactor)
+		{
+			T DLLevel;
+
+			DLLevel = (SLevel - Abs) / GFactor;
+			DLLevel = DLLevel / (((T) 1.0) + DLLevel);
+			return SLevel - GFactor * DLLevel;
+		}
+
+	/* Modulo limitato, ginocchio morbido per DLStart < 1,
+	troncatura al livello minimo MinLevel altrimenti */
+	template <class T>
+	inline T DKLimitLevel(const T Abs,const T MinLevel,const T SLevel,
+		const T GFactor,const bool Soft)
+		{
+			if (Soft)
+				return (Abs < SLevel) ? DKSoftLevel(Abs,SLevel,GFactor) : Abs;
+			else
+				return (Abs < MinLevel) ? MinLevel : Abs;
+		}
+
+	/* Limita il modulo delle NP coppie in X al livello minimo MinLevel,
+	mantenendo la fase. Le coppie nulle assumono fase nulla. */
+	template <class T>
+	void DKLimitPairs(T * X,const int NP,const T MinLevel,const T DLStart)
+		{
+			const bool Soft = DLStart < (T) 1.0;
+			const T SLevel = Soft ? MinLevel / DLStart : MinLevel;
+			const T GFactor = SLevel - MinLevel;
+			T Re;
+			T Im;
+			T Abs;
+			T Lev;
+			T Den;
+			int I;
+
+			for (I = 0;I < 2 * NP;I += 2)
+				{
+					Re = X[I];
+					Im = X[I + 1];
+					Abs = (T) sqrt(Re * Re + Im * Im);
+					Lev = DKLimitLevel(Abs,MinLevel,SLevel,GFactor,Soft);
+					Den = (Abs > (T) 0.0) ? Abs : (T) 1.0;
+					X[I] = (Abs > (T) 0.0) ? Re * (Lev / Den) : Lev;
+					X[I + 1] = Im * (Lev / Den);
+				}
+		}
+
+	/* Inverte lo spettro halfcomplex X di N punti limitando il modulo
+	al livello minimo MinLevel, con ginocchio morbido se DLStart < 1 */
+	template <class T>
+	void DKInvertHC(T * X,const int N,const T MinLevel,const T DLStart)
+		{
+			const bool Soft = DLStart < (T) 1.0;
+			const T SLevel = Soft ? MinLevel / DLStart : MinLevel;
+			const T GFactor = SLevel - MinLevel;
+			T Re;
+			T Im;
+			T Abs;
+			T Den;
+			T G;
+			int I;
+
+			/* Componenti continua e di Nyquist, reali */
+			for (I = 0;I < 2;I++)
+				if (X[I] < SLevel)
+					X[I] = ((T) 1.0) / (Soft ? DKSoftLevel(X[I],SLevel,GFactor) : MinLevel);
+				else
+					X[I] = ((T) 1.0) / X[I];
+
+			/* Inversione come coniugato per il guadagno 1 / (|X| * livello) */
+			for (I = 2;I < N;I += 2)
+				{
+					Re = X[I];
+					Im = X[I + 1];
+					Abs = (T) sqrt(Re * Re + Im * Im);
+					Den = (Abs > (T) 0.0) ? Abs : (T) 1.0;
+					G = ((T) 1.0) / (Den * DKLimitLevel(Abs,MinLevel,SLevel,GFactor,Soft));
+					X[I] = (Abs > (T) 0.0) ? Re * G : ((T) 1.0) / MinLevel;
+					X[I + 1] = -Im * G;
+				}
+		}
+
+#endif
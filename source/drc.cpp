@@ -47,6 +47,16 @@
 #include "cmdline.h"
 #include "spline.h"
 #include "psychoacoustic.h"
+#include "stagecache.h"
+#include "cfgsweep.h"
+#include "dspalloc.h"
+#include "lowmem.h"
+#include "perfmon.h"
+#include "vecmath.h"
+#include "fft.h"
+#include "sigwrite.h"
+#include "tpool.h"
+#include "resample.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -62,6 +72,256 @@
 	#include "debug_new.h"
 #endif
 
+/* Prefissi dei parametri letti dalle fasi i cui risultati sono
+memorizzati in cache, vedi drccfg.h */
+static const char * HDCachePrefixes[] = { "HDMultExponent", "HDPrecision", "BCVectorMath", NULL };
+static const char * ISCachePrefixes[] = { "BCSampleRate", "BCPreWindowLen", "HD", "MP", "DL", "EP", "PC", "IS",
+	"BCMemoryLimit", "BCVectorMath", NULL };
+
+/* Segnali intermedi salvati su file dalle fasi che vengono saltate quando
+il segnale invertito viene recuperato dalla cache. Sono memorizzati nella
+cache con la stessa chiave del segnale invertito, in modo da poter essere
+salvati anche in questo caso */
+#define ISCacheDumps 5
+#define ISDumpHDMP 0
+#define ISDumpHDEP 1
+#define ISDumpMPPF 2
+#define ISDumpEPPF 3
+#define ISDumpPC 4
+
+typedef struct
+	{
+		const char * Tag;
+		char ** OutFile;
+		char ** OutFileType;
+		const char * SaveMsg;
+		const char * FailMsg;
+	}
+ISCacheDumpType;
+
+static const ISCacheDumpType ISCacheDump[ISCacheDumps] =
+	{
+		{ "is-hdmp", &Cfg.HDMPOutFile, &Cfg.HDMPOutFileType,
+			"Saving minimum phase component: ", "Minimum phase component save failed." },
+		{ "is-hdep", &Cfg.HDEPOutFile, &Cfg.HDEPOutFileType,
+			"Saving excess phase component: ", "Excess phase component save failed." },
+		{ "is-mppf", &Cfg.MPPFOutFile, &Cfg.MPPFOutFileType,
+			"Saving minimum phase component: ", "Minimum phase component save failed." },
+		{ "is-eppf", &Cfg.EPPFOutFile, &Cfg.EPPFOutFileType,
+			"Saving excess phase component: ", "Excess phase component save failed." },
+		{ "is-pc", &Cfg.PCOutFile, &Cfg.PCOutFileType,
+			"Saving MP/EP signal: ", "MP/EP signal save failed." }
+	};
+
+/* Memorizza nella cache il segnale intermedio D appena salvato su file */
+static void DRCCacheDump(const int D,const DLReal * Sig,const int SigLen,
+	const SCKeyType Key)
+	{
+		if (Cfg.BCCacheDir == NULL)
+			return;
+		if (SCStore(Cfg.BCCacheDir,ISCacheDump[D].Tag,Key,Sig,SigLen,NULL,0) == False)
+			sputs("!!Warning: unable to save the intermediate signal to the cache.");
+	}
+
+/* Recupera dalla cache i segnali intermedi da salvare su file, ritorna
+False, senza alcun segnale allocato, se almeno uno non  disponibile */
+static Boolean DRCLoadDumps(const SCKeyType Key,DLReal * Sigs[],int Lens[])
+	{
+		Boolean Res;
+		int D;
+
+		Res = True;
+		for (D = 0;D < ISCacheDumps;D++)
+			{
+				Sigs[D] = NULL;
+				if (*ISCacheDump[D].OutFile == NULL || Res == False)
+					continue;
+				Sigs[D] = SCLoad(Cfg.BCCacheDir,ISCacheDump[D].Tag,Key,&Lens[D],NULL,0);
+				if (Sigs[D] == NULL)
+					Res = False;
+			}
+
+		if (Res == False)
+			for (D = 0;D < ISCacheDumps;D++)
+				{
+					delete[] Sigs[D];
+					Sigs[D] = NULL;
+				}
+
+		return Res;
+	}
+
+/* Salva su file i segnali intermedi recuperati dalla cache e li dealloca */
+static Boolean DRCSaveDumps(DLReal * Sigs[],const int Lens[])
+	{
+		Boolean Res;
+		int D;
+
+		Res = True;
+		for (D = 0;D < ISCacheDumps;D++)
+			{
+				if (Sigs[D] == NULL)
+					continue;
+				if (Res == True)
+					{
+						sputsp(ISCacheDump[D].SaveMsg,*ISCacheDump[D].OutFile);
+						if (SWWriteSignal(*ISCacheDump[D].OutFile,Sigs[D],Lens[D],
+							(IFileType) (*ISCacheDump[D].OutFileType)[0]) == False)
+							{
+								sputs(ISCacheDump[D].FailMsg);
+								Res = False;
+							}
+					}
+				delete[] Sigs[D];
+				Sigs[D] = NULL;
+			}
+
+		return Res;
+	}
+
+/* Precisione di calcolo di una fase, quella di compilazione se
+non specificata */
+static DLPrecisionType DRCPrecision(const char * P)
+	{
+		if (P == NULL)
+			return DLPNative;
+		return (DLPrecisionType) P[0];
+	}
+
+/* Dimensione della trasformata usata dalle fasi di elaborazione per un
+segnale di lunghezza N con moltiplicatore MExp */
+static int DRCFftSize(const int N,const int MExp)
+	{
+		int FS;
+
+		if (MExp < 0)
+			return N;
+		for (FS = 1;FS <= N;FS <<= 1);
+		return FS * (1 << MExp);
+	}
+
+/* Adatta il moltiplicatore FFT MExp della fase Name al limite di memoria.
+Le tabelle FFT mantenute dalla fase precedente vengono rilasciate, mentre
+quelle della fase vengono considerate insieme agli NArrays array complessi
+allocati dalla procedura, di dimensione doppia se la precisione Prec usa
+un tipo pi ampio di quello di compilazione, ed ai segnali in uso
+durante la chiamata, di LiveLen campioni complessivi */
+static int DRCFitExponent(const char * Name,const int N,const int MExp,
+	const int NArrays,const int LiveLen,const DLPrecisionType Prec)
+	{
+		int NA;
+
+		if (LMEnabled() == False)
+			return MExp;
+
+		FftReleaseTables();
+		NA = NArrays + FftWorkArrays;
+		if (DLUseAltReal(Prec) == True && sizeof(DLAltReal) > sizeof(DLReal))
+			NA *= 2;
+		return LMFitExponent(Name,N,MExp,NA,((size_t) LiveLen) * sizeof(DLReal));
+	}
+
+/* Verifica se  abilitato il passaggio diretto dello spettro della
+convoluzione alla fase successiva, escluso con il limite di memoria
+dato che la dimensione della trasformata viene adattata solo dopo la
+convoluzione */
+static Boolean DRCSpectrumHandoff(void)
+	{
+		if (Cfg.BCSpectrumHandoff != NULL && Cfg.BCSpectrumHandoff[0] == 'N')
+			return False;
+		return (LMEnabled() == True) ? False : True;
+	}
+
+/* Ricava dal filtro Sig le versioni alle frequenze di campionamento di
+BCDeriveRates e le salva nei file ottenuti aggiungendo la frequenza al nome
+FName. La lunghezza viene scalata per ottave, come nelle configurazioni
+fornite, in cui 44.1 e 48 kHz, cos come 88.2 e 96 kHz, usano le stesse
+lunghezze. Il campione di riferimento Anchor viene posto al centro del
+filtro ricavato se Centered, altrimenti alla stessa distanza temporale
+dall'inizio del filtro. */
+static Boolean DRCDeriveRates(const char * FName,const char * Desc,const DLReal * Sig,
+	const int SigLen,const int Anchor,const Boolean Centered,const DLReal NormFactor,
+	const char * NormT,const IFileType FType)
+	{
+		const char * S;
+		char * End;
+		char Tag[32];
+		char * TName;
+		DLReal * Out;
+		DLReal Gain;
+		int Rate;
+		int OutLen;
+		int OutAnchor;
+		int K;
+		int I;
+
+		for (S = Cfg.BCDeriveRates;*S != '\0';S = (*End == ',') ? End + 1 : End)
+			{
+				Rate = (int) strtol(S,&End,10);
+				if (Rate == Cfg.BCSampleRate)
+					continue;
+
+				/* Determina lunghezza e posizione del riferimento */
+				K = (int) floor(log(((double) Rate) / Cfg.BCSampleRate) / log(2.0) + 0.5);
+				OutLen = (K >= 0) ? SigLen << K : SigLen >> -K;
+				if (Centered == True)
+					OutAnchor = OutLen / 2;
+				else
+					OutAnchor = (int) floor(((double) Anchor) * Rate / Cfg.BCSampleRate + 0.5);
+				printf("Deriving %d Hz %s, length: %d, reference: %d.\n",Rate,Desc,
+					OutLen,OutAnchor);
+				fflush(stdout);
+
+				/* Ricampiona il filtro mantenendone la risposta in frequenza */
+				Out = new DLReal[OutLen];
+				if (Out == NULL)
+					{
+						sputs("Memory allocation failed.");
+						return False;
+					}
+				if (PolyResample(Sig,SigLen,Cfg.BCSampleRate,Anchor,Out,OutLen,
+					Rate,OutAnchor) == False)
+					{
+						sputs("Resampling failed.");
+						delete[] Out;
+						return False;
+					}
+				Gain = (DLReal) (((double) Cfg.BCSampleRate) / Rate);
+				for (I = 0;I < OutLen;I++)
+					Out[I] *= Gain;
+
+				/* Normalizzazione come per il filtro originale */
+				if (NormFactor > 0)
+					if (SigNormalize(Out,OutLen,NormFactor,(NormType) NormT[0]) == False)
+						{
+							sputs("Normalization failed.");
+							delete[] Out;
+							return False;
+						}
+
+				/* Salva il filtro */
+				sprintf(Tag,"%d",Rate);
+				if ((TName = CSTagFileName(FName,Tag)) == NULL)
+					{
+						sputs("Memory allocation failed.");
+						delete[] Out;
+						return False;
+					}
+				sputsp("Saving derived signal: ",TName);
+				if (SWWriteSignal(TName,Out,OutLen,FType) == False)
+					{
+						sputs("Derived signal save failed.");
+						free(TName);
+						delete[] Out;
+						return False;
+					}
+				free(TName);
+				delete[] Out;
+			}
+
+		return True;
+	}
+
 /* Header iniziale programma */
 void ShowDRCHeader(void)
 	{
@@ -93,20 +353,29 @@ void ShowDRCHeader(void)
 /* Descrizione uso programma */
 void ShowDRCUsage(void)
 	{
-		sputs("Usage: DRC [--help] [Options] DRCFile");
+		sputs("Usage: DRC [--help] [Options] DRCFile [DRCFile ...]");
 		sputs("\nParameters:\n");
 		sputs("  --help : show the full options list (long)");
 		sputs("  Options: parameters overwriting options");
 		sputs("  DRCFile: name of DRC configration file\n");
+		sputs("  Multiple DRC files or numeric options with comma separated");
+		sputs("  values (--Option=V1,V2,...) run one computation for each");
+		sputs("  combination, sharing the common stages. --SweepJobs=N sets");
+		sputs("  the number of parallel computations\n");
+		sputs("  --BCThreads=N runs the heavy stages on N threads,");
+		sputs("  -1 for all the available processors\n");
 		sputs("  Refer to the manual and samples for options");
 		sputs("  details and file format\n");
 	}
 
-/* Main procedure */
-int main(int argc, char * argv[])
+/* Procedura di elaborazione di una singola configurazione.
+SweepTag, se non nullo, identifica l'elaborazione all'interno di
+un insieme di configurazioni e viene aggiunto ai nomi dei file di output. */
+static int DRCMain(int argc, char * argv[], const char * SweepTag)
 	{
 		/* Segnale in ingresso */
 		DLReal * OInSig;
+		FILE * OInSigFile = NULL;
 		DLReal * InSig;
 
 		/* Punto iniziale e finale lettura da file */
@@ -157,6 +426,7 @@ int main(int argc, char * argv[])
 		DLReal * ISRevSig;
 		DLReal * ISMPEPSig;
 		DLReal * ISRevOut;
+		int ISRevOutLen;
 		int ISSigLen;
 
 		/* Array troncatura ringing */
@@ -172,6 +442,11 @@ int main(int argc, char * argv[])
 		int PSOutSigLen;
 		int PSMPFLen;
 
+		/* Spettri passati direttamente dalla convoluzione alla fase successiva */
+		DLComplex * PLSigFFT = NULL;
+		DLComplex * MSSigFFT = NULL;
+		int SHFS;
+
 		/* Valore RMS segnale in ingresso */
 		DLReal SRMSValue;
 
@@ -179,6 +454,13 @@ int main(int argc, char * argv[])
 		DLReal * TCSig;
 		int TCSigLen;
 
+		/* Chiavi e parametri cache risultati intermedi */
+		SCKeyType HDCacheKey = 0;
+		SCKeyType ISCacheKey = 0;
+		int ISCacheParms[2];
+		DLReal * ISDumpSig[ISCacheDumps];
+		int ISDumpLen[ISCacheDumps];
+
 		/* Indici generici */
 		int I;
 		int J;
@@ -197,6 +479,9 @@ int main(int argc, char * argv[])
 		/* Salvataggio istante di avvio */
 		time_t CStart = (time_t) 0;
 
+		/* Statistiche allocatore array temporanei */
+		DSPAllocStatsType DSPStats;
+
 		/* I386 Debug only, enables all floating point exceptions traps */
 		/* int em = 0x372;
 		__asm__ ("fldcw %0" : : "m" (em)); */
@@ -300,14 +585,81 @@ int main(int argc, char * argv[])
 				return 1;
 			}
 
+		/* Aggiunge l'identificativo dell'elaborazione ai file di output */
+		if (SweepTag != NULL)
+			if (CSApplyTag(CfgParmsDef,SweepTag) == False)
+				{
+					sputs("Memory allocation failed.");
+					return 1;
+				}
+
 		/* Controlla se  stata definita un directory base */
 		if (Cfg.BCBaseDir != NULL)
 			if (strlen(Cfg.BCBaseDir) > 0)
 				sputsp("Base directory: ",Cfg.BCBaseDir);
 
+		/* Imposta l'uso delle huge pages per gli array temporanei */
+		if (Cfg.BCHugePages != NULL)
+			DSPAllocSetHugePages(Cfg.BCHugePages[0] == 'Y' ? True : False);
+
+		/* Imposta l'uso della libreria matematica standard al posto
+		delle funzioni vettorizzabili */
+		if (Cfg.BCVectorMath != NULL)
+			VMSetLibm(Cfg.BCVectorMath[0] == 'N' ? True : False);
+
+		/* Avvia il pool di thread condiviso */
+		if (Cfg.BCThreads != 0)
+			{
+				if (TPSetThreads((Cfg.BCThreads < 0) ? 0 : (unsigned int) Cfg.BCThreads,
+					(Cfg.BCThreadAffinity != NULL) ? (TPAffinityType) Cfg.BCThreadAffinity[0] :
+					TPAffinityNone) == False)
+					sputs("Thread pool creation incomplete.");
+				TPSetDeterministic((Cfg.BCDeterministic == NULL ||
+					Cfg.BCDeterministic[0] == 'Y') ? True : False);
+				printf("Threads: %u.\n",TPGetThreads());
+				fflush(stdout);
+			}
+
+		/* Imposta il calcolo parallelo delle FFT, che in assenza di
+		indicazioni usa gli stessi thread del pool se non  richiesto
+		un risultato identico a quello dell'elaborazione seriale */
+		if (Cfg.BCFftThreads == 0 && TPGetThreads() > 1 && TPGetDeterministic() == False)
+			FftSetThreads(TPGetThreads(),
+				(Cfg.BCFftThreadsMinSize > 0) ? (unsigned int) Cfg.BCFftThreadsMinSize : 262144);
+		if (Cfg.BCFftThreads != 0)
+			{
+				FftSetThreads((Cfg.BCFftThreads < 0) ? 0 : (unsigned int) Cfg.BCFftThreads,
+					(Cfg.BCFftThreadsMinSize > 0) ? (unsigned int) Cfg.BCFftThreadsMinSize : 262144);
+				printf("FFT threads: %u.\n",FftGetThreads());
+				fflush(stdout);
+			}
+
+		/* Imposta il limite di memoria */
+		if (Cfg.BCMemoryLimit > 0)
+			{
+				printf("Memory limit: %d MB.\n",Cfg.BCMemoryLimit);
+				fflush(stdout);
+				LMSetLimit(Cfg.BCMemoryLimit);
+
+				/* Le tabelle delle finestre non rientrano nel calcolo della
+				memoria disponibile */
+				DWSetCacheSize(0);
+			}
+
+		/* Avvia la scrittura asincrona dei segnali, esclusa con il limite
+		di memoria dato che le copie dei segnali accodati non rientrano nel
+		calcolo della memoria disponibile */
+		if ((Cfg.BCAsyncWrite == NULL || Cfg.BCAsyncWrite[0] == 'Y') && Cfg.BCMemoryLimit <= 0)
+			SWStart((Cfg.BCAsyncWriteQueue > 0) ? Cfg.BCAsyncWriteQueue : 64);
+
+		/* Attiva il rilevamento delle prestazioni */
+		if (Cfg.BCProfileOutFile != NULL)
+			PMInit();
+
 		/*********************************************************************************/
 		/* Importazione iniziale risposta all'impulso */
 		/*********************************************************************************/
+		PMStage("Input");
 
 		/* Controlla il tipo ricerca centro impulso */
 		if (Cfg.BCImpulseCenterMode[0] == 'A')
@@ -357,6 +709,7 @@ int main(int argc, char * argv[])
 		/*********************************************************************************/
 		/* Compensazione microfono */
 		/*********************************************************************************/
+		PMStage("Mic compensation");
 
 		/* Verifica se abilitata */
 		if (Cfg.MCFilterType[0] != 'N')
@@ -438,6 +791,12 @@ int main(int argc, char * argv[])
 						break;
 					}
 
+				/* Adatta il moltiplicatore FFT al limite di memoria, il calcolo
+				del filtro usa trasformate di dimensione doppia */
+				I = (Cfg.MCFilterType[0] == 'M') ? 1 + 2 * Cfg.MCFilterLen : Cfg.MCFilterLen;
+				Cfg.MCMultExponent = DRCFitExponent("MCMultExponent",I,Cfg.MCMultExponent,
+					5,Cfg.BCInitWindow + MCOutSigLen + 2 * I,DLPNative);
+
 				/* Verifica il tipo di filtro da utilizzare */
 				switch (Cfg.MCFilterType[0])
 					{
@@ -546,7 +905,7 @@ int main(int argc, char * argv[])
 					{
 						/* Salva la componente MP */
 						sputsp("Saving mic compensation filter: ",Cfg.MCFilterFile);
-						if (WriteSignal(Cfg.MCFilterFile,MCFilter,Cfg.MCFilterLen,
+						if (SWWriteSignal(Cfg.MCFilterFile,MCFilter,Cfg.MCFilterLen,
 							(IFileType) Cfg.MCFilterFileType[0]) == False)
 							{
 								sputs("Mic compensation filter save failed.");
@@ -629,7 +988,7 @@ int main(int argc, char * argv[])
 					{
 						/* Salva il segnale compensato  */
 						sputsp("Saving mic compensated signal: ",Cfg.MCOutFile);
-						if (WriteSignal(Cfg.MCOutFile,&MCOutSig[MCOutSigStart],MCOutSigLen,
+						if (SWWriteSignal(Cfg.MCOutFile,&MCOutSig[MCOutSigStart],MCOutSigLen,
 							(IFileType) Cfg.MCOutFileType[0]) == False)
 							{
 								sputs("Mic compensated signal save failed.");
@@ -653,6 +1012,7 @@ int main(int argc, char * argv[])
     /*********************************************************************************/
 		/* Salvataggio segnale convoluzione di test */
 		/*********************************************************************************/
+		PMStage("Test convolution signal");
 
     /* Verifica se  attiva la convoluzione di test */
     if (Cfg.TCOutFile != NULL || Cfg.PTType[0] != 'N')
@@ -679,13 +1039,32 @@ int main(int argc, char * argv[])
 			printf("Input signal RMS level %f (-Inf dB).\n",(double) SRMSValue);
 		fflush(stdout);
 
+		/* Il segnale per la convoluzione di test non viene utilizzato fino
+		al calcolo del target psicoacustico, lo parcheggia su file temporaneo */
+		if (LMEnabled() == True && (Cfg.TCOutFile != NULL || Cfg.PTType[0] != 'N'))
+			{
+				sputs("Moving test convolution signal to temporary file.");
+				if ((OInSigFile = LMSpill(OInSig,MCOutSigLen)) == NULL)
+					{
+						sputs("Temporary file write failed.");
+						return 1;
+					}
+				delete[] OInSig;
+				OInSig = NULL;
+			}
+
     /*********************************************************************************/
 		/* Dip limiting preventivo */
 		/*********************************************************************************/
+		PMStage("Initial dip limiting");
 
 		/* Verifica se si deve effettuare il dip limiting */
 		if (Cfg.BCDLMinGain > 0)
 			{
+				/* Adatta il moltiplicatore FFT al limite di memoria */
+				Cfg.BCDLMultExponent = DRCFitExponent("BCDLMultExponent",MCOutSigLen,
+					Cfg.BCDLMultExponent,4,MCOutSigLen,DLPNative);
+
 				switch (Cfg.BCDLType[0])
 					{
 						/* Fase lineare */
@@ -727,37 +1106,113 @@ int main(int argc, char * argv[])
 			}
 
 		/*********************************************************************************/
-		/* Deconvoluzione omomorfa */
+		/* Recupero risultati da cache */
 		/*********************************************************************************/
+		PMStage("Cache lookup");
 
-		/* Alloca gli array per la deconvoluzione omomorfa */
-		sputs("Allocating homomorphic deconvolution arrays.");
-		MPSig = new DLReal[2 * MCOutSigLen];
-		if (MPSig == NULL)
-			{
-				sputs("Memory allocation failed.");
-				return 1;
-			}
-		EPSig = new DLReal[MCOutSigLen];
-		if (EPSig == NULL)
+		/* Adatta il moltiplicatore FFT al limite di memoria, prima del calcolo
+		delle chiavi della cache dato che ne modifica il risultato */
+		Cfg.HDMultExponent = DRCFitExponent("HDMultExponent",MCOutSigLen,
+			Cfg.HDMultExponent,3,4 * MCOutSigLen,DRCPrecision(Cfg.HDPrecision));
+
+		/* Verifica se la cache dei risultati intermedi  abilitata */
+		MPSig = NULL;
+		EPSig = NULL;
+		if (Cfg.BCCacheDir != NULL)
 			{
-				sputs("Memory allocation failed.");
-				return 1;
+				/* Calcola le chiavi della cache sulla base del segnale
+				in ingresso e dei parametri delle varie fasi */
+				HDCacheKey = SCHashSignal(SCHashInit(),&MCOutSig[MCOutSigStart],MCOutSigLen);
+				HDCacheKey = SCHashCfg(HDCacheKey,CfgParmsDef,HDCachePrefixes);
+				ISCacheKey = SCHashCfg(HDCacheKey,CfgParmsDef,ISCachePrefixes);
+
+				/* Verifica se il segnale invertito  gi disponibile */
+				sputsp("Looking up cached results in: ",Cfg.BCCacheDir);
+				ISRevOut = SCLoad(Cfg.BCCacheDir,"is",ISCacheKey,&WLen3,ISCacheParms,2);
+
+				/* Il segnale invertito viene usato solo se sono disponibili anche
+				i segnali intermedi da salvare su file */
+				if (ISRevOut != NULL && DRCLoadDumps(ISCacheKey,ISDumpSig,ISDumpLen) == False)
+					{
+						sputs("Intermediate signals not available in the cache.");
+						delete[] ISRevOut;
+						ISRevOut = NULL;
+					}
+				if (ISRevOut != NULL)
+					{
+						sputs("Inverted signal recovered from cache.");
+						WStart2 = ISCacheParms[0];
+						WLen2 = ISCacheParms[1];
+
+						/* Dealloca il segnale di ingresso */
+						delete[] MCOutSig;
+
+						/* Salva i segnali intermedi richiesti */
+						if (DRCSaveDumps(ISDumpSig,ISDumpLen) == False)
+							return 1;
+
+						/* Salta direttamente al salvataggio del segnale invertito */
+						goto ISCacheHit;
+					}
+
+				/* Verifica se la deconvoluzione omomorfa  gi disponibile */
+				MPSig = SCLoad(Cfg.BCCacheDir,"hdmp",HDCacheKey,&I,NULL,0);
+				if (MPSig != NULL)
+					{
+						EPSig = SCLoad(Cfg.BCCacheDir,"hdep",HDCacheKey,&I,NULL,0);
+						if (EPSig == NULL)
+							{
+								delete[] MPSig;
+								MPSig = NULL;
+							}
+					}
 			}
 
-		/* Azzera gli array */
-		for (I = 0;I < 2 * MCOutSigLen;I++)
-			MPSig[I] = 0;
-		for (I = 0;I < MCOutSigLen;I++)
-			EPSig[I] = 0;
+		/*********************************************************************************/
+		/* Deconvoluzione omomorfa */
+		/*********************************************************************************/
+		PMStage("Homomorphic deconvolution");
 
-		/* Effettua la deconvoluzione omomorfa*/
-		sputs("Homomorphic deconvolution stage...");
-		if (CepstrumHD(&MCOutSig[MCOutSigStart],&MPSig[MCOutSigLen / 2 - (1 - (MCOutSigLen % 2))],EPSig,
-			MCOutSigLen,Cfg.HDMultExponent) == False)
+		/* Verifica se la deconvoluzione  stata recuperata dalla cache */
+		if (MPSig != NULL)
+			sputs("Homomorphic deconvolution recovered from cache.");
+		else
 			{
-				sputs("Homomorphic deconvolution failed.");
-				return 1;
+				/* Alloca gli array per la deconvoluzione omomorfa */
+				sputs("Allocating homomorphic deconvolution arrays.");
+				MPSig = new DLReal[2 * MCOutSigLen];
+				if (MPSig == NULL)
+					{
+						sputs("Memory allocation failed.");
+						return 1;
+					}
+				EPSig = new DLReal[MCOutSigLen];
+				if (EPSig == NULL)
+					{
+						sputs("Memory allocation failed.");
+						return 1;
+					}
+
+				/* Azzera gli array */
+				for (I = 0;I < 2 * MCOutSigLen;I++)
+					MPSig[I] = 0;
+				for (I = 0;I < MCOutSigLen;I++)
+					EPSig[I] = 0;
+
+				/* Effettua la deconvoluzione omomorfa*/
+				sputs("Homomorphic deconvolution stage...");
+				if (CepstrumHD(&MCOutSig[MCOutSigStart],&MPSig[MCOutSigLen / 2 - (1 - (MCOutSigLen % 2))],EPSig,
+					MCOutSigLen,Cfg.HDMultExponent,DRCPrecision(Cfg.HDPrecision)) == False)
+					{
+						sputs("Homomorphic deconvolution failed.");
+						return 1;
+					}
+
+				/* Salva il risultato nella cache */
+				if (Cfg.BCCacheDir != NULL)
+					if (SCStore(Cfg.BCCacheDir,"hdmp",HDCacheKey,MPSig,2 * MCOutSigLen,NULL,0) == False ||
+						SCStore(Cfg.BCCacheDir,"hdep",HDCacheKey,EPSig,MCOutSigLen,NULL,0) == False)
+						sputs("!!Warning: unable to save the homomorphic deconvolution to the cache.");
 			}
 
 		/* Verifica se si deve effettuare rinormalizzazione */
@@ -787,12 +1242,13 @@ int main(int argc, char * argv[])
 			{
 				/* Salva la componente MP */
 				sputsp("Saving minimum phase component: ",Cfg.HDMPOutFile);
-				if (WriteSignal(Cfg.HDMPOutFile,MPSig,MCOutSigLen,
+				if (SWWriteSignal(Cfg.HDMPOutFile,MPSig,MCOutSigLen,
 					(IFileType) Cfg.HDMPOutFileType[0]) == False)
 					{
 						sputs("Minimum phase component save failed.");
 						return 1;
 					}
+				DRCCacheDump(ISDumpHDMP,MPSig,MCOutSigLen,ISCacheKey);
 			}
 
 		/* Verifica se si deve salvare la componente EP */
@@ -800,12 +1256,13 @@ int main(int argc, char * argv[])
 			{
 				/* Salva la componente EP */
 				sputsp("Saving excess phase component: ",Cfg.HDEPOutFile);
-				if (WriteSignal(Cfg.HDEPOutFile,EPSig,MCOutSigLen,
+				if (SWWriteSignal(Cfg.HDEPOutFile,EPSig,MCOutSigLen,
 					(IFileType) Cfg.HDEPOutFileType[0]) == False)
 					{
 						sputs("Excess phase component save failed.");
 						return 1;
 					}
+				DRCCacheDump(ISDumpHDEP,EPSig,MCOutSigLen,ISCacheKey);
 			}
 
 		/* Dealloca il segnale di ingresso */
@@ -814,6 +1271,7 @@ int main(int argc, char * argv[])
 		/*********************************************************************************/
 		/* Prefiltratura componente MP */
 		/*********************************************************************************/
+		PMStage("MP prefiltering");
 
 		/* Alloca l'array per il segnale MP prefiltrato */
 		sputs("Allocating minimum phase component prefiltering array.");
@@ -920,10 +1378,15 @@ int main(int argc, char * argv[])
 		/*********************************************************************************/
 		/* Dip limiting */
 		/*********************************************************************************/
+		PMStage("Dip limiting");
 
 		/* Verifica se si deve effettuare il dip limiting */
 		if (Cfg.DLMinGain > 0)
 			{
+				/* Adatta il moltiplicatore FFT al limite di memoria */
+				Cfg.DLMultExponent = DRCFitExponent("DLMultExponent",WLen1,
+					Cfg.DLMultExponent,4,MPPFSigLen + MCOutSigLen,DLPNative);
+
 				switch (Cfg.DLType[0])
 					{
 						/* Fase lineare */
@@ -985,10 +1448,14 @@ int main(int argc, char * argv[])
 				else
 					MPEPSig = NULL;
 
+				/* Adatta il moltiplicatore FFT al limite di memoria */
+				Cfg.MPHDMultExponent = DRCFitExponent("MPHDMultExponent",WLen1,Cfg.MPHDMultExponent,
+					3,MPPFSigLen + MCOutSigLen + 3 * WLen1,DRCPrecision(Cfg.HDPrecision));
+
 				/* Effettua la deconvoluzione omomorfa*/
 				sputs("MP Recover homomorphic deconvolution stage...");
 				if (CepstrumHD(&MPPFSig[WStart1],&MPSig[WLen1 / 2 - (1 - (WLen1 % 2))],MPEPSig,
-					WLen1,Cfg.MPHDMultExponent) == False)
+					WLen1,Cfg.MPHDMultExponent,DRCPrecision(Cfg.HDPrecision)) == False)
 					{
 						sputs("Homomorphic deconvolution failed.");
 						return 1;
@@ -1031,17 +1498,19 @@ int main(int argc, char * argv[])
 			{
 				/* Salva la componente MP */
 				sputsp("Saving minimum phase component: ",Cfg.MPPFOutFile);
-				if (WriteSignal(Cfg.MPPFOutFile,&MPPFSig[WStart1],WLen1,
+				if (SWWriteSignal(Cfg.MPPFOutFile,&MPPFSig[WStart1],WLen1,
 					(IFileType) Cfg.MPPFOutFileType[0]) == False)
 					{
 						sputs("Minimum phase component save failed.");
 						return 1;
 					}
+				DRCCacheDump(ISDumpMPPF,&MPPFSig[WStart1],WLen1,ISCacheKey);
 			}
 
 		/*********************************************************************************/
 		/* Prefiltratura componente EP */
 		/*********************************************************************************/
+		PMStage("EP prefiltering");
 
 		/* Controlla se si deve preservare la componente EP della fase minima */
 		if (Cfg.MPHDRecover[0] == 'Y' && Cfg.MPEPPreserve[0] == 'Y')
@@ -1179,6 +1648,10 @@ int main(int argc, char * argv[])
 		/* Verifica se si deve effettuare riappianamento */
 		if (Cfg.EPPFFlatGain > 0)
 			{
+				/* Adatta il moltiplicatore FFT al limite di memoria */
+				Cfg.EPPFFGMultExponent = DRCFitExponent("EPPFFGMultExponent",WLen2,Cfg.EPPFFGMultExponent,
+					4,MPPFSigLen + EPPFSigLen + WLen2,DRCPrecision(Cfg.HDPrecision));
+
 				switch (Cfg.EPPFFlatType[0])
 					{
 						case 'L':
@@ -1210,7 +1683,7 @@ int main(int argc, char * argv[])
 							/* Effettua la deconvoluzione omomorfa*/
 							sputs("Excess phase component homomorphic deconvolution flattening...");
 							if (CepstrumHD(&EPPFSig[WStart2],NULL,EPSig,
-								WLen2,Cfg.EPPFFGMultExponent) == False)
+								WLen2,Cfg.EPPFFGMultExponent,DRCPrecision(Cfg.HDPrecision)) == False)
 								{
 									sputs("Homomorphic deconvolution failed.");
 									return 1;
@@ -1250,17 +1723,19 @@ int main(int argc, char * argv[])
 			{
 				/* Salva la componente MP */
 				sputsp("Saving excess phase component: ",Cfg.EPPFOutFile);
-				if (WriteSignal(Cfg.EPPFOutFile,&EPPFSig[WStart2],WLen2,
+				if (SWWriteSignal(Cfg.EPPFOutFile,&EPPFSig[WStart2],WLen2,
 					(IFileType) Cfg.EPPFOutFileType[0]) == False)
 					{
 						sputs("Excess phase component save failed.");
 						return 1;
 					}
+				DRCCacheDump(ISDumpEPPF,&EPPFSig[WStart2],WLen2,ISCacheKey);
 			}
 
 		/*********************************************************************************/
 		/* Combinazione componente MP e EP */
 		/*********************************************************************************/
+		PMStage("MP/EP combination");
 
 		/* Controlla se si deve attuare la fase PC */
 		if (Cfg.ISType[0] == 'L' || Cfg.PCOutFile != NULL)
@@ -1321,12 +1796,13 @@ int main(int argc, char * argv[])
 					{
 						/* Salva la componente MP */
 						sputsp("Saving MP/EP signal: ",Cfg.PCOutFile);
-						if (WriteSignal(Cfg.PCOutFile,&MPEPSig[WStart3],WLen3,
+						if (SWWriteSignal(Cfg.PCOutFile,&MPEPSig[WStart3],WLen3,
 							(IFileType) Cfg.PCOutFileType[0]) == False)
 							{
 								sputs("MP/EP signal save failed.");
 								return 1;
 							}
+						DRCCacheDump(ISDumpPC,&MPEPSig[WStart3],WLen3,ISCacheKey);
 					}
 
 				/* Dealloca gli array */
@@ -1337,6 +1813,7 @@ int main(int argc, char * argv[])
 		/*********************************************************************************/
 		/* Inversione risposta all'impulso */
 		/*********************************************************************************/
+		PMStage("Inversion");
 
 		/* Verifica tipo inversione */
 		switch (Cfg.ISType[0])
@@ -1398,7 +1875,7 @@ int main(int argc, char * argv[])
 
 					/* Calcolo autocorrelazione e setup inversione */
 					sputs("Autocorrelation computation...");
-					if (AutoCorrelation(ISMPEPSig,ISSigLen) == False)
+					if (AutoCorrelation(ISMPEPSig,ISSigLen,DRCPrecision(Cfg.ISPrecision)) == False)
 						{
 							sputs("Autocorrelation computation failed.");
 							return 1;
@@ -1417,7 +1894,7 @@ int main(int argc, char * argv[])
 
 					/* Effettua l'inversione del segnale */
 					sputs("Toeplitz least square inversion...");
-					if (ToeplitzSolve(ISMPEPSig,ISRevSig,ISRevOut,ISSigLen) != 0)
+					if (ToeplitzSolve(ISMPEPSig,ISRevSig,ISRevOut,ISSigLen,DRCPrecision(Cfg.ISPrecision)) != 0)
 						{
 							sputs("Inversion failed.");
 							return 1;
@@ -1456,13 +1933,17 @@ int main(int argc, char * argv[])
 						/* Bilineare */
 						SLPType = SLPBilinear;
 
+					/* Adatta il moltiplicatore FFT al limite di memoria */
+					Cfg.ISSMPMultExponent = DRCFitExponent("ISSMPMultExponent",WLen3,Cfg.ISSMPMultExponent,
+						4,MPPFSigLen + EPPFSigLen + WLen3,DRCPrecision(Cfg.ISPrecision));
+
 					/* Inversione a fase minima selettiva */
 					sputs("Pre-echo truncation fast deconvolution...");
 					if (PETFDInvert(&MPPFSig[WStart1],WLen1,&EPPFSig[WStart2],WLen2,ISRevOut,WLen3,
 						Cfg.ISPETType[0],Cfg.ISPELowerWindow,Cfg.ISPEUpperWindow,Cfg.ISPEStartFreq,
 						Cfg.ISPEEndFreq,Cfg.ISPEFilterLen,Cfg.ISPEFSharpness,Cfg.ISPEBandSplit,
 						Cfg.ISPEWindowExponent,SLPType,Cfg.ISPEOGainFactor,Cfg.BCSampleRate,
-						Cfg.ISSMPMultExponent) == False)
+						Cfg.ISSMPMultExponent,DRCPrecision(Cfg.ISPrecision)) == False)
 						{
 							sputs("Inversion failed.");
 							return 1;
@@ -1501,12 +1982,25 @@ int main(int argc, char * argv[])
 					}
 			}
 
+		/* Salva il segnale invertito nella cache */
+		if (Cfg.BCCacheDir != NULL)
+			{
+				ISCacheParms[0] = WStart2;
+				ISCacheParms[1] = WLen2;
+				if (SCStore(Cfg.BCCacheDir,"is",ISCacheKey,ISRevOut,WLen3,ISCacheParms,2) == False)
+					sputs("!!Warning: unable to save the inverted signal to the cache.");
+			}
+
+		/* Punto di ingresso in caso di segnale invertito recuperato dalla cache */
+		ISCacheHit:
+		ISRevOutLen = WLen3;
+
 		/* Verifica se si deve salvare il segnale invertito */
 		if (Cfg.ISOutFile != NULL)
 			{
 				/* Salva la componente MP */
 				sputsp("Saving inverted signal: ",Cfg.ISOutFile);
-				if (WriteSignal(Cfg.ISOutFile,&ISRevOut[WStart2],WLen2,
+				if (SWWriteSignal(Cfg.ISOutFile,&ISRevOut[WStart2],WLen2,
 					(IFileType) Cfg.ISOutFileType[0]) == False)
 					{
 						sputs("Inverted signal save failed.");
@@ -1517,6 +2011,7 @@ int main(int argc, char * argv[])
 		/*********************************************************************************/
 		/* Calcolo target psicoacustico */
 		/*********************************************************************************/
+		PMStage("Psychoacoustic target");
 
 		/* Verifica se il target psicoacustico  abilitato */
 		if (Cfg.PTType[0] != 'N')
@@ -1531,6 +2026,14 @@ int main(int argc, char * argv[])
 						return 1;
 					}
 
+				/* Recupera il segnale per la convoluzione di test */
+				if (OInSigFile != NULL)
+					if ((OInSig = LMRestore(OInSigFile,MCOutSigLen)) == NULL)
+						{
+							sputs("Temporary file read failed.");
+							return 1;
+						}
+
 				/* Effettua la convoluzione tra filtro e risposta */
 				sputs("Psychoacoustic target reference convolution...");
 				if (DFftConvolve(OInSig,MCOutSigLen,ISRevOut,WLen2,PTTConv) == False)
@@ -1539,6 +2042,13 @@ int main(int argc, char * argv[])
 						return 1;
 					}
 
+				/* Il segnale non  pi necessario fino alla convoluzione di test */
+				if (OInSigFile != NULL)
+					{
+						delete[] OInSig;
+						OInSig = NULL;
+					}
+
 				/* Effettua la finestratura della convoluzione di riferimento */
 				PTTRefLen = (PTTConvLen - Cfg.PTReferenceWindow) / 2;
 				for (I = 0;I < PTTRefLen;I++)
@@ -1550,6 +2060,10 @@ int main(int argc, char * argv[])
 				/* Verifica se si deve effettuare il dip limiting sulla risposta target */
 				if (Cfg.PTDLMinGain > 0)
 					{
+						/* Adatta il moltiplicatore FFT al limite di memoria */
+						Cfg.PTDLMultExponent = DRCFitExponent("PTDLMultExponent",Cfg.PTReferenceWindow,
+							Cfg.PTDLMultExponent,4,PTTConvLen + ISRevOutLen,DLPNative);
+
 						switch (Cfg.PTDLType[0])
 							{
 								/* Fase lineare */
@@ -1630,7 +2144,7 @@ int main(int argc, char * argv[])
 
 						/* Salva la componente MP */
 						sputsp("Saving psychoacoustic target filter: ",Cfg.PTFilterFile);
-						if (WriteSignal(Cfg.PTFilterFile,PTFilter,Cfg.PTFilterLen,
+						if (SWWriteSignal(Cfg.PTFilterFile,PTFilter,Cfg.PTFilterLen,
 							(IFileType) Cfg.PTFilterFileType[0]) == False)
 							{
 								sputs("Psychoacoustic target filter save failed.");
@@ -1663,13 +2177,45 @@ int main(int argc, char * argv[])
 				for (I = 0;I < PTTConvStart;I++)
 					PTTConv[I] = (DLReal) 0.0;
 
+				/* Verifica se lo spettro della convoluzione pu essere
+				passato direttamente al peak limiting */
+				if (DRCSpectrumHandoff() == True && Cfg.PLMaxGain > 0 &&
+					Cfg.PTOutWindow <= 0 && Cfg.PTNormFactor <= 0)
+					{
+						SHFS = DRCFftSize(PTTConvLen,Cfg.PLMultExponent);
+						if (DFftConvolveHandoff(Cfg.PTFilterLen,WLen2,PTTConvStart,SHFS,
+							(Cfg.PTOutFile != NULL) ? True : False) == True)
+							{
+								PLSigFFT = new DLComplex[SHFS];
+								if (PLSigFFT == NULL)
+									{
+										sputs("Memory allocation failed.");
+										return 1;
+									}
+							}
+					}
+
 				/* Effettua la convoluzione tra filtro e target */
 				sputs("Psychoacoustic target correction filter convolution...");
-				if (DFftConvolve(PTFilter,Cfg.PTFilterLen,&ISRevOut[WStart2],WLen2,&PTTConv[PTTConvStart]) == False)
-					{
-						sputs("Convolution failed.");
-						return 1;
+				if (PLSigFFT != NULL)
+					{
+						/* Il risultato nel dominio del tempo viene calcolato
+						solo se deve essere salvato, dato che il peak limiting
+						lo sovrascrive interamente */
+						sputs("Convolution spectrum handed to peak limiting.");
+						if (DFftConvolveSpectrum(PTFilter,Cfg.PTFilterLen,&ISRevOut[WStart2],WLen2,PTTConvStart,
+							(Cfg.PTOutFile != NULL) ? &PTTConv[PTTConvStart] : NULL,PLSigFFT,SHFS) == False)
+							{
+								sputs("Convolution failed.");
+								return 1;
+							}
 					}
+				else
+					if (DFftConvolve(PTFilter,Cfg.PTFilterLen,&ISRevOut[WStart2],WLen2,&PTTConv[PTTConvStart]) == False)
+						{
+							sputs("Convolution failed.");
+							return 1;
+						}
 
 				/* Dealloca il filtro target */
 				delete[] PTFilter;
@@ -1706,7 +2252,7 @@ int main(int argc, char * argv[])
 					{
 						/* Salva il filtro correzione psicoacustico */
 						sputsp("Saving psychoacoustic target correction filter: ",Cfg.PTOutFile);
-						if (WriteSignal(Cfg.PTOutFile,&PTTConv[WStart2],WLen2,
+						if (SWWriteSignal(Cfg.PTOutFile,&PTTConv[WStart2],WLen2,
 							(IFileType) Cfg.PTOutFileType[0]) == False)
 							{
 								sputs("Psychoacoustic target correction filter save failed.");
@@ -1717,15 +2263,21 @@ int main(int argc, char * argv[])
 				/* Dealloca e riassegna il filtro inverso */
 				delete[] ISRevOut;
 				ISRevOut = PTTConv;
+				ISRevOutLen = PTTConvLen;
 			}
 
 		/*********************************************************************************/
 		/* Peak limiting */
 		/*********************************************************************************/
+		PMStage("Peak limiting");
 
 		/* Controlla se si deve effettuare il peak limiting */
 		if (Cfg.PLMaxGain > 0)
 			{
+				/* Adatta il moltiplicatore FFT al limite di memoria */
+				Cfg.PLMultExponent = DRCFitExponent("PLMultExponent",WLen2,
+					Cfg.PLMultExponent,4,ISRevOutLen,DLPNative);
+
 				switch (Cfg.PLType[0])
 					{
 						/* Fase lineare */
@@ -1733,7 +2285,8 @@ int main(int argc, char * argv[])
 						case 'P':
 							sputs("Linear phase peak limiting...");
 							if (C1LPPeakLimit(&ISRevOut[WStart2],WLen2,Cfg.PLMaxGain,Cfg.PLStart,
-								Cfg.BCSampleRate,Cfg.PLStartFreq,Cfg.PLEndFreq,Cfg.PLType[0] == 'P',Cfg.PLMultExponent) == False)
+								Cfg.BCSampleRate,Cfg.PLStartFreq,Cfg.PLEndFreq,Cfg.PLType[0] == 'P',Cfg.PLMultExponent,
+								PLSigFFT) == False)
 								{
 									sputs("Peak limiting failed.");
 									return 1;
@@ -1745,13 +2298,21 @@ int main(int argc, char * argv[])
 						case 'W':
 							sputs("Minimum phase peak limiting...");
 							if (C1HMPPeakLimit(&ISRevOut[WStart2],WLen2,Cfg.PLMaxGain,Cfg.PLStart,
-								Cfg.BCSampleRate,Cfg.PLStartFreq,Cfg.PLEndFreq,Cfg.PLType[0] == 'W',Cfg.PLMultExponent) == False)
+								Cfg.BCSampleRate,Cfg.PLStartFreq,Cfg.PLEndFreq,Cfg.PLType[0] == 'W',Cfg.PLMultExponent,
+								PLSigFFT) == False)
 								{
 									sputs("Peak limiting failed.");
 									return 1;
 								}
 						break;
 					}
+
+				/* Dealloca lo spettro passato dalla convoluzione */
+				if (PLSigFFT != NULL)
+					{
+						delete[] PLSigFFT;
+						PLSigFFT = NULL;
+					}
 			}
 
 		/* Effettua la finestratura finale */
@@ -1780,7 +2341,7 @@ int main(int argc, char * argv[])
 			{
 				/* Salva il segnale limitato*/
 				sputsp("Saving peak limited signal: ",Cfg.PLOutFile);
-				if (WriteSignal(Cfg.PLOutFile,&ISRevOut[WStart2],WLen2,
+				if (SWWriteSignal(Cfg.PLOutFile,&ISRevOut[WStart2],WLen2,
 					(IFileType) Cfg.PLOutFileType[0]) == False)
 					{
 						sputs("Peak limited signal save failed.");
@@ -1791,6 +2352,7 @@ int main(int argc, char * argv[])
 		/*********************************************************************************/
 		/* Troncatura ringing */
 		/*********************************************************************************/
+		PMStage("Ringing truncation");
 
 		/* Controlla se  abilitata */
 		if (Cfg.RTType[0] != 'N')
@@ -1901,7 +2463,7 @@ int main(int argc, char * argv[])
 					{
 						/* Salva la componente MP */
 						sputsp("Saving ringing truncation: ",Cfg.RTOutFile);
-						if (WriteSignal(Cfg.RTOutFile,&RTSig[WStart2],WLen2,
+						if (SWWriteSignal(Cfg.RTOutFile,&RTSig[WStart2],WLen2,
 							(IFileType) Cfg.RTOutFileType[0]) == False)
 							{
 								sputs("Ringing truncation save failed.");
@@ -1911,12 +2473,14 @@ int main(int argc, char * argv[])
 
 				/* Reimposta il segnale invertito */
 				ISRevOut = RTSig;
+				ISRevOutLen = RTSigLen;
 			}
 
 
 		/*********************************************************************************/
 		/* Applicazione risposta target */
 		/*********************************************************************************/
+		PMStage("Target response");
 
 		/* Verifica se si devono contare i punti filtro */
 		if (Cfg.PSNumPoints == 0)
@@ -1987,6 +2551,12 @@ int main(int argc, char * argv[])
 				break;
 			}
 
+		/* Adatta il moltiplicatore FFT al limite di memoria, il calcolo
+		del filtro usa trasformate di dimensione doppia */
+		I = (Cfg.PSFilterType[0] == 'L') ? Cfg.PSFilterLen : 1 + 2 * Cfg.PSFilterLen;
+		Cfg.PSMultExponent = DRCFitExponent("PSMultExponent",I,Cfg.PSMultExponent,
+			5,ISRevOutLen + 2 * I,DLPNative);
+
 		/* Verifica il tipo di filtro da utilizzare */
 		switch (Cfg.PSFilterType[0])
 			{
@@ -2091,14 +2661,43 @@ int main(int argc, char * argv[])
 				break;
 			}
 
+		/* Verifica se lo spettro della convoluzione pu essere passato
+		direttamente all'estrazione del filtro a fase minima, che usa
+		l'intero risultato solo con il filtro a fase lineare non finestrato */
+		if (DRCSpectrumHandoff() == True && Cfg.MSOutFile != NULL &&
+			Cfg.PSOutWindow <= 0 && Cfg.PSFilterType[0] == 'L')
+			{
+				SHFS = DRCFftSize(PSOutSigLen,Cfg.MSMultExponent);
+				if (DFftConvolveHandoff(WLen2,Cfg.PSFilterLen,0,SHFS,True) == True)
+					{
+						MSSigFFT = new DLComplex[SHFS];
+						if (MSSigFFT == NULL)
+							{
+								sputs("Memory allocation failed.");
+								return 1;
+							}
+					}
+			}
+
 		/* Convoluzione filtro segnale */
 		sputs("Target response FIR Filter convolution...");
-		if (DFftConvolve(&ISRevOut[WStart2],WLen2,PSFilter,
-			Cfg.PSFilterLen,PSOutSig) == False)
+		if (MSSigFFT != NULL)
 			{
-				perror("Convolution failed.");
-				return 1;
+				sputs("Convolution spectrum handed to MP filter extraction.");
+				if (DFftConvolveSpectrum(&ISRevOut[WStart2],WLen2,PSFilter,
+					Cfg.PSFilterLen,0,PSOutSig,MSSigFFT,SHFS) == False)
+					{
+						perror("Convolution failed.");
+						return 1;
+					}
 			}
+		else
+			if (DFftConvolve(&ISRevOut[WStart2],WLen2,PSFilter,
+				Cfg.PSFilterLen,PSOutSig) == False)
+				{
+					perror("Convolution failed.");
+					return 1;
+				}
 
 		/* Deallocazione array */
 		delete[] ISRevOut;
@@ -2215,12 +2814,22 @@ int main(int argc, char * argv[])
 			{
 				/* Salva la componente MP */
 				sputsp("Saving Target response signal: ",Cfg.PSOutFile);
-				if (WriteSignal(Cfg.PSOutFile,PSFilter,WLen2,
+				if (SWWriteSignal(Cfg.PSOutFile,PSFilter,WLen2,
 					(IFileType) Cfg.PSOutFileType[0]) == False)
 					{
 						sputs("Target response signal save failed.");
 						return 1;
 					}
+
+				/* Ricava il filtro alle altre frequenze di campionamento, il
+				riferimento temporale  il centro del filtro o, per il tipo T,
+				la fine della finestra di pre-eco */
+				if (Cfg.BCDeriveRates != NULL)
+					if (DRCDeriveRates(Cfg.PSOutFile,"target response signal",PSFilter,WLen2,
+						(Cfg.PSFilterType[0] == 'T') ? Cfg.ISPELowerWindow : WLen2 / 2,
+						(Cfg.PSFilterType[0] == 'T') ? False : True,Cfg.PSNormFactor,
+						Cfg.PSNormType,(IFileType) Cfg.PSOutFileType[0]) == False)
+						return 1;
 			}
 
 		/* Deallocazione array */
@@ -2234,6 +2843,7 @@ int main(int argc, char * argv[])
 		/*********************************************************************************/
 		/* Estrazione filtro a fase minima */
 		/*********************************************************************************/
+		PMStage("MP filter extraction");
 
 		/* Verifica se deve essere estratto il filtro a fase minima */
 		if (Cfg.MSOutFile != NULL)
@@ -2252,15 +2862,26 @@ int main(int argc, char * argv[])
 				for (I = 0;I < PSMPFLen;I++)
 					MPSig[I] = 0;
 
+				/* Adatta il moltiplicatore FFT al limite di memoria */
+				Cfg.MSMultExponent = DRCFitExponent("MSMultExponent",WLen2,Cfg.MSMultExponent,
+					3,PSOutSigLen + PSMPFLen + WLen2,DLPNative);
+
 				/* Effettua la deconvoluzione omomorfa*/
 				sputs("MP filter extraction homomorphic deconvolution stage...");
 				if (CepstrumHD(&PSOutSig[WStart2],&MPSig[Cfg.MSFilterDelay],NULL,
-					WLen2,Cfg.MSMultExponent) == False)
+					WLen2,Cfg.MSMultExponent,MSSigFFT) == False)
 					{
 						sputs("Homomorphic deconvolution failed.");
 						return 1;
 					}
 
+				/* Dealloca lo spettro passato dalla convoluzione */
+				if (MSSigFFT != NULL)
+					{
+						delete[] MSSigFFT;
+						MSSigFFT = NULL;
+					}
+
 				/* Verifica se si deve finestrare il filtro */
 				sputs("MP filter extraction windowing.");
 				if (Cfg.MSOutWindow > 0)
@@ -2285,13 +2906,20 @@ int main(int argc, char * argv[])
 
 				/* Salva il il filtro a fase minima */
 				sputsp("Saving MP filter signal: ",Cfg.MSOutFile);
-				if (WriteSignal(Cfg.MSOutFile,MPSig,WLen1,
+				if (SWWriteSignal(Cfg.MSOutFile,MPSig,WLen1,
 					(IFileType) Cfg.MSOutFileType[0]) == False)
 					{
 						sputs("MP filter signal save failed.");
 						return 1;
 					}
 
+				/* Ricava il filtro alle altre frequenze di campionamento */
+				if (Cfg.BCDeriveRates != NULL)
+					if (DRCDeriveRates(Cfg.MSOutFile,"MP filter signal",MPSig,WLen1,
+						Cfg.MSFilterDelay,False,Cfg.MSNormFactor,Cfg.MSNormType,
+						(IFileType) Cfg.MSOutFileType[0]) == False)
+						return 1;
+
 				/* Dealloca l'array deconvoluzione */
 				delete[] MPSig;
 			}
@@ -2302,6 +2930,7 @@ int main(int argc, char * argv[])
 		/*********************************************************************************/
 		/* Convoluzione di test */
 		/*********************************************************************************/
+		PMStage("Test convolution");
 
 		/* Verifica se va effettuata la convoluzione finale */
 		if (Cfg.TCOutFile != NULL)
@@ -2316,6 +2945,14 @@ int main(int argc, char * argv[])
 						return 1;
 					}
 
+				/* Recupera il segnale per la convoluzione di test */
+				if (OInSigFile != NULL)
+					if ((OInSig = LMRestore(OInSigFile,MCOutSigLen)) == NULL)
+						{
+							sputs("Temporary file read failed.");
+							return 1;
+						}
+
 				/* Effettua la convoluzione */
 				sputs("Convolving input signal with target response signal...");
 				if (DFftConvolve(OInSig,MCOutSigLen,PSFilter,PSOutSigLen,TCSig) == False)
@@ -2352,7 +2989,7 @@ int main(int argc, char * argv[])
 
 				/* Salva il segnale convoluzione test */
 				sputsp("Saving test convolution signal: ",Cfg.TCOutFile);
-				if (WriteSignal(Cfg.TCOutFile,TCSig,WLen3,
+				if (SWWriteSignal(Cfg.TCOutFile,TCSig,WLen3,
 					(IFileType) Cfg.TCOutFileType[0]) == False)
 					{
 						sputs("Test convolution save failed.");
@@ -2376,6 +3013,14 @@ int main(int argc, char * argv[])
 									}
 							}
 
+						/* Completa le scritture accodate, il file da sovrascrivere
+						potrebbe essere uno dei segnali salvati */
+						if (SWFlush() == False)
+							{
+								sputs("Signal save failed.");
+								return 1;
+							}
+
 						/* Controlla il tipo di filtro */
 						if (Cfg.PSFilterType[0] == 'T')
 							{
@@ -2414,21 +3059,103 @@ int main(int argc, char * argv[])
 
 		/* Dealloca gli array temporanei */
 		if (Cfg.TCOutFile != NULL || Cfg.PTType[0] != 'N')
-			delete[] OInSig;
+			if (OInSig != NULL)
+				delete[] OInSig;
+		if (OInSigFile != NULL)
+			fclose(OInSigFile);
 
 		/* Dealloca il filtro convoluzione test */
 		delete[] PSFilter;
 
+		/* Salva il rapporto sulle prestazioni */
+		if (Cfg.BCProfileOutFile != NULL)
+			{
+				PMEnd();
+				sputsp("Saving performance report: ",Cfg.BCProfileOutFile);
+				if (PMWriteReport(Cfg.BCProfileOutFile,
+					(Cfg.BCProfileOutType != NULL && Cfg.BCProfileOutType[0] == 'C') ? PMCsv : PMJson) == False)
+					{
+						sputs("Performance report save failed.");
+						return 1;
+					}
+			}
+
 		/* Libera la memoria della struttura di configurazione */
 		CfgFree(CfgParmsDef);
 		free(DRCFile);
 
+		/* Completa le scritture accodate prima di segnalare il
+		completamento dell'elaborazione */
+		if (SWFlush() == False)
+			{
+				sputs("Signal save failed.");
+				return 1;
+			}
+
 		/* Esecuzione completata */
 		sputs("Execution completed.");
 
+		/* Segnala l'utilizzo dell'allocatore array temporanei */
+		DSPAllocGetStats(&DSPStats);
+		printf("Scratch allocator: %lu allocations, %lu reused, peak %.1f MB, %.3f s\n",
+			DSPStats.AllocCount,DSPStats.ReuseCount,
+			((double) DSPStats.PeakBytes) / (1024.0 * 1024.0),DSPStats.AllocTime);
+
+		/* Segnala il picco di memoria utilizzata */
+		if (LMPeakMemory() > 0)
+			printf("Peak memory usage: %.1f MB\n",((double) LMPeakMemory()) / (1024.0 * 1024.0));
+
+		/* Segnala il superamento del limite di memoria */
+		if (Cfg.BCMemoryLimit > 0 && LMPeakMemory() > ((size_t) Cfg.BCMemoryLimit) * 1024 * 1024)
+			printf("!!Warning: peak memory usage above the %d MB memory limit.\n",Cfg.BCMemoryLimit);
+
 		/* Segnala la durata */
 		printf("Total computing time: %lu s\n",(unsigned long int) (time(NULL) - CStart));
 		fflush(stdout);
 
 		return 0;
 	}
+
+/* Main procedure */
+/* Esegue l'elaborazione completando le scritture accodate */
+static int DRCRun(int argc, char * argv[], const char * SweepTag)
+	{
+		int Res;
+
+		Res = DRCMain(argc,argv,SweepTag);
+
+		/* Termina il pool di thread, che non sopravvive al fork delle
+		elaborazioni multiple */
+		TPStop();
+		if (SWStop() == False)
+			{
+				sputs("Signal save failed.");
+				return 1;
+			}
+		return Res;
+	}
+
+int main(int argc, char * argv[])
+	{
+		int Res;
+
+		/* Verifica se sono richieste pi elaborazioni */
+		if (argc > 2)
+			if (CSIsSweep(argc,argv,CfgParmsDef) == True)
+				{
+					/* Messaggio iniziale */
+					ShowDRCHeader();
+					sputs("");
+
+					/* Esegue tutte le elaborazioni, che condividono le
+					tabelle delle finestre */
+					Res = (CSRun(argc,argv,CfgParmsDef,DRCRun) != 0) ? 1 : 0;
+					DWFreeCache();
+					return Res;
+				}
+
+		/* Elaborazione singola */
+		Res = DRCRun(argc,argv,NULL);
+		DWFreeCache();
+		return Res;
+	}
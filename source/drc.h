@@ -51,6 +51,24 @@
 	noticeably faster */
 	/* #define UseOouraFft */
 
+	/* Commentare per disabilitare il calcolo parallelo delle FFT di grandi dimensioni,
+	che richiede le pthread */
+	/* Comment out to disable the parallel computation of large FFTs, which requires
+	pthreads */
+	#define UseFftThreads
+
+	/* Commentare per disabilitare la scrittura asincrona dei segnali su disco,
+	che richiede le pthread */
+	/* Comment out to disable the asynchronous writing of the signals to disk,
+	which requires pthreads */
+	#define UseAsyncWrite
+
+	/* Commentare per disabilitare il pool di thread per il calcolo parallelo,
+	che richiede le pthread */
+	/* Comment out to disable the thread pool for parallel computation, which
+	requires pthreads */
+	#define UseThreadPool
+
 	#ifdef UseDouble
 		/* Tipo floating point usato per le elaborazioni */
 		#define DRCFloat double
@@ -55,6 +55,21 @@ CfgParameter CfgParmsDef[] =
 		{ (char *) "BCPreWindowGap",CfgInt,&Cfg.BCPreWindowGap },
 		{ (char *) "BCNormFactor",DRCCfgFloat,&Cfg.BCNormFactor },
 		{ (char *) "BCNormType",CfgString,&Cfg.BCNormType },
+		{ (char *) "BCCacheDir",CfgString,&Cfg.BCCacheDir },
+		{ (char *) "BCHugePages",CfgString,&Cfg.BCHugePages },
+		{ (char *) "BCMemoryLimit",CfgInt,&Cfg.BCMemoryLimit },
+		{ (char *) "BCProfileOutFile",CfgString,&Cfg.BCProfileOutFile },
+		{ (char *) "BCProfileOutType",CfgString,&Cfg.BCProfileOutType },
+		{ (char *) "BCVectorMath",CfgString,&Cfg.BCVectorMath },
+		{ (char *) "BCFftThreads",CfgInt,&Cfg.BCFftThreads },
+		{ (char *) "BCFftThreadsMinSize",CfgInt,&Cfg.BCFftThreadsMinSize },
+		{ (char *) "BCSpectrumHandoff",CfgString,&Cfg.BCSpectrumHandoff },
+		{ (char *) "BCAsyncWrite",CfgString,&Cfg.BCAsyncWrite },
+		{ (char *) "BCAsyncWriteQueue",CfgInt,&Cfg.BCAsyncWriteQueue },
+		{ (char *) "BCThreads",CfgInt,&Cfg.BCThreads },
+		{ (char *) "BCThreadAffinity",CfgString,&Cfg.BCThreadAffinity },
+		{ (char *) "BCDeterministic",CfgString,&Cfg.BCDeterministic },
+		{ (char *) "BCDeriveRates",CfgString,&Cfg.BCDeriveRates },
 
     /* Mic correction stage */
 		{ (char *) "MCFilterType",CfgString,&Cfg.MCFilterType },
@@ -82,6 +97,7 @@ CfgParameter CfgParmsDef[] =
 
 		/* Homomorphic Deconvolution */
 		{ (char *) "HDMultExponent",CfgInt,&Cfg.HDMultExponent },
+		{ (char *) "HDPrecision",CfgString,&Cfg.HDPrecision },
 		{ (char *) "HDMPNormFactor",DRCCfgFloat,&Cfg.HDMPNormFactor },
 		{ (char *) "HDMPNormType",CfgString,&Cfg.HDMPNormType },
 		{ (char *) "HDMPOutFile",CfgString,&Cfg.HDMPOutFile },
@@ -163,6 +179,7 @@ CfgParameter CfgParmsDef[] =
 		{ (char *) "ISPEWindowExponent",DRCCfgFloat,&Cfg.ISPEWindowExponent },
 		{ (char *) "ISPEOGainFactor",DRCCfgFloat,&Cfg.ISPEOGainFactor },
 		{ (char *) "ISSMPMultExponent",CfgInt,&Cfg.ISSMPMultExponent },
+		{ (char *) "ISPrecision",CfgString,&Cfg.ISPrecision },
 		{ (char *) "ISOutWindow",CfgInt,&Cfg.ISOutWindow },
 		{ (char *) "ISNormFactor",DRCCfgFloat,&Cfg.ISNormFactor },
 		{ (char *) "ISNormType",CfgString,&Cfg.ISNormType },
@@ -266,6 +283,8 @@ directory base */
 static const char * BaseDirParmsList[] =
 	{
 		"BCInFile",
+		"BCCacheDir",
+		"BCProfileOutFile",
 		"HDMPOutFile",
 		"HDEPOutFile",
 		"MPPFOutFile",
@@ -407,6 +426,82 @@ int CheckDRCCfg(const CfgParmsType * DRCCfg)
 				sputs("BC->BCInitWindow: Initial window should be at least 3.");
 				return 1;
 			}
+		if (DRCCfg->BCMemoryLimit < 0)
+			{
+				sputs("BC->BCMemoryLimit: BCMemoryLimit can't be less than 0.");
+				return 1;
+			}
+		if (DRCCfg->BCVectorMath != NULL && DRCCfg->BCVectorMath[0] != 'Y'
+				&& DRCCfg->BCVectorMath[0] != 'N')
+			{
+				sputs("BC->BCVectorMath: Invalid vector math selection supplied.");
+				return 1;
+			}
+		if (DRCCfg->BCFftThreads < -1)
+			{
+				sputs("BC->BCFftThreads: BCFftThreads can't be less than -1.");
+				return 1;
+			}
+		if (DRCCfg->BCFftThreadsMinSize != 0 && DRCCfg->BCFftThreadsMinSize < 1024)
+			{
+				sputs("BC->BCFftThreadsMinSize: BCFftThreadsMinSize should be at least 1024.");
+				return 1;
+			}
+		if (DRCCfg->BCSpectrumHandoff != NULL && DRCCfg->BCSpectrumHandoff[0] != 'Y'
+				&& DRCCfg->BCSpectrumHandoff[0] != 'N')
+			{
+				sputs("BC->BCSpectrumHandoff: Invalid spectrum handoff selection supplied.");
+				return 1;
+			}
+		if (DRCCfg->BCAsyncWrite != NULL && DRCCfg->BCAsyncWrite[0] != 'Y'
+				&& DRCCfg->BCAsyncWrite[0] != 'N')
+			{
+				sputs("BC->BCAsyncWrite: Invalid asynchronous write selection supplied.");
+				return 1;
+			}
+		if (DRCCfg->BCAsyncWriteQueue < 0)
+			{
+				sputs("BC->BCAsyncWriteQueue: BCAsyncWriteQueue can't be less than 0.");
+				return 1;
+			}
+		if (DRCCfg->BCThreads < -1)
+			{
+				sputs("BC->BCThreads: BCThreads can't be less than -1.");
+				return 1;
+			}
+		if (DRCCfg->BCThreadAffinity != NULL && DRCCfg->BCThreadAffinity[0] != 'N'
+				&& DRCCfg->BCThreadAffinity[0] != 'C' && DRCCfg->BCThreadAffinity[0] != 'S')
+			{
+				sputs("BC->BCThreadAffinity: Invalid thread affinity supplied.");
+				return 1;
+			}
+		if (DRCCfg->BCDeterministic != NULL && DRCCfg->BCDeterministic[0] != 'Y'
+				&& DRCCfg->BCDeterministic[0] != 'N')
+			{
+				sputs("BC->BCDeterministic: Invalid deterministic mode selection supplied.");
+				return 1;
+			}
+		if (DRCCfg->BCDeriveRates != NULL)
+			{
+				/* Verifica che l'elenco contenga solo frequenze positive
+				separate da virgole */
+				const char * S = DRCCfg->BCDeriveRates;
+				char * End;
+				long Rate;
+
+				do
+					{
+						Rate = strtol(S,&End,10);
+						if (End == S || *S < '0' || *S > '9' || Rate <= 0
+							|| (*End != ',' && *End != '\0'))
+							{
+								sputs("BC->BCDeriveRates: Invalid sample rate list supplied.");
+								return 1;
+							}
+						S = End + 1;
+					}
+				while (*End == ',');
+			}
 		if (DRCCfg->BCPreWindowGap < 0)
 			{
 				sputs("BC->BCPreWindowGap: BCPreWindowGap can't be less than 0.");
@@ -546,6 +641,12 @@ int CheckDRCCfg(const CfgParmsType * DRCCfg)
 		/* Deconvoluzione omomorfa */
 		/*********************************************************************************/
 
+		if (DRCCfg->HDPrecision != NULL && DRCCfg->HDPrecision[0] != 'F'
+				&& DRCCfg->HDPrecision[0] != 'D')
+			{
+				sputs("HD->HDPrecision: Invalid precision supplied.");
+				return 1;
+			}
 		if (DRCCfg->HDMPNormFactor > 0 && DRCCfg->HDMPNormType == NULL)
 			{
 				sputs("HD->HDMPNormType: No MP normalization type supplied.");
@@ -851,6 +952,12 @@ int CheckDRCCfg(const CfgParmsType * DRCCfg)
 				sputs("IS->ISOutFileType: No output file type supplied.");
 				return 1;
 			}
+		if (DRCCfg->ISPrecision != NULL && DRCCfg->ISPrecision[0] != 'F'
+				&& DRCCfg->ISPrecision[0] != 'D')
+			{
+				sputs("IS->ISPrecision: Invalid precision supplied.");
+				return 1;
+			}
 		if (DRCCfg->ISOutWindow < 0)
 			{
 				sputs("IS->ISOutWindow: ISOutWindow must be greater than 0.");
@@ -67,6 +67,21 @@
 			int BCPreWindowGap;
 			DRCFloat BCNormFactor;
 			char * BCNormType;
+			char * BCCacheDir;
+			char * BCHugePages;
+			int BCMemoryLimit;
+			char * BCProfileOutFile;
+			char * BCProfileOutType;
+			char * BCVectorMath;
+			int BCFftThreads;
+			int BCFftThreadsMinSize;
+			char * BCSpectrumHandoff;
+			char * BCAsyncWrite;
+			int BCAsyncWriteQueue;
+			int BCThreads;
+			char * BCThreadAffinity;
+			char * BCDeterministic;
+			char * BCDeriveRates;
 
       /* Mic compensation stage */
 			char * MCFilterType;
@@ -94,6 +109,7 @@
 
 			/* Homomorphic Deconvolution */
 			int HDMultExponent;
+			char * HDPrecision;
 			DRCFloat HDMPNormFactor;
 			char * HDMPNormType;
 			char * HDMPOutFile;
@@ -175,6 +191,7 @@
 			DRCFloat ISPEWindowExponent;
 			DRCFloat ISPEOGainFactor;
 			int ISSMPMultExponent;
+			char * ISPrecision;
 			int ISOutWindow;
 			DRCFloat ISNormFactor;
 			char * ISNormType;
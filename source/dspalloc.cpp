@@ -0,0 +1,282 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Allocatore per gli array temporanei delle funzioni DSP */
+
+/* Inclusioni */
+#include "dspalloc.h"
+#include <stdlib.h>
+#include <time.h>
+#ifdef _WIN32
+	#include <malloc.h>
+#else
+	#include <sys/mman.h>
+#endif
+
+/* Memory leaks debugger */
+#ifdef DebugMLeaks
+	#include "debug_new.h"
+#endif
+
+/* Numero di classi di dimensione */
+#define DSPAllocClasses 48
+
+/* Dimensione minima dei blocchi per l'uso delle huge pages */
+#define DSPHugePageSize ((size_t) 2 * 1024 * 1024)
+
+/* Intestazione del blocco, posta prima dell'area restituita */
+typedef union
+	{
+		struct
+			{
+				/* Classe di dimensione e indirizzo del blocco di sistema */
+				int Class;
+				void * Base;
+
+				/* Blocco successivo nel pool */
+				void * Next;
+			}
+		H;
+		char Pad[DSPAllocAlign];
+	}
+DSPHeaderType;
+
+/* Liste dei blocchi liberi per classe */
+static void * DSPFreeList[DSPAllocClasses];
+
+/* Flag abilitazione huge pages */
+static Boolean DSPHugePages = False;
+
+/* Dimensione massima del pool */
+static size_t DSPMaxPool = DSPAllocMaxPool;
+
+/* Flag registrazione procedura di uscita */
+static Boolean DSPExitSet = False;
+
+/* Statistiche */
+static DSPAllocStatsType DSPStats = { 0, 0, 0, 0, 0, 0.0 };
+
+/* Il pool e le statistiche sono condivisi tra i thread del pool di calcolo */
+#ifdef UseThreadPool
+	#include <pthread.h>
+	static pthread_mutex_t DSPMutex = PTHREAD_MUTEX_INITIALIZER;
+	#define DSPLock() pthread_mutex_lock(&DSPMutex)
+	#define DSPUnlock() pthread_mutex_unlock(&DSPMutex)
+#else
+	#define DSPLock()
+	#define DSPUnlock()
+#endif
+
+/* Recupera l'intestazione del blocco */
+static DSPHeaderType * DSPHeader(void * P)
+	{
+		return ((DSPHeaderType *) P) - 1;
+	}
+
+/* Dimensione dei blocchi della classe indicata */
+static size_t DSPClassSize(const int Class)
+	{
+		return ((size_t) DSPAllocAlign) << Class;
+	}
+
+/* Alloca un blocco di sistema allineato */
+static void * DSPSysAlloc(const size_t Size, void ** Base)
+	{
+		size_t Align;
+		void * P;
+
+		/* Determina l'allineamento */
+		Align = DSPAllocAlign;
+		if (DSPHugePages == True && Size >= DSPHugePageSize)
+			Align = DSPHugePageSize;
+
+		#ifdef _WIN32
+			if ((P = _aligned_malloc(Size,Align)) == NULL)
+				return NULL;
+		#else
+			if (posix_memalign(&P,Align,Size) != 0)
+				return NULL;
+
+			/* Richiede l'uso delle huge pages */
+			#ifdef MADV_HUGEPAGE
+				if (Align == DSPHugePageSize)
+					madvise(P,Size,MADV_HUGEPAGE);
+			#endif
+		#endif
+
+		*Base = P;
+		return P;
+	}
+
+/* Libera un blocco di sistema */
+static void DSPSysFree(void * Base)
+	{
+		#ifdef _WIN32
+			_aligned_free(Base);
+		#else
+			free(Base);
+		#endif
+	}
+
+/* Alloca un blocco */
+void * DSPAlloc(const size_t Size)
+	{
+		DSPHeaderType * H;
+		void * Base;
+		clock_t CStart;
+		int Class;
+
+		CStart = clock();
+
+		/* Determina la classe di dimensione */
+		for (Class = 0;Class < DSPAllocClasses && DSPClassSize(Class) < Size;Class++);
+		if (Class == DSPAllocClasses)
+			return NULL;
+
+		DSPLock();
+
+		/* Registra la procedura di rilascio in uscita */
+		if (DSPExitSet == False)
+			{
+				atexit(DSPAllocRelease);
+				DSPExitSet = True;
+			}
+
+		/* Verifica se il pool contiene un blocco della classe */
+		if (DSPFreeList[Class] != NULL)
+			{
+				H = DSPHeader(DSPFreeList[Class]);
+				DSPFreeList[Class] = H->H.Next;
+				DSPStats.PoolBytes -= DSPClassSize(Class);
+				DSPStats.ReuseCount++;
+			}
+		else
+			{
+				/* Alloca un nuovo blocco di sistema, al di fuori della
+				sezione critica */
+				DSPUnlock();
+				H = (DSPHeaderType *) DSPSysAlloc(sizeof(DSPHeaderType) + DSPClassSize(Class),&Base);
+				if (H == NULL)
+					return NULL;
+				H->H.Class = Class;
+				H->H.Base = Base;
+				DSPLock();
+			}
+		H->H.Next = NULL;
+
+		/* Aggiorna le statistiche */
+		DSPStats.AllocCount++;
+		DSPStats.CurBytes += DSPClassSize(Class);
+		if (DSPStats.CurBytes > DSPStats.PeakBytes)
+			DSPStats.PeakBytes = DSPStats.CurBytes;
+		DSPStats.AllocTime += ((double) (clock() - CStart)) / CLOCKS_PER_SEC;
+
+		DSPUnlock();
+
+		return (void *) (H + 1);
+	}
+
+/* Rilascia un blocco nel pool */
+void DSPFree(void * P)
+	{
+		DSPHeaderType * H;
+		clock_t CStart;
+		int Class;
+
+		if (P == NULL)
+			return;
+
+		CStart = clock();
+
+		H = DSPHeader(P);
+		Class = H->H.Class;
+
+		DSPLock();
+		DSPStats.CurBytes -= DSPClassSize(Class);
+
+		/* Verifica se il pool ha raggiunto la dimensione massima */
+		if (DSPStats.PoolBytes + DSPClassSize(Class) > DSPMaxPool)
+			DSPSysFree(H->H.Base);
+		else
+			{
+				H->H.Next = DSPFreeList[Class];
+				DSPFreeList[Class] = P;
+				DSPStats.PoolBytes += DSPClassSize(Class);
+			}
+
+		DSPStats.AllocTime += ((double) (clock() - CStart)) / CLOCKS_PER_SEC;
+		DSPUnlock();
+	}
+
+/* Restituisce al sistema la memoria nel pool, da chiamare all'interno
+della sezione critica */
+static void DSPReleasePool(void)
+	{
+		DSPHeaderType * H;
+		int Class;
+
+		for (Class = 0;Class < DSPAllocClasses;Class++)
+			while (DSPFreeList[Class] != NULL)
+				{
+					H = DSPHeader(DSPFreeList[Class]);
+					DSPFreeList[Class] = H->H.Next;
+					DSPSysFree(H->H.Base);
+				}
+		DSPStats.PoolBytes = 0;
+	}
+
+/* Abilita l'uso delle huge pages per i blocchi di grandi dimensioni */
+void DSPAllocSetHugePages(const Boolean Enable)
+	{
+		DSPLock();
+		DSPHugePages = Enable;
+		DSPUnlock();
+	}
+
+/* Imposta la dimensione massima della memoria mantenuta nel pool */
+void DSPAllocSetMaxPool(const size_t MaxPool)
+	{
+		DSPLock();
+		DSPMaxPool = MaxPool;
+		if (DSPStats.PoolBytes > DSPMaxPool)
+			DSPReleasePool();
+		DSPUnlock();
+	}
+
+/* Restituisce al sistema tutta la memoria nel pool */
+void DSPAllocRelease(void)
+	{
+		DSPLock();
+		DSPReleasePool();
+		DSPUnlock();
+	}
+
+/* Recupera le statistiche dell'allocatore */
+void DSPAllocGetStats(DSPAllocStatsType * Stats)
+	{
+		DSPLock();
+		*Stats = DSPStats;
+		DSPUnlock();
+	}
@@ -0,0 +1,98 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Allocatore per gli array temporanei delle funzioni DSP */
+
+/* I blocchi sono allineati a 64 byte e raggruppati in classi di dimensione
+a potenze di due. I blocchi rilasciati restano nel pool per essere riutilizzati
+dalle chiamate successive, evitando di richiedere ogni volta al sistema nuove
+pagine di memoria. A differenza di new[] la memoria non viene inizializzata.
+Il pool e le statistiche sono protetti da un mutex quando il pool di thread
+ abilitato, le funzioni possono quindi essere chiamate dai job paralleli. */
+
+#ifndef DSPAlloc_h
+	#define DSPAlloc_h
+
+	/* Inclusioni */
+	#include "dsplib.h"
+	#include "boolean.h"
+	#include <stddef.h>
+
+	/* Allineamento dei blocchi */
+	#define DSPAllocAlign 64
+
+	/* Dimensione massima predefinita della memoria mantenuta nel pool */
+	#define DSPAllocMaxPool ((size_t) 512 * 1024 * 1024)
+
+	/* Statistiche allocatore */
+	typedef struct
+		{
+			/* Memoria attualmente allocata e picco */
+			size_t CurBytes;
+			size_t PeakBytes;
+
+			/* Memoria mantenuta nel pool */
+			size_t PoolBytes;
+
+			/* Numero allocazioni totali e soddisfatte dal pool */
+			unsigned long AllocCount;
+			unsigned long ReuseCount;
+
+			/* Tempo trascorso nell'allocatore, in secondi */
+			double AllocTime;
+		}
+	DSPAllocStatsType;
+
+	/* Alloca un blocco, ritorna NULL in caso di memoria insufficiente */
+	void * DSPAlloc(const size_t Size);
+
+	/* Rilascia un blocco nel pool */
+	void DSPFree(void * P);
+
+	/* Abilita l'uso delle huge pages per i blocchi di grandi dimensioni */
+	void DSPAllocSetHugePages(const Boolean Enable);
+
+	/* Imposta la dimensione massima della memoria mantenuta nel pool */
+	void DSPAllocSetMaxPool(const size_t MaxPool);
+
+	/* Restituisce al sistema tutta la memoria nel pool */
+	void DSPAllocRelease(void);
+
+	/* Recupera le statistiche dell'allocatore */
+	void DSPAllocGetStats(DSPAllocStatsType * Stats);
+
+	/* Allocazione array reali */
+	inline DLReal * DSPRealAlloc(const int N)
+		{
+			return (DLReal *) DSPAlloc(N * sizeof(DLReal));
+		}
+
+	/* Allocazione array complessi */
+	inline DLComplex * DSPComplexAlloc(const int N)
+		{
+			return (DLComplex *) DSPAlloc(N * sizeof(DLComplex));
+		}
+
+#endif
@@ -55,6 +55,29 @@
 	#endif
 
 	typedef std::complex<DLReal> DLComplex;
+
+	/* Tipo floating point alternativo, usato dalle fasi di elaborazione
+	eseguite con precisione diversa da quella di compilazione */
+	#ifdef UseDouble
+		typedef float DLAltReal;
+	#else
+		typedef double DLAltReal;
+	#endif
+
+	typedef std::complex<DLAltReal> DLAltComplex;
+
+	/* Precisione di calcolo di una fase di elaborazione */
+	typedef enum { DLPNative = 'N', DLPFloat = 'F', DLPDouble = 'D' } DLPrecisionType;
+
+	/* Verifica se la precisione richiesta richiede il tipo alternativo */
+	inline Boolean DLUseAltReal(const DLPrecisionType Prec)
+		{
+			#ifdef UseDouble
+				return (Prec == DLPFloat) ? True : False;
+			#else
+				return (Prec == DLPDouble) ? True : False;
+			#endif
+		}
 #endif
 
 /***************************************************************************/
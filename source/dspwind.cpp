@@ -40,101 +40,296 @@
 	#include "debug_new.h"
 #endif
 
-void HammingWindow(DLReal * A,unsigned int Size)
-  {
-    unsigned int I,Half = Size/2;
-    DLReal C;
-
-    for(I = 0;I < Half;I++)
-      {
-        C = (DLReal) (0.54-0.46*DLCos(2*M_PI*I/(Size-1)));
-        A[I] *= C;
-        A[Size-I-1] *= C;
-      }
-  }
-
-void HanningWindow(DLReal * A,unsigned int Size)
-  {
-    unsigned int I,Half = Size/2;
-    DLReal C;
+/* Tipi di finestra con coefficienti in tabella */
+typedef enum
+	{
+		DWHamming,
+		DWHanning,
+		DWBlackman,
+		DWBlackmanHarris,
+		DWSpacedBlackman,
+		DWHalfBlackman
+	}
+DWType;
+
+/* Tabella dei coefficienti di una finestra. Le finestre simmetriche
+sono memorizzate per intero, con il campione centrale unitario per le
+lunghezze dispari, quelle parziali nell'ordine di applicazione, in modo
+che ogni finestratura sia un'unica moltiplicazione elemento per
+elemento con indici crescenti */
+typedef struct
+	{
+		DWType Type;
+		unsigned int Size;
+		WindowType WType;
+		DLReal * W;
+		unsigned long Use;
+	}
+DWTableType;
+
+/* Numero massimo di tabelle in memoria */
+#define DWMaxTables 32
+
+/* Dimensione dei blocchi di coefficienti calcolati al volo per le
+finestre non memorizzate */
+#define DWBlockSize 256
+
+/* Tabelle in memoria */
+static DWTableType DWTables[DWMaxTables];
+static unsigned int DWNTables = 0;
+static size_t DWCacheBytes = 0;
+static unsigned long DWUse = 0;
+
+/* Dimensione massima della memoria per le tabelle */
+static size_t DWCacheLimit = 16 * 1024 * 1024;
+
+#ifdef UseThreadPool
+	#include <pthread.h>
+	static pthread_mutex_t DWMutex = PTHREAD_MUTEX_INITIALIZER;
+	#define DWLock() pthread_mutex_lock(&DWMutex)
+	#define DWUnlock() pthread_mutex_unlock(&DWMutex)
+#else
+	#define DWLock()
+	#define DWUnlock()
+#endif
 
-    for(I = 0;I < Half;I++)
-      {
-        C = (DLReal) (0.5*(1-DLCos(2*M_PI*I/(Size-1))));
-        A[I] *= C;
-        A[Size-I-1] *= C;
-      }
-  }
+/* Calcola i coefficienti [Lo,Hi) della tabella della finestra di tipo
+Type e dimensione Size, usando le stesse espressioni del calcolo
+diretto per ottenere coefficienti identici */
+static void DWFill(const DWType Type,const unsigned int Size,const WindowType WType,
+	const unsigned int Lo,const unsigned int Hi,DLReal * W)
+	{
+		unsigned int I,K;
+		unsigned int Half = Size / 2;
+		DLReal C1;
+		DLReal C2;
 
-void BlackmanWindow(DLReal * A,unsigned int Size)
-  {
-    unsigned int I,J;
-    unsigned int Half = Size/2;
-    DLReal C;
-		DLReal C1 = (DLReal) (2*M_PI/(Size-1));
-		DLReal C2 = (DLReal) (4*M_PI/(Size-1));
+		switch (Type)
+			{
+				case DWHamming:
+					for (I = Lo;I < Hi;I++)
+						{
+							K = (I < Half) ? I : Size - I - 1;
+							W[I - Lo] = (K < Half) ? (DLReal) (0.54-0.46*DLCos(2*M_PI*K/(Size-1))) :
+								(DLReal) 1.0;
+						}
+				break;
 
-    for(I = 0,J = Size - 1;I < Half;I++,J--)
-      {
-        C = (DLReal) (((DLReal) 0.42)-((DLReal) 0.5)*DLCos(C1*I)+((DLReal) 0.08)*DLCos(C2*I));
-        A[I] *= C;
-        A[J] *= C;
-      }
-  }
+				case DWHanning:
+					for (I = Lo;I < Hi;I++)
+						{
+							K = (I < Half) ? I : Size - I - 1;
+							W[I - Lo] = (K < Half) ? (DLReal) (0.5*(1-DLCos(2*M_PI*K/(Size-1)))) :
+								(DLReal) 1.0;
+						}
+				break;
 
-void SpacedBlackmanWindow(DLReal * A,unsigned int Size, unsigned int Space, WindowType WType)
-  {
-		unsigned int ESize = Size - Space;
-    unsigned int I,Half = (ESize) / 2;
-    DLReal C;
-		DLReal C1 = 2*M_PI/(ESize-1);
-		DLReal C2 = 4*M_PI/(ESize-1);
+				case DWBlackman:
+					C1 = (DLReal) (2*M_PI/(Size-1));
+					C2 = (DLReal) (4*M_PI/(Size-1));
+					for (I = Lo;I < Hi;I++)
+						{
+							K = (I < Half) ? I : Size - I - 1;
+							W[I - Lo] = (K < Half) ? (DLReal) (((DLReal) 0.42)-((DLReal) 0.5)*DLCos(C1*K)+
+								((DLReal) 0.08)*DLCos(C2*K)) : (DLReal) 1.0;
+						}
+				break;
 
-		switch (WType)
-			{
-				case WRight:
-					for(I = 0;I < Half;I++)
+				case DWBlackmanHarris:
+					for (I = Lo;I < Hi;I++)
 						{
-							C = (DLReal) (0.42-0.5*DLCos(C1*I)+0.08*DLCos(C2*I));
-							A[Size-I-1] *= C;
+							K = (I < Half) ? I : Size - I - 1;
+							W[I - Lo] = (K < Half) ? (DLReal) (0.35875-0.48829*DLCos(2*M_PI*K/(Size-1))+
+								0.14128*DLCos(4*M_PI*K/(Size-1))+0.01168*DLCos(6*M_PI*K/(Size-1))) :
+								(DLReal) 1.0;
 						}
 				break;
 
-				case WFull:
-					for(I = 0;I < Half;I++)
+				case DWSpacedBlackman:
+					C1 = 2*M_PI/(Size-1);
+					C2 = 4*M_PI/(Size-1);
+					for (I = Lo;I < Hi;I++)
 						{
-							C = (DLReal) (0.42-0.5*DLCos(C1*I)+0.08*DLCos(C2*I));
-							A[I] *= C;
-							A[Size-I-1] *= C;
+							K = (I < Half) ? I : Size - I - 1;
+							W[I - Lo] = (K < Half) ? (DLReal) (0.42-0.5*DLCos(C1*K)+0.08*DLCos(C2*K)) :
+								(DLReal) 1.0;
 						}
 				break;
 
-				case WLeft:
-					for(I = 0;I < Half;I++)
+				case DWHalfBlackman:
+					C1 = M_PI/(Size-1);
+					C2 = 2*M_PI/(Size-1);
+					for (I = Lo;I < Hi;I++)
 						{
-							C = (DLReal) (0.42-0.5*DLCos(C1*I)+0.08*DLCos(C2*I));
-							A[I] *= C;
+							K = (WType == WRight) ? Size - I - 1 : I;
+							W[I - Lo] = (DLReal) (0.42-0.5*DLCos(C1*K)+0.08*DLCos(C2*K));
 						}
 				break;
 			}
+	}
+
+/* Moltiplica A per W elemento per elemento */
+static void DWApply(DLReal * __restrict A,const DLReal * __restrict W,const unsigned int N)
+	{
+		unsigned int I;
+
+		for (I = 0;I < N;I++)
+			A[I] *= W[I];
+	}
+
+/* Recupera dalla memoria o calcola la tabella della finestra, ritorna
+NULL se la tabella supera la memoria disponibile. Va chiamata con il
+mutex acquisito. */
+static const DLReal * DWGetTable(const DWType Type,const unsigned int Size,
+	const WindowType WType)
+	{
+		unsigned int I;
+		unsigned int L;
+		size_t Bytes = Size * sizeof(DLReal);
+		DLReal * W;
+
+		/* Ricerca la tabella */
+		DWUse++;
+		for (I = 0;I < DWNTables;I++)
+			if (DWTables[I].Type == Type && DWTables[I].Size == Size &&
+				DWTables[I].WType == WType)
+				{
+					DWTables[I].Use = DWUse;
+					return DWTables[I].W;
+				}
+
+		/* Verifica se la tabella pu essere memorizzata */
+		if (Bytes > DWCacheLimit / 4)
+			return NULL;
+
+		/* Libera le tabelle usate meno di recente */
+		while (DWNTables > 0 && (DWNTables == DWMaxTables ||
+			DWCacheBytes + Bytes > DWCacheLimit))
+			{
+				for (I = 1,L = 0;I < DWNTables;I++)
+					if (DWTables[I].Use < DWTables[L].Use)
+						L = I;
+				DWCacheBytes -= DWTables[L].Size * sizeof(DLReal);
+				delete[] DWTables[L].W;
+				DWTables[L] = DWTables[--DWNTables];
+			}
+
+		/* Calcola la tabella */
+		if ((W = new DLReal[Size]) == NULL)
+			return NULL;
+		DWFill(Type,Size,WType,0,Size,W);
+		DWTables[DWNTables].Type = Type;
+		DWTables[DWNTables].Size = Size;
+		DWTables[DWNTables].WType = WType;
+		DWTables[DWNTables].W = W;
+		DWTables[DWNTables].Use = DWUse;
+		DWNTables++;
+		DWCacheBytes += Bytes;
+		return W;
+	}
+
+/* Moltiplica A[0,N) per i coefficienti [Lo,Lo + N) della tabella della
+finestra, calcolando i coefficienti a blocchi se la tabella non pu
+essere memorizzata */
+static void DWSegment(DLReal * A,const DWType Type,const unsigned int Size,
+	const WindowType WType,const unsigned int Lo,const unsigned int N)
+	{
+		const DLReal * W;
+		DLReal B[DWBlockSize];
+		unsigned int I;
+		unsigned int L;
+
+		if (N == 0)
+			return;
+
+		DWLock();
+		W = DWGetTable(Type,Size,WType);
+		if (W != NULL)
+			{
+				DWApply(A,&W[Lo],N);
+				DWUnlock();
+				return;
+			}
+		DWUnlock();
+
+		for (I = 0;I < N;I += DWBlockSize)
+			{
+				L = (N - I < DWBlockSize) ? N - I : DWBlockSize;
+				DWFill(Type,Size,WType,Lo + I,Lo + I + L,B);
+				DWApply(&A[I],B,L);
+			}
+	}
+
+/* Finestratura simmetrica di dimensione Size, eventualmente parziale,
+con Space campioni centrali non finestrati */
+static void DWSymmetric(DLReal * A,const DWType Type,const unsigned int Size,
+	const unsigned int Space,const WindowType WType)
+	{
+		unsigned int ESize = Size - Space;
+		unsigned int Half = ESize / 2;
+
+		/* Finestra completa senza spaziatura, un unico passaggio */
+		if (WType == WFull && Space == 0)
+			{
+				DWSegment(A,Type,ESize,WFull,0,ESize);
+				return;
+			}
+
+		if (WType == WLeft || WType == WFull)
+			DWSegment(A,Type,ESize,WFull,0,Half);
+		if (WType == WRight || WType == WFull)
+			DWSegment(&A[Size - Half],Type,ESize,WFull,ESize - Half,Half);
+	}
+
+void DWSetCacheSize(const size_t Bytes)
+	{
+		DWLock();
+		DWCacheLimit = Bytes;
+		DWUnlock();
+		if (Bytes == 0)
+			DWFreeCache();
+	}
+
+void DWFreeCache(void)
+	{
+		unsigned int I;
+
+		DWLock();
+		for (I = 0;I < DWNTables;I++)
+			delete[] DWTables[I].W;
+		DWNTables = 0;
+		DWCacheBytes = 0;
+		DWUnlock();
+	}
+
+void HammingWindow(DLReal * A,unsigned int Size)
+  {
+		DWSymmetric(A,DWHamming,Size,0,WFull);
+  }
+
+void HanningWindow(DLReal * A,unsigned int Size)
+  {
+		DWSymmetric(A,DWHanning,Size,0,WFull);
+  }
+
+void BlackmanWindow(DLReal * A,unsigned int Size)
+  {
+		DWSymmetric(A,DWBlackman,Size,0,WFull);
+  }
+
+void SpacedBlackmanWindow(DLReal * A,unsigned int Size, unsigned int Space, WindowType WType)
+  {
+		DWSymmetric(A,DWSpacedBlackman,Size,Space,WType);
   }
 
 void HalfBlackmanWindow(DLReal * A,unsigned int Size, unsigned int Space, WindowType WType)
   {
 		unsigned int ESize = Size - Space;
-    unsigned int I;
-    DLReal C;
-		DLReal C1 = M_PI/(ESize-1);
-		DLReal C2 = 2*M_PI/(ESize-1);
 
 		switch (WType)
 			{
 				case WRight:
-					for(I = 0;I < ESize;I++)
-						{
-							C = (DLReal) (0.42-0.5*DLCos(C1*I)+0.08*DLCos(C2*I));
-							A[Size-I-1] *= C;
-						}
+					DWSegment(&A[Size - ESize],DWHalfBlackman,ESize,WRight,0,ESize);
 				break;
 
 				case WFull:
@@ -142,11 +337,7 @@ void HalfBlackmanWindow(DLReal * A,unsigned int Size, unsigned int Space, Window
 				break;
 
 				case WLeft:
-					for(I = 0;I < ESize;I++)
-						{
-							C = (DLReal) (0.42-0.5*DLCos(C1*I)+0.08*DLCos(C2*I));
-							A[I] *= C;
-						}
+					DWSegment(A,DWHalfBlackman,ESize,WLeft,0,ESize);
 				break;
 			}
   }
@@ -166,15 +357,7 @@ void BartlettWindow(DLReal * A,unsigned int Size)
 
 void BlackmanHarrisWindow(DLReal * A,unsigned int Size)
 	{
-		unsigned int I,Half = Size/2;
-    DLReal C;
-
-    for(I = 0;I < Half;I++)
-      {
-        C = (DLReal) (0.35875-0.48829*DLCos(2*M_PI*I/(Size-1))+0.14128*DLCos(4*M_PI*I/(Size-1))+0.01168*DLCos(6*M_PI*I/(Size-1)));
-        A[I] *= C;
-        A[Size-I-1] *= C;
-      }
+		DWSymmetric(A,DWBlackmanHarris,Size,0,WFull);
 	}
 
 void ExponentialWindow(DLReal * A,unsigned int Size,DLReal P)
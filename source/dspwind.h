@@ -56,6 +56,15 @@
   // Riempie A di 1.
   void Ones(DLReal * A,unsigned int Size);
 
+	// Le finestre basate su funzioni trigonometriche usano tabelle di
+	// coefficienti mantenute in memoria e riutilizzate dalle finestrature
+	// successive della stessa dimensione. Imposta la memoria massima per
+	// le tabelle, 0 per disabilitarle.
+	void DWSetCacheSize(const size_t Bytes);
+
+	// Dealloca le tabelle delle finestre
+	void DWFreeCache(void);
+
 #endif
 
 /***************************************************************************/
@@ -33,6 +33,8 @@
 ****************************************************************************/
 
 #include "fft.h"
+#include "perfmon.h"
+#include "fftcodelet.h"
 
 /* Memory leaks debugger */
 #ifdef DebugMLeaks
@@ -80,111 +82,6 @@ unsigned int FirstFactor(unsigned int N)
     return(I);
   }
 
-/* Controlla se  ablitato l'uso della FFT GSL o di Ooura */
-#if !defined(UseGSLFft) && !defined(UseOouraFft)
-
-static unsigned int Radix2Reverse(unsigned int I,unsigned int N)
-  {
-    unsigned int IR,J,Bit;
-
-    IR = 0;
-
-    for(J = 1,Bit = N >> 1;J < N;J <<= 1,Bit >>= 1)
-      if((I & J) != 0)
-        IR |= Bit;
-
-    return(IR);
-  }
-
-static void Radix2Shuffle(DLComplex P[],unsigned int N)
-  {
-    unsigned int I,IR;
-    DLComplex Temp;
-
-    for(I = 0;I < N;I++)
-      {
-        IR = Radix2Reverse(I,N);
-
-        if(I < IR)
-          {
-            Temp = P[I];
-            P[I] = P[IR];
-            P[IR] = Temp;
-          }
-      }
-  }
-
-static void DLRadix2Fft(DLComplex P[],unsigned int N)
-  {
-    unsigned int I,J,K,Span,Start,End;
-    DLComplex P0,Root;
-
-    for(K = 0,Span = N >> 1;K < Span;K++)
-      {
-        P0 = P[Span+K];
-        P[Span+K] = P[K]-P0;
-        P[K] += P0;
-      }
-
-    for(I = 2,Span >>= 1;I < N;I <<= 1,Span >>= 1)
-      {
-        for(J = 0;J < I;J++)
-          {
-						Root = std::conj(UnitRoot(J,I << 1));
-
-            Start = (Radix2Reverse(J,I) << 1)*Span;
-            End = Start+Span;
-
-            for(K = Start;K < End;K++)
-              {
-                P0 = Root*P[Span+K];
-                P[Span+K] = P[K]-P0;
-                P[K] += P0;
-              }
-          }
-      }
-
-    Radix2Shuffle(P,N);
-  }
-
-static void DLRadix2IFft(DLComplex P[],unsigned int N)
-  {
-    unsigned int I,J,K,Span,Start,End;
-    DLComplex P0,Root;
-
-    for(K = 0,Span = N >> 1;K < Span;K++)
-      {
-        P0 = P[Span+K];
-        P[Span+K] = P[K]-P0;
-        P[K] += P0;
-      }
-
-    for(I = 2,Span >>= 1;I < N;I <<= 1,Span >>= 1)
-      {
-        for(J = 0;J < I;J++)
-          {
-            Root = UnitRoot(J,I << 1);
-
-            Start = (Radix2Reverse(J,I) << 1)*Span;
-            End = Start+Span;
-
-            for(K = Start;K < End;K++)
-              {
-                P0 = Root*P[Span+K];
-                P[Span+K] = P[K]-P0;
-                P[K] += P0;
-              }
-          }
-      }
-
-    Radix2Shuffle(P,N);
-
-    for(I = 0;I < N;I++)
-      P[I] /= (DLReal) N;
-  }
-
-#endif
-
 /* Verifica se  abiliato l'uso della GSL */
 #ifndef UseGSLFft
 
@@ -305,74 +202,109 @@ static Boolean DLFft(DLComplex P[],unsigned int N)
     return(True);
   }
 
-static Boolean DLIFft(DLComplex P[],unsigned int N)
+/* Trasformata non normalizzata con le trasformate espanse come
+trasformate terminali. N viene scomposto in N = L M, con L il maggiore
+divisore di N per cui esiste la trasformata espansa, e la trasformata
+viene calcolata come M trasformate terminali di L punti, rotazione per
+W_N^(n2 k1) e L trasformate di M punti, calcolate ricorsivamente. Le
+lunghezze prive di divisori adatti usano DLFft(). */
+static Boolean DLLeafFft(DLComplex P[],unsigned int N,const Boolean Inverse)
   {
-    unsigned int I,J,K,L,Span,Radix,Start,End,RP;
-    DLComplex * PT;
-    DLComplex Root,P0;
+    DLComplex X[FCMaxSize];
+    DLComplex * T;
+    DLComplex * U;
+    std::complex<double> R,W;
+    unsigned int I,L,M,K1,N2;
+    Boolean Res;
+
+    /* Trasformata espansa */
+    if (FCAvailable(N) == True)
+      {
+        for(I = 0;I < N;I++)
+          X[I] = P[I];
+        if (Inverse == False)
+          FCDftN<DLReal,-1>(X,1,P,N);
+        else
+          FCDftN<DLReal,1>(X,1,P,N);
+        return(True);
+      }
 
-    Radix = FirstFactor(N);
+    /* Lunghezza delle trasformate terminali */
+    for(L = FCMaxSize;L > 1;L--)
+      if (N%L == 0 && FCAvailable(L) == True)
+        break;
 
-    for(I = 1,Span = N/Radix;I < N;Span /= Radix)
+    /* Senza divisori adatti usa la trasformata a radice mista,
+    l'inversa come coniugata della diretta del coniugato */
+    if (L < 2)
       {
-        RP = I*Radix;
+        if (Inverse == False)
+          return(DLFft(P,N));
+        for(I = 0;I < N;I++)
+          P[I] = std::conj(P[I]);
+        Res = DLFft(P,N);
+        for(I = 0;I < N;I++)
+          P[I] = std::conj(P[I]);
+        return(Res);
+      }
+    M = N/L;
 
-        if (Radix == 2)
-          if (I == 1)
-            for(K = 0;K < Span;K++)
-              {
-                P0 = P[Span+K];
-                P[Span+K] = P[K]-P0;
-                P[K] += P0;
-              }
-          else
-            for(J = 0;J < I;J++)
-              {
-                Start = MixedReverse(J,I)*Radix*Span;
-                End = Start+Span;
-                Root = UnitRoot(J,RP);
+    if ((T = new DLComplex[N]) == NULL)
+      return(False);
+    if ((U = new DLComplex[M]) == NULL)
+      {
+        delete[](T);
+        return(False);
+      }
 
-                for(K = Start;K < End;K++)
-                  {
-                    P0 = Root*P[Span+K];
-                    P[Span+K] = P[K]-P0;
-                    P[K] += P0;
-                  }
-              }
+    /* Trasformate terminali sui campioni P[n2 + M n1] e rotazione */
+    for(N2 = 0;N2 < M;N2++)
+      {
+        if (Inverse == False)
+          FCDftN<DLReal,-1>(&P[N2],M,&T[N2*L],L);
         else
-          if ((PT = new(DLComplex[Radix])) != NULL)
-            {
-              for(J = 0;J < I;J++)
-                {
-                  Start = MixedReverse(J,I)*Radix*Span;
-                  End = Start+Span;
+          FCDftN<DLReal,1>(&P[N2],M,&T[N2*L],L);
 
-                  for(K = Start;K < End;K++)
-                    {
-                      for (L = 0;L < Radix;L++)
-                        PT[L] = P[Span*L+K];
+        R = std::polar(1.0,((Inverse == False) ? -2.0 : 2.0)*M_PI*N2/N);
+        W = R;
+        for(K1 = 1;K1 < L;K1++)
+          {
+            T[N2*L+K1] = DLComplex((DLReal) (T[N2*L+K1].real()*W.real()-T[N2*L+K1].imag()*W.imag()),
+              (DLReal) (T[N2*L+K1].real()*W.imag()+T[N2*L+K1].imag()*W.real()));
+            W *= R;
+          }
+      }
 
-                      for (L = 0;L < Radix;L++)
-                        P[Span*L+K] = PolyEval(PT,Radix,
-                          UnitRoot(L*I+J,RP));
-                    }
-                }
+    /* Trasformate di M punti per ogni k1 */
+    Res = True;
+    for(K1 = 0;K1 < L;K1++)
+      {
+        for(N2 = 0;N2 < M;N2++)
+          U[N2] = T[N2*L+K1];
+        if (DLLeafFft(U,M,Inverse) == False)
+          Res = False;
+        for(N2 = 0;N2 < M;N2++)
+          P[K1+L*N2] = U[N2];
+      }
 
-              delete[](PT);
-            }
-          else
-            return(False);
+    delete[](T);
+    delete[](U);
 
-        I *= Radix;
-        Radix = FirstFactor(Span);
-      }
+    return(Res);
+  }
 
-    MixedShuffle(P,N);
+/* Antitrasformata normalizzata */
+static Boolean DLLeafIFft(DLComplex P[],unsigned int N)
+  {
+    unsigned int I;
+    Boolean Res;
+
+    Res = DLLeafFft(P,N,True);
 
     for(I = 0;I < N;I++)
       P[I] /= (DLReal) N;
 
-    return(True);
+    return(Res);
   }
 
 #else
@@ -497,10 +429,16 @@ static void FreeWTAndWS(void)
 
 static Boolean CheckWTAndWS(unsigned int N)
 	{
-		if (FftWT == NULL)
+		static Boolean ExitSet = False;
+
+		if (ExitSet == False)
 			{
 				atexit(FreeWTAndWS);
+				ExitSet = True;
+			}
 
+		if (FftWT == NULL)
+			{
 				FftWT = FftWTAlloc(N);
 				if (FftWT == NULL)
 					return(False);
@@ -534,8 +472,537 @@ static Boolean CheckWTAndWS(unsigned int N)
 
 #endif
 
-void Radix2Fft(DLComplex P[],unsigned int N)
+/* Controlla se  abilitato il calcolo parallelo delle FFT */
+#ifdef UseFftThreads
+
+#include "dspalloc.h"
+#include "tpool.h"
+#include <pthread.h>
+#include <math.h>
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <unistd.h>
+#endif
+
+/* Numero massimo di thread */
+#define FftMaxThreads 64
+
+/* Numero di thread e lunghezza minima per il calcolo parallelo */
+static unsigned int FftThreads = 1;
+static unsigned int FftThreadsMinSize = 262144;
+
+/* Lavoro eseguito da ogni thread sull'intervallo [Start,End) */
+typedef void (* FftJobType)(void * Arg,const unsigned int Thread,
+	const unsigned int Start,const unsigned int End);
+
+typedef struct
+	{
+		FftJobType Job;
+		void * Arg;
+		unsigned int Thread;
+		unsigned int Start;
+		unsigned int End;
+	}
+FftThreadArgType;
+
+static void * FftThreadMain(void * P)
+	{
+		FftThreadArgType * TA = (FftThreadArgType *) P;
+
+		TA->Job(TA->Arg,TA->Thread,TA->Start,TA->End);
+		return(NULL);
+	}
+
+/* Suddivide gli indici [0,Count) tra i thread e attende il completamento,
+il primo intervallo viene elaborato dal thread chiamante. Se la creazione
+di un thread fallisce il relativo intervallo viene elaborato dal thread
+chiamante. */
+static void FftParallelFor(FftJobType Job,void * Arg,const unsigned int Count)
+	{
+		pthread_t TH[FftMaxThreads];
+		Boolean TC[FftMaxThreads];
+		FftThreadArgType TA[FftMaxThreads];
+		unsigned int NT;
+		unsigned int T;
+
+		/* Usa il pool di thread condiviso se ha lo stesso numero di thread,
+		dato che gli indici dei thread identificano le aree di lavoro */
+		if (FftThreads > 1 && TPGetThreads() == FftThreads)
+			{
+				TPParallelFor(Job,Arg,Count,0);
+				return;
+			}
+
+		NT = (FftThreads < Count) ? FftThreads : Count;
+		for (T = 0;T < NT;T++)
+			{
+				TA[T].Job = Job;
+				TA[T].Arg = Arg;
+				TA[T].Thread = T;
+				TA[T].Start = (unsigned int) (((unsigned long long) Count * T) / NT);
+				TA[T].End = (unsigned int) (((unsigned long long) Count * (T + 1)) / NT);
+				TC[T] = False;
+			}
+		for (T = 1;T < NT;T++)
+			if (pthread_create(&TH[T],NULL,FftThreadMain,&TA[T]) == 0)
+				TC[T] = True;
+
+		Job(Arg,0,TA[0].Start,TA[0].End);
+
+		for (T = 1;T < NT;T++)
+			if (TC[T] == True)
+				pthread_join(TH[T],NULL);
+			else
+				Job(Arg,T,TA[T].Start,TA[T].End);
+	}
+
+/* Numero di processori disponibili */
+static unsigned int FftCPUCount(void)
+	{
+		#ifdef _WIN32
+			SYSTEM_INFO SI;
+
+			GetSystemInfo(&SI);
+			return((unsigned int) SI.dwNumberOfProcessors);
+		#else
+			long NC = sysconf(_SC_NPROCESSORS_ONLN);
+
+			return((NC > 0) ? (unsigned int) NC : 1);
+		#endif
+	}
+
+/* Trasformata six-step di lunghezza N = N1 * N2, con il segnale visto
+come matrice di N1 righe e N2 colonne:
+  1) trasposizione in una matrice di N2 righe e N1 colonne
+  2) N2 trasformate di lunghezza N1 sulle righe
+  3) moltiplicazione per i fattori di rotazione W_N^(n2 k1)
+  4) trasposizione in una matrice di N1 righe e N2 colonne
+  5) N1 trasformate di lunghezza N2 sulle righe
+  6) trasposizione finale nell'ordine naturale
+Ogni passo opera su righe contigue, indipendenti tra loro, che vengono
+suddivise tra i thread. Le trasformate sulle righe hanno lunghezza circa
+pari a sqrt(N) e restano nella cache del processore. */
+
+/* Dimensione dei blocchi di trasposizione */
+#define FftTransposeBlock 32
+
+/* Lunghezza minima delle trasformate sulle righe */
+#define FftSixStepMinFactor 16
+
+/* Tabelle per le trasformate di una data lunghezza sulle righe, il
+workspace GSL e' separato per ogni thread */
+typedef struct
+	{
+		unsigned int N;
+		#ifdef UseGSLFft
+			FftWTType * WT;
+			FftWSType * WS[FftMaxThreads];
+		#endif
+	}
+FftRowPlanType;
+
+/* Stato della trasformata six-step */
+typedef struct
+	{
+		/* Segnale, array temporaneo e dimensioni */
+		DLComplex * P;
+		DLComplex * T;
+		unsigned int N;
+		unsigned int N1;
+		unsigned int N2;
+		Boolean Inverse;
+
+		/* Sorgente e destinazione delle trasposizioni */
+		DLComplex * S;
+		DLComplex * D;
+		unsigned int Rows;
+		unsigned int Cols;
+
+		/* Trasformate sulle righe */
+		FftRowPlanType * RP;
+		Boolean Twiddle;
+
+		/* Fattori di rotazione, W_N^E = WHi[E / N1] * WLo[E % N1] */
+		std::complex<double> * WLo;
+		std::complex<double> * WHi;
+
+		/* Esito delle trasformate sulle righe */
+		Boolean Failed;
+	}
+FftSixStepType;
+
+static Boolean FftRowPlanInit(FftRowPlanType * RP,const unsigned int N)
+	{
+		unsigned int T;
+
+		RP->N = N;
+		#ifdef UseGSLFft
+			RP->WT = NULL;
+			for (T = 0;T < FftMaxThreads;T++)
+				RP->WS[T] = NULL;
+			if ((RP->WT = FftWTAlloc(N)) == NULL)
+				return(False);
+			for (T = 0;T < FftThreads;T++)
+				if ((RP->WS[T] = FftWSAlloc(N)) == NULL)
+					return(False);
+		#else
+			T = 0;
+		#endif
+
+		/* Inizializza le tabelle di Ooura nel thread chiamante, le
+		tabelle per la lunghezza maggiore valgono anche per le minori */
+		#ifdef UseOouraFft
+			if ((N & (N - 1)) == 0)
+				{
+					DLComplex * D;
+
+					if (CheckWAAndCS(N) == False)
+						return(False);
+					if ((D = new DLComplex[N]) == NULL)
+						return(False);
+					for (T = 0;T < N;T++)
+						D[T] = 0;
+					cdft(2 * N,OouraForward,(DRCFloat *) D,OWATable,OCSTable);
+					delete[] D;
+				}
+		#endif
+
+		return(True);
+	}
+
+static void FftRowPlanFree(FftRowPlanType * RP)
+	{
+		#ifdef UseGSLFft
+			unsigned int T;
+
+			if (RP->WT != NULL)
+				FftWTFree(RP->WT);
+			for (T = 0;T < FftMaxThreads;T++)
+				if (RP->WS[T] != NULL)
+					FftWSFree(RP->WS[T]);
+		#endif
+	}
+
+/* Trasformata di una riga, normalizzata nell'inversa */
+static Boolean FftRow(const FftRowPlanType * RP,const unsigned int Thread,DLComplex * P,
+	const Boolean Inverse)
+	{
+		unsigned int N = RP->N;
+
+		#ifdef UseOouraFft
+			if ((N & (N - 1)) == 0)
+				{
+					unsigned int I;
+
+					if (Inverse == False)
+						cdft(2 * N,OouraForward,(DRCFloat *) P,OWATable,OCSTable);
+					else
+						{
+							cdft(2 * N,OouraBackward,(DRCFloat *) P,OWATable,OCSTable);
+							for (I = 0;I < N;I++)
+								P[I] /= (DRCFloat) N;
+						}
+					return(True);
+				}
+		#endif
+
+		#ifdef UseGSLFft
+			if (Inverse == True)
+				return((FftInverse((FftArrayType) P,1,N,RP->WT,RP->WS[Thread]) == 0) ? True : False);
+			return((FftForward((FftArrayType) P,1,N,RP->WT,RP->WS[Thread]) == 0) ? True : False);
+		#else
+			if (Inverse == True)
+				return(DLLeafIFft(P,N));
+			return(DLLeafFft(P,N,False));
+		#endif
+	}
+
+/* Trasposizione a blocchi delle righe [Start,End) di blocchi */
+static void FftTransposeJob(void * Arg,const unsigned int,
+	const unsigned int Start,const unsigned int End)
+	{
+		FftSixStepType * SS = (FftSixStepType *) Arg;
+		unsigned int RB;
+		unsigned int CB;
+		unsigned int R;
+		unsigned int C;
+		unsigned int RE;
+		unsigned int CE;
+
+		for (RB = Start * FftTransposeBlock;RB < End * FftTransposeBlock && RB < SS->Rows;
+			RB += FftTransposeBlock)
+			{
+				RE = (RB + FftTransposeBlock < SS->Rows) ? RB + FftTransposeBlock : SS->Rows;
+				for (CB = 0;CB < SS->Cols;CB += FftTransposeBlock)
+					{
+						CE = (CB + FftTransposeBlock < SS->Cols) ? CB + FftTransposeBlock : SS->Cols;
+						for (R = RB;R < RE;R++)
+							for (C = CB;C < CE;C++)
+								SS->D[C * SS->Rows + R] = SS->S[R * SS->Cols + C];
+					}
+			}
+	}
+
+/* Trasposizione della matrice S di Rows righe e Cols colonne in D */
+static void FftTranspose(FftSixStepType * SS,DLComplex * S,DLComplex * D,
+	const unsigned int Rows,const unsigned int Cols)
+	{
+		SS->S = S;
+		SS->D = D;
+		SS->Rows = Rows;
+		SS->Cols = Cols;
+		FftParallelFor(FftTransposeJob,SS,(Rows + FftTransposeBlock - 1) / FftTransposeBlock);
+	}
+
+/* Trasformate delle righe [Start,End) di SS->D, di lunghezza SS->RP->N,
+con eventuale moltiplicazione per i fattori di rotazione */
+static void FftRowsJob(void * Arg,const unsigned int Thread,
+	const unsigned int Start,const unsigned int End)
+	{
+		FftSixStepType * SS = (FftSixStepType *) Arg;
+		unsigned int L = SS->RP->N;
+		unsigned int R;
+		unsigned int K;
+		unsigned int Q;
+		unsigned int E;
+		unsigned int DQ;
+		unsigned int DE;
+		DLComplex * P;
+		std::complex<double> W;
+
+		for (R = Start;R < End;R++)
+			{
+				P = &SS->D[(size_t) R * L];
+				if (FftRow(SS->RP,Thread,P,SS->Inverse) == False)
+					SS->Failed = True;
+
+				if (SS->Twiddle == False)
+					continue;
+
+				/* Moltiplica per W_N^(R K), con R K = Q N1 + E mod N */
+				DQ = R / SS->N1;
+				DE = R % SS->N1;
+				for (K = 0,Q = 0,E = 0;K < L;K++)
+					{
+						W = SS->WHi[Q] * SS->WLo[E];
+						P[K] = DLComplex((DLReal) (P[K].real() * W.real() - P[K].imag() * W.imag()),
+							(DLReal) (P[K].real() * W.imag() + P[K].imag() * W.real()));
+						Q += DQ;
+						E += DE;
+						if (E >= SS->N1)
+							{
+								E -= SS->N1;
+								Q++;
+							}
+						if (Q >= SS->N2)
+							Q -= SS->N2;
+					}
+			}
+	}
+
+/* Calcola il fattore N1 <= sqrt(N) di N piu' vicino a sqrt(N) */
+static unsigned int FftSixStepFactor(const unsigned int N)
+	{
+		unsigned int F;
+
+		for (F = (unsigned int) sqrt((double) N);F > 1;F--)
+			if (N % F == 0)
+				return(F);
+		return(1);
+	}
+
+/* Trasformata six-step parallela, ritorna False se N non e' fattorizzabile
+o in caso di memoria insufficiente, senza modificare P */
+static Boolean FftSixStep(DLComplex P[],const unsigned int N,const Boolean Inverse)
+	{
+		FftSixStepType SS;
+		FftRowPlanType RP1;
+		FftRowPlanType RP2;
+		double S;
+		unsigned int I;
+		Boolean Res;
+
+		SS.N = N;
+		SS.N1 = FftSixStepFactor(N);
+		SS.N2 = N / SS.N1;
+		if (SS.N1 < FftSixStepMinFactor)
+			return(False);
+		SS.P = P;
+		SS.Inverse = Inverse;
+		SS.Failed = False;
+
+		/* Alloca l'array temporaneo e le tabelle */
+		if ((SS.T = DSPComplexAlloc(N)) == NULL)
+			return(False);
+		SS.WLo = new std::complex<double>[SS.N1];
+		SS.WHi = new std::complex<double>[SS.N2];
+		Res = (SS.WLo != NULL && SS.WHi != NULL) ? True : False;
+		/* N2 >= N1, le tabelle di Ooura sono inizializzate per N2 */
+		if (FftRowPlanInit(&RP1,SS.N1) == False)
+			Res = False;
+		if (FftRowPlanInit(&RP2,SS.N2) == False)
+			Res = False;
+
+		if (Res == True)
+			{
+				/* Fattori di rotazione */
+				S = (Inverse == True) ? 1.0 : -1.0;
+				for (I = 0;I < SS.N1;I++)
+					SS.WLo[I] = std::polar(1.0,(S * 2 * M_PI * I) / N);
+				for (I = 0;I < SS.N2;I++)
+					SS.WHi[I] = std::polar(1.0,(S * 2 * M_PI * I) / SS.N2);
+
+				/* Passi 1, 2 e 3 */
+				FftTranspose(&SS,SS.P,SS.T,SS.N1,SS.N2);
+				SS.RP = &RP1;
+				SS.Twiddle = True;
+				FftParallelFor(FftRowsJob,&SS,SS.N2);
+
+				/* Passi 4 e 5 */
+				FftTranspose(&SS,SS.T,SS.P,SS.N2,SS.N1);
+				SS.RP = &RP2;
+				SS.Twiddle = False;
+				FftParallelFor(FftRowsJob,&SS,SS.N1);
+
+				/* Passo 6 */
+				FftTranspose(&SS,SS.P,SS.T,SS.N1,SS.N2);
+				for (I = 0;I < N;I++)
+					P[I] = SS.T[I];
+
+				Res = (SS.Failed == True) ? False : True;
+			}
+
+		FftRowPlanFree(&RP1);
+		FftRowPlanFree(&RP2);
+		if (SS.WLo != NULL)
+			delete[] SS.WLo;
+		if (SS.WHi != NULL)
+			delete[] SS.WHi;
+		DSPFree(SS.T);
+
+		return(Res);
+	}
+
+/* Calcolo parallelo della trasformata, ritorna False se la trasformata
+deve essere calcolata in modo seriale */
+static Boolean FftParallel(DLComplex P[],const unsigned int N,const Boolean Inverse)
+	{
+		if (FftThreads < 2 || N < FftThreadsMinSize)
+			return(False);
+
+		/* Le routine di Ooura gestiscono direttamente fino a 4 thread */
+		#ifdef UseOouraFft
+			if ((N & (N - 1)) == 0 && FftThreads <= 4)
+				return(False);
+		#endif
+
+		return(FftSixStep(P,N,Inverse));
+	}
+
+/* Stato di un gruppo di trasformate della stessa lunghezza */
+typedef struct
+	{
+		DLComplex ** P;
+		FftRowPlanType * RP;
+		Boolean Inverse;
+		Boolean Failed;
+	}
+FftBatchType;
+
+/* Trasformate [Start,End) del gruppo */
+static void FftBatchJob(void * Arg,const unsigned int Thread,
+	const unsigned int Start,const unsigned int End)
+	{
+		FftBatchType * FB = (FftBatchType *) Arg;
+		unsigned int I;
+
+		for (I = Start;I < End;I++)
+			if (FftRow(FB->RP,Thread,FB->P[I],FB->Inverse) == False)
+				FB->Failed = True;
+	}
+
+/* Calcolo parallelo di un gruppo di trasformate, suddivise tra i thread
+con tabelle condivise, ritorna False se il gruppo deve essere calcolato
+in modo seriale */
+static Boolean FftParallelBatch(DLComplex * P[],const unsigned int Count,
+	const unsigned int N,const Boolean Inverse)
+	{
+		FftBatchType FB;
+		FftRowPlanType RP;
+		Boolean Res;
+
+		if (FftThreads < 2 || Count < 2 || (unsigned long long) Count * N < FftThreadsMinSize)
+			return(False);
+
+		Res = FftRowPlanInit(&RP,N);
+		if (Res == True)
+			{
+				FB.P = P;
+				FB.RP = &RP;
+				FB.Inverse = Inverse;
+				FB.Failed = False;
+				FftParallelFor(FftBatchJob,&FB,Count);
+				Res = (FB.Failed == True) ? False : True;
+			}
+		FftRowPlanFree(&RP);
+
+		return(Res);
+	}
+
+void FftSetThreads(unsigned int Threads,unsigned int MinSize)
+	{
+		if (Threads == 0)
+			Threads = FftCPUCount();
+		if (Threads > FftMaxThreads)
+			Threads = FftMaxThreads;
+		FftThreads = Threads;
+		FftThreadsMinSize = MinSize;
+
+		#ifdef UseOouraFft
+			cdft_threads((int) Threads,(int) (2 * MinSize),(int) (16 * MinSize));
+		#endif
+	}
+
+unsigned int FftGetThreads(void)
+	{
+		return(FftThreads);
+	}
+
+#else
+
+/* Senza il calcolo parallelo le trasformate sono sempre seriali */
+static Boolean FftParallel(DLComplex P[],const unsigned int N,const Boolean Inverse)
+	{
+		return(False);
+	}
+
+static Boolean FftParallelBatch(DLComplex * P[],const unsigned int Count,
+	const unsigned int N,const Boolean Inverse)
+	{
+		return(False);
+	}
+
+void FftSetThreads(unsigned int Threads,unsigned int MinSize)
+	{
+	}
+
+unsigned int FftGetThreads(void)
+	{
+		return(1);
+	}
+
+#endif
+
+static void Radix2FftBase(DLComplex P[],unsigned int N)
   {
+		/* Trasformate di piccole dimensioni espanse */
+		if (N <= FCMaxSize && FCFft(P,N,False) == True)
+			return;
+
+		if (FftParallel(P,N,False) == True)
+			return;
+
 		#ifdef UseOouraFft
 			if (CheckWAAndCS(N) == False)
 				return;
@@ -548,13 +1015,20 @@ void Radix2Fft(DLComplex P[],unsigned int N)
 
 				FftForward((FftArrayType) P,1,N,FftWT,FftWS);
 			#else
-				DLRadix2Fft(P,N);
+				DLLeafFft(P,N,False);
 			#endif
 		#endif
 	}
 
-void Radix2IFft(DLComplex P[],unsigned int N)
+static void Radix2IFftBase(DLComplex P[],unsigned int N)
   {
+		/* Trasformate di piccole dimensioni espanse */
+		if (N <= FCMaxSize && FCFft(P,N,True) == True)
+			return;
+
+		if (FftParallel(P,N,True) == True)
+			return;
+
 		#ifdef UseOouraFft
 			unsigned int I;
 
@@ -571,13 +1045,20 @@ void Radix2IFft(DLComplex P[],unsigned int N)
 					return;
 				FftInverse((FftArrayType) P,1,N,FftWT,FftWS);
 			#else
-				DLRadix2IFft(P,N);
+				DLLeafIFft(P,N);
 			#endif
 		#endif
 	}
 
-Boolean Fft(DLComplex P[],unsigned int N)
+static Boolean FftBase(DLComplex P[],unsigned int N)
   {
+		/* Trasformate di piccole dimensioni espanse */
+		if (N <= FCMaxSize && FCFft(P,N,False) == True)
+			return(True);
+
+		if (FftParallel(P,N,False) == True)
+			return(True);
+
 		/* Controlla se la lunghezza  una potenza di 2 */
 		if ((N & (N - 1)) > 0)
 			{
@@ -588,7 +1069,7 @@ Boolean Fft(DLComplex P[],unsigned int N)
 					if (FftForward((FftArrayType) P,1,N,FftWT,FftWS) != 0)
 						return(False);
 				#else
-					return(DLFft(P,N));
+					return(DLLeafFft(P,N,False));
 				#endif
 			}
 		else
@@ -606,7 +1087,7 @@ Boolean Fft(DLComplex P[],unsigned int N)
 						if (FftForward((FftArrayType) P,1,N,FftWT,FftWS) != 0)
 							return(False);
 					#else
-						DLRadix2Fft(P,N);
+						DLLeafFft(P,N,False);
 					#endif
 				#endif
 			}
@@ -614,8 +1095,15 @@ Boolean Fft(DLComplex P[],unsigned int N)
 		return(True);
 	}
 
-Boolean IFft(DLComplex P[],unsigned int N)
+static Boolean IFftBase(DLComplex P[],unsigned int N)
   {
+		/* Trasformate di piccole dimensioni espanse */
+		if (N <= FCMaxSize && FCFft(P,N,True) == True)
+			return(True);
+
+		if (FftParallel(P,N,True) == True)
+			return(True);
+
 		/* Controlla se la lunghezza  una potenza di 2 */
 		if ((N & (N - 1)) > 0)
 			{
@@ -626,7 +1114,7 @@ Boolean IFft(DLComplex P[],unsigned int N)
 					if (FftInverse((FftArrayType) P,1,N,FftWT,FftWS) != 0)
 						return(False);
 				#else
-					return(DLIFft(P,N));
+					return(DLLeafIFft(P,N));
 				#endif
 			}
 		else
@@ -649,7 +1137,7 @@ Boolean IFft(DLComplex P[],unsigned int N)
 						if (FftInverse((FftArrayType) P,1,N,FftWT,FftWS) != 0)
 							return(False);
 					#else
-						DLRadix2IFft(P,N);
+						DLLeafIFft(P,N);
 					#endif
 				#endif
 			}
@@ -657,6 +1145,274 @@ Boolean IFft(DLComplex P[],unsigned int N)
 		return(True);
 	}
 
+/* Funzioni pubbliche, con rilevamento delle prestazioni */
+void Radix2Fft(DLComplex P[],unsigned int N)
+	{
+		double Start = 0;
+
+		if (PMEnabled() == True)
+			Start = PMTime();
+		Radix2FftBase(P,N);
+		PMCountFft(N,Start);
+	}
+
+void Radix2IFft(DLComplex P[],unsigned int N)
+	{
+		double Start = 0;
+
+		if (PMEnabled() == True)
+			Start = PMTime();
+		Radix2IFftBase(P,N);
+		PMCountFft(N,Start);
+	}
+
+Boolean Fft(DLComplex P[],unsigned int N)
+	{
+		double Start = 0;
+		Boolean Res;
+
+		if (PMEnabled() == True)
+			Start = PMTime();
+		Res = FftBase(P,N);
+		PMCountFft(N,Start);
+		return(Res);
+	}
+
+Boolean IFft(DLComplex P[],unsigned int N)
+	{
+		double Start = 0;
+		Boolean Res;
+
+		if (PMEnabled() == True)
+			Start = PMTime();
+		Res = IFftBase(P,N);
+		PMCountFft(N,Start);
+		return(Res);
+	}
+
+/* Gruppo di trasformate della stessa lunghezza, le tabelle sono calcolate
+una sola volta per l'intero gruppo */
+static Boolean FftBatchBase(DLComplex * P[],unsigned int Count,unsigned int N,
+	const Boolean Inverse)
+	{
+		double Start = 0;
+		unsigned int I;
+		Boolean Res;
+
+		if (PMEnabled() == True)
+			Start = PMTime();
+
+		Res = True;
+		if (FftParallelBatch(P,Count,N,Inverse) == False)
+			for (I = 0;I < Count;I++)
+				if (((Inverse == True) ? IFftBase(P[I],N) : FftBase(P[I],N)) == False)
+					Res = False;
+
+		/* Il tempo complessivo viene attribuito alla prima trasformata */
+		if (Count > 0)
+			PMCountFft(N,Start);
+		for (I = 1;I < Count;I++)
+			PMCountFft(N,PMTime());
+
+		return(Res);
+	}
+
+Boolean FftBatch(DLComplex * P[],unsigned int Count,unsigned int N)
+	{
+		return(FftBatchBase(P,Count,N,False));
+	}
+
+Boolean IFftBatch(DLComplex * P[],unsigned int Count,unsigned int N)
+	{
+		return(FftBatchBase(P,Count,N,True));
+	}
+
+/* Gruppo di trasformate con passo Stride tra gli inizi */
+static Boolean FftStridedBase(DLComplex P[],unsigned int Count,unsigned int N,
+	unsigned int Stride,const Boolean Inverse)
+	{
+		DLComplex ** PA;
+		unsigned int I;
+		Boolean Res;
+
+		if ((PA = new DLComplex *[Count]) == NULL)
+			return(False);
+		for (I = 0;I < Count;I++)
+			PA[I] = &P[(size_t) I * Stride];
+		Res = FftBatchBase(PA,Count,N,Inverse);
+		delete[] PA;
+
+		return(Res);
+	}
+
+Boolean FftBatch(DLComplex P[],unsigned int Count,unsigned int N,unsigned int Stride)
+	{
+		return(FftStridedBase(P,Count,N,Stride,False));
+	}
+
+Boolean IFftBatch(DLComplex P[],unsigned int Count,unsigned int N,unsigned int Stride)
+	{
+		return(FftStridedBase(P,Count,N,Stride,True));
+	}
+
+/* Istanze del modello per il tipo DLReal */
+template <> Boolean TFft<DLReal>(DLComplex P[],unsigned int N)
+	{
+		return(Fft(P,N));
+	}
+
+template <> Boolean TIFft<DLReal>(DLComplex P[],unsigned int N)
+	{
+		return(IFft(P,N));
+	}
+
+/* Istanze del modello per il tipo DLAltReal, basate sulle routine GSL
+nella precisione alternativa, con tabelle separate da quelle di Fft() */
+#ifdef UseGSLFft
+
+#ifdef UseDouble
+	#include "gsl/gsl_fft_complex_float.h"
+
+	#define AltFftWTAlloc gsl_fft_complex_wavetable_float_alloc
+	#define AltFftWTFree gsl_fft_complex_wavetable_float_free
+	#define AltFftWSAlloc gsl_fft_complex_workspace_float_alloc
+	#define AltFftWSFree gsl_fft_complex_workspace_float_free
+	#define AltFftForward gsl_fft_complex_float_forward
+	#define AltFftInverse gsl_fft_complex_float_inverse
+	#define AltFftArrayType gsl_complex_packed_array_float
+	#define AltFftWTType gsl_fft_complex_wavetable_float
+	#define AltFftWSType gsl_fft_complex_workspace_float
+#else
+	#include "gsl/gsl_fft_complex.h"
+
+	#define AltFftWTAlloc gsl_fft_complex_wavetable_alloc
+	#define AltFftWTFree gsl_fft_complex_wavetable_free
+	#define AltFftWSAlloc gsl_fft_complex_workspace_alloc
+	#define AltFftWSFree gsl_fft_complex_workspace_free
+	#define AltFftForward gsl_fft_complex_forward
+	#define AltFftInverse gsl_fft_complex_inverse
+	#define AltFftArrayType gsl_complex_packed_array
+	#define AltFftWTType gsl_fft_complex_wavetable
+	#define AltFftWSType gsl_fft_complex_workspace
+#endif
+
+static AltFftWTType * AltFftWT = NULL;
+static AltFftWSType * AltFftWS = NULL;
+
+static void FreeAltWTAndWS(void)
+	{
+		if (AltFftWT != NULL)
+			{
+				AltFftWTFree(AltFftWT);
+				AltFftWT = NULL;
+			}
+
+		if (AltFftWS != NULL)
+			{
+				AltFftWSFree(AltFftWS);
+				AltFftWS = NULL;
+			}
+	}
+
+static Boolean CheckAltWTAndWS(unsigned int N)
+	{
+		static Boolean ExitSet = False;
+
+		if (ExitSet == False)
+			{
+				atexit(FreeAltWTAndWS);
+				ExitSet = True;
+			}
+
+		if (AltFftWT != NULL && AltFftWT->n == N)
+			return(True);
+
+		FreeAltWTAndWS();
+
+		AltFftWT = AltFftWTAlloc(N);
+		if (AltFftWT == NULL)
+			return(False);
+
+		AltFftWS = AltFftWSAlloc(N);
+		if (AltFftWS == NULL)
+			{
+				FreeAltWTAndWS();
+				return(False);
+			}
+
+		return(True);
+	}
+
+template <> Boolean TFft<DLAltReal>(DLAltComplex P[],unsigned int N)
+	{
+		double Start = 0;
+		Boolean Res;
+
+		if (PMEnabled() == True)
+			Start = PMTime();
+		Res = (CheckAltWTAndWS(N) == True &&
+			AltFftForward((AltFftArrayType) P,1,N,AltFftWT,AltFftWS) == 0) ? True : False;
+		PMCountFft(N,Start);
+		return(Res);
+	}
+
+template <> Boolean TIFft<DLAltReal>(DLAltComplex P[],unsigned int N)
+	{
+		double Start = 0;
+		Boolean Res;
+
+		if (PMEnabled() == True)
+			Start = PMTime();
+		Res = (CheckAltWTAndWS(N) == True &&
+			AltFftInverse((AltFftArrayType) P,1,N,AltFftWT,AltFftWS) == 0) ? True : False;
+		PMCountFft(N,Start);
+		return(Res);
+	}
+
+#else
+
+/* Senza le routine GSL la trasformata viene calcolata nella precisione
+di compilazione */
+static Boolean AltFftBase(DLAltComplex P[],unsigned int N,const Boolean Inverse)
+	{
+		DLComplex * C;
+		unsigned int I;
+		Boolean Res;
+
+		if ((C = new DLComplex[N]) == NULL)
+			return(False);
+		for (I = 0;I < N;I++)
+			C[I] = DLComplex((DLReal) P[I].real(),(DLReal) P[I].imag());
+		Res = (Inverse == True) ? IFft(C,N) : Fft(C,N);
+		for (I = 0;I < N;I++)
+			P[I] = DLAltComplex(C[I].real(),C[I].imag());
+		delete[] C;
+		return(Res);
+	}
+
+template <> Boolean TFft<DLAltReal>(DLAltComplex P[],unsigned int N)
+	{
+		return(AltFftBase(P,N,False));
+	}
+
+template <> Boolean TIFft<DLAltReal>(DLAltComplex P[],unsigned int N)
+	{
+		return(AltFftBase(P,N,True));
+	}
+
+#endif
+
+/* Dealloca le tabelle e gli array di lavoro mantenuti tra una
+trasformata e la successiva, vengono ricalcolati alla prossima
+trasformata */
+void FftReleaseTables(void)
+	{
+		#ifdef UseGSLFft
+			FreeWTAndWS();
+			FreeAltWTAndWS();
+		#endif
+	}
+
 DLComplex PolyEval(DLComplex P[],unsigned int N,DLComplex X)
   {
     DLComplex Y(0);
@@ -69,6 +69,51 @@
   Boolean Fft(DLComplex P[],unsigned int N);
   Boolean IFft(DLComplex P[],unsigned int N);
 
+  // Fft e IFft di Count array di lunghezza N, indicati dal vettore di
+  // puntatori P oppure disposti nell'array P con passo Stride >= N tra
+  // l'inizio di un array e il successivo. Le tabelle sono calcolate una
+  // sola volta per tutto il gruppo e, con il calcolo parallelo abilitato,
+  // le trasformate vengono distribuite tra i thread.
+  // Ritorna False se una delle trasformate non ha successo.
+  Boolean FftBatch(DLComplex * P[],unsigned int Count,unsigned int N);
+  Boolean IFftBatch(DLComplex * P[],unsigned int Count,unsigned int N);
+  Boolean FftBatch(DLComplex P[],unsigned int Count,unsigned int N,unsigned int Stride);
+  Boolean IFftBatch(DLComplex P[],unsigned int Count,unsigned int N,unsigned int Stride);
+
+  // Imposta il calcolo parallelo delle trasformate di lunghezza almeno
+  // pari a MinSize su Threads thread. Con Threads pari a 0 vengono usati
+  // tutti i processori disponibili, con Threads pari a 1 il calcolo e`
+  // seriale. Le trasformate di lunghezza pari a una potenza di 2 usano i
+  // thread delle routine di Ooura, se abilitate e con non piu` di 4
+  // thread, le altre una trasformata six-step con le trasformate sulle
+  // righe distribuite tra i thread. Richiede UseFftThreads, altrimenti
+  // il calcolo e` sempre seriale.
+  void FftSetThreads(unsigned int Threads,unsigned int MinSize);
+
+  // Ritorna il numero di thread impostato con FftSetThreads().
+  unsigned int FftGetThreads(void);
+
+  // Numero di array di complessi di lunghezza pari alla trasformata
+  // allocati internamente dalle routine di calcolo: tabella e array di
+  // lavoro GSL, mantenuti fino alla trasformata di lunghezza diversa
+  // successiva, oppure array temporaneo della trasformata six-step.
+  #define FftWorkArrays 2
+
+  // Dealloca le tabelle e gli array di lavoro mantenuti tra una
+  // trasformata e la successiva.
+  void FftReleaseTables(void);
+
+  // Fft e IFft come sopra, con il tipo floating point come parametro del
+  // modello. Sono disponibili le sole istanze per DLReal, equivalenti a
+  // Fft() e IFft(), e per DLAltReal, basata sulle routine GSL nella
+  // precisione alternativa.
+  template <class T> Boolean TFft(std::complex<T> P[],unsigned int N);
+  template <class T> Boolean TIFft(std::complex<T> P[],unsigned int N);
+  template <> Boolean TFft<DLReal>(DLComplex P[],unsigned int N);
+  template <> Boolean TIFft<DLReal>(DLComplex P[],unsigned int N);
+  template <> Boolean TFft<DLAltReal>(DLAltComplex P[],unsigned int N);
+  template <> Boolean TIFft<DLAltReal>(DLAltComplex P[],unsigned int N);
+
   // Valutazione del polinomio P nel punto X col metodo di Horner
   // Il polinomio e` considerato nella forma :
   // P[0] + P[1]*X + P[2]*X^2 + ... + P[N-1]*X^(N-1)
@@ -0,0 +1,349 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Trasformate di Fourier di piccole dimensioni completamente espanse a
+tempo di compilazione */
+
+/* Le trasformate di lunghezza N = 2^a 3^b 5^c, con N <= FCMaxSize, sono
+generate tramite modelli come decomposizioni a decimazione nel tempo con
+farfalle a radice 2, 3, 4 e 5. I cicli sono espansi dal compilatore e i
+fattori di rotazione sono costanti calcolate a tempo di compilazione
+tramite serie di Taylor, senza tabelle e senza chiamate a seno e
+coseno. Le trasformate sono usate direttamente per le FFT di piccole
+dimensioni e come trasformate terminali della FFT interna. */
+
+#ifndef FftCodelet_h
+	#define FftCodelet_h
+
+	/* Inclusioni */
+	#include "boolean.h"
+	#include <complex>
+	#include <math.h>
+
+	/* Espansione forzata delle funzioni, necessaria per le trasformate
+	maggiori che superano i limiti di espansione del compilatore */
+	#ifdef __GNUC__
+		#define FCInline inline __attribute__((always_inline))
+	#else
+		#define FCInline inline
+	#endif
+
+	/* Lunghezza massima delle trasformate espanse */
+	#define FCMaxSize 64
+
+	/* Serie di Taylor di seno e coseno, per |X| <= pi */
+	constexpr double FCSinTaylor(const double X2,const double Term,const int K)
+		{
+			return (K > 30) ? 0.0 : Term + FCSinTaylor(X2,-Term * X2 / ((2 * K + 2) * (2 * K + 3)),K + 1);
+		}
+
+	constexpr double FCCosTaylor(const double X2,const double Term,const int K)
+		{
+			return (K > 30) ? 0.0 : Term + FCCosTaylor(X2,-Term * X2 / ((2 * K + 1) * (2 * K + 2)),K + 1);
+		}
+
+	/* Angolo 2 pi E / N ridotto nell'intervallo [-pi,pi] */
+	constexpr double FCAngle(const unsigned int E,const unsigned int N)
+		{
+			return (2 * (E % N) > N) ? (2.0 * M_PI * (double) (E % N)) / N - 2.0 * M_PI :
+				(2.0 * M_PI * (double) (E % N)) / N;
+		}
+
+	/* Coseno e seno di 2 pi E / N */
+	constexpr double FCCos(const unsigned int E,const unsigned int N)
+		{
+			return FCCosTaylor(FCAngle(E,N) * FCAngle(E,N),1.0,0);
+		}
+
+	constexpr double FCSin(const unsigned int E,const unsigned int N)
+		{
+			return FCSinTaylor(FCAngle(E,N) * FCAngle(E,N),FCAngle(E,N),0);
+		}
+
+	/* Radice usata per la decomposizione di N, la radice 4 riduce il
+	numero di moltiplicazioni rispetto alla radice 2 */
+	template <unsigned int N>
+	struct FCRadix
+		{
+			static const unsigned int Value = (N % 4 == 0) ? 4 : (N % 2 == 0) ? 2 : ((N % 3 == 0) ? 3 : ((N % 5 == 0) ? 5 : N));
+		};
+
+	/* Moltiplicazione per i */
+	template <class T>
+	FCInline std::complex<T> FCMulI(const std::complex<T> & X)
+		{
+			return std::complex<T>(-X.imag(),X.real());
+		}
+
+	/* Moltiplicazione per W_N^E = exp(S i 2 pi E / N), con S = -1 per la
+	trasformata diretta e S = 1 per l'inversa. I multipli di un quarto di
+	giro sono esatti, il prodotto complesso e' esplicito per evitare la
+	gestione NaN/Inf della moltiplicazione complessa C99. */
+	template <class T,int S,unsigned int N,unsigned int E>
+	FCInline std::complex<T> FCTwiddle(const std::complex<T> & X)
+		{
+			const unsigned int Q = (4 * (E % N)) / N;
+			constexpr double WR = FCCos(E,N);
+			constexpr double WI = S * FCSin(E,N);
+
+			if ((4 * (E % N)) % N == 0)
+				switch (Q)
+					{
+						case 0:
+							return X;
+						case 1:
+							return (S > 0) ? FCMulI(X) : -FCMulI(X);
+						case 2:
+							return -X;
+						default:
+							return (S > 0) ? -FCMulI(X) : FCMulI(X);
+					}
+
+			return std::complex<T>(X.real() * (T) WR - X.imag() * (T) WI,
+				X.real() * (T) WI + X.imag() * (T) WR);
+		}
+
+	/* Farfalle sulle posizioni K, K + M, ..., K + (R - 1) M di Y, con
+	M = N / R, dopo la rotazione di W_N^(q K) */
+	template <class T,int S,unsigned int N,unsigned int R,unsigned int K>
+	struct FCButterfly;
+
+	template <class T,int S,unsigned int N,unsigned int K>
+	struct FCButterfly<T,S,N,2,K>
+		{
+			static FCInline void Run(std::complex<T> * Y)
+				{
+					const unsigned int M = N / 2;
+					std::complex<T> A = Y[K];
+					std::complex<T> B = FCTwiddle<T,S,N,K>(Y[K + M]);
+
+					Y[K] = A + B;
+					Y[K + M] = A - B;
+				}
+		};
+
+	template <class T,int S,unsigned int N,unsigned int K>
+	struct FCButterfly<T,S,N,4,K>
+		{
+			static FCInline void Run(std::complex<T> * Y)
+				{
+					const unsigned int M = N / 4;
+					std::complex<T> A = Y[K];
+					std::complex<T> B = FCTwiddle<T,S,N,K>(Y[K + M]);
+					std::complex<T> C = FCTwiddle<T,S,N,2 * K>(Y[K + 2 * M]);
+					std::complex<T> D = FCTwiddle<T,S,N,3 * K>(Y[K + 3 * M]);
+					std::complex<T> T1 = A + C;
+					std::complex<T> T2 = A - C;
+					std::complex<T> T3 = B + D;
+					std::complex<T> T4 = (S > 0) ? FCMulI(B - D) : FCMulI(D - B);
+
+					Y[K] = T1 + T3;
+					Y[K + M] = T2 + T4;
+					Y[K + 2 * M] = T1 - T3;
+					Y[K + 3 * M] = T2 - T4;
+				}
+		};
+
+	template <class T,int S,unsigned int N,unsigned int K>
+	struct FCButterfly<T,S,N,3,K>
+		{
+			static FCInline void Run(std::complex<T> * Y)
+				{
+					const unsigned int M = N / 3;
+					const T C = (T) -0.5;
+					const T SN = (T) (S * 0.86602540378443864676);
+					std::complex<T> A = Y[K];
+					std::complex<T> B = FCTwiddle<T,S,N,K>(Y[K + M]);
+					std::complex<T> D = FCTwiddle<T,S,N,2 * K>(Y[K + 2 * M]);
+					std::complex<T> T1 = B + D;
+					std::complex<T> T2 = A + C * T1;
+					std::complex<T> T3 = SN * (B - D);
+
+					Y[K] = A + T1;
+					Y[K + M] = T2 + FCMulI(T3);
+					Y[K + 2 * M] = T2 - FCMulI(T3);
+				}
+		};
+
+	template <class T,int S,unsigned int N,unsigned int K>
+	struct FCButterfly<T,S,N,5,K>
+		{
+			static FCInline void Run(std::complex<T> * Y)
+				{
+					const unsigned int M = N / 5;
+					constexpr double C1 = FCCos(1,5);
+					constexpr double C2 = FCCos(2,5);
+					constexpr double S1 = S * FCSin(1,5);
+					constexpr double S2 = S * FCSin(2,5);
+					std::complex<T> X0 = Y[K];
+					std::complex<T> X1 = FCTwiddle<T,S,N,K>(Y[K + M]);
+					std::complex<T> X2 = FCTwiddle<T,S,N,2 * K>(Y[K + 2 * M]);
+					std::complex<T> X3 = FCTwiddle<T,S,N,3 * K>(Y[K + 3 * M]);
+					std::complex<T> X4 = FCTwiddle<T,S,N,4 * K>(Y[K + 4 * M]);
+					std::complex<T> T1 = X1 + X4;
+					std::complex<T> T2 = X2 + X3;
+					std::complex<T> T3 = X1 - X4;
+					std::complex<T> T4 = X2 - X3;
+					std::complex<T> A1 = X0 + (T) C1 * T1 + (T) C2 * T2;
+					std::complex<T> A2 = X0 + (T) C2 * T1 + (T) C1 * T2;
+					std::complex<T> B1 = (T) S1 * T3 + (T) S2 * T4;
+					std::complex<T> B2 = (T) S2 * T3 - (T) S1 * T4;
+
+					Y[K] = X0 + T1 + T2;
+					Y[K + M] = A1 + FCMulI(B1);
+					Y[K + 4 * M] = A1 - FCMulI(B1);
+					Y[K + 2 * M] = A2 + FCMulI(B2);
+					Y[K + 3 * M] = A2 - FCMulI(B2);
+				}
+		};
+
+	/* Passo di ricombinazione per K = 0 ... N / R - 1 */
+	template <class T,int S,unsigned int N,unsigned int R,unsigned int K,bool End = (K >= N / R)>
+	struct FCPass
+		{
+			static FCInline void Run(std::complex<T> * Y)
+				{
+					FCButterfly<T,S,N,R,K>::Run(Y);
+					FCPass<T,S,N,R,K + 1>::Run(Y);
+				}
+		};
+
+	template <class T,int S,unsigned int N,unsigned int R,unsigned int K>
+	struct FCPass<T,S,N,R,K,true>
+		{
+			static FCInline void Run(std::complex<T> *)
+				{
+				}
+		};
+
+	/* Trasformata di N punti del vettore X con passo XS nel vettore Y,
+	senza normalizzazione. X e Y non devono sovrapporsi. */
+	template <class T,int S,unsigned int N>
+	struct FCDft
+		{
+			static FCInline void Run(const std::complex<T> * X,const unsigned int XS,
+				std::complex<T> * Y)
+				{
+					const unsigned int R = FCRadix<N>::Value;
+					const unsigned int M = N / R;
+					unsigned int Q;
+
+					for (Q = 0;Q < R;Q++)
+						FCDft<T,S,M>::Run(&X[Q * XS],XS * R,&Y[Q * M]);
+					FCPass<T,S,N,R,0>::Run(Y);
+				}
+		};
+
+	template <class T,int S>
+	struct FCDft<T,S,1>
+		{
+			static FCInline void Run(const std::complex<T> * X,const unsigned int,
+				std::complex<T> * Y)
+				{
+					Y[0] = X[0];
+				}
+		};
+
+	/* Verifica se esiste la trasformata espansa di lunghezza N */
+	inline Boolean FCAvailable(unsigned int N)
+		{
+			if (N < 2 || N > FCMaxSize)
+				return False;
+			while (N % 2 == 0)
+				N /= 2;
+			while (N % 3 == 0)
+				N /= 3;
+			while (N % 5 == 0)
+				N /= 5;
+			return (N == 1) ? True : False;
+		}
+
+	/* Trasformata di N punti del vettore X con passo XS nel vettore Y,
+	senza normalizzazione, con S = -1 per la trasformata diretta e S = 1
+	per l'inversa. Ritorna False se la lunghezza non e' disponibile. */
+	template <class T,int S>
+	Boolean FCDftN(const std::complex<T> * X,const unsigned int XS,
+		std::complex<T> * Y,const unsigned int N)
+		{
+			switch (N)
+				{
+					case 2: FCDft<T,S,2>::Run(X,XS,Y); break;
+					case 3: FCDft<T,S,3>::Run(X,XS,Y); break;
+					case 4: FCDft<T,S,4>::Run(X,XS,Y); break;
+					case 5: FCDft<T,S,5>::Run(X,XS,Y); break;
+					case 6: FCDft<T,S,6>::Run(X,XS,Y); break;
+					case 8: FCDft<T,S,8>::Run(X,XS,Y); break;
+					case 9: FCDft<T,S,9>::Run(X,XS,Y); break;
+					case 10: FCDft<T,S,10>::Run(X,XS,Y); break;
+					case 12: FCDft<T,S,12>::Run(X,XS,Y); break;
+					case 15: FCDft<T,S,15>::Run(X,XS,Y); break;
+					case 16: FCDft<T,S,16>::Run(X,XS,Y); break;
+					case 18: FCDft<T,S,18>::Run(X,XS,Y); break;
+					case 20: FCDft<T,S,20>::Run(X,XS,Y); break;
+					case 24: FCDft<T,S,24>::Run(X,XS,Y); break;
+					case 25: FCDft<T,S,25>::Run(X,XS,Y); break;
+					case 27: FCDft<T,S,27>::Run(X,XS,Y); break;
+					case 30: FCDft<T,S,30>::Run(X,XS,Y); break;
+					case 32: FCDft<T,S,32>::Run(X,XS,Y); break;
+					case 36: FCDft<T,S,36>::Run(X,XS,Y); break;
+					case 40: FCDft<T,S,40>::Run(X,XS,Y); break;
+					case 45: FCDft<T,S,45>::Run(X,XS,Y); break;
+					case 48: FCDft<T,S,48>::Run(X,XS,Y); break;
+					case 50: FCDft<T,S,50>::Run(X,XS,Y); break;
+					case 54: FCDft<T,S,54>::Run(X,XS,Y); break;
+					case 60: FCDft<T,S,60>::Run(X,XS,Y); break;
+					case 64: FCDft<T,S,64>::Run(X,XS,Y); break;
+					default:
+						return False;
+				}
+			return True;
+		}
+
+	/* Trasformata diretta o inversa sul posto del vettore P di N punti,
+	l'inversa e' normalizzata. Ritorna False se la lunghezza non e'
+	disponibile, senza modificare P. */
+	template <class T>
+	Boolean FCFft(std::complex<T> * P,const unsigned int N,const Boolean Inverse)
+		{
+			std::complex<T> X[FCMaxSize];
+			unsigned int I;
+
+			if (FCAvailable(N) == False)
+				return False;
+
+			for (I = 0;I < N;I++)
+				X[I] = P[I];
+			if (Inverse == False)
+				FCDftN<T,-1>(X,1,P,N);
+			else
+				{
+					FCDftN<T,1>(X,1,P,N);
+					for (I = 0;I < N;I++)
+						P[I] *= ((T) 1.0) / N;
+				}
+			return True;
+		}
+
+#endif
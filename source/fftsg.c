@@ -1,5 +1,15 @@
 #include "fftsg.h"
 
+/* DRC: the threaded code paths are enabled together with the parallel
+   FFT of fft.cpp, see UseFftThreads in drc.h */
+#ifdef UseFftThreads
+#ifdef _WIN32
+#define USE_CDFT_WINTHREADS
+#else
+#define USE_CDFT_PTHREADS
+#endif
+#endif
+
 /*
 Fast Fourier/Cosine/Sine Transform
     dimension   :one
@@ -799,6 +809,25 @@ void makect(int nc, int *ip, DRCFloat *c)
 #endif /* USE_CDFT_WINTHREADS */
 
 
+/* DRC: number of threads and thresholds settable at run time, threads
+   are disabled until cdft_threads() is called with nthreads > 1 */
+#ifdef USE_CDFT_THREADS
+static int cdft_nthreads = 1;
+static int cdft_threads_begin_n = CDFT_THREADS_BEGIN_N;
+static int cdft_4threads_begin_n = CDFT_4THREADS_BEGIN_N;
+#endif /* USE_CDFT_THREADS */
+
+
+void cdft_threads(int nthreads, int begin_n, int begin4_n)
+{
+#ifdef USE_CDFT_THREADS
+    cdft_nthreads = nthreads;
+    cdft_threads_begin_n = (begin_n >= 512) ? begin_n : 512;
+    cdft_4threads_begin_n = (begin4_n >= 512) ? begin4_n : 512;
+#endif /* USE_CDFT_THREADS */
+}
+
+
 void cftfsub(int n, DRCFloat *a, int *ip, int nw, DRCFloat *w)
 {
     void bitrv2(int n, int *ip, DRCFloat *a);
@@ -820,7 +849,7 @@ void cftfsub(int n, DRCFloat *a, int *ip, int nw, DRCFloat *w)
         if (n > 32) {
             cftf1st(n, a, &w[nw - (n >> 2)]);
 #ifdef USE_CDFT_THREADS
-            if (n > CDFT_THREADS_BEGIN_N) {
+            if (cdft_nthreads > 1 && n > cdft_threads_begin_n) {
                 cftrec4_th(n, a, nw, w);
             } else
 #endif /* USE_CDFT_THREADS */
@@ -868,7 +897,7 @@ void cftbsub(int n, DRCFloat *a, int *ip, int nw, DRCFloat *w)
         if (n > 32) {
             cftb1st(n, a, &w[nw - (n >> 2)]);
 #ifdef USE_CDFT_THREADS
-            if (n > CDFT_THREADS_BEGIN_N) {
+            if (cdft_nthreads > 1 && n > cdft_threads_begin_n) {
                 cftrec4_th(n, a, nw, w);
             } else
 #endif /* USE_CDFT_THREADS */
@@ -2217,7 +2246,7 @@ void cftrec4_th(int n, DRCFloat *a, int nw, DRCFloat *w)
     nthread = 2;
     idiv4 = 0;
     m = n >> 1;
-    if (n > CDFT_4THREADS_BEGIN_N) {
+    if (cdft_nthreads >= 4 && n > cdft_4threads_begin_n) {
         nthread = 4;
         idiv4 = 1;
         m >>= 1;
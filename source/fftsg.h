@@ -32,6 +32,10 @@ http://momonga.t.u-tokyo.ac.jp/~ooura/fft.html
   void ddst(int n, int dir, DRCFloat * data, int * ip, DRCFloat * w);
   void dfct(int n, DRCFloat *a, DRCFloat *t, int *ip, DRCFloat *w);	
   void dfst(int n, DRCFloat *a, DRCFloat *t, int *ip, DRCFloat *w);
+
+	/* Number of threads used by cdft() and data lengths (2*n) above which
+	2 and 4 threads are used, see USE_CDFT_PTHREADS in fftsg.c */
+	void cdft_threads(int nthreads, int begin_n, int begin4_n);
 	
 	#ifdef __cplusplus
 		}
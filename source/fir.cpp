@@ -35,6 +35,7 @@
 #include "fir.h"
 #include "fft.h"
 #include "spline.h"
+#include "dspalloc.h"
 #include <stddef.h>
 
 /* Memory leaks debugger */
@@ -205,12 +206,12 @@ Boolean GenericFir(DLReal * Filter,unsigned int Order,DLReal * F,
 
     HtSize2 = 2*HtSize;
 
-    if ((Ht = new DLComplex[HtSize2]) == NULL)
+    if ((Ht = DSPComplexAlloc(HtSize2)) == NULL)
       return(False);
 
-		if ((Hf = new DLReal[HtSize]) == NULL)
+		if ((Hf = DSPRealAlloc(HtSize)) == NULL)
 			{
-				delete[](Ht);
+				DSPFree(Ht);
 				return(False);
 			}
 
@@ -227,23 +228,23 @@ Boolean GenericFir(DLReal * Filter,unsigned int Order,DLReal * F,
 					/* Alloca gli array temporanei rimappatura logaritmica */
 					if ((LF = new DLReal[Np]) == NULL)
 						{
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 					if ((LM = new DLReal[Np]) == NULL)
 						{
 							delete[](LF);
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 					if ((LP = new DLReal[Np]) == NULL)
 						{
 							delete[](LM);
 							delete[](LF);
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 
@@ -267,8 +268,8 @@ Boolean GenericFir(DLReal * Filter,unsigned int Order,DLReal * F,
 							delete[](LP);
 							delete[](LM);
 							delete[](LF);
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 
@@ -281,8 +282,8 @@ Boolean GenericFir(DLReal * Filter,unsigned int Order,DLReal * F,
 				case SplineLinear:
 					if (CSLCASplineValue(F,M,P,Np,Hf,HtSize,Ht,CSLBSpline,CSLLinXLinY) == False)
 						{
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 				break;
@@ -291,23 +292,23 @@ Boolean GenericFir(DLReal * Filter,unsigned int Order,DLReal * F,
 					/* Alloca gli array temporanei rimappatura logaritmica */
 					if ((LF = new DLReal[Np]) == NULL)
 						{
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 					if ((LM = new DLReal[Np]) == NULL)
 						{
 							delete[](LF);
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 					if ((LP = new DLReal[Np]) == NULL)
 						{
 							delete[](LM);
 							delete[](LF);
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 
@@ -331,8 +332,8 @@ Boolean GenericFir(DLReal * Filter,unsigned int Order,DLReal * F,
 							delete[](LP);
 							delete[](LM);
 							delete[](LF);
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 
@@ -345,8 +346,8 @@ Boolean GenericFir(DLReal * Filter,unsigned int Order,DLReal * F,
 				case PCHIPLinear:
 					if (CSLCASplineValue(F,M,P,Np,Hf,HtSize,Ht,CSLHSSpline,CSLLinXLinY) == False)
 						{
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 				break;
@@ -355,23 +356,23 @@ Boolean GenericFir(DLReal * Filter,unsigned int Order,DLReal * F,
 					/* Alloca gli array temporanei rimappatura logaritmica */
 					if ((LF = new DLReal[Np]) == NULL)
 						{
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 					if ((LM = new DLReal[Np]) == NULL)
 						{
 							delete[](LF);
-							delete[](Ht);
-							delete(Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 					if ((LP = new DLReal[Np]) == NULL)
 						{
 							delete[](LM);
 							delete[](LF);
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 
@@ -395,8 +396,8 @@ Boolean GenericFir(DLReal * Filter,unsigned int Order,DLReal * F,
 							delete[](LP);
 							delete[](LM);
 							delete[](LF);
-							delete[](Ht);
-							delete[](Hf);
+							DSPFree(Ht);
+							DSPFree(Hf);
 							return(False);
 						}
 
@@ -424,7 +425,8 @@ Boolean GenericFir(DLReal * Filter,unsigned int Order,DLReal * F,
 
     if (IFft(Ht,HtSize2) == False)
       {
-        delete[](Ht);
+        DSPFree(Ht);
+        DSPFree(Hf);
         return(False);
       }
 
@@ -435,8 +437,8 @@ Boolean GenericFir(DLReal * Filter,unsigned int Order,DLReal * F,
     for(I = HalfFilter;I < Order;I++)
       Filter[I] = std::real(Ht[I-HalfFilter]);
 
-    delete[](Ht);
-    delete[](Hf);
+    DSPFree(Ht);
+    DSPFree(Hf);
     return(True);
   }
 
@@ -31,6 +31,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
+#include "mls.h"
 
 /* Decommentare per abilitare la compilazione in doppia precisione */
 /* Uncomment to enable double precision computation */
@@ -75,6 +77,13 @@
 	#define M_2PI ((DLReal) 6.28318530717958647692528676655900576)
 #endif
 
+/* Block length used for generation and output */
+#define GenBlockLen 4096
+
+/* Interval between exact evaluations of the exponential phase and
+of the inverse decay, which are otherwise computed by recurrence */
+#define ExpAnchorLen 256
+
 /* Output stringhe con sync output e parametro */
 int sputsp(const char * s, const char * p)
 	{
@@ -93,6 +102,133 @@ int sputs(const char * s)
 		return(sputsp(s, NULL));
 	}
 
+/* Writes the mono signal in MF, ML samples long, as NC interleaved
+channels, each one delayed by DL samples with respect to the previous */
+int WriteChannels(FILE * MF,const int ML,const int NC,const int DL,FILE * OF)
+	{
+		float * CB;
+		float * FB;
+		int FL;
+		int F;
+		int BL;
+		int S;
+		int A;
+		int E;
+		int C;
+		int I;
+
+		CB = (float *) malloc(sizeof(float) * GenBlockLen);
+		FB = (float *) malloc(sizeof(float) * GenBlockLen * NC);
+		if (CB == NULL || FB == NULL)
+			{
+				free(CB);
+				free(FB);
+				return 1;
+			}
+
+		FL = ML + (NC - 1) * DL;
+		for (F = 0;F < FL;F += GenBlockLen)
+			{
+				BL = (FL - F < GenBlockLen) ? FL - F : GenBlockLen;
+				for (C = 0;C < NC;C++)
+					{
+						/* Mono samples starting at F - C * DL */
+						S = F - C * DL;
+						for (I = 0;I < BL;I++)
+							CB[I] = (float) 0.0;
+						A = (S > 0) ? S : 0;
+						E = (S + BL < ML) ? S + BL : ML;
+						if (A < E)
+							{
+								fseek(MF,(long) (sizeof(float) * A),SEEK_SET);
+								if (fread(&CB[A - S],sizeof(float),E - A,MF) != (size_t) (E - A))
+									{
+										free(CB);
+										free(FB);
+										return 1;
+									}
+							}
+						for (I = 0;I < BL;I++)
+							FB[I * NC + C] = CB[I];
+					}
+				fwrite(FB,sizeof(float) * NC,BL,OF);
+			}
+
+		free(CB);
+		free(FB);
+		return 0;
+	}
+
+/* Generates Periods periods of the maximum length sequence of the
+given order on NC interleaved channels, each one circularly shifted
+by one NC-th of the sequence length */
+int GenerateMLS(const int Order,const DLReal Rate,const DLReal Amplitude,
+	const int Periods,const int NC,const char * MLSFile)
+	{
+		unsigned char * S;
+		float * FB;
+		FILE * OF;
+		int L;
+		int Shift;
+		int FL;
+		int F;
+		int BL;
+		int C;
+		int I;
+
+		L = MLSLength(Order);
+		Shift = L / NC;
+		FL = Periods * L;
+		printf("\nSequence length: %d samples (%g s)\n",L,L / Rate);
+		if (NC > 1)
+			printf("Channel shift: %d samples\n",Shift);
+		printf("Total sequence length: %d samples\n",FL);
+		printf("Total sequence file size: %lu bytes\n\n",
+			(unsigned long) (sizeof(float) * FL * NC));
+		fflush(stdout);
+
+		S = (unsigned char *) malloc(L);
+		FB = (float *) malloc(sizeof(float) * GenBlockLen * NC);
+		if (S == NULL || FB == NULL)
+			{
+				free(S);
+				free(FB);
+				sputs("Memory allocation failure.");
+				return 1;
+			}
+		MLSGenerate(Order,S);
+
+		sputsp("Opening sequence file: ", MLSFile);
+		if ((OF = fopen(MLSFile,"wb")) == NULL)
+			{
+				perror("Unable to open sequence file");
+				free(S);
+				free(FB);
+				return 1;
+			}
+
+		sputs("Generating the sequence file...");
+		for (F = 0;F < FL;F += GenBlockLen)
+			{
+				BL = (FL - F < GenBlockLen) ? FL - F : GenBlockLen;
+				for (I = 0;I < BL;I++)
+					for (C = 0;C < NC;C++)
+						FB[I * NC + C] = (float) (Amplitude *
+							(1 - 2 * S[(F + I + L - C * Shift) % L]));
+				fwrite(FB,sizeof(float) * NC,BL,OF);
+			}
+
+		free(S);
+		free(FB);
+		if (fclose(OF) != 0)
+			{
+				perror("Unable to write sequence file");
+				return 1;
+			}
+		sputs("Sequence file generated.");
+		return 0;
+	}
+
 /* Main procedure */
 int main(int argc, char * argv[])
 	{
@@ -116,14 +252,12 @@ int main(int argc, char * argv[])
 		DLReal W1;
 		DLReal W2;
 		DLReal Ratio;
-		DLReal Sample;
 		DLReal S1;
 		DLReal S2;
 		DLReal DecayTime;
 		DLReal Decay;
 		int I;
 		int J;
-		float FS;
 
 		/* Sweep normalization factor */
 		DLReal SNF;
@@ -137,8 +271,28 @@ int main(int argc, char * argv[])
 		DLReal WC2Out;
 		DLReal WC;
 
-		/* Output file */
+		/* Block generation */
+		int B;
+		int BL;
+		int IS;
+		DLReal E;
+		DLReal ES2;
+		DLReal DecayStep;
+		DLReal Raw[GenBlockLen];
+		float SB[GenBlockLen];
+		float IB[GenBlockLen];
+
+		/* Output files */
 		FILE * OF;
+		FILE * IF;
+		FILE * MF;
+
+		/* Multiple channels and MLS options */
+		int AO;
+		int NChannels;
+		DLReal Delay;
+		int MLSOrder;
+		int Periods;
 
 		/* Initial message */
 		sputs("\nGLSweep 1.1.0: log sweep and inverse filter generation.");
@@ -152,12 +306,46 @@ int main(int argc, char * argv[])
 		sputs("the GNU GPL and is provided to you as is, without any warranty");
 		sputs("of any kind. Please read the file \"COPYING\" for details.");
 
+		/* Options parsing */
+		NChannels = 1;
+		Delay = (DLReal) 0.0;
+		MLSOrder = 0;
+		Periods = 2;
+		for (AO = 1;AO < argc && argv[AO][0] == '-' && argv[AO][1] == '-';AO++)
+			{
+				if (strncmp(argv[AO],"--channels=",11) == 0)
+					NChannels = atoi(&argv[AO][11]);
+				else if (strncmp(argv[AO],"--delay=",8) == 0)
+					Delay = (DLReal) atof(&argv[AO][8]);
+				else if (strncmp(argv[AO],"--mls=",6) == 0)
+					MLSOrder = atoi(&argv[AO][6]);
+				else if (strncmp(argv[AO],"--periods=",10) == 0)
+					Periods = atoi(&argv[AO][10]);
+				else
+					{
+						sputsp("\nUnknown option: ",argv[AO]);
+						return 1;
+					}
+			}
+		argc -= AO - 1;
+		argv += AO - 1;
+
 		/* Check program arguments */
-		if (argc < 11)
+		if ((MLSOrder == 0 && argc < 11) || (MLSOrder != 0 && argc < 4))
 			{
-				sputs("\nUsage: glsweep rate amplitude hzstart hzend duration silence");
+				sputs("\nUsage: glsweep [options] rate amplitude hzstart hzend duration silence");
 				sputs("        leadin leadout sweepfile inversefile");
+				sputs("       glsweep --mls=order [options] rate amplitude mlsfile");
 				sputs("\nParameters:\n");
+				sputs("  options: optional settings:");
+				sputs("    --channels=N: writes an N channels interleaved excitation file,");
+				sputs("      for the measurement of N channels with a single recording");
+				sputs("    --delay=D: delay between the sweeps of consecutive channels");
+				sputs("      in seconds, longer than the impulse response to measure");
+				sputs("    --mls=order: generates a maximum length sequence of length");
+				sputs("      2^order - 1 instead of a sweep, shifted by one N-th of its");
+				sputs("      length on each channel");
+				sputs("    --periods=P: number of sequence periods, default 2");
 				sputs("  rate: reference sample rate");
 				sputs("  amplitude: sweep amplitude");
 				sputs("  hzstart: sweep start frequency");
@@ -168,10 +356,33 @@ int main(int argc, char * argv[])
 				sputs("  leadout: trailing window length as a fraction of duration");
 				sputs("  sweepfile: sweep file name");
 				sputs("  inversefile: inverse sweep file name");
-				sputs("\nExample: glsweep 44100 0.5 10 21000 45 2 0.05 0.005 sweep.pcm inverse.pcm\n");
+				sputs("  mlsfile: maximum length sequence file name");
+				sputs("\nExample: glsweep 44100 0.5 10 21000 45 2 0.05 0.005 sweep.pcm inverse.pcm");
+				sputs("         glsweep --channels=8 --delay=2 44100 0.5 10 21000 45 2 0.05 0.005 sweep.pcm inverse.pcm");
+				sputs("         glsweep --mls=18 44100 0.5 mls.pcm\n");
 				return 0;
 			}
 
+		/* Options check */
+		if (NChannels < 1 || (NChannels > 1 && MLSOrder == 0 && Delay <= (DLReal) 0.0))
+			{
+				sputs("\nMultiple channels require a positive sweep delay.");
+				return 1;
+			}
+
+		/* Maximum length sequence generation */
+		if (MLSOrder != 0)
+			{
+				if (MLSLength(MLSOrder) == 0 || Periods < 2)
+					{
+						printf("\nThe sequence order must be between %d and %d, with at least two periods.\n",
+							MLSMinOrder,MLSMaxOrder);
+						return 1;
+					}
+				return GenerateMLS(MLSOrder,(DLReal) atof(argv[1]),(DLReal) atof(argv[2]),
+					Periods,NChannels,argv[3]);
+			}
+
 		/* Get the input parameters from the command line */
 		sputs("\nCommand line parsing.");
 		Rate = (DLReal) atof(argv[1]);
@@ -215,112 +426,168 @@ int main(int argc, char * argv[])
     printf("Total inverse file size: %d bytes\n\n",sizeof(float) * SweepLen);
     fflush(stdout);
 
-		/* Open the sweep file */
-		sputsp("Opening sweep file: ", SweepFile);
-		if ((OF = fopen(SweepFile,"wb")) == NULL)
-			{
-				perror("Unable to open sweep file");
-				return 1;
-			}
+		/* Computes the sweep normalization factor */
 
-		/* Generates the sweep file */
-		sputs("Generating the sweep file...");
+		/* Number of octaves involved */
+		SNF = (DLReal) (log(HzEnd/HzStart) / log(2.0));
 
-		/* Initial silence */
-		FS = (DLReal) 0.0;
-		for (I = 0;I < SilenceLen;I++)
-			fwrite(&FS,sizeof(float),1,OF);
+		/* Bandwidth and exponential decay compensation */
+		SNF = (DLReal) ((2.0 * (HzEnd - HzStart) / Rate) * (log(4.0) * SNF / (1 - pow(2.0,-SNF))) / SweepLen);
+
+		/* Report the normalization factor */
+		printf("Sweep normalizaton factor: %g\n",SNF);
+		fflush(stdout);
 
-		/* Initial lead in */
-		for (I = 0;I < LeadInLen;I++)
+		/* Open the sweep and inverse files, with multiple channels
+		the sweep is generated first on a temporary file */
+		if (NChannels > 1)
 			{
-				Sample = (DLReal) DLSin(S1 * (exp(I * S2) - 1.0));
-				WC = (DLReal) (0.42 - 0.5 * DLCos(WC1In * I) + 0.08 * DLCos(WC2In * I));
-				FS = (float) (Sample * WC * Amplitude);
-				fwrite(&FS,sizeof(float),1,OF);
+				printf("Channels: %d, sweep delay: %d samples\n",NChannels,(int) (Rate * Delay));
+				printf("Total multichannel sweep length: %d samples\n",
+					2 * SilenceLen + SweepLen + (NChannels - 1) * (int) (Rate * Delay));
+				fflush(stdout);
+				OF = tmpfile();
 			}
-
-		/* Full sweep */
-		for (I = LeadInLen;I < SweepLen - LeadOutLen;I++)
+		else
 			{
-				Sample = (DLReal) DLSin(S1 * (exp(I * S2) - 1.0));
-				FS = (float) (Sample * Amplitude);
-				fwrite(&FS,sizeof(float),1,OF);
+				sputsp("Opening sweep file: ", SweepFile);
+				OF = fopen(SweepFile,"wb");
 			}
-
-		/* Final lead out */
-		for (I = SweepLen - LeadOutLen,J = LeadOutLen;I < SweepLen;I++,J--)
+		if (OF == NULL)
 			{
-				Sample = (DLReal) DLSin(S1 * (exp(I * S2) - 1.0));
-				WC = (DLReal) (0.42 - 0.5 * DLCos(WC1Out * J) + 0.08 * DLCos(WC2Out * J));
-				FS = (float) (Sample * WC * Amplitude);
-				fwrite(&FS,sizeof(float),1,OF);
+				perror("Unable to open sweep file");
+				return 1;
 			}
-
-		/* Final silence */
-		FS = (DLReal) 0.0;
-		for (I = 0;I < SilenceLen;I++)
-			fwrite(&FS,sizeof(float),1,OF);
-
-		/* Close the sweep file */
-		sputs("Sweep file generated.");
-		fclose(OF);
-
-		/* Computes the sweep normalization factor */
-
-		/* Number of octaves involved */
-		SNF = (DLReal) (log(HzEnd/HzStart) / log(2.0));
-
-		/* Bandwidth and exponential decay compensation */
-		SNF = (DLReal) ((2.0 * (HzEnd - HzStart) / Rate) * (log(4.0) * SNF / (1 - pow(2.0,-SNF))) / SweepLen);
-
-		/* Report the normalization factor */
-		printf("Sweep normalizaton factor: %g\n",SNF);
-		fflush(stdout);
-
-		/* Open the inverse file */
 		sputsp("Opening inverse file: ", InverseFile);
-		if ((OF = fopen(InverseFile,"wb")) == NULL)
+		if ((IF = fopen(InverseFile,"wb")) == NULL)
 			{
 				perror("Unable to open inverse file");
+				fclose(OF);
 				return 1;
 			}
 
-		/* Generates the sweep file */
-		sputs("Generating the inverse file...");
+		/* Generates the sweep and inverse files */
+		sputs("Generating the sweep and inverse files...");
 
-		/* Final lead out */
-		for (I = 0,J = SweepLen;I < LeadOutLen;I++,J--)
+		/* Initial silence */
+		for (I = 0;I < GenBlockLen;I++)
+			SB[I] = (float) 0.0;
+		for (I = 0;I < SilenceLen;I += GenBlockLen)
+			fwrite(SB,sizeof(float),(SilenceLen - I < GenBlockLen) ? SilenceLen - I : GenBlockLen,OF);
+
+		/* Recurrence factors for the exponential phase and the inverse decay */
+		ES2 = (DLReal) exp(S2);
+		DecayStep = (DLReal) pow(0.5,-1.0 / DecayTime);
+
+		/* The inverse is the time reversed sweep, sample I of the
+		inverse uses the sweep sample SweepLen - I, so the sweep is
+		generated from 0 to SweepLen included */
+		for (B = 0;B <= SweepLen;B += GenBlockLen)
 			{
-				Decay = (DLReal) pow(0.5,I / DecayTime);
-				Sample = (DLReal) DLSin(S1 * (exp(J * S2) - 1.0));
-				WC = (DLReal) (0.42 - 0.5 * DLCos(WC1Out * I) + 0.08 * DLCos(WC2Out * I));
-				FS = (float) (SNF * Sample * WC * Decay);
-				fwrite(&FS,sizeof(float),1,OF);
+				BL = (SweepLen + 1 - B < GenBlockLen) ? SweepLen + 1 - B : GenBlockLen;
+
+				/* Sweep phase, the exponential is computed by recurrence
+				and evaluated exactly every ExpAnchorLen samples */
+				E = (DLReal) exp(B * S2);
+				for (I = 0;I < BL;I++)
+					{
+						if (I > 0 && (I % ExpAnchorLen) == 0)
+							E = (DLReal) exp((B + I) * S2);
+						Raw[I] = S1 * (E - (DLReal) 1.0);
+						E *= ES2;
+					}
+
+				/* Sweep samples */
+				for (I = 0;I < BL;I++)
+					Raw[I] = (DLReal) DLSin(Raw[I]);
+
+				/* Sweep output with lead in and lead out windowing */
+				for (I = 0,J = B;I < BL && J < SweepLen;I++,J++)
+					{
+						if (J < LeadInLen)
+							WC = (DLReal) (0.42 - 0.5 * DLCos(WC1In * J) + 0.08 * DLCos(WC2In * J));
+						else
+							if (J >= SweepLen - LeadOutLen)
+								WC = (DLReal) (0.42 - 0.5 * DLCos(WC1Out * (SweepLen - J)) +
+									0.08 * DLCos(WC2Out * (SweepLen - J)));
+							else
+								WC = (DLReal) 1.0;
+						SB[I] = (float) (Raw[I] * WC * Amplitude);
+					}
+				fwrite(SB,sizeof(float),I,OF);
+
+				/* Inverse output, with decay and windowing, stored
+				reversed at its position in the inverse file */
+				IS = (B == 0) ? 1 : 0;
+				Decay = (DLReal) pow(0.5,(SweepLen - (B + IS)) / DecayTime);
+				for (I = IS,J = B + IS;I < BL;I++,J++)
+					{
+						if (I > IS && ((I - IS) % ExpAnchorLen) == 0)
+							Decay = (DLReal) pow(0.5,(SweepLen - J) / DecayTime);
+						if (J <= LeadInLen)
+							WC = (DLReal) (0.42 - 0.5 * DLCos(WC1In * J) + 0.08 * DLCos(WC2In * J));
+						else
+							if (J > SweepLen - LeadOutLen)
+								WC = (DLReal) (0.42 - 0.5 * DLCos(WC1Out * (SweepLen - J)) +
+									0.08 * DLCos(WC2Out * (SweepLen - J)));
+							else
+								WC = (DLReal) 1.0;
+						IB[BL - 1 - I] = (float) (SNF * Raw[I] * WC * Decay);
+						Decay *= DecayStep;
+					}
+				if (BL > IS)
+					{
+						fseek(IF,(long) (sizeof(float) * (SweepLen - (B + BL - 1))),SEEK_SET);
+						fwrite(IB,sizeof(float),BL - IS,IF);
+					}
 			}
 
-		/* Full sweep */
-		for (I = LeadOutLen,J = SweepLen - LeadOutLen;I < SweepLen - LeadInLen;I++,J--)
+		/* Final silence */
+		for (I = 0;I < GenBlockLen;I++)
+			SB[I] = (float) 0.0;
+		for (I = 0;I < SilenceLen;I += GenBlockLen)
+			fwrite(SB,sizeof(float),(SilenceLen - I < GenBlockLen) ? SilenceLen - I : GenBlockLen,OF);
+
+		/* Writes the delayed sweep on each channel */
+		if (NChannels > 1)
 			{
-				Decay = (DLReal) pow(0.5,I / DecayTime);
-				Sample = (DLReal) DLSin(S1 * (exp(J * S2) - 1.0));
-				FS = (float) (SNF * Sample * Decay);
-				fwrite(&FS,sizeof(float),1,OF);
+				MF = OF;
+				sputsp("Opening sweep file: ", SweepFile);
+				if ((OF = fopen(SweepFile,"wb")) == NULL)
+					{
+						perror("Unable to open sweep file");
+						fclose(MF);
+						fclose(IF);
+						return 1;
+					}
+				sputs("Writing the multichannel sweep file...");
+				fflush(MF);
+				if (WriteChannels(MF,2 * SilenceLen + SweepLen,NChannels,
+					(int) (Rate * Delay),OF) != 0)
+					{
+						sputs("Multichannel sweep file generation failed.");
+						fclose(MF);
+						fclose(OF);
+						fclose(IF);
+						return 1;
+					}
+				fclose(MF);
 			}
 
-		/* Initial lead in */
-		for (I = SweepLen - LeadInLen,J = LeadInLen;I < SweepLen;I++,J--)
+		/* Close the sweep and inverse files */
+		if (fclose(OF) != 0)
+			{
+				perror("Unable to write sweep file");
+				fclose(IF);
+				return 1;
+			}
+		sputs("Sweep file generated.");
+		if (fclose(IF) != 0)
 			{
-				Decay = (DLReal) pow(0.5,I / DecayTime);
-				Sample = (DLReal) DLSin(S1 * (exp(J * S2) - 1.0));
-				WC = (DLReal) (0.42 - 0.5 * DLCos(WC1In * J) + 0.08 * DLCos(WC2In * J));
-				FS = (float) (SNF * Sample * WC * Decay);
-				fwrite(&FS,sizeof(float),1,OF);
+				perror("Unable to write inverse file");
+				return 1;
 			}
-
-		/* Close the inverse file */
 		sputs("Inverse file generated.");
-		fclose(OF);
 
 		/* Execution completed */
 		return 0;
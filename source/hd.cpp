@@ -30,7 +30,10 @@
 #include "fft.h"
 #include "baselib.h"
 #include "level.h"
+#include "dspalloc.h"
+#include "splitcpx.h"
 #include <math.h>
+#include <limits>
 
 /* Memory leaks debugger */
 #ifdef DebugMLeaks
@@ -38,16 +41,16 @@
 #endif
 
 /* Effettua la deconvoluzione omomorfa del segnale In */
-/* Versione basata sul calcolo del Cepstrum */
-Boolean CepstrumHD(const DLReal * In, DLReal * MPOut, DLReal * EPOut,
-	const int N, const int MExp)
+/* Versione basata sul calcolo del Cepstrum, modello sul tipo floating point */
+template <class T>
+static Boolean TCepstrumHD(const T * In, T * MPOut, T * EPOut,
+	const int N, const int MExp, std::complex<T> * InFFT)
 	{
-		DLComplex * FFTArray1;
-		DLComplex * FFTArray2;
+		std::complex<T> * FFTArray;
+		SCSpectrum<T> S1;
+		SCSpectrum<T> S2;
 		int FS;
 		int I;
-		Boolean LogLimit;
-		DLReal CV;
 
 		/* Controlla se si deve adottare una potenza di due */
 		if (MExp >= 0)
@@ -59,104 +62,154 @@ Boolean CepstrumHD(const DLReal * In, DLReal * MPOut, DLReal * EPOut,
 		else
 			FS = N;
 
-		/* Alloca gli array per l'FFT */
-		if ((FFTArray1 = new DLComplex[FS]) == NULL)
+		/* Alloca l'array per l'FFT e gli spettri in formato separato,
+		usando se disponibile la trasformata del segnale gi calcolata */
+		if (InFFT != NULL)
+			FFTArray = InFFT;
+		else
+			if ((FFTArray = (std::complex<T> *) DSPAlloc(FS * sizeof(std::complex<T>))) == NULL)
+				return False;
+		if (SCAlloc(S1,FS) == False)
 			return False;
-		if ((FFTArray2 = new DLComplex[FS]) == NULL)
+		if (SCAlloc(S2,FS) == False)
 			return False;
 
-		/* Copia l'array sorgente in quello temporaneo */
-		for (I = 0;I < N;I++)
-			FFTArray1[I] = In[I];
+		/* Verifica se si deve calcolare la trasformata del segnale */
+		if (InFFT == NULL)
+			{
+				/* Copia l'array sorgente in quello temporaneo */
+				for (I = 0;I < N;I++)
+					FFTArray[I] = In[I];
 
-		/* Azzera la parte rimanente */
-		for (I = N;I < FS;I++)
-			FFTArray1[I] = 0;
+				/* Azzera la parte rimanente */
+				for (I = N;I < FS;I++)
+					FFTArray[I] = 0;
 
-		/* Trasforma l'array risultante */
-		Fft(FFTArray1,FS);
-
-		/* Calcola i valori per il cepstrum */
-		LogLimit = False;
-		for (I = 0;I < FS;I++)
-			{
-				CV = std::abs<DLReal>(FFTArray1[I]);
-				if (CV <= 0)
-					{
-						LogLimit = True;
-						FFTArray2[I] = (DLReal) log(DRCMinFloat);
-					}
-				else
-					FFTArray2[I] = std::log<DLReal>(CV);
+				/* Trasforma l'array risultante */
+				TFft(FFTArray,FS);
 			}
+		SCSplit(FFTArray,S1);
 
-		/* Verifica se si  raggiunto il limite */
-		if (LogLimit == True)
+		/* Calcola i valori per il cepstrum */
+		if (SCLogAbs(S1,S2.Re,std::numeric_limits<T>::min()) == True)
 			sputs("Notice: log limit reached in cepstrum computation.");
+		for (I = 0;I < FS;I++)
+			FFTArray[I] = S2.Re[I];
 
 		/* Calcola il cepstrum */
-		IFft(FFTArray2,FS);
+		TIFft(FFTArray,FS);
 
 		/* Finestra il cepstrum */
 		for (I = 1; I < FS/2;I++)
-			FFTArray2[I] *= 2;
+			FFTArray[I] *= 2;
 		for (I = FS/2 + 1; I < FS;I++)
-			FFTArray2[I] = 0;
+			FFTArray[I] = 0;
 
 		/* Calcola la trsformata del cepstrum finestrato */
-		Fft(FFTArray2,FS);
+		TFft(FFTArray,FS);
 
 		/* Effettua il calcolo dell'esponenziale */
-		for (I = 0;I < FS;I++)
-			FFTArray2[I] = std::exp<DLReal>(FFTArray2[I]);
+		SCSplit(FFTArray,S2);
+		SCExp(S2);
 
-		/* Verifica se deve estrarre la componente EP */
-		if (EPOut != NULL)
+		/* Verifica se deve estrarre la componente MP */
+		if (MPOut != NULL)
 			{
-				/* Determina la trasformata della parte excess phase */
-				for (I = 0;I < FS;I++)
-					FFTArray1[I] = std::polar((DLReal) 1.0,
-						std::arg(FFTArray1[I]) - std::arg(FFTArray2[I]));
-
-				/* Determina la risposta del sistema excess phase */
-				IFft(FFTArray1,FS);
+				/* Determina la risposta del sistema a fase minima */
+				SCMerge(S2,FFTArray);
+				TIFft(FFTArray,FS);
 
 				/* Copia il risultato nell'array destinazione */
 				for (I = 0;I < N;I++)
-					EPOut[I] = std::real<DLReal>(FFTArray1[I]);
+					MPOut[I] = std::real<T>(FFTArray[I]);
 			}
 
-		/* Verifica se deve estrarre la componente MP */
-		if (MPOut != NULL)
+		/* Verifica se deve estrarre la componente EP */
+		if (EPOut != NULL)
 			{
-				/* Determina la risposta del sistema a fase minima */
-				IFft(FFTArray2,FS);
+				/* Determina la trasformata della parte excess phase,
+				con fase pari alla differenza delle fasi */
+				SCConjMul(S1,S2,S1);
+				SCUnit(S1);
+				SCMerge(S1,FFTArray);
+
+				/* Determina la risposta del sistema excess phase */
+				TIFft(FFTArray,FS);
 
 				/* Copia il risultato nell'array destinazione */
 				for (I = 0;I < N;I++)
-					MPOut[I] = std::real<DLReal>(FFTArray2[I]);
+					EPOut[I] = std::real<T>(FFTArray[I]);
 			}
 
 		/* Dealloca gli array */
-		delete[] FFTArray1;
-		delete[] FFTArray2;
+		SCFree(S1);
+		SCFree(S2);
+		if (InFFT == NULL)
+			DSPFree(FFTArray);
 
 		/* Operazione completata */
 		return True;
 	}
 
+/* Effettua la deconvoluzione omomorfa del segnale In */
+/* Versione basata sul calcolo del Cepstrum */
+Boolean CepstrumHD(const DLReal * In, DLReal * MPOut, DLReal * EPOut,
+	const int N, const int MExp, DLComplex * InFFT)
+	{
+		return TCepstrumHD<DLReal>(In,MPOut,EPOut,N,MExp,InFFT);
+	}
+
+/* Versione con precisione di calcolo Prec */
+Boolean CepstrumHD(const DLReal * In, DLReal * MPOut, DLReal * EPOut,
+	const int N, const int MExp, const DLPrecisionType Prec)
+	{
+		DLAltReal * AIn;
+		DLAltReal * AMPOut;
+		DLAltReal * AEPOut;
+		Boolean Res;
+		int I;
+
+		if (DLUseAltReal(Prec) == False)
+			return TCepstrumHD<DLReal>(In,MPOut,EPOut,N,MExp,NULL);
+
+		/* Alloca gli array nella precisione alternativa */
+		if ((AIn = (DLAltReal *) DSPAlloc(3 * N * sizeof(DLAltReal))) == NULL)
+			return False;
+		AMPOut = (MPOut != NULL) ? &AIn[N] : NULL;
+		AEPOut = (EPOut != NULL) ? &AIn[2 * N] : NULL;
+
+		for (I = 0;I < N;I++)
+			AIn[I] = In[I];
+
+		Res = TCepstrumHD<DLAltReal>(AIn,AMPOut,AEPOut,N,MExp,NULL);
+
+		/* Riporta il risultato nella precisione di compilazione */
+		if (Res == True)
+			{
+				if (MPOut != NULL)
+					for (I = 0;I < N;I++)
+						MPOut[I] = (DLReal) AMPOut[I];
+				if (EPOut != NULL)
+					for (I = 0;I < N;I++)
+						EPOut[I] = (DLReal) AEPOut[I];
+			}
+
+		DSPFree(AIn);
+		return Res;
+	}
+
 /* Effettua la deconvoluzione omomorfa del segnale In */
 /* Versione basata sulla trasformata di Hilbert */
 Boolean HilbertHD(const DLReal * In, DLReal * MPOut, DLReal * EPOut,
 	const int N,const int MExp)
 	{
-		DLComplex * FFTArray1;
-		DLComplex * FFTArray2;
-		DLReal * FFTArray3;
+		DLComplex * FFTArray;
+		DLReal * AbsArray;
+		SCSpectrum<DLReal> S1;
+		SCSpectrum<DLReal> S2;
 		int FS;
 		int I;
 		Boolean LogLimit;
-		DLReal CV;
 
 		/* Controlla se si deve adottare una potenza di due */
 		if (MExp >= 0)
@@ -168,93 +221,93 @@ Boolean HilbertHD(const DLReal * In, DLReal * MPOut, DLReal * EPOut,
 		else
 			FS = N;
 
-		/* Alloca gli array per l'FFT */
-		if ((FFTArray1 = new DLComplex[FS]) == NULL)
+		/* Alloca gli array per l'FFT e gli spettri in formato separato */
+		if ((FFTArray = DSPComplexAlloc(FS)) == NULL)
 			return False;
-		if ((FFTArray2 = new DLComplex[FS]) == NULL)
+		if ((AbsArray = DSPRealAlloc(FS)) == NULL)
+			return False;
+		if (SCAlloc(S1,FS) == False)
 			return False;
-		if ((FFTArray3 = new DLReal[FS]) == NULL)
+		if (SCAlloc(S2,FS) == False)
 			return False;
 
 		/* Copia l'array sorgente in quello temporaneo */
 		for (I = 0;I < N;I++)
-			FFTArray1[I] = In[I];
+			FFTArray[I] = In[I];
 
 		/* Azzera la parte rimanente */
 		for (I = N;I < FS;I++)
-			FFTArray1[I] = 0;
+			FFTArray[I] = 0;
 
 		/* Trasforma l'array risultante */
-		Fft(FFTArray1,FS);
+		Fft(FFTArray,FS);
+		SCSplit(FFTArray,S1);
 
 		/* Calcola i valori per la trasformata di Hilbert */
+		SCAbs(S1,AbsArray);
 		LogLimit = False;
 		for (I = 0;I < FS;I++)
-			{
-				CV = std::abs<DLReal>(FFTArray1[I]);
-				if (CV <= DRCMinFloat)
-					{
-						LogLimit = True;
-						FFTArray2[I] = (DLReal) log(DRCMinFloat);
-						FFTArray3[I] = DRCMinFloat;
-					}
-				else
-					{
-						FFTArray2[I] = std::log<DLReal>(CV);
-						FFTArray3[I] = CV;
-					}
-			}
+			if (AbsArray[I] <= DRCMinFloat)
+				{
+					LogLimit = True;
+					AbsArray[I] = DRCMinFloat;
+				}
+		SCRealLog(AbsArray,FFTArray,FS);
 
 		/* Verifica se si  raggiunto il limite */
 		if (LogLimit == True)
 			sputs("Notice: log limit reached in Hilbert computation.");
 
 		/* Calcola la fase per la componente a fase minima */
-		IFft(FFTArray2,FS);
+		IFft(FFTArray,FS);
 		for (I = 1 + FS / 2; I < FS;I++)
-			FFTArray2[I] = -FFTArray2[I];
-		FFTArray2[0] = 0;
-		FFTArray2[FS / 2] = 0;
-		Fft(FFTArray2,FS);
+			FFTArray[I] = -FFTArray[I];
+		FFTArray[0] = 0;
+		FFTArray[FS / 2] = 0;
+		Fft(FFTArray,FS);
 
 		/* Effettua la convoluzione per l'estrazione del sistema
 		a fase minima */
-		for (I = 0; I < FS;I++)
-			FFTArray2[I] = FFTArray3[I] * std::exp<DLReal>(FFTArray2[I]);
+		SCSplit(FFTArray,S2);
+		SCExp(S2);
+		SCScale(S2,AbsArray);
 
 		/* Dealloca gli array */
-		delete[] FFTArray3;
+		DSPFree(AbsArray);
 
-		/* Verifica se deve estrarre la componente EP */
-		if (EPOut != NULL)
+		/* Verifica se deve estrarre la componente MP */
+		if (MPOut != NULL)
 			{
-				/* Determina la trasformata della parte excess phase */
-				for (I = 0;I < FS;I++)
-					FFTArray1[I] = std::polar((DLReal) 1.0,
-						std::arg(FFTArray1[I]) - std::arg(FFTArray2[I]));
-
-				/* Determina la risposta del sistema excess phase */
-				IFft(FFTArray1,FS);
+				/* Determina la risposta del sistema a fase minima */
+				SCMerge(S2,FFTArray);
+				IFft(FFTArray,FS);
 
 				/* Copia il risultato nell'array destinazione */
 				for (I = 0;I < N;I++)
-					EPOut[I] = std::real<DLReal>(FFTArray1[I]);
+					MPOut[I] = std::real<DLReal>(FFTArray[I]);
 			}
 
-		/* Verifica se deve estrarre la componente MP */
-		if (MPOut != NULL)
+		/* Verifica se deve estrarre la componente EP */
+		if (EPOut != NULL)
 			{
-				/* Determina la risposta del sistema a fase minima */
-				IFft(FFTArray2,FS);
+				/* Determina la trasformata della parte excess phase,
+				con fase pari alla differenza delle fasi */
+				SCConjMul(S1,S2,S1);
+				SCUnit(S1);
+				SCMerge(S1,FFTArray);
+
+				/* Determina la risposta del sistema excess phase */
+				IFft(FFTArray,FS);
 
 				/* Copia il risultato nell'array destinazione */
 				for (I = 0;I < N;I++)
-					MPOut[I] = std::real<DLReal>(FFTArray2[I]);
+					EPOut[I] = std::real<DLReal>(FFTArray[I]);
 			}
 
 		/* Dealloca gli array */
-		delete[] FFTArray1;
-		delete[] FFTArray2;
+		SCFree(S1);
+		SCFree(S2);
+		DSPFree(FFTArray);
 
 		/* Operazione completata */
 		return True;
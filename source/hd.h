@@ -33,8 +33,16 @@
 
 	/* Effettua la deconvoluzione omomorfa del segnale In */
 	/* Versione basata sul calcolo del Cepstrum */
+	/* Se InFFT non  NULL contiene la trasformata del segnale In sulla
+	dimensione determinata da MExp, che viene usata ed alterata al posto
+	della trasformata del segnale */
 	Boolean CepstrumHD(const DLReal * In, DLReal * MPOut, DLReal * EPOut,
-		const int N, const int MExp);
+		const int N, const int MExp, DLComplex * InFFT = NULL);
+
+	/* Versione con precisione di calcolo Prec, ingresso ed uscita restano
+	nella precisione di compilazione */
+	Boolean CepstrumHD(const DLReal * In, DLReal * MPOut, DLReal * EPOut,
+		const int N, const int MExp, const DLPrecisionType Prec);
 
 	/* Effettua la deconvoluzione omomorfa del segnale In */
 	/* Versione basata sulla trasformata di Hilbert */
@@ -33,6 +33,8 @@
 #include "slprefilt.h"
 #include "bwprefilt.h"
 #include "convol.h"
+#include "dspalloc.h"
+#include "splitcpx.h"
 #include <math.h>
 
 /* Memory leaks debugger */
@@ -53,13 +55,19 @@ Boolean KirkebyFDInvert(const DLReal * InSig, int InSigLen,DLReal * InvFilter,
 
 		/* Array FFT */
 		DLComplex * FFTArray1;
-		DLComplex * FFTArray2;
+		DLComplex * FFTArray2 = NULL;
+
+		/* Spettro in formato separato */
+		SCSpectrum<DLReal> S;
+
+		/* Regolarizzazione in frequenza */
+		DLReal * RegArray = NULL;
 
 		/* Livello RMS segnale in ingresso */
 		DLReal IRMS;
 
 		/* Livello massimo del segnale di effort */
-		DLReal EMax;
+		DLReal EMax = 0;
 
 		/* Indice generico */
 		int I = 0;
@@ -85,11 +93,13 @@ Boolean KirkebyFDInvert(const DLReal * InSig, int InSigLen,DLReal * InvFilter,
 			FS = SigLen;
 
 		/* Alloca gli array per l'FFT */
-		if ((FFTArray1 = new DLComplex[FS]) == NULL)
+		if ((FFTArray1 = DSPComplexAlloc(FS)) == NULL)
 			return False;
 		if (EffortSig != NULL)
-			if ((FFTArray2 = new DLComplex[FS]) == NULL)
+			if ((FFTArray2 = DSPComplexAlloc(FS)) == NULL)
 				return False;
+		if (SCAlloc(S,FS) == False)
+			return False;
 
 		/* Copia l'array sorgente in quello temporaneo */
 		for (I = 0;I < InSigLen;I++)
@@ -112,12 +122,17 @@ Boolean KirkebyFDInvert(const DLReal * InSig, int InSigLen,DLReal * InvFilter,
 				/* Porta nel dominio della frequenza */
 				Fft(FFTArray2,FS);
 
+				/* Calcola il quadrato del modulo dell'array effort, usando
+				l'array per l'FFT come memoria */
+				SCSplit(FFTArray2,S);
+				RegArray = (DLReal *) FFTArray2;
+				SCNorm(S,RegArray);
+
 				/* Calcola il valore massimo dell'array effort */
 				EMax = 0;
 				for (I = 0;I < FS;I++)
-					if (std::abs(FFTArray2[I]) > EMax)
-						EMax = std::abs(FFTArray2[I]);
-				EMax *= EMax;
+					if (RegArray[I] > EMax)
+						EMax = RegArray[I];
 
 				/* Riscala il fattore di effort */
 				EffortFactor /= EMax;
@@ -133,19 +148,17 @@ Boolean KirkebyFDInvert(const DLReal * InSig, int InSigLen,DLReal * InvFilter,
 		EffortFactor *= IRMS * IRMS;
 
 		/* Effettua la fast deconvolution */
+		SCSplit(FFTArray1,S);
 		if (EffortSig != NULL)
 			{
 				for (I = 0;I < FS;I++)
-					FFTArray1[I] = std::conj<DLReal>(FFTArray1[I]) /
-						(FFTArray1[I] * std::conj<DLReal>(FFTArray1[I]) +
-						EffortFactor * (EMax - FFTArray2[I] * std::conj<DLReal>(FFTArray2[I])));
+					RegArray[I] = EffortFactor * (EMax - RegArray[I]);
+				SCRegInverse(S,RegArray,(DLReal) 0.0);
 			}
 		else
-			{
-				for (I = 0;I < FS;I++)
-					FFTArray1[I] = std::conj<DLReal>(FFTArray1[I]) /
-						(FFTArray1[I] * std::conj<DLReal>(FFTArray1[I]) + EffortFactor);
-			}
+			SCRegInverse(S,(DLReal *) NULL,EffortFactor);
+		SCMerge(S,FFTArray1);
+		SCFree(S);
 
 		/* Ritorna nel dominio del tempo */
 		IFft(FFTArray1,FS);
@@ -155,9 +168,9 @@ Boolean KirkebyFDInvert(const DLReal * InSig, int InSigLen,DLReal * InvFilter,
 			InvFilter[I] = std::real<DLReal>(FFTArray1[J]);
 
 		/* Dealloca gli array temporanei */
-		delete[] FFTArray1;
+		DSPFree(FFTArray1);
 		if (EffortSig != NULL)
-			delete[] FFTArray2;
+			DSPFree(FFTArray2);
 
 		/* Operazione completata */
 		return True;
@@ -178,11 +191,18 @@ Boolean PEISMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 		DLComplex * FFTArray1;
 		DLComplex * FFTArray2;
 
+		/* Spettri in formato separato */
+		SCSpectrum<DLReal> SE;
+		SCSpectrum<DLReal> SM;
+
 		/* Valore massimo e minimo componente EP */
 		DLReal * AEPAbs;
 		DLReal EPAbs;
 		DLReal EMax;
 
+		/* Fase della componente ritardata */
+		DLReal Ph;
+
 		/* Indici generici */
 		int I;
 		int J;
@@ -210,6 +230,8 @@ Boolean PEISMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 			return False;
 		if ((FFTArray2 = new DLComplex[FS]) == NULL)
 			return False;
+		if (SCAlloc(SE,FS) == False)
+			return False;
 
 		/* Copia l'array sorgente in quello temporaneo */
 		for (I = 0;I < MPSigLen;I++)
@@ -238,8 +260,8 @@ Boolean PEISMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 			return False;
 
 		/* Estrae l'array valori assoluti */
-		for (I = 0;I < FS;I++)
-			AEPAbs[I] = std::abs<DLReal>(FFTArray2[I]);
+		SCSplit(FFTArray2,SE);
+		SCAbs(SE,AEPAbs);
 
 		/* Calcola il valore massimo della componente EP */
 		EMax = 0;
@@ -257,6 +279,7 @@ Boolean PEISMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 
 		/* Effettua la fast deconvolution selettiva
 		della componente EP */
+		SCUnit(SE);
 		for (I = 0;I < FS;I++)
 			{
 				/* Normalizza il valore assoluto */
@@ -276,16 +299,22 @@ Boolean PEISMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 						}
 
 				/* Calcola la trasformata della deconvoluzione selettiva */
-				FFTArray2[I] = std::polar<DLReal>(EPAbs,-std::arg<DLReal>(FFTArray2[I])) +
-					std::polar<DLReal>((DLReal) 1.0 - EPAbs,(I * M_PI * EPSigLen) / FS);
+				Ph = (DLReal) ((I * M_PI * EPSigLen) / FS);
+				SE.Re[I] = EPAbs * SE.Re[I] + ((DLReal) 1.0 - EPAbs) * (DLReal) cos(Ph);
+				SE.Im[I] = ((DLReal) 1.0 - EPAbs) * (DLReal) sin(Ph) - EPAbs * SE.Im[I];
 			}
 
 		/* Dealloca gli array temporanei */
 		delete[] AEPAbs;
 
-		/* Compone l'inverso componente MP e EP */
-		for (I = 0;I < FS;I++)
-		  FFTArray1[I] = std::polar<DLReal>(1,std::arg<DLReal>(FFTArray2[I])) / FFTArray1[I];
+		/* Compone l'inverso componente MP e EP, usando l'array per l'FFT
+		componente EP come memoria per la componente MP */
+		SCUnit(SE);
+		SCAttach(SM,FFTArray2,FS);
+		SCSplit(FFTArray1,SM);
+		SCDiv(SE,SM,SM);
+		SCMerge(SM,FFTArray1);
+		SCFree(SE);
 
 		/* Ritorna nel dominio del tempo */
 		IFft(FFTArray1,FS);
@@ -317,11 +346,18 @@ Boolean PEMSMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 		DLComplex * FFTArray1;
 		DLComplex * FFTArray2;
 
+		/* Spettri in formato separato */
+		SCSpectrum<DLReal> SE;
+		SCSpectrum<DLReal> SM;
+
 		/* Valore massimo e minimo componente EP */
 		DLReal * AEPAbs;
 		DLReal EPAbs;
 		DLReal EMax;
 
+		/* Fase della componente ritardata */
+		DLReal Ph;
+
 		/* Indici generici */
 		int I;
 		int J;
@@ -349,6 +385,8 @@ Boolean PEMSMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 			return False;
 		if ((FFTArray2 = new DLComplex[FS]) == NULL)
 			return False;
+		if (SCAlloc(SE,FS) == False)
+			return False;
 
 		/* Copia l'array sorgente in quello temporaneo */
 		for (I = 0;I < MPSigLen;I++)
@@ -373,8 +411,11 @@ Boolean PEMSMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 		Fft(FFTArray2,FS);
 
 		/* Effettua l'inversione per l'estrazione degli effetti di pre-echo */
+		SCSplit(FFTArray2,SE);
+		SCUnit(SE);
 		for (I = 0;I < FS;I++)
-			FFTArray2[I] = std::polar<DLReal>((DLReal) 1.0,-std::arg<DLReal>(FFTArray2[I]));
+			SE.Im[I] = -SE.Im[I];
+		SCMerge(SE,FFTArray2);
 
 		/* Riporta nel dominio del tempo */
 		IFft(FFTArray2,FS);
@@ -398,8 +439,8 @@ Boolean PEMSMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 		Fft(FFTArray2,FS);
 
 		/* Estrae l'array valori assoluti porzione di pre-echo */
-		for (I = 0;I < FS;I++)
-			AEPAbs[I] = std::abs<DLReal>(FFTArray2[I]);
+		SCSplit(FFTArray2,SE);
+		SCAbs(SE,AEPAbs);
 
 		/* Copia l'array sorgente in quello temporaneo */
 		for (I = 0;I < EPSigLen;I++)
@@ -411,6 +452,7 @@ Boolean PEMSMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 
 		/* Porta nel dominio della frequenza */
 		Fft(FFTArray2,FS);
+		SCSplit(FFTArray2,SE);
 
 		/* Calcola il valore massimo della componente di pre-echo */
 		EMax = 0;
@@ -428,6 +470,7 @@ Boolean PEMSMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 
 		/* Effettua la fast deconvolution selettiva
 		della componente EP */
+		SCUnit(SE);
 		for (I = 0;I < FS;I++)
 			{
 				/* Normalizza il valore assoluto */
@@ -447,16 +490,22 @@ Boolean PEMSMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 						}
 
 				/* Calcola la trasformata della deconvoluzione selettiva */
-				FFTArray2[I] = std::polar<DLReal>((DLReal) EPAbs,-std::arg<DLReal>(FFTArray2[I])) +
-					std::polar<DLReal>(1.0 - EPAbs,(I * M_PI * EPSigLen) / FS);
+				Ph = (DLReal) ((I * M_PI * EPSigLen) / FS);
+				SE.Re[I] = EPAbs * SE.Re[I] + ((DLReal) 1.0 - EPAbs) * (DLReal) cos(Ph);
+				SE.Im[I] = ((DLReal) 1.0 - EPAbs) * (DLReal) sin(Ph) - EPAbs * SE.Im[I];
 			}
 
 		/* Dealloca gli array temporanei */
 		delete[] AEPAbs;
 
-		/* Compone l'inverso componente MP e EP */
-		for (I = 0;I < FS;I++)
-		  FFTArray1[I] = std::polar<DLReal>(1,std::arg<DLReal>(FFTArray2[I])) / FFTArray1[I];
+		/* Compone l'inverso componente MP e EP, usando l'array per l'FFT
+		componente EP come memoria per la componente MP */
+		SCUnit(SE);
+		SCAttach(SM,FFTArray2,FS);
+		SCSplit(FFTArray1,SM);
+		SCDiv(SE,SM,SM);
+		SCMerge(SM,FFTArray1);
+		SCFree(SE);
 
 		/* Ritorna nel dominio del tempo */
 		IFft(FFTArray1,FS);
@@ -473,13 +522,82 @@ Boolean PEMSMPKirkebyFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal *
 		return True;
 	}
 
+/* Composizione dell'inverso per PETFDInvert, con la componente EP
+inversa EPIPERemove di dimensione FS, deallocata durante il calcolo.
+Modello sul tipo floating point usato per il calcolo. */
+template <class T>
+static Boolean PETFDCompose(const DLReal * MPSig, int MPSigLen, DLReal * EPIPERemove,
+	int EPSigLen, DLReal * InvFilter, int InvFilterLen, int FS)
+	{
+		/* Array FFT */
+		std::complex<T> * FFTArray;
+
+		/* Spettri in formato separato */
+		SCSpectrum<T> SE;
+		SCSpectrum<T> SM;
+
+		/* Indici generici */
+		int I;
+		int J;
+
+		/* Alloca l'array per l'FFT */
+		if ((FFTArray = new std::complex<T>[FS]) == NULL)
+			return False;
+
+		/* Copia l'array componente EP in quello per l'FFT */
+		for (I = 0;I < FS;I++)
+			FFTArray[I] = (T) EPIPERemove[I];
+
+		/* Dealloca l'array componente EP */
+		delete[] EPIPERemove;
+
+		/* Porta nel dominio della frequenza */
+		TFft(FFTArray,FS);
+		if (SCAlloc(SE,FS) == False)
+			return False;
+		SCSplit(FFTArray,SE);
+
+		/* Copia l'array sorgente in quello temporaneo */
+		for (I = 0;I < MPSigLen;I++)
+			FFTArray[I] = (T) MPSig[I];
+
+		/* Azzera la parte rimanente */
+		for (I = MPSigLen;I < FS;I++)
+			FFTArray[I] = 0;
+
+		/* Porta nel dominio della frequenza */
+		TFft(FFTArray,FS);
+		if (SCAlloc(SM,FS) == False)
+			return False;
+		SCSplit(FFTArray,SM);
+
+		/* Compone l'inverso componente MP e EP */
+		SCDiv(SE,SM,SE);
+		SCMerge(SE,FFTArray);
+		SCFree(SE);
+		SCFree(SM);
+
+		/* Ritorna nel dominio del tempo */
+		TIFft(FFTArray,FS);
+
+		/* Estrae il filtro inverso */
+		for (I = 0,J = (1 + FS + FS - (MPSigLen + EPSigLen + InvFilterLen) / 2) % FS;I < InvFilterLen;I++,J = (J + 1) % FS)
+			InvFilter[I] = (DLReal) std::real<T>(FFTArray[J]);
+
+		/* Dealloca l'array temporaneo */
+		delete[] FFTArray;
+
+		/* Operazione completata */
+		return True;
+	}
+
 /* Inversione tramite selective minimum pahse fast deconvolution */
 /* Versione a troncatura degli effetti di pre echo */
 Boolean PETFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal * EPSig, int EPSigLen,
 	DLReal * InvFilter,	int InvFilterLen, char PEType, int PELowerWindow, int PEUpperWindow,
 	DLReal PEStartFreq, DLReal PEEndFreq, int PEFilterLen, DLReal FSharpness, int PEBandSplit,
 	DLReal PEWindowExponent, const SLPPrefilteringType SLPType, const DLReal OGainFactor,
-	int SampleRate, int MExp)
+	int SampleRate, int MExp, const DLPrecisionType Prec)
 	{
 		/* Dimensione da considerare per il segnale */
 		int SigLen;
@@ -487,10 +605,6 @@ Boolean PETFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal * EPSig, in
 		/* Dimensione FFT */
 		int FS;
 
-		/* Array FFT */
-		DLComplex * FFTArray1;
-		DLComplex * FFTArray2;
-
 		/* Array rimozione pre-echo */
 		DLReal * EPIPERemove;
 
@@ -592,52 +706,13 @@ Boolean PETFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal * EPSig, in
 					CMPNormFlat(EPIPERemove,FS,(DLReal) 1.0,OGainFactor,-1);
 			}
 
-		/* Alloca l'array per l'FFT componente EP */
-		if ((FFTArray2 = new DLComplex[FS]) == NULL)
-			return False;
-
-		/* Copia l'array componente EP in quello per l'FFT */
-		for (I = 0;I < FS;I++)
-			FFTArray2[I] = EPIPERemove[I];
-
-		/* Dealloca l'array componente EP */
-		delete[] EPIPERemove;
-
-		/* Porta nel dominio della frequenza */
-		Fft(FFTArray2,FS);
-
-		/* Alloca l'array per l'FFT componente MP */
-		if ((FFTArray1 = new DLComplex[FS]) == NULL)
-			return False;
-
-		/* Copia l'array sorgente in quello temporaneo */
-		for (I = 0;I < MPSigLen;I++)
-			FFTArray1[I] = MPSig[I];
-
-		/* Azzera la parte rimanente */
-		for (I = MPSigLen;I < FS;I++)
-			FFTArray1[I] = 0;
-
-		/* Porta nel dominio della frequenza */
-		Fft(FFTArray1,FS);
-
-		/* Compone l'inverso componente MP e EP */
-		for (I = 0;I < FS;I++)
-			FFTArray1[I] = FFTArray2[I] / FFTArray1[I];
-
-		/* Ritorna nel dominio del tempo */
-		IFft(FFTArray1,FS);
-
-		/* Estrae il filtro inverso */
-		for (I = 0,J = (1 + FS + FS - (MPSigLen + EPSigLen + InvFilterLen) / 2) % FS;I < InvFilterLen;I++,J = (J + 1) % FS)
-			InvFilter[I] = std::real<DLReal>(FFTArray1[J]);
-
-		/* Dealloca gli array temporanei */
-		delete[] FFTArray1;
-		delete[] FFTArray2;
-
-		/* Operazione completata */
-		return True;
+		/* Compone l'inverso nella precisione richiesta */
+		if (DLUseAltReal(Prec) == True)
+			return PETFDCompose<DLAltReal>(MPSig,MPSigLen,EPIPERemove,EPSigLen,
+				InvFilter,InvFilterLen,FS);
+		else
+			return PETFDCompose<DLReal>(MPSig,MPSigLen,EPIPERemove,EPSigLen,
+				InvFilter,InvFilterLen,FS);
 	}
 
 /* Experimental, ignore it */
@@ -662,6 +737,7 @@ Boolean MRefPETFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal * EPSig
 		/* Array FFT */
 		DLComplex * FFTArray1;
 		DLComplex * FFTArray2;
+		DLComplex * FFTBatch[2];
 
 		/* Array rimozione pre-echo */
 		DLReal * EPIPERemove;
@@ -731,15 +807,15 @@ Boolean MRefPETFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal * EPSig
 				for (I = EPRefLen / 2;I < FS - EPRefLen / 2;I++)
 					EPFDRef[I] = 0;
 
-				/* Porta nel dominio della frequenza */
-				Fft(EPFDRef,FS);
-
 				/* Copia l'array componente EP in quello per l'FFT */
 				for (I = 0;I < FS;I++)
 					FFTArray2[I] = EPIPERemove[I];
 
-				/* Porta nel dominio della frequenza */
-				Fft(FFTArray2,FS);
+				/* Porta nel dominio della frequenza riferimento e
+				componente EP */
+				FFTBatch[0] = EPFDRef;
+				FFTBatch[1] = FFTArray2;
+				FftBatch(FFTBatch,2,FS);
 
 				/* Effettua la convoluzione tra il filtro inverso e il riferimento */
 				for (I = 0;I < FS;I++)
@@ -891,9 +967,6 @@ Boolean MRefPETFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal * EPSig
 		/* Dealloca l'array componente EP */
 		delete[] EPIPERemove;
 
-		/* Porta nel dominio della frequenza */
-		Fft(FFTArray2,FS);
-
 		/* Alloca l'array per l'FFT componente MP */
 		if ((FFTArray1 = new DLComplex[FS]) == NULL)
 			return False;
@@ -906,8 +979,10 @@ Boolean MRefPETFDInvert(const DLReal * MPSig, int MPSigLen, const DLReal * EPSig
 		for (I = MPSigLen;I < FS;I++)
 			FFTArray1[I] = 0;
 
-		/* Porta nel dominio della frequenza */
-		Fft(FFTArray1,FS);
+		/* Porta nel dominio della frequenza componente MP e EP */
+		FFTBatch[0] = FFTArray1;
+		FFTBatch[1] = FFTArray2;
+		FftBatch(FFTBatch,2,FS);
 
 		/* Compone l'inverso componente MP e EP */
 		for (I = 0;I < FS;I++)
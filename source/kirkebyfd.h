@@ -54,7 +54,7 @@
 		DLReal * InvFilter,	int InvFilterLen, char PEType, int PELowerWindow, int PEUpperWindow,
 		DLReal PEStartFreq, DLReal PEEndFreq, int PEFilterLen, DLReal FSharpness, int PEBandSplit,
 		DLReal PEWindowExponent, const SLPPrefilteringType SLPType, const DLReal OGainFactor,
-		int SampleRate, int MExp);
+		int SampleRate, int MExp, const DLPrecisionType Prec = DLPNative);
 
 	/* Inversione tramite selective minimum pahse fast deconvolution */
 	/* Versione a troncatura multipla degli effetti di pre echo
@@ -30,6 +30,8 @@
 #include "baselib.h"
 #include "fft.h"
 #include "dspwind.h"
+#include "dipknee.h"
+#include "splitcpx.h"
 #include <math.h>
 
 /* Memory leaks debugger */
@@ -311,6 +313,9 @@ Boolean LPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLRe
 		int I;
 		int J;
 		DLComplex * FFTArray;
+		SCSpectrum<DLReal> S;
+		DLReal * AbsArray;
+		DLReal * LevArray;
 		DLReal RMSLevel;
 		DLReal DLSLevel;
 		DLReal DLLevel;
@@ -333,6 +338,8 @@ Boolean LPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLRe
 		FFTArray = new DLComplex[FFTSize];
 		if (FFTArray == NULL)
 			return False;
+		if (SCAlloc(S,FFTSize) == False)
+			return False;
 
 		/* Copia il segnale nell'array */
 		for (I = 0;I < SigLen;I++)
@@ -349,15 +356,24 @@ Boolean LPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLRe
 		/* Calcola il livello minimo tenendo conto delle limitazioni di banda */
 		RMSLevel = (DLReal) (RMSLevel * MinGain / sqrt(2.0 * (EndFreq - StartFreq) / SampleFreq));
 
+		/* Separa parte reale e immaginaria e calcola il modulo, usando
+		l'array per l'fft come memoria per moduli e livelli limitati */
+		SCSplit(FFTArray,S);
+		AbsArray = (DLReal *) FFTArray;
+		LevArray = &AbsArray[FFTSize];
+		SCAbs(S,AbsArray);
+		for (I = 0;I < FFTSize;I++)
+			LevArray[I] = AbsArray[I];
+
 		/* Verifica il tipo di limitazione impostata */
 		if (DLStart >= (DLReal) 1.0)
 			{
 				/* Scansione per troncatura guadagno */
 				for (I = 0; I < FFTSize; I++)
 					{
-						DLAbs = std::abs(FFTArray[I]);
+						DLAbs = AbsArray[I];
 						if (DLAbs < RMSLevel)
-							FFTArray[I] = std::polar<DLReal>(RMSLevel,std::arg<DLReal>(FFTArray[I]));
+							LevArray[I] = RMSLevel;
 					}
 			}
 		else
@@ -370,7 +386,7 @@ Boolean LPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLRe
 				/* Scansione per limitazione guadagno */
 				for (I = 0; I < FFTSize; I++)
 					{
-						DLAbs = std::abs(FFTArray[I]);
+						DLAbs = AbsArray[I];
 						if (DLAbs < DLSLevel)
 							{
 								/* Verifica se  gi disponibile il minimo locale */
@@ -383,7 +399,7 @@ Boolean LPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLRe
 											{
 												if (DLLevel < DLMin)
 													DLMin = DLLevel;
-												DLLevel = std::abs(FFTArray[J]);
+												DLLevel = AbsArray[J];
 											}
 
 										/* Verifica se il minimo locale  inferiore
@@ -397,14 +413,18 @@ Boolean LPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLRe
 
 								/* Riassegna il guadagno del filtro */
 								DLLevel = (DLSLevel - DLAbs) / DLMFactor;
-								FFTArray[I] = std::polar<DLReal>(DLSLevel - DLGFactor * DLLevel,
-									std::arg<DLReal>(FFTArray[I]));
+								LevArray[I] = DLSLevel - DLGFactor * DLLevel;
 							}
 						else
 							DLMin = (DLReal) -1.0;
 					}
 			}
 
+		/* Riassegna il modulo mantenendo la fase */
+		SCSetAbs(S,AbsArray,LevArray);
+		SCMerge(S,FFTArray);
+		SCFree(S);
+
 		/* Effettua l'fft inversa del segnale */
 		IFft(FFTArray,FFTSize);
 
@@ -428,10 +448,6 @@ Boolean C1LPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DL
 		int I;
 		DLComplex * FFTArray;
 		DLReal RMSLevel;
-		DLReal DLSLevel;
-		DLReal DLLevel;
-		DLReal DLGFactor;
-		DLReal DLAbs;
 
 		/* Determina la prima potenza di 2 >= SigLen */
 		if (MExp >= 0)
@@ -458,42 +474,13 @@ Boolean C1LPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DL
 		Fft(FFTArray,FFTSize);
 
 		/* Determina il livello RMS del segnale */
-		RMSLevel = GetBLFFTRMSLevel(FFTArray,FFTSize,SampleFreq,StartFreq,EndFreq,W);
-
-		/* Calcola il livello minimo tenendo conto delle limitazioni di banda */
+		RMSLevel = GetBLFFTRMSLevel(FFTArray,FFTSize,SampleFreq,StartFreq,EndFreq,W);
+
+		/* Calcola il livello minimo tenendo conto delle limitazioni di banda */
 		RMSLevel = (DLReal) (RMSLevel * MinGain / sqrt(2.0 * (EndFreq - StartFreq) / SampleFreq));
 
-		/* Verifica il tipo di limitazione impostata */
-		if (DLStart >= (DLReal) 1.0)
-			{
-				/* Scansione per troncatura guadagno */
-				for (I = 0; I < FFTSize; I++)
-					{
-						DLAbs = std::abs(FFTArray[I]);
-						if (DLAbs < RMSLevel)
-							FFTArray[I] = std::polar<DLReal>(RMSLevel,std::arg<DLReal>(FFTArray[I]));
-					}
-			}
-		else
-			{
-				/* Determina i fattori per la limitazione guadagno */
-				DLSLevel = RMSLevel / DLStart;
-				DLGFactor = DLSLevel - RMSLevel;
-
-				/* Scansione per limitazione guadagno */
-				for (I = 0; I < FFTSize; I++)
-					{
-						DLAbs = std::abs(FFTArray[I]);
-						if (DLAbs < DLSLevel)
-							{
-								/* Riassegna il guadagno del filtro */
-								DLLevel = (DLSLevel - DLAbs) / DLGFactor;
-								DLLevel = DLLevel / (((DLReal) 1.0) + DLLevel);
-								FFTArray[I] = std::polar<DLReal>(DLSLevel - DLGFactor * DLLevel,
-									std::arg<DLReal>(FFTArray[I]));
-							}
-					}
-			}
+		/* Limitazione guadagno, troncatura o ginocchio morbido */
+		DKLimitPairs((DLReal *) FFTArray,FFTSize,RMSLevel,DLStart);
 
 		/* Effettua l'fft inversa del segnale */
 		IFft(FFTArray,FFTSize);
@@ -517,6 +504,8 @@ Boolean HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLR
 		DLComplex * FFTArray1;
 		DLComplex * FFTArray2;
 		DLReal * FFTArray3;
+		SCSpectrum<DLReal> S1;
+		SCSpectrum<DLReal> S2;
 		int FS;
 		int I;
 		int J;
@@ -546,6 +535,8 @@ Boolean HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLR
 			return False;
 		if ((FFTArray3 = new DLReal[FS]) == NULL)
 			return False;
+		if (SCAlloc(S1,FS) == False)
+			return False;
 
 		/* Copia l'array sorgente in quello temporaneo */
 		for (I = 0;I < SigLen;I++)
@@ -564,6 +555,11 @@ Boolean HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLR
 		/* Calcola il livello minimo tenendo conto delle limitazioni di banda */
 		RMSLevel = (DLReal) (RMSLevel * MinGain / sqrt(2.0 * (EndFreq - StartFreq) / SampleFreq));
 
+		/* Separa parte reale e immaginaria e calcola il modulo, sostituito
+		poi dal guadagno del filtro */
+		SCSplit(FFTArray1,S1);
+		SCAbs(S1,FFTArray3);
+
 		/* Verifica il tipo di limitazione impostata */
 		if (DLStart >= (DLReal) 1.0)
 			{
@@ -571,12 +567,11 @@ Boolean HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLR
 				LogLimit = False;
 				for (I = 0;I < FS;I++)
 					{
-						DLAbs = std::abs<DLReal>(FFTArray1[I]);
+						DLAbs = FFTArray3[I];
 						if (DLAbs <= 0)
 							{
 								LogLimit = True;
 								FFTArray3[I] = DRCMaxFloat;
-								FFTArray2[I] = std::log<DLReal>(DRCMaxFloat);
 							}
 						else
 							{
@@ -584,7 +579,6 @@ Boolean HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLR
 									FFTArray3[I] = (DLReal) RMSLevel / DLAbs;
 								else
 									FFTArray3[I] = (DLReal) 1.0;
-								FFTArray2[I] = std::log<DLReal>(FFTArray3[I]);
 							}
 					}
 
@@ -603,7 +597,7 @@ Boolean HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLR
 				LogLimit = False;
 				for (I = 0; I < FS; I++)
 					{
-						DLAbs = std::abs<DLReal>(FFTArray1[I]);
+						DLAbs = FFTArray3[I];
 						if (DLAbs < DLSLevel)
 							{
 								/* Verifica se  gi disponibile il minimo locale */
@@ -616,7 +610,7 @@ Boolean HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLR
 											{
 												if (DLLevel < DLMin)
 													DLMin = DLLevel;
-												DLLevel = std::abs<DLReal>(FFTArray1[J]);
+												DLLevel = FFTArray3[J];
 											}
 
 										/* Verifica se il minimo locale  inferiore
@@ -635,19 +629,14 @@ Boolean HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLR
 									{
 										LogLimit = True;
 										FFTArray3[I] = DRCMaxFloat;
-										FFTArray2[I] = std::log<DLReal>(DRCMaxFloat);
 									}
 								else
-									{
-										FFTArray3[I] = (DLReal) DLLevel / DLAbs;
-										FFTArray2[I] = std::log<DLReal>(FFTArray3[I]);
-									}
+									FFTArray3[I] = (DLReal) DLLevel / DLAbs;
 							}
 						else
 							{
 								DLMin = (DLReal) -1.0;
 								FFTArray3[I] = (DLReal) 1.0;
-								FFTArray2[I] = (DLReal) 0.0;
 							}
 					}
 
@@ -656,6 +645,9 @@ Boolean HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLR
 					sputs("Notice: limit reached in Hilbert filter computation.");
 			}
 
+		/* Calcola il logaritmo del guadagno */
+		SCRealLog(FFTArray3,FFTArray2,FS);
+
 		/* Calcola la fase per il filtro a fase minima */
 		IFft(FFTArray2,FS);
 		for (I = 1 + FS / 2; I < FS;I++)
@@ -664,18 +656,24 @@ Boolean HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const DLR
 		FFTArray2[FS / 2] = (DLReal) 0.0;
 		Fft(FFTArray2,FS);
 
-		/* Effettua la convoluzione con il sistema inverso a fase minima */
-		for (I = 0;I < FS;I++)
-			FFTArray1[I] *= FFTArray3[I] * std::exp<DLReal>(FFTArray2[I]);
+		/* Effettua la convoluzione con il sistema inverso a fase minima,
+		usando l'array della trasformata come memoria per il filtro */
+		SCAttach(S2,FFTArray1,FS);
+		SCSplit(FFTArray2,S2);
+		SCExp(S2);
+		SCScale(S2,FFTArray3);
+		SCMul(S1,S2,S1);
+		SCMerge(S1,FFTArray2);
 
 		/* Determina la risposta del sistema */
-		IFft(FFTArray1,FS);
+		IFft(FFTArray2,FS);
 
 		/* Copia il risultato nell'array destinazione */
 		for (I = 0;I < SigLen;I++)
-			Sig[I] = std::real<DLReal>(FFTArray1[I]);
+			Sig[I] = std::real<DLReal>(FFTArray2[I]);
 
 		/* Dealloca gli array */
+		SCFree(S1);
 		delete[] FFTArray1;
 		delete[] FFTArray2;
 		delete[] FFTArray3;
@@ -693,6 +691,8 @@ Boolean C1HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const D
 		DLComplex * FFTArray1;
 		DLComplex * FFTArray2;
 		DLReal * FFTArray3;
+		SCSpectrum<DLReal> S1;
+		SCSpectrum<DLReal> S2;
 		int FS;
 		int I;
 		DLReal RMSLevel;
@@ -719,6 +719,8 @@ Boolean C1HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const D
 			return False;
 		if ((FFTArray3 = new DLReal[FS]) == NULL)
 			return False;
+		if (SCAlloc(S1,FS) == False)
+			return False;
 
 		/* Copia l'array sorgente in quello temporaneo */
 		for (I = 0;I < SigLen;I++)
@@ -737,6 +739,11 @@ Boolean C1HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const D
 		/* Calcola il livello minimo tenendo conto delle limitazioni di banda */
 		RMSLevel = (DLReal) (RMSLevel * MinGain / sqrt(2.0 * (EndFreq - StartFreq) / SampleFreq));
 
+		/* Separa parte reale e immaginaria e calcola il modulo, sostituito
+		poi dal guadagno del filtro */
+		SCSplit(FFTArray1,S1);
+		SCAbs(S1,FFTArray3);
+
 		/* Verifica il tipo di limitazione impostata */
 		if (DLStart >= (DLReal) 1.0)
 			{
@@ -744,12 +751,11 @@ Boolean C1HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const D
 				LogLimit = False;
 				for (I = 0;I < FS;I++)
 					{
-						DLAbs = std::abs<DLReal>(FFTArray1[I]);
+						DLAbs = FFTArray3[I];
 						if (DLAbs <= 0)
 							{
 								LogLimit = True;
 								FFTArray3[I] = DRCMaxFloat;
-								FFTArray2[I] = std::log<DLReal>(DRCMaxFloat);
 							}
 						else
 							{
@@ -757,7 +763,6 @@ Boolean C1HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const D
 									FFTArray3[I] = (DLReal) RMSLevel / DLAbs;
 								else
 									FFTArray3[I] = (DLReal) 1.0;
-								FFTArray2[I] = std::log<DLReal>(FFTArray3[I]);
 							}
 					}
 
@@ -775,30 +780,21 @@ Boolean C1HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const D
 				LogLimit = False;
 				for (I = 0; I < FS; I++)
 					{
-						DLAbs = std::abs(FFTArray1[I]);
+						DLAbs = FFTArray3[I];
 						if (DLAbs < DLSLevel)
 							{
 								/* Riassegna il guadagno del filtro */
-								DLLevel = (DLSLevel - DLAbs) / DLGFactor;
-								DLLevel = DLLevel / (((DLReal) 1.0) + DLLevel);
-								DLLevel = DLSLevel - DLGFactor * DLLevel;
+								DLLevel = DKSoftLevel(DLAbs,DLSLevel,DLGFactor);
 								if (DLAbs <= 0)
 									{
 										LogLimit = True;
 										FFTArray3[I] = DRCMaxFloat;
-										FFTArray2[I] = std::log<DLReal>(DRCMaxFloat);
 									}
 								else
-									{
-										FFTArray3[I] = (DLReal) DLLevel / DLAbs;
-										FFTArray2[I] = std::log<DLReal>(FFTArray3[I]);
-									}
+									FFTArray3[I] = (DLReal) DLLevel / DLAbs;
 							}
 						else
-							{
-								FFTArray3[I] = (DLReal) 1.0;
-								FFTArray2[I] = (DLReal) 0.0;
-							}
+							FFTArray3[I] = (DLReal) 1.0;
 					}
 
 				/* Verifica se si  raggiunto il limite */
@@ -806,6 +802,9 @@ Boolean C1HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const D
 					sputs("Notice: limit reached in Hilbert filter computation.");
 			}
 
+		/* Calcola il logaritmo del guadagno */
+		SCRealLog(FFTArray3,FFTArray2,FS);
+
 		/* Calcola la fase per il filtro a fase minima */
 		IFft(FFTArray2,FS);
 		for (I = 1 + FS / 2; I < FS;I++)
@@ -814,18 +813,24 @@ Boolean C1HMPDipLimit(DLReal * Sig,const int SigLen,const DLReal MinGain,const D
 		FFTArray2[FS / 2] = (DLReal) 0.0;
 		Fft(FFTArray2,FS);
 
-		/* Effettua la convoluzione con il sistema inverso a fase minima */
-		for (I = 0;I < FS;I++)
-			FFTArray1[I] *= FFTArray3[I] * std::exp<DLReal>(FFTArray2[I]);
+		/* Effettua la convoluzione con il sistema inverso a fase minima,
+		usando l'array della trasformata come memoria per il filtro */
+		SCAttach(S2,FFTArray1,FS);
+		SCSplit(FFTArray2,S2);
+		SCExp(S2);
+		SCScale(S2,FFTArray3);
+		SCMul(S1,S2,S1);
+		SCMerge(S1,FFTArray2);
 
 		/* Determina la risposta del sistema */
-		IFft(FFTArray1,FS);
+		IFft(FFTArray2,FS);
 
 		/* Copia il risultato nell'array destinazione */
 		for (I = 0;I < SigLen;I++)
-			Sig[I] = std::real<DLReal>(FFTArray1[I]);
+			Sig[I] = std::real<DLReal>(FFTArray2[I]);
 
 		/* Dealloca gli array */
+		SCFree(S1);
 		delete[] FFTArray1;
 		delete[] FFTArray2;
 		delete[] FFTArray3;
@@ -842,6 +847,9 @@ Boolean LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DLR
 		int I;
 		int J;
 		DLComplex * FFTArray;
+		SCSpectrum<DLReal> S;
+		DLReal * AbsArray;
+		DLReal * LevArray;
 		DLReal RMSLevel;
 		DLReal PLSLevel;
 		DLReal PLLevel;
@@ -864,6 +872,8 @@ Boolean LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DLR
 		FFTArray = new DLComplex[FFTSize];
 		if (FFTArray == NULL)
 			return False;
+		if (SCAlloc(S,FFTSize) == False)
+			return False;
 
 		/* Copia il segnale nell'array */
 		for (I = 0;I < SigLen;I++)
@@ -880,15 +890,24 @@ Boolean LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DLR
 		/* Calcola il livello massimo tenendo conto delle limitazioni di banda */
 		RMSLevel = (DLReal) (RMSLevel * MaxGain / sqrt(2.0 * (EndFreq - StartFreq) / SampleFreq));
 
+		/* Separa parte reale e immaginaria e calcola il modulo, usando
+		l'array per l'fft come memoria per moduli e livelli limitati */
+		SCSplit(FFTArray,S);
+		AbsArray = (DLReal *) FFTArray;
+		LevArray = &AbsArray[FFTSize];
+		SCAbs(S,AbsArray);
+		for (I = 0;I < FFTSize;I++)
+			LevArray[I] = AbsArray[I];
+
 		/* Verifica il tipo di limitazione impostata */
 		if (PLStart >= (DLReal) 1.0)
 			{
 				/* Scansione per troncatura guadagno */
 				for (I = 0; I < FFTSize; I++)
 					{
-						PLAbs = std::abs(FFTArray[I]);
+						PLAbs = AbsArray[I];
 						if (PLAbs > RMSLevel)
-							FFTArray[I] = std::polar<DLReal>(RMSLevel,std::arg<DLReal>(FFTArray[I]));
+							LevArray[I] = RMSLevel;
 					}
 			}
 		else
@@ -901,7 +920,7 @@ Boolean LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DLR
 				/* Scansione per limitazione guadagno */
 				for (I = 0; I < FFTSize; I++)
 					{
-						PLAbs = std::abs(FFTArray[I]);
+						PLAbs = AbsArray[I];
 						if (PLAbs > PLSLevel)
 							{
 								/* Verifica se  gi disponibile il massimo locale */
@@ -914,7 +933,7 @@ Boolean LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DLR
 											{
 												if (PLLevel > PLMax)
 													PLMax = PLLevel;
-												PLLevel = std::abs(FFTArray[J]);
+												PLLevel = AbsArray[J];
 											}
 
 										/* Verifica se il massimo locale  superiore
@@ -928,14 +947,18 @@ Boolean LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DLR
 
 								/* Riassegna il guadagno del filtro */
 								PLLevel = (PLAbs - PLSLevel) / PLMFactor;
-								FFTArray[I] = std::polar<DLReal>(PLSLevel + PLGFactor * PLLevel,
-									std::arg<DLReal>(FFTArray[I]));
+								LevArray[I] = PLSLevel + PLGFactor * PLLevel;
 							}
 						else
 							PLMax = (DLReal) -1.0;
 					}
 			}
 
+		/* Riassegna il modulo mantenendo la fase */
+		SCSetAbs(S,AbsArray,LevArray);
+		SCMerge(S,FFTArray);
+		SCFree(S);
+
 		/* Effettua l'fft inversa del segnale */
 		IFft(FFTArray,FFTSize);
 
@@ -953,11 +976,15 @@ Boolean LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DLR
 /* Limitazione picchi a fase lineare con calcolo del valore RMS sull banda indicata */
 /* Versione con mantenimento continuit della derivata prima nei punti di limitazione */
 Boolean C1LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DLReal PLStart,
-	const int SampleFreq,const DLReal StartFreq,const DLReal EndFreq,const DLReal W,const int MExp)
+	const int SampleFreq,const DLReal StartFreq,const DLReal EndFreq,const DLReal W,const int MExp,
+	DLComplex * SigFFT)
 	{
 		int FFTSize;
 		int I;
 		DLComplex * FFTArray;
+		SCSpectrum<DLReal> S;
+		DLReal * AbsArray;
+		DLReal * LevArray;
 		DLReal RMSLevel;
 		DLReal PLSLevel;
 		DLReal PLLevel;
@@ -974,19 +1001,31 @@ Boolean C1LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const D
 		else
 			FFTSize = SigLen;
 
-		/* Alloca l'array per l'fft */
-		FFTArray = new DLComplex[FFTSize];
-		if (FFTArray == NULL)
-			return False;
-
-		/* Copia il segnale nell'array */
-		for (I = 0;I < SigLen;I++)
-			FFTArray[I] = Sig[I];
-		for (I = SigLen;I < FFTSize;I++)
-			FFTArray[I] = (DLReal) 0.0;
-
-		/* Effettua l'fft del segnale */
-		Fft(FFTArray,FFTSize);
+		/* Verifica se la trasformata del segnale  gi disponibile */
+		if (SigFFT != NULL)
+			{
+				FFTArray = SigFFT;
+				if (SCAlloc(S,FFTSize) == False)
+					return False;
+			}
+		else
+			{
+				/* Alloca l'array per l'fft */
+				FFTArray = new DLComplex[FFTSize];
+				if (FFTArray == NULL)
+					return False;
+				if (SCAlloc(S,FFTSize) == False)
+					return False;
+
+				/* Copia il segnale nell'array */
+				for (I = 0;I < SigLen;I++)
+					FFTArray[I] = Sig[I];
+				for (I = SigLen;I < FFTSize;I++)
+					FFTArray[I] = (DLReal) 0.0;
+
+				/* Effettua l'fft del segnale */
+				Fft(FFTArray,FFTSize);
+			}
 
 		/* Determina il livello RMS del segnale */
 		RMSLevel = GetBLFFTRMSLevel(FFTArray,FFTSize,SampleFreq,StartFreq,EndFreq,W);
@@ -994,15 +1033,24 @@ Boolean C1LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const D
 		/* Calcola il livello massimo tenendo conto delle limitazioni di banda */
 		RMSLevel = (DLReal) (RMSLevel * MaxGain / sqrt(2.0 * (EndFreq - StartFreq) / SampleFreq));
 
+		/* Separa parte reale e immaginaria e calcola il modulo, usando
+		l'array per l'fft come memoria per moduli e livelli limitati */
+		SCSplit(FFTArray,S);
+		AbsArray = (DLReal *) FFTArray;
+		LevArray = &AbsArray[FFTSize];
+		SCAbs(S,AbsArray);
+		for (I = 0;I < FFTSize;I++)
+			LevArray[I] = AbsArray[I];
+
 		/* Verifica il tipo di limitazione impostata */
 		if (PLStart >= (DLReal) 1.0)
 			{
 				/* Scansione per troncatura guadagno */
 				for (I = 0; I < FFTSize; I++)
 					{
-						PLAbs = std::abs(FFTArray[I]);
+						PLAbs = AbsArray[I];
 						if (PLAbs > RMSLevel)
-							FFTArray[I] = std::polar<DLReal>(RMSLevel,std::arg<DLReal>(FFTArray[I]));
+							LevArray[I] = RMSLevel;
 					}
 			}
 		else
@@ -1014,18 +1062,22 @@ Boolean C1LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const D
 				/* Scansione per limitazione guadagno */
 				for (I = 0; I < FFTSize; I++)
 					{
-						PLAbs = std::abs(FFTArray[I]);
+						PLAbs = AbsArray[I];
 						if (PLAbs > PLSLevel)
 							{
 								/* Riassegna il guadagno del filtro */
 								PLLevel = (PLAbs - PLSLevel) / PLGFactor;
 								PLLevel = PLLevel / (((DLReal) 1.0) + PLLevel);
-								FFTArray[I] = std::polar<DLReal>(PLSLevel + PLGFactor * PLLevel,
-									std::arg<DLReal>(FFTArray[I]));
+								LevArray[I] = PLSLevel + PLGFactor * PLLevel;
 							}
 					}
 			}
 
+		/* Riassegna il modulo mantenendo la fase */
+		SCSetAbs(S,AbsArray,LevArray);
+		SCMerge(S,FFTArray);
+		SCFree(S);
+
 		/* Effettua l'fft inversa del segnale */
 		IFft(FFTArray,FFTSize);
 
@@ -1034,7 +1086,8 @@ Boolean C1LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const D
 			Sig[I] = std::real(FFTArray[I]);
 
 		/* Dealloca l'array */
-		delete[] FFTArray;
+		if (SigFFT == NULL)
+			delete[] FFTArray;
 
 		/* Operazione completata */
 		return True;
@@ -1048,6 +1101,8 @@ Boolean HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DL
 		DLComplex * FFTArray1;
 		DLComplex * FFTArray2;
 		DLReal * FFTArray3;
+		SCSpectrum<DLReal> S1;
+		SCSpectrum<DLReal> S2;
 		int FS;
 		int I;
 		int J;
@@ -1077,6 +1132,8 @@ Boolean HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DL
 			return False;
 		if ((FFTArray3 = new DLReal[FS]) == NULL)
 			return False;
+		if (SCAlloc(S1,FS) == False)
+			return False;
 
 		/* Copia l'array sorgente in quello temporaneo */
 		for (I = 0;I < SigLen;I++)
@@ -1095,6 +1152,11 @@ Boolean HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DL
 		/* Calcola il livello massimo tenendo conto delle limitazioni di banda */
 		RMSLevel = (DLReal) (RMSLevel * MaxGain / sqrt(2.0 * (EndFreq - StartFreq) / SampleFreq));
 
+		/* Separa parte reale e immaginaria e calcola il modulo, sostituito
+		poi dal guadagno del filtro */
+		SCSplit(FFTArray1,S1);
+		SCAbs(S1,FFTArray3);
+
 		/* Verifica il tipo di limitazione impostata */
 		if (PLStart >= (DLReal) 1.0)
 			{
@@ -1102,12 +1164,11 @@ Boolean HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DL
 				LogLimit = False;
 				for (I = 0;I < FS;I++)
 					{
-						PLAbs = std::abs<DLReal>(FFTArray1[I]);
+						PLAbs = FFTArray3[I];
 						if (PLAbs <= 0)
 							{
 								LogLimit = True;
 								FFTArray3[I] = DRCMaxFloat;
-								FFTArray2[I] = std::log<DLReal>(DRCMaxFloat);
 							}
 						else
 							{
@@ -1115,7 +1176,6 @@ Boolean HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DL
 									FFTArray3[I] = (DLReal) RMSLevel / PLAbs;
 								else
 									FFTArray3[I] = (DLReal) 1.0;
-								FFTArray2[I] = std::log<DLReal>(FFTArray3[I]);
 							}
 					}
 
@@ -1134,7 +1194,7 @@ Boolean HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DL
 				LogLimit = False;
 				for (I = 0; I < FS; I++)
 					{
-						PLAbs = std::abs(FFTArray1[I]);
+						PLAbs = FFTArray3[I];
 						if (PLAbs > PLSLevel)
 							{
 								/* Verifica se  gi disponibile il massimo locale */
@@ -1147,7 +1207,7 @@ Boolean HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DL
 											{
 												if (PLLevel > PLMax)
 													PLMax = PLLevel;
-												PLLevel = std::abs(FFTArray1[J]);
+												PLLevel = FFTArray3[J];
 											}
 
 										/* Verifica se il massimo locale  superiore
@@ -1166,19 +1226,14 @@ Boolean HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DL
 									{
 										LogLimit = True;
 										FFTArray3[I] = DRCMaxFloat;
-										FFTArray2[I] = std::log<DLReal>(DRCMaxFloat);
 									}
 								else
-									{
-										FFTArray3[I] = (DLReal) PLLevel / PLAbs;
-										FFTArray2[I] = std::log<DLReal>(FFTArray3[I]);
-									}
+									FFTArray3[I] = (DLReal) PLLevel / PLAbs;
 							}
 						else
 							{
 								PLMax = (DLReal) -1.0;
 								FFTArray3[I] = (DLReal) 1.0;
-								FFTArray2[I] = (DLReal) 0.0;
 							}
 					}
 
@@ -1187,6 +1242,9 @@ Boolean HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DL
 					sputs("Notice: limit reached in Hilbert filter computation.");
 			}
 
+		/* Calcola il logaritmo del guadagno */
+		SCRealLog(FFTArray3,FFTArray2,FS);
+
 		/* Calcola la fase per il filtro a fase minima */
 		IFft(FFTArray2,FS);
 		for (I = 1 + FS / 2; I < FS;I++)
@@ -1195,18 +1253,24 @@ Boolean HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DL
 		FFTArray2[FS / 2] = (DLReal) 0.0;
 		Fft(FFTArray2,FS);
 
-		/* Effettua la convoluzione con il sistema inverso a fase minima */
-		for (I = 0;I < FS;I++)
-			FFTArray1[I] *= FFTArray3[I] * std::exp<DLReal>(FFTArray2[I]);
+		/* Effettua la convoluzione con il sistema inverso a fase minima,
+		usando l'array della trasformata come memoria per il filtro */
+		SCAttach(S2,FFTArray1,FS);
+		SCSplit(FFTArray2,S2);
+		SCExp(S2);
+		SCScale(S2,FFTArray3);
+		SCMul(S1,S2,S1);
+		SCMerge(S1,FFTArray2);
 
 		/* Determina la risposta del sistema */
-		IFft(FFTArray1,FS);
+		IFft(FFTArray2,FS);
 
 		/* Copia il risultato nell'array destinazione */
 		for (I = 0;I < SigLen;I++)
-			Sig[I] = std::real<DLReal>(FFTArray1[I]);
+			Sig[I] = std::real<DLReal>(FFTArray2[I]);
 
 		/* Dealloca gli array */
+		SCFree(S1);
 		delete[] FFTArray1;
 		delete[] FFTArray2;
 		delete[] FFTArray3;
@@ -1219,11 +1283,14 @@ Boolean HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DL
 /* Versione basata sulla trasformata di Hilbert */
 /* Versione con mantenimento continuit della derivata prima nei punti di limitazione */
 Boolean C1HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DLReal PLStart,
-	const int SampleFreq,const DLReal StartFreq,const DLReal EndFreq,const DLReal W,const int MExp)
+	const int SampleFreq,const DLReal StartFreq,const DLReal EndFreq,const DLReal W,const int MExp,
+	DLComplex * SigFFT)
 	{
 		DLComplex * FFTArray1;
 		DLComplex * FFTArray2;
 		DLReal * FFTArray3;
+		SCSpectrum<DLReal> S1;
+		SCSpectrum<DLReal> S2;
 		int FS;
 		int I;
 		DLReal RMSLevel;
@@ -1243,24 +1310,34 @@ Boolean C1HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const
 		else
 			FS = SigLen;
 
-		/* Alloca gli array per l'FFT */
-		if ((FFTArray1 = new DLComplex[FS]) == NULL)
-			return False;
+		/* Alloca gli array per l'FFT, usando se disponibile la
+		trasformata del segnale gi calcolata */
+		if (SigFFT != NULL)
+			FFTArray1 = SigFFT;
+		else
+			if ((FFTArray1 = new DLComplex[FS]) == NULL)
+				return False;
 		if ((FFTArray2 = new DLComplex[FS]) == NULL)
 			return False;
 		if ((FFTArray3 = new DLReal[FS]) == NULL)
 			return False;
+		if (SCAlloc(S1,FS) == False)
+			return False;
 
-		/* Copia l'array sorgente in quello temporaneo */
-		for (I = 0;I < SigLen;I++)
-			FFTArray1[I] = Sig[I];
+		/* Verifica se si deve calcolare la trasformata del segnale */
+		if (SigFFT == NULL)
+			{
+				/* Copia l'array sorgente in quello temporaneo */
+				for (I = 0;I < SigLen;I++)
+					FFTArray1[I] = Sig[I];
 
-		/* Azzera la parte rimanente */
-		for (I = SigLen;I < FS;I++)
-			FFTArray1[I] = (DLReal) 0.0;
+				/* Azzera la parte rimanente */
+				for (I = SigLen;I < FS;I++)
+					FFTArray1[I] = (DLReal) 0.0;
 
-		/* Trasforma l'array risultante */
-		Fft(FFTArray1,FS);
+				/* Trasforma l'array risultante */
+				Fft(FFTArray1,FS);
+			}
 
 		/* Determina il livello RMS del segnale */
 		RMSLevel = GetBLFFTRMSLevel(FFTArray1,FS,SampleFreq,StartFreq,EndFreq,W);
@@ -1268,6 +1345,11 @@ Boolean C1HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const
 		/* Calcola il livello massimo tenendo conto delle limitazioni di banda */
 		RMSLevel = (DLReal) (RMSLevel * MaxGain / sqrt(2.0 * (EndFreq - StartFreq) / SampleFreq));
 
+		/* Separa parte reale e immaginaria e calcola il modulo, sostituito
+		poi dal guadagno del filtro */
+		SCSplit(FFTArray1,S1);
+		SCAbs(S1,FFTArray3);
+
 		/* Verifica il tipo di limitazione impostata */
 		if (PLStart >= (DLReal) 1.0)
 			{
@@ -1275,12 +1357,11 @@ Boolean C1HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const
 				LogLimit = False;
 				for (I = 0;I < FS;I++)
 					{
-						PLAbs = std::abs<DLReal>(FFTArray1[I]);
+						PLAbs = FFTArray3[I];
 						if (PLAbs <= 0)
 							{
 								LogLimit = True;
 								FFTArray3[I] = DRCMaxFloat;
-								FFTArray2[I] = std::log<DLReal>(DRCMaxFloat);
 							}
 						else
 							{
@@ -1288,7 +1369,6 @@ Boolean C1HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const
 									FFTArray3[I] = (DLReal) RMSLevel / PLAbs;
 								else
 									FFTArray3[I] = (DLReal) 1.0;
-								FFTArray2[I] = std::log<DLReal>(FFTArray3[I]);
 							}
 					}
 
@@ -1306,7 +1386,7 @@ Boolean C1HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const
 				LogLimit = False;
 				for (I = 0; I < FS; I++)
 					{
-						PLAbs = std::abs(FFTArray1[I]);
+						PLAbs = FFTArray3[I];
 						if (PLAbs > PLSLevel)
 							{
 								/* Riassegna il guadagno del filtro */
@@ -1317,19 +1397,12 @@ Boolean C1HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const
 									{
 										LogLimit = True;
 										FFTArray3[I] = DRCMaxFloat;
-										FFTArray2[I] = std::log<DLReal>(DRCMaxFloat);
 									}
 								else
-									{
-										FFTArray3[I] = (DLReal) PLLevel / PLAbs;
-										FFTArray2[I] = std::log<DLReal>(FFTArray3[I]);
-									}
+									FFTArray3[I] = (DLReal) PLLevel / PLAbs;
 							}
 						else
-							{
-								FFTArray3[I] = (DLReal) 1.0;
-								FFTArray2[I] = (DLReal) 0.0;
-							}
+							FFTArray3[I] = (DLReal) 1.0;
 					}
 
 				/* Verifica se si  raggiunto il limite */
@@ -1337,6 +1410,9 @@ Boolean C1HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const
 					sputs("Notice: limit reached in Hilbert filter computation.");
 			}
 
+		/* Calcola il logaritmo del guadagno */
+		SCRealLog(FFTArray3,FFTArray2,FS);
+
 		/* Calcola la fase per il filtro a fase minima */
 		IFft(FFTArray2,FS);
 		for (I = 1 + FS / 2; I < FS;I++)
@@ -1345,19 +1421,26 @@ Boolean C1HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const
 		FFTArray2[FS / 2] = (DLReal) 0.0;
 		Fft(FFTArray2,FS);
 
-		/* Effettua la convoluzione con il sistema inverso a fase minima */
-		for (I = 0;I < FS;I++)
-			FFTArray1[I] *= FFTArray3[I] * std::exp<DLReal>(FFTArray2[I]);
+		/* Effettua la convoluzione con il sistema inverso a fase minima,
+		usando l'array della trasformata come memoria per il filtro */
+		SCAttach(S2,FFTArray1,FS);
+		SCSplit(FFTArray2,S2);
+		SCExp(S2);
+		SCScale(S2,FFTArray3);
+		SCMul(S1,S2,S1);
+		SCMerge(S1,FFTArray2);
 
 		/* Determina la risposta del sistema */
-		IFft(FFTArray1,FS);
+		IFft(FFTArray2,FS);
 
 		/* Copia il risultato nell'array destinazione */
 		for (I = 0;I < SigLen;I++)
-			Sig[I] = std::real<DLReal>(FFTArray1[I]);
+			Sig[I] = std::real<DLReal>(FFTArray2[I]);
 
 		/* Dealloca gli array */
-		delete[] FFTArray1;
+		SCFree(S1);
+		if (SigFFT == NULL)
+			delete[] FFTArray1;
 		delete[] FFTArray2;
 		delete[] FFTArray3;
 
@@ -1371,6 +1454,9 @@ Boolean LPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal
 		int FFTSize;
 		int I;
 		DLComplex * FFTArray;
+		SCSpectrum<DLReal> S;
+		DLReal * AbsArray;
+		DLReal * LevArray;
 		DLReal G;
 
 		/* Controlla se si deve adottare un potenza di due */
@@ -1387,6 +1473,8 @@ Boolean LPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal
 		FFTArray = new DLComplex[FFTSize];
 		if (FFTArray == NULL)
 			return False;
+		if (SCAlloc(S,FFTSize) == False)
+			return False;
 
 		/* Copia il segnale nell'array */
 		for (I = 0;I < SigLen;I++)
@@ -1397,10 +1485,20 @@ Boolean LPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal
 		/* Effettua l'fft del segnale */
 		Fft(FFTArray,FFTSize);
 
+		/* Separa parte reale e immaginaria e calcola il modulo, usando
+		l'array per l'fft come memoria per moduli e livelli */
+		SCSplit(FFTArray,S);
+		AbsArray = (DLReal *) FFTArray;
+		LevArray = &AbsArray[FFTSize];
+		SCAbs(S,AbsArray);
+
 		/* Scansione per normalizzazione guadagno */
 		G = (1 - OGainFactor) * GetRMSLevel(Sig,SigLen);
 		for (I = 0; I < FFTSize; I++)
-			FFTArray[I] = std::polar<DLReal>(Gain * (G + OGainFactor * std::abs(FFTArray[I])), std::arg<DLReal>(FFTArray[I]));
+			LevArray[I] = Gain * (G + OGainFactor * AbsArray[I]);
+		SCSetAbs(S,AbsArray,LevArray);
+		SCMerge(S,FFTArray);
+		SCFree(S);
 
 		/* Effettua l'fft inversa del segnale */
 		IFft(FFTArray,FFTSize);
@@ -1422,6 +1520,9 @@ Boolean CMPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal
 	{
 		DLComplex * FFTArray1;
 		DLComplex * FFTArray2;
+		DLReal * AbsArray;
+		SCSpectrum<DLReal> S1;
+		SCSpectrum<DLReal> S2;
 		int FS;
 		int I;
 		DLReal G;
@@ -1442,6 +1543,8 @@ Boolean CMPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal
 			return False;
 		if ((FFTArray2 = new DLComplex[FS]) == NULL)
 			return False;
+		if (SCAlloc(S1,FS) == False)
+			return False;
 
 		/* Copia l'array sorgente in quello temporaneo */
 		for (I = 0;I < SigLen;I++)
@@ -1454,21 +1557,33 @@ Boolean CMPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal
 		/* Trasforma l'array risultante */
 		Fft(FFTArray1,FS);
 
+		/* Separa parte reale e immaginaria e calcola il modulo, usando
+		l'array della trasformata come memoria */
+		SCSplit(FFTArray1,S1);
+		AbsArray = (DLReal *) FFTArray1;
+		SCAbs(S1,AbsArray);
+
 		/* Calcola i valori per il cepstrum */
 		G = OGainFactor * GetRMSLevel(Sig,SigLen);
 		LogLimit = False;
 		for (I = 0;I < FS;I++)
-			if (std::abs<DLReal>(FFTArray1[I]) <= 0)
+			if (AbsArray[I] <= 0)
 				{
 					LogLimit = True;
-					FFTArray2[I] = DRCMaxFloat;
+					AbsArray[I] = (DLReal) 0.0;
 				}
 			else
-				FFTArray2[I] = std::log<DLReal>(Gain / (G + (1 - OGainFactor) * std::abs<DLReal>(FFTArray1[I])));
+				AbsArray[I] = Gain / (G + (1 - OGainFactor) * AbsArray[I]);
+		SCRealLog(AbsArray,FFTArray2,FS);
 
 		/* Verifica se si  raggiunto il limite */
 		if (LogLimit == True)
-			sputs("Notice: limit reached in cepstrum computation.");
+			{
+				for (I = 0;I < FS;I++)
+					if (AbsArray[I] <= 0)
+						FFTArray2[I] = DRCMaxFloat;
+				sputs("Notice: limit reached in cepstrum computation.");
+			}
 
 		/* Calcola il cepstrum */
 		IFft(FFTArray2,FS);
@@ -1482,18 +1597,23 @@ Boolean CMPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal
 		/* Calcola la trsformata del cepstrum finestrato */
 		Fft(FFTArray2,FS);
 
-		/* Effettua la convoluzione con il sistema inverso a fase minima */
-		for (I = 0;I < FS;I++)
-			FFTArray1[I] *= std::exp<DLReal>(FFTArray2[I]);
+		/* Effettua la convoluzione con il sistema inverso a fase minima,
+		usando l'array della trasformata come memoria per il filtro */
+		SCAttach(S2,FFTArray1,FS);
+		SCSplit(FFTArray2,S2);
+		SCExp(S2);
+		SCMul(S1,S2,S1);
+		SCMerge(S1,FFTArray2);
 
 		/* Determina la risposta del sistema */
-		IFft(FFTArray1,FS);
+		IFft(FFTArray2,FS);
 
 		/* Copia il risultato nell'array destinazione */
 		for (I = 0;I < SigLen;I++)
-			Sig[I] = std::real<DLReal>(FFTArray1[I]);
+			Sig[I] = std::real<DLReal>(FFTArray2[I]);
 
 		/* Dealloca gli array */
+		SCFree(S1);
 		delete[] FFTArray1;
 		delete[] FFTArray2;
 
@@ -1508,6 +1628,8 @@ Boolean HMPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal
 		DLComplex * FFTArray1;
 		DLComplex * FFTArray2;
 		DLReal * FFTArray3;
+		SCSpectrum<DLReal> S1;
+		SCSpectrum<DLReal> S2;
 		int FS;
 		int I;
 		DLReal G;
@@ -1530,6 +1652,8 @@ Boolean HMPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal
 			return False;
 		if ((FFTArray3 = new DLReal[FS]) == NULL)
 			return False;
+		if (SCAlloc(S1,FS) == False)
+			return False;
 
 		/* Copia l'array sorgente in quello temporaneo */
 		for (I = 0;I < SigLen;I++)
@@ -1542,25 +1666,32 @@ Boolean HMPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal
 		/* Trasforma l'array risultante */
 		Fft(FFTArray1,FS);
 
+		/* Separa parte reale e immaginaria e calcola il modulo, sostituito
+		poi dall'ampiezza del filtro */
+		SCSplit(FFTArray1,S1);
+		SCAbs(S1,FFTArray3);
+
 		/* Calcola l'ampiezza per il filtro a fase minima */
 		G = OGainFactor * GetRMSLevel(Sig,SigLen);
 		LogLimit = False;
 		for (I = 0;I < FS;I++)
-			if (std::abs<DLReal>(FFTArray1[I]) <= 0)
+			if (FFTArray3[I] <= 0)
 				{
 					LogLimit = True;
-					FFTArray2[I] = DRCMaxFloat;
 					FFTArray3[I] = (DLReal) 0.0;
 				}
 			else
-				{
-					FFTArray3[I] = (DLReal) Gain / (G + (1 - OGainFactor) * std::abs<DLReal>(FFTArray1[I]));
-					FFTArray2[I] = std::log<DLReal>(FFTArray3[I]);
-				}
+				FFTArray3[I] = (DLReal) Gain / (G + (1 - OGainFactor) * FFTArray3[I]);
+		SCRealLog(FFTArray3,FFTArray2,FS);
 
 		/* Verifica se si  raggiunto il limite */
 		if (LogLimit == True)
-			sputs("Notice: limit reached in Hilbert filter computation.");
+			{
+				for (I = 0;I < FS;I++)
+					if (FFTArray3[I] <= 0)
+						FFTArray2[I] = DRCMaxFloat;
+				sputs("Notice: limit reached in Hilbert filter computation.");
+			}
 
 		/* Calcola la fase per il filtro a fase minima */
 		IFft(FFTArray2,FS);
@@ -1570,18 +1701,24 @@ Boolean HMPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal
 		FFTArray2[FS / 2] = (DLReal) 0.0;
 		Fft(FFTArray2,FS);
 
-		/* Effettua la convoluzione con il sistema inverso a fase minima */
-		for (I = 0;I < FS;I++)
-			FFTArray1[I] *= FFTArray3[I] * std::exp<DLReal>(FFTArray2[I]);
+		/* Effettua la convoluzione con il sistema inverso a fase minima,
+		usando l'array della trasformata come memoria per il filtro */
+		SCAttach(S2,FFTArray1,FS);
+		SCSplit(FFTArray2,S2);
+		SCExp(S2);
+		SCScale(S2,FFTArray3);
+		SCMul(S1,S2,S1);
+		SCMerge(S1,FFTArray2);
 
 		/* Determina la risposta del sistema */
-		IFft(FFTArray1,FS);
+		IFft(FFTArray2,FS);
 
 		/* Copia il risultato nell'array destinazione */
 		for (I = 0;I < SigLen;I++)
-			Sig[I] = std::real<DLReal>(FFTArray1[I]);
+			Sig[I] = std::real<DLReal>(FFTArray2[I]);
 
 		/* Dealloca gli array */
+		SCFree(S1);
 		delete[] FFTArray1;
 		delete[] FFTArray2;
 		delete[] FFTArray3;
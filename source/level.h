@@ -81,8 +81,12 @@
 
 	/* Limitazione picchi a fase lineare con calcolo del valore RMS sull banda indicata */
 	/* Versione con mantenimento continuit della derivata prima nei punti di limitazione */
+	/* Se SigFFT non  NULL contiene la trasformata del segnale sulla
+	dimensione determinata da MExp, ad esempio lasciata da DFftConvolveSpectrum,
+	e viene usata ed alterata al posto della trasformata del segnale */
 	Boolean C1LPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DLReal PLStart,
-		const int SampleFreq,const DLReal StartFreq,const DLReal EndFreq,const DLReal W,const int MExp);
+		const int SampleFreq,const DLReal StartFreq,const DLReal EndFreq,const DLReal W,const int MExp,
+		DLComplex * SigFFT = NULL);
 
 	/* Limitazione picchi a fase minima con calcolo del valore RMS sull banda indicata */
 	/* Versione basata sulla trasformata di Hilbert */
@@ -92,8 +96,12 @@
 	/* Limitazione picchi a fase minima con calcolo del valore RMS sull banda indicata */
 	/* Versione basata sulla trasformata di Hilbert */
 	/* Versione con mantenimento continuit della derivata prima nei punti di limitazione */
+	/* Se SigFFT non  NULL contiene la trasformata del segnale sulla
+	dimensione determinata da MExp e viene usata ed alterata al posto
+	della trasformata del segnale */
 	Boolean C1HMPPeakLimit(DLReal * Sig,const int SigLen,const DLReal MaxGain,const DLReal PLStart,
-		const int SampleFreq,const DLReal StartFreq,const DLReal EndFreq,const DLReal W,const int MExp);
+		const int SampleFreq,const DLReal StartFreq,const DLReal EndFreq,const DLReal W,const int MExp,
+		DLComplex * SigFFT = NULL);
 
 	/* Livellazione norma a fase lineare */
 	Boolean LPNormFlat(DLReal * Sig,const int SigLen,const DLReal Gain,const DLReal OGainFactor,const int MExp);
@@ -0,0 +1,189 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Gestione della modalit a ridotto consumo di memoria */
+
+/* Inclusioni */
+#include "lowmem.h"
+#include "dspalloc.h"
+#ifndef _WIN32
+	#include <sys/time.h>
+	#include <sys/resource.h>
+#endif
+#ifdef __GLIBC__
+	#include <malloc.h>
+#endif
+
+/* Memory leaks debugger */
+#ifdef DebugMLeaks
+	#include "debug_new.h"
+#endif
+
+/* Limite di memoria in byte */
+static size_t LMLimit = 0;
+
+/* Dimensione minima dei blocchi allocati direttamente dal sistema */
+#define LMMmapThreshold (256 * 1024)
+
+/* Imposta il limite di memoria in MB, 0 per nessun limite */
+void LMSetLimit(const int MemLimit)
+	{
+		if (MemLimit > 0)
+			{
+				LMLimit = ((size_t) MemLimit) * 1024 * 1024;
+
+				/* Gli array temporanei vengono restituiti subito al sistema */
+				DSPAllocSetMaxPool(0);
+
+				/* Le glibc alzano la soglia di allocazione diretta dal sistema
+				dopo il rilascio dei blocchi di grandi dimensioni, che restano
+				poi nello heap anche dopo il rilascio. Una soglia fissa fa
+				restituire subito al sistema gli array dei segnali. */
+				#ifdef __GLIBC__
+					mallopt(M_MMAP_THRESHOLD,LMMmapThreshold);
+				#endif
+			}
+		else
+			LMLimit = 0;
+	}
+
+/* Verifica se la modalit a ridotto consumo di memoria  attiva */
+Boolean LMEnabled(void)
+	{
+		return (LMLimit > 0) ? True : False;
+	}
+
+/* Determina il moltiplicatore FFT compatibile con il limite di memoria */
+int LMFitExponent(const char * Name,const int N,const int MExp,
+	const int NArrays,const size_t LiveBytes)
+	{
+		size_t FS;
+		int E;
+
+		/* Verifica se il limite  attivo */
+		if (LMLimit == 0 || MExp <= 0)
+			return MExp;
+
+		/* Calcola la potenza di due superiore a N */
+		for (FS = 1;FS <= (size_t) N;FS <<= 1);
+
+		/* Riduce il moltiplicatore fino a rientrare nel limite */
+		for (E = MExp;E > 0;E--)
+			if (LiveBytes + NArrays * (FS << E) * sizeof(DLComplex) <= LMLimit)
+				break;
+
+		if (E < MExp)
+			printf("!!Warning: %s reduced from %d to %d to fit the memory limit.\n",
+				Name,MExp,E);
+		if (LiveBytes + NArrays * (FS << E) * sizeof(DLComplex) > LMLimit)
+			printf("!!Warning: memory limit too low for %s, exceeding it.\n",Name);
+		fflush(stdout);
+
+		return E;
+	}
+
+/* Salva un segnale su file temporaneo */
+FILE * LMSpill(const DLReal * Sig,const int SigLen)
+	{
+		FILE * SF;
+
+		if ((SF = tmpfile()) == NULL)
+			return NULL;
+
+		if (fwrite(Sig,sizeof(DLReal),SigLen,SF) != (size_t) SigLen)
+			{
+				fclose(SF);
+				return NULL;
+			}
+
+		return SF;
+	}
+
+/* Recupera un segnale dal file temporaneo */
+DLReal * LMRestore(FILE * SF,const int SigLen)
+	{
+		DLReal * Sig;
+
+		if ((Sig = new DLReal[SigLen]) == NULL)
+			return NULL;
+
+		rewind(SF);
+		if (fread(Sig,sizeof(DLReal),SigLen,SF) != (size_t) SigLen)
+			{
+				delete[] Sig;
+				return NULL;
+			}
+
+		return Sig;
+	}
+
+/* Picco di memoria precedente all'ultimo azzeramento */
+static size_t LMPrevPeak = 0;
+
+/* Recupera il picco di memoria dall'ultimo azzeramento */
+size_t LMRecentPeakMemory(void)
+	{
+		#ifdef _WIN32
+			return 0;
+		#else
+			struct rusage RU;
+
+			if (getrusage(RUSAGE_SELF,&RU) != 0)
+				return 0;
+
+			/* Su Mac OS X il valore  espresso in byte, altrove in KB */
+			#ifdef __APPLE__
+				return (size_t) RU.ru_maxrss;
+			#else
+				return ((size_t) RU.ru_maxrss) * 1024;
+			#endif
+		#endif
+	}
+
+/* Recupera il picco di memoria utilizzata dal processo */
+size_t LMPeakMemory(void)
+	{
+		size_t Peak;
+
+		Peak = LMRecentPeakMemory();
+		if (LMPrevPeak > Peak)
+			return LMPrevPeak;
+		return Peak;
+	}
+
+/* Azzera il picco di memoria rilevato dal sistema operativo */
+void LMResetPeakMemory(void)
+	{
+		#ifdef __linux__
+			FILE * CRF;
+
+			LMPrevPeak = LMPeakMemory();
+			if ((CRF = fopen("/proc/self/clear_refs","w")) != NULL)
+				{
+					fputs("5",CRF);
+					fclose(CRF);
+				}
+		#endif
+	}
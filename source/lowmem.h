@@ -0,0 +1,75 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Gestione della modalit a ridotto consumo di memoria */
+
+/* Con un limite di memoria impostato, i segnali non utilizzati per lunghi
+tratti dell'elaborazione vengono parcheggiati su file temporaneo ed i
+moltiplicatori delle dimensioni FFT delle varie fasi vengono ridotti fino a
+rientrare nel limite, considerando la memoria occupata dagli array ancora in
+uso al momento della chiamata. */
+
+#ifndef LowMem_h
+	#define LowMem_h
+
+	/* Inclusioni */
+	#include "dsplib.h"
+	#include "boolean.h"
+	#include <stdio.h>
+	#include <stddef.h>
+
+	/* Imposta il limite di memoria in MB, 0 per nessun limite */
+	void LMSetLimit(const int MemLimit);
+
+	/* Verifica se la modalit a ridotto consumo di memoria  attiva */
+	Boolean LMEnabled(void);
+
+	/* Determina il moltiplicatore FFT compatibile con il limite di memoria.
+	N  la lunghezza del segnale elaborato, NArrays il numero di array
+	complessi di dimensione FFT allocati dalla procedura, comprese le
+	tabelle delle routine FFT, e LiveBytes la memoria occupata da tutti i
+	segnali in uso durante la chiamata. Se il limite non pu essere
+	rispettato nemmeno senza moltiplicatore viene emesso un avviso */
+	int LMFitExponent(const char * Name,const int N,const int MExp,
+		const int NArrays,const size_t LiveBytes);
+
+	/* Salva un segnale su file temporaneo */
+	FILE * LMSpill(const DLReal * Sig,const int SigLen);
+
+	/* Recupera un segnale dal file temporaneo, ritorna NULL in caso di errore */
+	DLReal * LMRestore(FILE * SF,const int SigLen);
+
+	/* Recupera il picco di memoria utilizzata dal processo in byte,
+	0 se non disponibile */
+	size_t LMPeakMemory(void);
+
+	/* Azzera il picco di memoria rilevato dal sistema operativo, dove
+	supportato, mantenendo quello complessivo ritornato da LMPeakMemory */
+	void LMResetPeakMemory(void);
+
+	/* Recupera il picco di memoria dall'ultimo azzeramento */
+	size_t LMRecentPeakMemory(void);
+
+#endif
@@ -29,7 +29,49 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <unistd.h>
+#endif
 #include "fftsg_h.h"
+#include "dipknee.h"
+#include "mls.h"
+
+/* Mixed radix real FFT */
+#ifdef UseDouble
+	#include "gsl/gsl_fft_real.h"
+	#include "gsl/gsl_fft_halfcomplex.h"
+
+	#define RFRWTType gsl_fft_real_wavetable
+	#define RFRWTAlloc gsl_fft_real_wavetable_alloc
+	#define RFRWTFree gsl_fft_real_wavetable_free
+	#define RFHWTType gsl_fft_halfcomplex_wavetable
+	#define RFHWTAlloc gsl_fft_halfcomplex_wavetable_alloc
+	#define RFHWTFree gsl_fft_halfcomplex_wavetable_free
+	#define RFWSType gsl_fft_real_workspace
+	#define RFWSAlloc gsl_fft_real_workspace_alloc
+	#define RFWSFree gsl_fft_real_workspace_free
+	#define RFRTransform gsl_fft_real_transform
+	#define RFHBackward gsl_fft_halfcomplex_backward
+#else
+	#include "gsl/gsl_fft_real_float.h"
+	#include "gsl/gsl_fft_halfcomplex_float.h"
+
+	#define RFRWTType gsl_fft_real_wavetable_float
+	#define RFRWTAlloc gsl_fft_real_wavetable_float_alloc
+	#define RFRWTFree gsl_fft_real_wavetable_float_free
+	#define RFHWTType gsl_fft_halfcomplex_wavetable_float
+	#define RFHWTAlloc gsl_fft_halfcomplex_wavetable_float_alloc
+	#define RFHWTFree gsl_fft_halfcomplex_wavetable_float_free
+	#define RFWSType gsl_fft_real_workspace_float
+	#define RFWSAlloc gsl_fft_real_workspace_float_alloc
+	#define RFWSFree gsl_fft_real_workspace_float_free
+	#define RFRTransform gsl_fft_real_float_transform
+	#define RFHBackward gsl_fft_halfcomplex_float_backward
+#endif
 
 /* Output stringhe con sync output e parametro */
 int sputsp(const char * s, const char * p)
@@ -67,6 +109,126 @@ size_t FSize(char * FName)
 		return (size_t) FS;
 	}
 
+/* Finds the FFT size for a convolution of length N, the smallest
+even 2^a 3^b 5^c size, or the smallest power of two if Pow2 is set */
+int FftSize(const int N,const int Pow2)
+	{
+		double P3;
+		double P5;
+		double S;
+		double Best;
+
+		for (Best = 2;Best < N;Best *= 2);
+		if (Pow2 != 0)
+			return (int) Best;
+
+		for (P5 = 1;P5 < Best;P5 *= 5)
+			for (P3 = P5;P3 < Best;P3 *= 3)
+				{
+					for (S = 2 * P3;S < N;S *= 2);
+					if (S < Best)
+						Best = S;
+				}
+		return (int) Best;
+	}
+
+/* Mixed radix wavetables for the current FFT size */
+static RFRWTType * RFRWT = NULL;
+static RFHWTType * RFHWT = NULL;
+static int RFAtExit = 0;
+
+/* Deallocates the mixed radix wavetables */
+void RealFftFree(void)
+	{
+		if (RFRWT != NULL)
+			{
+				RFRWTFree(RFRWT);
+				RFRWT = NULL;
+			}
+		if (RFHWT != NULL)
+			{
+				RFHWTFree(RFHWT);
+				RFHWT = NULL;
+			}
+	}
+
+/* Prepares the real FFT of size N, must be called before
+starting any thread using RealFft */
+int RealFftInit(const int N)
+	{
+		RealFftFree();
+
+		/* Powers of two use the Ooura FFT */
+		if ((N & (N - 1)) == 0)
+			return 0;
+
+		if (RFAtExit == 0)
+			{
+				atexit(RealFftFree);
+				RFAtExit = 1;
+			}
+
+		if ((RFRWT = RFRWTAlloc(N)) == NULL ||
+			(RFHWT = RFHWTAlloc(N)) == NULL)
+			{
+				RealFftFree();
+				return 1;
+			}
+		return 0;
+	}
+
+/* Real FFT of size N, with the same layout, sign and scaling
+of the Ooura rdft, using the mixed radix GSL FFT when N is
+not a power of two */
+int RealFft(const int N,const int Dir,DLReal * Data)
+	{
+		RFWSType * WS;
+		DLReal RN;
+		int I;
+
+		if ((N & (N - 1)) == 0)
+			{
+				rdft(N,Dir,Data);
+				return 0;
+			}
+
+		/* Each call uses its own workspace */
+		if ((WS = RFWSAlloc(N)) == NULL)
+			return 1;
+
+		if (Dir == OouraRForward)
+			{
+				/* GSL halfcomplex is r0 r1 i1 ... rn/2, Ooura is
+				r0 rn/2 r1 -i1 ... */
+				RFRTransform(Data,1,N,RFRWT,WS);
+				RN = Data[N - 1];
+				for (I = N - 1;I > 1;I -= 2)
+					{
+						Data[I] = -Data[I - 1];
+						Data[I - 1] = Data[I - 2];
+					}
+				Data[1] = RN;
+			}
+		else
+			{
+				RN = Data[1];
+				for (I = 1;I < N - 1;I += 2)
+					{
+						Data[I] = Data[I + 1];
+						Data[I + 1] = -Data[I + 2];
+					}
+				Data[N - 1] = RN;
+				RFHBackward(Data,1,N,RFHWT,WS);
+
+				/* Ooura backward transform is scaled by N / 2 */
+				for (I = 0;I < N;I++)
+					Data[I] *= (DLReal) 0.5;
+			}
+
+		RFWSFree(WS);
+		return 0;
+	}
+
 /* Calola il valore RMS del segnale Sig */
 DLReal GetRMSLevel(const DLReal * Sig,const int SigLen)
 	{
@@ -99,6 +261,811 @@ void hcconvolve(DLReal * A,const DLReal * B,const int N)
 			}
 	}
 
+/* Halfcomplex array multiply and accumulate */
+void hcmulacc(DLReal * Y,const DLReal * A,const DLReal * B,const int N)
+	{
+		int R;
+		int I;
+
+		Y[0] += A[0] * B[0];
+		Y[1] += A[1] * B[1];
+		for (R = 2,I = 3;R < N;R += 2,I += 2)
+			{
+				Y[R] += A[R] * B[R] - A[I] * B[I];
+				Y[I] += A[R] * B[I] + A[I] * B[R];
+			}
+	}
+
+/* Streaming convolution by uniformly partitioned overlap-save. The
+inverse filter is split in blocks of BS samples, each one transformed
+with a 2 * BS FFT, and the sweep is read and convolved one block at
+a time, so memory usage depends only on the inverse filter length and
+the output is written while the sweep is being read */
+int StreamConvolve(const char * SweepFile,const int SS,const DLReal * Inverse,
+	const int IS,const char * OutFile,const int BS)
+	{
+		/* Convolution parameters */
+		int FS;
+		int NP;
+		int NB;
+		int CL;
+		int OL;
+		int K;
+		int P;
+		int I;
+		DLReal * H;
+		DLReal * X;
+		DLReal * XB;
+		DLReal * Y;
+		float * RB;
+		size_t RL;
+
+		/* Peak position */
+		int MP;
+		DLReal AMax;
+
+		/* Input/output file */
+		FILE * SF;
+		FILE * OF;
+
+		/* Computes the partition parameters */
+		FS = 2 * BS;
+		NP = (IS + BS - 1) / BS;
+		CL = SS + IS - 1;
+		NB = (CL + BS - 1) / BS;
+		printf("Partition size: %d, partitions: %d, blocks: %d\n",BS,NP,NB);
+		fflush(stdout);
+
+		/* Partitioned convolution arrays allocation */
+		sputs("Partitioned convolution arrays allocation.");
+		H = (DLReal *) malloc(sizeof(DLReal) * FS * NP);
+		X = (DLReal *) malloc(sizeof(DLReal) * FS * NP);
+		XB = (DLReal *) malloc(sizeof(DLReal) * FS);
+		Y = (DLReal *) malloc(sizeof(DLReal) * FS);
+		RB = (float *) malloc(sizeof(float) * BS);
+		if (H == NULL || X == NULL || XB == NULL || Y == NULL || RB == NULL)
+			{
+				sputs("Memory allocation failure.");
+				return 1;
+			}
+
+		/* Inverse filter partitions transform */
+		sputs("Inverse filter partitions FFT...");
+		for (P = 0;P < NP;P++)
+			{
+				for (I = 0;I < BS && P * BS + I < IS;I++)
+					H[P * FS + I] = Inverse[P * BS + I];
+				for (;I < FS;I++)
+					H[P * FS + I] = (DLReal) 0.0;
+				rdft(FS,OouraRForward,&H[P * FS]);
+			}
+		for (I = 0;I < FS * NP;I++)
+			X[I] = (DLReal) 0.0;
+		for (I = 0;I < FS;I++)
+			XB[I] = (DLReal) 0.0;
+
+		/* Opens the sweep and output files */
+		sputsp("Reading sweep file: ",SweepFile);
+		if ((SF = fopen(SweepFile,"rb")) == NULL)
+			{
+				perror("Unable to open sweep file");
+				return 1;
+			}
+		sputsp("Writing output file: ",OutFile);
+		if ((OF = fopen(OutFile,"wb")) == NULL)
+			{
+				perror("Unable to open output file");
+				fclose(SF);
+				return 1;
+			}
+
+		/* Block convolution */
+		sputs("Sweep and inverse partitioned convolution...");
+		MP = 0;
+		AMax = (DLReal) 0.0;
+		for (K = 0;K < NB;K++)
+			{
+				/* Shifts the input buffer and reads the next block */
+				for (I = 0;I < BS;I++)
+					XB[I] = XB[BS + I];
+				RL = fread(RB,sizeof(float),BS,SF);
+				for (I = 0;I < (int) RL;I++)
+					XB[BS + I] = (DLReal) RB[I];
+				for (;I < BS;I++)
+					XB[BS + I] = (DLReal) 0.0;
+
+				/* Input block transform into the frequency delay line */
+				for (I = 0;I < FS;I++)
+					X[(K % NP) * FS + I] = XB[I];
+				rdft(FS,OouraRForward,&X[(K % NP) * FS]);
+
+				/* Accumulates the partitions contributions */
+				for (I = 0;I < FS;I++)
+					Y[I] = (DLReal) 0.0;
+				for (P = 0;P < NP && P <= K;P++)
+					hcmulacc(Y,&X[((K - P) % NP) * FS],&H[P * FS],FS);
+
+				/* Output block recover, only the second half is valid */
+				rdft(FS,OouraRBackward,Y);
+				OL = CL - K * BS;
+				if (OL > BS)
+					OL = BS;
+				for (I = 0;I < OL;I++)
+					{
+						RB[I] = (float) (Y[BS + I] * (DLReal) (2.0 / FS));
+						if ((DLReal) fabs(RB[I]) > AMax)
+							{
+								MP = K * BS + I;
+								AMax = (DLReal) fabs(RB[I]);
+							}
+					}
+				fwrite(RB,sizeof(float),OL,OF);
+			}
+		fclose(SF);
+		fclose(OF);
+
+		/* Peak report */
+		printf("Peak position: %d\n",MP);
+		if (AMax > (DLReal) 0.0)
+			printf("Peak value: %f (%f dB)\n",(double) AMax, (double) (20 * log10((double) AMax)));
+		else
+			printf("Peak value: %f (-inf dB)\n",(double) AMax);
+		fflush(stdout);
+
+		/* Memory deallocation */
+		free(H);
+		free(X);
+		free(XB);
+		free(Y);
+		free(RB);
+
+		/* Execution completed */
+		sputs("Completed.");
+		return 0;
+	}
+
+/* Builds an output file name adding Tag before the file extension,
+replacing the extension with NewExt if not NULL */
+char * TagFileName(const char * OutFile,const char * Tag,const char * NewExt)
+	{
+		char * FName;
+		const char * Ext;
+		const char * S;
+
+		/* Looks for the extension in the last path component */
+		Ext = strrchr(OutFile,'.');
+		S = strrchr(OutFile,'/');
+		if (Ext == NULL || (S != NULL && S > Ext))
+			Ext = OutFile + strlen(OutFile);
+		if (NewExt == NULL)
+			NewExt = Ext;
+
+		if ((FName = (char *) malloc(strlen(OutFile) + strlen(Tag) +
+			strlen(NewExt) + 1)) == NULL)
+			return NULL;
+		sprintf(FName,"%.*s%s%s",(int) (Ext - OutFile),OutFile,Tag,NewExt);
+		return FName;
+	}
+
+/* Harmonic distortion separation parameters, from the glsweep
+parameters used to generate the sweep */
+typedef struct
+	{
+		/* Number of harmonics, 0 if disabled */
+		int NH;
+
+		/* Sweep parameters */
+		double Rate;
+		double HzStart;
+		double HzEnd;
+		double Duration;
+	}
+LSHarmonicsType;
+
+/* Writes Len samples of the circular signal Sig of length SigLen,
+starting at Start */
+int WriteSegment(const char * FName,const DLReal * Sig,const int SigLen,
+	const int Start,const int Len)
+	{
+		FILE * IOF;
+		float RF;
+		int I;
+
+		if ((IOF = fopen(FName,"wb")) == NULL)
+			return 1;
+		for (I = 0;I < Len;I++)
+			{
+				RF = (float) Sig[(((Start + I) % SigLen) + SigLen) % SigLen];
+				fwrite(&RF,sizeof(float),1,IOF);
+			}
+		if (fclose(IOF) != 0)
+			return 1;
+		return 0;
+	}
+
+/* Computes the magnitude spectrum of Len samples of the circular
+signal Sig, starting at Start, with a FS points FFT */
+void SegmentSpectrum(const DLReal * Sig,const int SigLen,const int Start,
+	const int Len,DLReal * Buf,const int FS,DLReal * Mag)
+	{
+		int I;
+
+		for (I = 0;I < Len;I++)
+			Buf[I] = Sig[(((Start + I) % SigLen) + SigLen) % SigLen];
+		for (I = Len;I < FS;I++)
+			Buf[I] = (DLReal) 0.0;
+		rdft(FS,OouraRForward,Buf);
+
+		Mag[0] = (DLReal) fabs(Buf[0]);
+		for (I = 1;I < FS / 2;I++)
+			Mag[I] = (DLReal) sqrt(Buf[2 * I] * Buf[2 * I] + Buf[2 * I + 1] * Buf[2 * I + 1]);
+	}
+
+/* Splits the impulse response IR of length CS, with the linear peak
+at MP, in the linear response and the harmonic distortion responses,
+and writes the harmonic distortion against the excitation frequency */
+int HarmonicsSplit(const DLReal * IR,const int CS,const int CL,const int MP,
+	const LSHarmonicsType * HP,const char * OutFile)
+	{
+		/* Harmonic time offsets */
+		double L;
+		int HLen;
+		int Pre;
+		int HS;
+
+		/* Spectra */
+		int FS;
+		DLReal * Buf;
+		DLReal * Lin;
+		DLReal * Mag;
+		double * THD;
+
+		/* Output */
+		char Tag[32];
+		char * FName;
+		FILE * TF;
+		double F;
+		double HD;
+		int K;
+		int I;
+		int Res;
+
+		/* With a log sweep the harmonic of order K precedes the linear
+		response by L ln(K) samples */
+		L = ((int) (HP->Rate * HP->Duration)) / log(HP->HzEnd / HP->HzStart);
+
+		/* Every response is limited to the spacing between the last
+		two harmonics, with a short pre-roll */
+		HLen = (int) (L * log((HP->NH + 1.0) / HP->NH));
+		Pre = HLen / 8;
+		if (HLen < 16)
+			{
+				sputs("Harmonic responses too close, increase the sweep duration.");
+				return 1;
+			}
+		printf("Harmonic response length: %d samples.\n",HLen);
+		fflush(stdout);
+
+		/* Spectra allocation */
+		for (FS = 16;FS < HLen;FS <<= 1);
+		Buf = (DLReal *) malloc(sizeof(DLReal) * FS);
+		Lin = (DLReal *) malloc(sizeof(DLReal) * FS / 2);
+		Mag = (DLReal *) malloc(sizeof(DLReal) * FS / 2);
+		THD = (double *) malloc(sizeof(double) * FS / 2);
+		if (Buf == NULL || Lin == NULL || Mag == NULL || THD == NULL)
+			{
+				free(Buf);
+				free(Lin);
+				free(Mag);
+				free(THD);
+				sputs("Memory allocation failure.");
+				return 1;
+			}
+		for (I = 0;I < FS / 2;I++)
+			THD[I] = 0.0;
+
+		/* Linear response, from the peak up to the end of the convolution */
+		Res = 0;
+		if ((FName = TagFileName(OutFile,"-lin",NULL)) == NULL)
+			Res = 1;
+		else
+			{
+				HS = (MP - Pre > 0) ? MP - Pre : 0;
+				sputsp("Writing linear response: ",FName);
+				Res |= WriteSegment(FName,IR,CS,HS,CL - HS);
+				free(FName);
+			}
+		SegmentSpectrum(IR,CS,MP - Pre,HLen,Buf,FS,Lin);
+
+		/* Harmonic responses */
+		for (K = 2;K <= HP->NH + 1 && Res == 0;K++)
+			{
+				HS = MP - (int) floor(L * log((double) K) + 0.5) - Pre;
+
+				/* Impulse response */
+				sprintf(Tag,"-h%d",K);
+				if ((FName = TagFileName(OutFile,Tag,NULL)) == NULL)
+					{
+						Res = 1;
+						break;
+					}
+				sputsp("Writing harmonic response: ",FName);
+				Res |= WriteSegment(FName,IR,CS,HS,HLen);
+				free(FName);
+
+				/* Harmonic distortion against the excitation frequency,
+				the harmonic at K F is compared with the linear response at F */
+				SegmentSpectrum(IR,CS,HS,HLen,Buf,FS,Mag);
+				sprintf(Tag,"-hd%d",K);
+				if ((FName = TagFileName(OutFile,Tag,".txt")) == NULL ||
+					(TF = fopen(FName,"wt")) == NULL)
+					{
+						free(FName);
+						Res = 1;
+						break;
+					}
+				for (I = 1;K * I < FS / 2;I++)
+					{
+						F = I * HP->Rate / FS;
+						if (F < HP->HzStart || F > HP->HzEnd || Lin[I] <= (DLReal) 0.0)
+							continue;
+						HD = Mag[K * I] / Lin[I];
+						THD[I] += HD * HD;
+						fprintf(TF,"%f %f\n",F,(HD > 0.0) ? 20.0 * log10(HD) : -300.0);
+					}
+				fclose(TF);
+				free(FName);
+			}
+
+		/* Total harmonic distortion */
+		if (Res == 0)
+			{
+				if ((FName = TagFileName(OutFile,"-thd",".txt")) == NULL ||
+					(TF = fopen(FName,"wt")) == NULL)
+					Res = 1;
+				else
+					{
+						sputsp("Writing total harmonic distortion: ",FName);
+						for (I = 1;2 * I < FS / 2;I++)
+							{
+								F = I * HP->Rate / FS;
+								if (F < HP->HzStart || F > HP->HzEnd || Lin[I] <= (DLReal) 0.0)
+									continue;
+								fprintf(TF,"%f %f\n",F,(THD[I] > 0.0) ?
+									10.0 * log10(THD[I]) : -300.0);
+							}
+						fclose(TF);
+					}
+				free(FName);
+			}
+
+		free(Buf);
+		free(Lin);
+		free(Mag);
+		free(THD);
+		if (Res != 0)
+			sputs("Harmonic responses output failed.");
+		return Res;
+	}
+
+/* Splits the impulse response IR of length CS, obtained with NS
+overlapped sweeps delayed by DL samples, in the responses of the
+single excitation channels, each DL samples long */
+int SweepsSplit(const DLReal * IR,const int CS,const int MP,const int NS,
+	const int DL,const char * OutFile)
+	{
+		int Pre;
+		int Base;
+		int BestBase;
+		double Score;
+		double BestScore;
+		DLReal AMax;
+		char Tag[32];
+		char * FName;
+		int C;
+		int I;
+		int T;
+		int Res;
+
+		/* The global peak belongs to one of the channels, the first
+		channel position is the one giving the highest peaks at all
+		the channel positions */
+		Pre = DL / 8;
+		BestBase = MP;
+		BestScore = -1.0;
+		for (C = 0;C < NS;C++)
+			{
+				Base = MP - C * DL;
+				if (Base + Pre < 0)
+					break;
+				Score = 0.0;
+				for (I = 0;I < NS;I++)
+					{
+						AMax = (DLReal) 0.0;
+						for (T = Base + I * DL - Pre;T < Base + I * DL + Pre;T++)
+							if (T >= 0 && T < CS && (DLReal) fabs(IR[T]) > AMax)
+								AMax = (DLReal) fabs(IR[T]);
+						Score += AMax;
+					}
+				if (Score > BestScore)
+					{
+						BestScore = Score;
+						BestBase = Base;
+					}
+			}
+		printf("First channel peak position: %d\n",BestBase);
+		fflush(stdout);
+
+		/* Writes the channel responses */
+		Res = 0;
+		for (C = 0;C < NS && Res == 0;C++)
+			{
+				sprintf(Tag,"-ch%d",C + 1);
+				if ((FName = TagFileName(OutFile,Tag,NULL)) == NULL)
+					{
+						Res = 1;
+						break;
+					}
+				sputsp("Writing channel response: ",FName);
+				Res = WriteSegment(FName,IR,CS,BestBase + C * DL - Pre,DL);
+				free(FName);
+			}
+
+		if (Res != 0)
+			sputs("Channel responses output failed.");
+		return Res;
+	}
+
+/* Recovers the impulse responses from a recorded maximum length
+sequence of the given order and amplitude, played on NE excitation
+channels, each one shifted by one NE-th of the sequence length */
+int MLSConvolve(const char * SweepFile,const char * OutFile,const int Order,
+	const double Amplitude,const int NE)
+	{
+		FILE * IOF;
+		double * Y;
+		double * H;
+		float * RB;
+		int L;
+		int RL;
+		int NP;
+		int SL;
+		int P;
+		int I;
+		int C;
+		int Res;
+		char Tag[32];
+		char * FName;
+
+		L = MLSLength(Order);
+		RL = FSize((char *) SweepFile) / sizeof(float);
+		printf("Sequence length: %d samples.\n",L);
+		fflush(stdout);
+
+		/* The first period is discarded, since the response is not
+		yet periodic, the following complete periods are averaged */
+		NP = RL / L - 1;
+		if (NP < 1)
+			{
+				sputs("The recording must contain at least two sequence periods.");
+				return 1;
+			}
+		printf("Averaged periods: %d\n",NP);
+		fflush(stdout);
+
+		Y = (double *) malloc(sizeof(double) * L);
+		H = (double *) malloc(sizeof(double) * L);
+		RB = (float *) malloc(sizeof(float) * L);
+		if (Y == NULL || H == NULL || RB == NULL)
+			{
+				free(Y);
+				free(H);
+				free(RB);
+				sputs("Memory allocation failure.");
+				return 1;
+			}
+
+		/* Reads and averages the periods */
+		sputsp("Reading recording file: ",SweepFile);
+		if ((IOF = fopen(SweepFile,"rb")) == NULL)
+			{
+				perror("Unable to open recording file");
+				free(Y);
+				free(H);
+				free(RB);
+				return 1;
+			}
+		for (I = 0;I < L;I++)
+			Y[I] = 0.0;
+		fseek(IOF,(long) (sizeof(float) * L),SEEK_SET);
+		for (P = 0;P < NP;P++)
+			{
+				fread(RB,sizeof(float),L,IOF);
+				for (I = 0;I < L;I++)
+					Y[I] += RB[I];
+			}
+		fclose(IOF);
+
+		/* Cross correlation by the fast Hadamard transform */
+		sputs("Sequence decoding...");
+		MLSDecode(Order,Y,H);
+		for (I = 0;I < L;I++)
+			H[I] /= NP * Amplitude;
+
+		/* Writes the responses, each channel takes one NE-th
+		of the sequence length */
+		Res = 0;
+		SL = L / NE;
+		for (C = 0;C < NE && Res == 0;C++)
+			{
+				if (NE > 1)
+					{
+						sprintf(Tag,"-ch%d",C + 1);
+						FName = TagFileName(OutFile,Tag,NULL);
+					}
+				else
+					FName = TagFileName(OutFile,"",NULL);
+				if (FName == NULL || (IOF = fopen(FName,"wb")) == NULL)
+					{
+						Res = 1;
+						free(FName);
+						break;
+					}
+				sputsp("Writing output file: ",FName);
+				for (I = 0;I < SL;I++)
+					RB[I] = (float) H[C * SL + I];
+				fwrite(RB,sizeof(float),SL,IOF);
+				if (fclose(IOF) != 0)
+					Res = 1;
+				free(FName);
+			}
+
+		free(Y);
+		free(H);
+		free(RB);
+		if (Res != 0)
+			{
+				sputs("Output file write failed.");
+				return 1;
+			}
+		sputs("Completed.");
+		return 0;
+	}
+
+/* Multichannel deconvolution job */
+typedef struct
+	{
+		/* Input file, channel and number of interleaved channels */
+		char * SweepFile;
+		int Channel;
+		int NChannels;
+
+		/* Output file */
+		char * OutFile;
+
+		/* Results */
+		int Res;
+		int MP;
+		DLReal AMax;
+	}
+LSJobType;
+
+/* Multichannel deconvolution shared data */
+typedef struct
+	{
+		/* Inverse or reference compensated spectrum */
+		const DLReal * Inverse;
+
+		/* Convolution size and length */
+		int CS;
+		int CL;
+
+		/* Harmonic distortion separation */
+		const LSHarmonicsType * HP;
+
+		/* Jobs list and next job to process */
+		LSJobType * Jobs;
+		int NJobs;
+		int NextJob;
+		#ifndef _WIN32
+			pthread_mutex_t Lock;
+		#endif
+	}
+LSBatchType;
+
+/* Reads one channel of an interleaved file, returns the
+number of samples read */
+int ReadChannel(const char * FName,const int NC,const int C,DLReal * Sig,
+	const int SigLen)
+	{
+		FILE * IOF;
+		float * RB;
+		size_t RL;
+		int FL;
+		int I;
+		int J;
+
+		if ((IOF = fopen(FName,"rb")) == NULL)
+			return -1;
+
+		/* Reads a block of frames at a time */
+		FL = 4096;
+		if ((RB = (float *) malloc(sizeof(float) * FL * NC)) == NULL)
+			{
+				fclose(IOF);
+				return -1;
+			}
+		J = 0;
+		while (J < SigLen && (RL = fread(RB,sizeof(float) * NC,FL,IOF)) > 0)
+			for (I = 0;I < (int) RL && J < SigLen;I++,J++)
+				Sig[J] = (DLReal) RB[I * NC + C];
+
+		free(RB);
+		fclose(IOF);
+		return J;
+	}
+
+/* Builds the output file name of a channel, adding "-chN" before
+the file extension */
+char * ChannelFileName(const char * OutFile,const int C)
+	{
+		char Tag[32];
+
+		sprintf(Tag,"-ch%d",C + 1);
+		return TagFileName(OutFile,Tag,NULL);
+	}
+
+/* Deconvolves a single channel */
+void ChannelConvolve(const LSBatchType * LB,LSJobType * Job,DLReal * Sweep)
+	{
+		FILE * IOF;
+		float RF;
+		int SL;
+		int I;
+
+		/* Reads the channel */
+		SL = ReadChannel(Job->SweepFile,Job->NChannels,Job->Channel,Sweep,LB->CS);
+		if (SL < 0)
+			{
+				Job->Res = 1;
+				return;
+			}
+		for (I = SL;I < LB->CS;I++)
+			Sweep[I] = (DLReal) 0.0;
+
+		/* Convolving sweep and inverse */
+		RealFft(LB->CS,OouraRForward,Sweep);
+		hcconvolve(Sweep,LB->Inverse,LB->CS);
+
+		/* Impulse response recover */
+		RealFft(LB->CS,OouraRBackward,Sweep);
+		for (I = 0;I < LB->CS;I++)
+			Sweep[I] *= (DLReal) (2.0  / LB->CS);
+
+		/* Peak search */
+		Job->MP = 0;
+		Job->AMax = (DLReal) 0.0;
+		for (I = 0;I < LB->CS;I++)
+			if ((DLReal) fabs(Sweep[I]) > Job->AMax)
+				{
+					Job->MP = I;
+					Job->AMax = (DLReal) fabs(Sweep[I]);
+				}
+
+		/* Writes output file */
+		if ((IOF = fopen(Job->OutFile,"wb")) == NULL)
+			{
+				Job->Res = 1;
+				return;
+			}
+		for(I = 0;I < LB->CL;I++)
+			{
+				RF = (float) Sweep[I];
+				fwrite(&RF,sizeof(float),1,IOF);
+			}
+		fclose(IOF);
+
+		/* Harmonic distortion separation */
+		if (LB->HP->NH > 0)
+			{
+				Job->Res = HarmonicsSplit(Sweep,LB->CS,LB->CL,Job->MP,LB->HP,Job->OutFile);
+				return;
+			}
+		Job->Res = 0;
+	}
+
+/* Deconvolution worker, processes the jobs until the list is empty */
+void * ChannelWorker(void * Arg)
+	{
+		LSBatchType * LB = (LSBatchType *) Arg;
+		DLReal * Sweep;
+		int J;
+
+		/* Each worker uses its own convolution array */
+		if ((Sweep = (DLReal *) malloc(sizeof(DLReal) * LB->CS)) == NULL)
+			return NULL;
+
+		for (;;)
+			{
+				/* Gets the next job */
+				#ifndef _WIN32
+					pthread_mutex_lock(&LB->Lock);
+				#endif
+				J = LB->NextJob++;
+				#ifndef _WIN32
+					pthread_mutex_unlock(&LB->Lock);
+				#endif
+				if (J >= LB->NJobs)
+					break;
+
+				ChannelConvolve(LB,&LB->Jobs[J],Sweep);
+			}
+
+		free(Sweep);
+		return NULL;
+	}
+
+/* Deconvolves all the jobs with the shared spectrum, using up to
+NThreads parallel threads, returns the number of failed jobs */
+int BatchConvolve(LSBatchType * LB,int NThreads)
+	{
+		int I;
+		int NF;
+		#ifndef _WIN32
+			pthread_t * TH;
+		#endif
+
+		LB->NextJob = 0;
+		for (I = 0;I < LB->NJobs;I++)
+			LB->Jobs[I].Res = 1;
+
+		/* Runs the workers */
+		if (NThreads > LB->NJobs)
+			NThreads = LB->NJobs;
+		#ifdef _WIN32
+			ChannelWorker(LB);
+		#else
+			pthread_mutex_init(&LB->Lock,NULL);
+			if (NThreads <= 1 || (TH = (pthread_t *) malloc(sizeof(pthread_t) * NThreads)) == NULL)
+				ChannelWorker(LB);
+			else
+				{
+					/* The calling thread is the first worker */
+					for (I = 1;I < NThreads;I++)
+						if (pthread_create(&TH[I],NULL,ChannelWorker,LB) != 0)
+							break;
+					NF = I;
+					ChannelWorker(LB);
+					for (I = 1;I < NF;I++)
+						pthread_join(TH[I],NULL);
+					free(TH);
+				}
+			pthread_mutex_destroy(&LB->Lock);
+		#endif
+
+		/* Reports the results */
+		NF = 0;
+		for (I = 0;I < LB->NJobs;I++)
+			{
+				if (LB->Jobs[I].Res != 0)
+					{
+						sputsp("Channel deconvolution failed: ",LB->Jobs[I].OutFile);
+						NF++;
+						continue;
+					}
+				printf("Channel %d, %s: peak position %d, peak value ",I + 1,
+					LB->Jobs[I].OutFile,LB->Jobs[I].MP);
+				if (LB->Jobs[I].AMax > (DLReal) 0.0)
+					printf("%f (%f dB)\n",(double) LB->Jobs[I].AMax,
+						(double) (20 * log10((double) LB->Jobs[I].AMax)));
+				else
+					printf("%f (-inf dB)\n",(double) LB->Jobs[I].AMax);
+			}
+		fflush(stdout);
+
+		return NF;
+	}
+
 /* Main procedure */
 int main(int argc, char * argv[])
 	{
@@ -109,6 +1076,26 @@ int main(int argc, char * argv[])
 		char * RefSweepFile;
 		DLReal MinGain;
 		DLReal DLStart;
+		int BlockSize;
+		int NChannels;
+		int NThreads;
+		int Pow2;
+		int AO;
+
+		/* Harmonic distortion separation */
+		LSHarmonicsType HP;
+
+		/* Multiple excitation channels */
+		int NSweeps;
+		double SweepDelay;
+		double SweepRate;
+		int MLSOrder;
+		double MLSAmplitude;
+		int MLSChannels;
+
+		/* Multichannel deconvolution */
+		LSBatchType LB;
+		char * SL;
 
 		/* Convolution parameters */
 		int SS;
@@ -125,11 +1112,6 @@ int main(int argc, char * argv[])
 		/* Dip limiting */
 		DLReal RMSLevel;
 		DLReal RMSMin;
-		DLReal DLSLevel;
-		DLReal DLLevel;
-		DLReal DLGFactor;
-		DLReal DLAbs;
-		DLReal DLTheta;
 
 		/* Peak position */
 		int MP;
@@ -150,21 +1132,122 @@ int main(int argc, char * argv[])
 		sputs("the GNU GPL and is provided to you as is, without any warranty");
 		sputs("of any kind. Please read the file \"COPYING\" for details.");
 
+		/* Options parsing */
+		BlockSize = 0;
+		NChannels = 1;
+		Pow2 = 0;
+		HP.NH = 0;
+		NSweeps = 1;
+		MLSOrder = 0;
+		#ifdef _WIN32
+			NThreads = 1;
+		#else
+			NThreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+		#endif
+		for (AO = 1;AO < argc && argv[AO][0] == '-' && argv[AO][1] == '-';AO++)
+			{
+				if (strncmp(argv[AO],"--block=",8) == 0)
+					{
+						/* Rounds the block size to a power of two */
+						for (BlockSize = 16;BlockSize < atoi(&argv[AO][8]);BlockSize <<= 1);
+					}
+				else if (strncmp(argv[AO],"--channels=",11) == 0)
+					NChannels = atoi(&argv[AO][11]);
+				else if (strncmp(argv[AO],"--threads=",10) == 0)
+					NThreads = atoi(&argv[AO][10]);
+				else if (strcmp(argv[AO],"--pow2") == 0)
+					Pow2 = 1;
+				else if (strncmp(argv[AO],"--harmonics=",12) == 0)
+					{
+						if (sscanf(&argv[AO][12],"%d,%lf,%lf,%lf,%lf",&HP.NH,&HP.Rate,
+							&HP.HzStart,&HP.HzEnd,&HP.Duration) != 5 || HP.NH < 1 ||
+							HP.Rate <= 0 || HP.HzStart <= 0 || HP.HzEnd <= HP.HzStart ||
+							HP.Duration <= 0)
+							{
+								sputsp("\nInvalid harmonics option: ",argv[AO]);
+								return 1;
+							}
+					}
+				else if (strncmp(argv[AO],"--sweeps=",9) == 0)
+					{
+						if (sscanf(&argv[AO][9],"%d,%lf,%lf",&NSweeps,&SweepDelay,
+							&SweepRate) != 3 || NSweeps < 1 || SweepDelay <= 0 || SweepRate <= 0)
+							{
+								sputsp("\nInvalid sweeps option: ",argv[AO]);
+								return 1;
+							}
+					}
+				else if (strncmp(argv[AO],"--mls=",6) == 0)
+					{
+						MLSChannels = 1;
+						if (sscanf(&argv[AO][6],"%d,%lf,%d",&MLSOrder,&MLSAmplitude,
+							&MLSChannels) < 2 || MLSLength(MLSOrder) == 0 ||
+							MLSAmplitude <= 0 || MLSChannels < 1)
+							{
+								sputsp("\nInvalid MLS option: ",argv[AO]);
+								return 1;
+							}
+					}
+				else
+					{
+						sputsp("\nUnknown option: ",argv[AO]);
+						return 1;
+					}
+			}
+		argc -= AO - 1;
+		argv += AO - 1;
+
 		/* Check program arguments */
-		if (argc < 4 || (argc > 4 && argc < 6))
+		if ((MLSOrder == 0 && (argc < 4 || (argc > 4 && argc < 6))) ||
+			(MLSOrder > 0 && argc != 3))
 			{
-				sputs("\nUsage: LSConv sweepfile inversefile outfile [refsweep mingain [dlstart]]");
+				sputs("\nUsage: LSConv [options] sweepfile inversefile outfile [refsweep mingain [dlstart]]");
+				sputs("       LSConv --mls=order,amplitude[,channels] recfile outfile");
 				sputs("\nParameters:\n");
+				sputs("  options: optional settings:");
+				sputs("    --block=N: streaming mode, partitioned convolution with");
+				sputs("      blocks of N samples (rounded to a power of two)");
+				sputs("    --channels=N: sweepfile is an interleaved N channels recording,");
+				sputs("      one output file per channel, named outfile-chK");
+				sputs("    --threads=N: number of parallel threads for multiple channels");
+				sputs("    --pow2: use a power of two FFT size instead of the");
+				sputs("      smallest 2^a 3^b 5^c size");
+				sputs("    --harmonics=K,rate,hzstart,hzend,duration: writes the linear");
+				sputs("      response and the first K harmonic responses, with their");
+				sputs("      distortion levels, using the glsweep sweep parameters");
+				sputs("    --sweeps=N,delay,rate: sweepfile is the recording of N");
+				sputs("      overlapped sweeps delayed by delay seconds, as generated by");
+				sputs("      glsweep --channels=N --delay=delay, one output per sweep");
+				sputs("    --mls=order,amplitude[,channels]: recfile is the recording");
+				sputs("      of a maximum length sequence generated by glsweep --mls,");
+				sputs("      one output per excitation channel");
+				sputs("  A comma separated list of sweep files is processed like");
+				sputs("  a multichannel recording, one channel per file");
 				sputs("  sweepfile: sweep file name");
 				sputs("  inversefile: inverse sweep file name");
 				sputs("  outfile: output impulse response file");
 				sputs("  refsweep: reference channel sweep file name");
 				sputs("  mingain: min gain for reference channel inversion");
 				sputs("  dlstart: dip limiting start for reference channel inversion");
-				sputs("\nExample: lsconv sweep.pcm inverse.pcm impulse.pcm refchannel.pcm 0.1 0.8\n");
+				sputs("\nExample: lsconv sweep.pcm inverse.pcm impulse.pcm refchannel.pcm 0.1 0.8");
+				sputs("         lsconv --block=16384 sweep.pcm inverse.pcm impulse.pcm");
+				sputs("         lsconv --channels=24 sweep24.pcm inverse.pcm impulse.pcm");
+				sputs("         lsconv --harmonics=4,44100,10,21000,45 sweep.pcm inverse.pcm impulse.pcm");
+				sputs("         lsconv --mls=18,0.5 mls.pcm impulse.pcm\n");
 				return 0;
 			}
 
+		/* Maximum length sequence decoding */
+		if (MLSOrder > 0)
+			{
+				if (NChannels > 1 || BlockSize > 0 || HP.NH > 0 || NSweeps > 1)
+					{
+						sputs("MLS decoding available only for a single recording channel.");
+						return 1;
+					}
+				return MLSConvolve(argv[1],argv[2],MLSOrder,MLSAmplitude,MLSChannels);
+			}
+
 		/* Get the input parameters from the command line */
 		sputs("\nCommand line parsing.");
 		SweepFile = argv[1];
@@ -176,7 +1259,10 @@ int main(int argc, char * argv[])
 				MinGain = (DLReal) atof(argv[5]);
 			}
 		else
-			RefSweepFile = NULL;
+			{
+				RefSweepFile = NULL;
+				MinGain = 0;
+			}
 		if (argc >= 7)
 			DLStart = (DLReal) atof(argv[6]);
 		else
@@ -184,14 +1270,106 @@ int main(int argc, char * argv[])
 
 		/* Computes the convolution length */
 		sputs("Convolution length computation.");
-		SS = FSize(SweepFile) / sizeof(float);
+		LB.Jobs = NULL;
+		LB.NJobs = 0;
+		SL = NULL;
+		if (NChannels < 1)
+			{
+				sputs("Invalid number of channels.");
+				return 1;
+			}
+		if (NChannels > 1 || strchr(SweepFile,',') != NULL)
+			{
+				/* Multichannel mode, sets up one job per channel */
+				if (BlockSize > 0)
+					{
+						sputs("Streaming mode not available with multiple channels.");
+						return 1;
+					}
+				if (NSweeps > 1)
+					{
+						sputs("Sweeps separation not available with multiple channels.");
+						return 1;
+					}
+				if (NChannels > 1)
+					LB.NJobs = NChannels;
+				else
+					for (LB.NJobs = 1,I = 0;SweepFile[I] != '\0';I++)
+						if (SweepFile[I] == ',')
+							LB.NJobs++;
+				if ((LB.Jobs = (LSJobType *) malloc(sizeof(LSJobType) * LB.NJobs)) == NULL ||
+					(SL = (char *) malloc(strlen(SweepFile) + 1)) == NULL)
+					{
+						sputs("Memory allocation failure.");
+						return 1;
+					}
+				strcpy(SL,SweepFile);
+
+				SS = 0;
+				for (I = 0;I < LB.NJobs;I++)
+					{
+						if (NChannels > 1)
+							{
+								/* Interleaved channels of a single file */
+								LB.Jobs[I].SweepFile = SweepFile;
+								LB.Jobs[I].Channel = I;
+								LB.Jobs[I].NChannels = NChannels;
+								SS = FSize(SweepFile) / (sizeof(float) * NChannels);
+							}
+						else
+							{
+								/* One file per channel */
+								LB.Jobs[I].SweepFile = strtok(I == 0 ? SL : NULL,",");
+								LB.Jobs[I].Channel = 0;
+								LB.Jobs[I].NChannels = 1;
+								J = FSize(LB.Jobs[I].SweepFile) / sizeof(float);
+								if (J > SS)
+									SS = J;
+							}
+						if ((LB.Jobs[I].OutFile = ChannelFileName(OutFile,I)) == NULL)
+							{
+								sputs("Memory allocation failure.");
+								return 1;
+							}
+					}
+				printf("Channels: %d, sweep length: %d samples.\n",LB.NJobs,SS);
+				fflush(stdout);
+			}
+		else
+			SS = FSize(SweepFile) / sizeof(float);
 		IS = FSize(InverseFile) / sizeof(float);
 		if (RefSweepFile != NULL)
 			RS = FSize(RefSweepFile) / sizeof(float);
 		else
 			RS = 1;
 		CL = SS + IS + RS - 2;
-		for(CS = 1;CS < CL;CS <<= 1);
+		CS = FftSize(CL,Pow2);
+
+		/* Streaming mode, the inverse filter is read on its own */
+		if (BlockSize > 0)
+			{
+				if (RefSweepFile != NULL)
+					{
+						sputs("Streaming mode not available with a reference channel.");
+						return 1;
+					}
+				if (HP.NH > 0 || NSweeps > 1)
+					{
+						sputs("Streaming mode not available with harmonics or sweeps separation.");
+						return 1;
+					}
+				CS = IS;
+			}
+		else
+			{
+				printf("FFT size: %d samples.\n",CS);
+				fflush(stdout);
+				if (RealFftInit(CS) != 0)
+					{
+						sputs("Memory allocation failure.");
+						return 1;
+					}
+			}
 
 		/* Convolution arrays allocation */
 		sputs("Convolution arrays allocation.");
@@ -223,8 +1401,17 @@ int main(int argc, char * argv[])
 			Inverse[I] = (DLReal) 0.0;
 		fclose(IOF);
 
+		/* Streaming convolution */
+		if (BlockSize > 0)
+			{
+				I = StreamConvolve(SweepFile,SS,Inverse,IS,OutFile,BlockSize);
+				free(Sweep);
+				free(Inverse);
+				return I;
+			}
+
 		sputs("Inverse filter FFT...");
-		rdft(CS,OouraRForward,Inverse);
+		RealFft(CS,OouraRForward,Inverse);
 
 		/* Check the reference file */
 		if (RefSweepFile != NULL)
@@ -247,7 +1434,7 @@ int main(int argc, char * argv[])
 
 				/* Convolving sweep and inverse */
 				sputs("Reference inversion and convolution...");
-				rdft(CS,OouraRForward,Sweep);
+				RealFft(CS,OouraRForward,Sweep);
 				hcconvolve(Sweep,Inverse,CS);
 
 				/* Computes the RMS Level */
@@ -257,103 +1444,40 @@ int main(int argc, char * argv[])
 				RMSLevel = (DLReal) sqrt(2.0 * RMSLevel / CS);
 				RMSMin = MinGain * RMSLevel;
 
-				/* Check the gain truncation type */
-				if (DLStart >= (DLReal) 1.0)
-					{
-						/* Check starting components */
-						if (Sweep[0] < RMSMin)
-							Sweep[0] = ((DLReal) 1.0) / RMSMin;
-						else
-							Sweep[0] = ((DLReal) 1.0) / Sweep[0];
-						if (Sweep[1] < RMSMin)
-							Sweep[1] = ((DLReal) 1.0) / RMSMin;
-						else
-							Sweep[1] = ((DLReal) 1.0) / Sweep[1];
+				/* Dip limited inversion */
+				DKInvertHC(Sweep,CS,RMSMin,DLStart);
 
-						/* Gain truncation scan */
-						for (I = 2,J = 3;I < CS;I += 2,J += 2)
-							{
-								/* Gain computation */
-								DLAbs = (DLReal) hypot(Sweep[I],Sweep[J]);
-
-								/* Gain check and limitation */
-								if (DLAbs < RMSMin)
-									{
-										/* Gain limited inversion */
-										DLTheta = (DLReal) atan2(Sweep[J],Sweep[I]);
-										DLAbs = ((DLReal) 1.0) / RMSMin;
-										Sweep[I] = DLAbs * (DLReal) cos(-DLTheta);
-										Sweep[J] = DLAbs * (DLReal) sin(-DLTheta);
-									}
-								else
-									{
-										/* Inversion and renormalization */
-										DLAbs = ((DLReal) 1.0) / (DLAbs * DLAbs);
-										Sweep[I] *= DLAbs;
-										Sweep[J] *= -DLAbs;
-									}
-							}
-					}
-				else
-					{
-						/* Determina i fattori per la limitazione guadagno */
-						DLSLevel = RMSMin / DLStart;
-						DLGFactor = DLSLevel - RMSMin;
+				/* Inverse convolution */
+				hcconvolve(Inverse,Sweep,CS);
+			}
 
-						/* Check starting components */
-						if (Sweep[0] < DLSLevel)
-							{
-								/* Riassegna il guadagno del filtro */
-								DLLevel = (DLSLevel - Sweep[0]) / DLGFactor;
-								DLLevel = DLLevel / (((DLReal) 1.0) + DLLevel);
-								Sweep[0] = ((DLReal) 1.0) / (DLSLevel - DLGFactor * DLLevel);
-							}
-						else
-							Sweep[0] = ((DLReal) 1.0) / Sweep[0];
-						if (Sweep[1] < DLSLevel)
-							{
-								/* Riassegna il guadagno del filtro */
-								DLLevel = (DLSLevel - Sweep[1]) / DLGFactor;
-								DLLevel = DLLevel / (((DLReal) 1.0) + DLLevel);
-								Sweep[1] = ((DLReal) 1.0) / (DLSLevel - DLGFactor * DLLevel);
-							}
-						else
-							Sweep[1] = ((DLReal) 1.0) / Sweep[1];
+		/* Multichannel deconvolution with the shared inverse spectrum */
+		if (LB.NJobs > 0)
+			{
+				free(Sweep);
+				if (NThreads < 1)
+					NThreads = 1;
+				printf("Channels deconvolution, %d threads...\n",
+					NThreads < LB.NJobs ? NThreads : LB.NJobs);
+				fflush(stdout);
+				LB.Inverse = Inverse;
+				LB.CS = CS;
+				LB.CL = CL;
+				LB.HP = &HP;
+				I = BatchConvolve(&LB,NThreads);
 
-						/* Scansione per limitazione guadagno */
-						for (I = 2,J = 3;I < CS;I += 2,J += 2)
-							{
-								DLAbs = (DLReal) hypot(Sweep[I],Sweep[J]);
-								if (DLAbs <= (DLReal) 0.0)
-									{
-										Sweep[I] = ((DLReal) 1.0) / RMSMin;
-										Sweep[J] = 0;
-									}
-								else
-									if (DLAbs < DLSLevel)
-										{
-											/* Riassegna il guadagno del filtro */
-											DLLevel = (DLSLevel - DLAbs) / DLGFactor;
-											DLLevel = DLLevel / (((DLReal) 1.0) + DLLevel);
-											DLAbs = ((DLReal) 1.0) / (DLSLevel - DLGFactor * DLLevel);
-
-											/* Gain limited inversion */
-											DLTheta = (DLReal) atan2(Sweep[J],Sweep[I]);
-											Sweep[I] = DLAbs * (DLReal) cos(-DLTheta);
-											Sweep[J] = DLAbs * (DLReal) sin(-DLTheta);
-										}
-									else
-										{
-											/* Inversion and renormalization */
-											DLAbs = ((DLReal) 1.0) / (DLAbs * DLAbs);
-											Sweep[I] *= DLAbs;
-											Sweep[J] *= -DLAbs;
-										}
-							}
-					}
+				/* Memory deallocation */
+				for (J = 0;J < LB.NJobs;J++)
+					free(LB.Jobs[J].OutFile);
+				free(LB.Jobs);
+				free(SL);
+				free(Inverse);
+				if (I > 0)
+					return 1;
 
-				/* Inverse convolution */
-				hcconvolve(Inverse,Sweep,CS);
+				/* Execution completed */
+				sputs("Completed.");
+				return 0;
 			}
 
 		/* Read the sweep file */
@@ -374,11 +1498,11 @@ int main(int argc, char * argv[])
 
 		/* Convolving sweep and inverse */
 		sputs("Sweep and inverse convolution...");
-		rdft(CS,OouraRForward,Sweep);
+		RealFft(CS,OouraRForward,Sweep);
 		hcconvolve(Sweep,Inverse,CS);
 
 		/* Impulse response recover */
-		rdft(CS,OouraRBackward,Sweep);
+		RealFft(CS,OouraRBackward,Sweep);
 		for (I = 0;I < CS;I++)
 			Sweep[I] *= (DLReal) (2.0  / CS);
 
@@ -414,6 +1538,24 @@ int main(int argc, char * argv[])
 			}
 		fclose(IOF);
 
+		/* Harmonic distortion separation */
+		if (HP.NH > 0)
+			if (HarmonicsSplit(Sweep,CS,CL,MP,&HP,OutFile) != 0)
+				{
+					free(Sweep);
+					free(Inverse);
+					return 1;
+				}
+
+		/* Overlapped sweeps separation */
+		if (NSweeps > 1)
+			if (SweepsSplit(Sweep,CS,MP,NSweeps,(int) (SweepDelay * SweepRate),OutFile) != 0)
+				{
+					free(Sweep);
+					free(Inverse);
+					return 1;
+				}
+
 		/* Memory deallocation */
 		free(Sweep);
 		free(Inverse);
@@ -0,0 +1,161 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Maximum length sequence generation and decoding */
+
+/* Includes */
+#include "mls.h"
+#include <stdlib.h>
+
+/* Primitive polynomials x^M + ..., bit mask of the lower terms,
+for orders from MLSMinOrder to MLSMaxOrder */
+static const unsigned long MLSPoly[MLSMaxOrder - MLSMinOrder + 1] =
+	{
+		0x3, 0x3, 0x3, 0x5, 0x3, 0x3, 0x1d, 0x11, 0x9, 0x5, 0x53,
+		0x1b, 0x443, 0x3, 0x100b, 0x9, 0x81, 0x27, 0x9, 0x5, 0x3,
+		0x21, 0x87
+	};
+
+/* Length of the sequence of the given order, 0 if not supported */
+int MLSLength(const int Order)
+	{
+		if (Order < MLSMinOrder || Order > MLSMaxOrder)
+			return 0;
+		return (1 << Order) - 1;
+	}
+
+/* Generates the sequence of the given order as 0 or 1 values */
+int MLSGenerate(const int Order,unsigned char * S)
+	{
+		unsigned long Poly;
+		int L;
+		int N;
+		int I;
+		unsigned char B;
+
+		if ((L = MLSLength(Order)) == 0)
+			return 1;
+		Poly = MLSPoly[Order - MLSMinOrder];
+
+		/* Any non zero initial state gives the same sequence,
+		circularly shifted */
+		S[0] = 1;
+		for (I = 1;I < Order;I++)
+			S[I] = 0;
+
+		/* Linear recurrence given by the polynomial */
+		for (N = 0;N < L - Order;N++)
+			{
+				B = 0;
+				for (I = 0;I < Order;I++)
+					if ((Poly >> I) & 1)
+						B ^= S[N + I];
+				S[N + Order] = B;
+			}
+
+		return 0;
+	}
+
+/* In place fast Walsh-Hadamard transform of size N */
+static void FWHT(double * W,const int N)
+	{
+		int Len;
+		int I;
+		int J;
+		double A;
+		double B;
+
+		for (Len = 1;Len < N;Len <<= 1)
+			for (I = 0;I < N;I += 2 * Len)
+				for (J = I;J < I + Len;J++)
+					{
+						A = W[J];
+						B = W[J + Len];
+						W[J] = A + B;
+						W[J + Len] = A - B;
+					}
+	}
+
+/* Circular cross correlation with the sequence by the fast
+Hadamard transform */
+int MLSDecode(const int Order,const double * Y,double * H)
+	{
+		unsigned char * S;
+		double * W;
+		int NJ[MLSMaxOrder];
+		int L;
+		int N;
+		int K;
+		int J;
+		unsigned long V;
+
+		if ((L = MLSLength(Order)) == 0)
+			return 1;
+		S = (unsigned char *) malloc(L);
+		W = (double *) malloc(sizeof(double) * (L + 1));
+		if (S == NULL || W == NULL)
+			{
+				free(S);
+				free(W);
+				return 1;
+			}
+		MLSGenerate(Order,S);
+
+		/* Input permutation, the response sample at time N goes at the
+		index given by the generator state, i.e. the window of Order
+		sequence values starting at N */
+		for (N = 0;N <= L;N++)
+			W[N] = 0.0;
+		for (V = 0,J = 0;J < Order;J++)
+			V |= ((unsigned long) S[J]) << J;
+		for (N = 0;N < L;N++)
+			{
+				W[V] = Y[N];
+
+				/* Times at which the state is a single bit */
+				if ((V & (V - 1)) == 0)
+					for (J = 0;J < Order;J++)
+						if (V == (1UL << J))
+							NJ[J] = N;
+
+				V = (V >> 1) | (((unsigned long) S[(N + Order) % L]) << (Order - 1));
+			}
+
+		/* Hadamard transform */
+		FWHT(W,L + 1);
+
+		/* Output permutation, lag K is found at the index whose bits are
+		the sequence values K samples before the single bit states */
+		for (K = 0;K < L;K++)
+			{
+				for (V = 0,J = 0;J < Order;J++)
+					V |= ((unsigned long) S[((NJ[J] - K) % L + L) % L]) << J;
+				H[K] = W[V] / (L + 1);
+			}
+
+		free(S);
+		free(W);
+		return 0;
+	}
@@ -0,0 +1,54 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Maximum length sequence generation and decoding, shared by glsweep
+and lsconv */
+
+/* The sequence of order M has length L = 2^M - 1 and is played as
+1 - 2 s[n], where s[n] is 0 or 1. The impulse response is recovered
+from one period of the steady state response by the circular cross
+correlation with the sequence, computed with a fast Hadamard transform
+of size 2^M between two permutations (Borish and Angell). */
+
+#ifndef MLS_h
+	#define MLS_h
+
+	/* Supported orders */
+	#define MLSMinOrder 2
+	#define MLSMaxOrder 24
+
+	/* Length of the sequence of the given order, 0 if not supported */
+	int MLSLength(const int Order);
+
+	/* Generates the sequence of the given order as 0 or 1 values in S,
+	which must hold MLSLength(Order) values */
+	int MLSGenerate(const int Order,unsigned char * S);
+
+	/* Computes the circular cross correlation between one period Y of
+	the response and the sequence of the given order, divided by the
+	sequence length plus one. Y and H hold MLSLength(Order) values. */
+	int MLSDecode(const int Order,const double * Y,double * H);
+
+#endif
@@ -0,0 +1,289 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Misura delle prestazioni delle fasi di elaborazione */
+
+/* Inclusioni */
+#include "perfmon.h"
+#include "lowmem.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#ifndef _WIN32
+	#include <sys/time.h>
+#endif
+
+/* Memory leaks debugger */
+#ifdef DebugMLeaks
+	#include "debug_new.h"
+#endif
+
+/* Numero massimo di fasi */
+#define PMMaxStages 64
+
+/* Lunghezza massima del nome della fase */
+#define PMNameLen 64
+
+/* Numero di classi di dimensione FFT */
+#define PMFftClasses 32
+
+/* Dati della singola fase */
+typedef struct
+	{
+		char Name[PMNameLen];
+
+		/* Tempo reale e di CPU */
+		double WallTime;
+		double CPUTime;
+
+		/* Picco di memoria alla fine della fase */
+		size_t PeakMemory;
+
+		/* FFT, conteggio per classe di dimensione, punti ed operazioni */
+		unsigned long FftCount;
+		unsigned long FftSizes[PMFftClasses];
+		double FftPoints;
+		double FftFlops;
+		double FftTime;
+
+		/* Convoluzioni */
+		unsigned long ConvCount;
+		double ConvSamples;
+		double ConvTime;
+	}
+PMStageType;
+
+/* Fasi rilevate */
+static PMStageType PMStages[PMMaxStages];
+static int PMNStages = 0;
+
+/* Fase corrente, -1 se nessuna */
+static int PMCurStage = -1;
+
+/* Istanti di avvio della fase corrente */
+static double PMStageWall;
+static double PMStageCPU;
+
+/* Flag rilevamento attivo */
+static Boolean PMActive = False;
+
+/* Tempo di CPU del processo */
+static double PMCPUTime(void)
+	{
+		return ((double) clock()) / CLOCKS_PER_SEC;
+	}
+
+/* Attiva il rilevamento delle prestazioni */
+void PMInit(void)
+	{
+		PMActive = True;
+		PMNStages = 0;
+		PMCurStage = -1;
+	}
+
+/* Verifica se il rilevamento  attivo */
+Boolean PMEnabled(void)
+	{
+		return PMActive;
+	}
+
+/* Istante corrente in secondi */
+double PMTime(void)
+	{
+		#ifdef _WIN32
+			return PMCPUTime();
+		#else
+			struct timeval TV;
+
+			gettimeofday(&TV,NULL);
+			return TV.tv_sec + TV.tv_usec * 1.0e-6;
+		#endif
+	}
+
+/* Chiude la fase corrente */
+void PMEnd(void)
+	{
+		PMStageType * S;
+
+		if (PMActive == False || PMCurStage < 0)
+			return;
+
+		S = &PMStages[PMCurStage];
+		S->WallTime += PMTime() - PMStageWall;
+		S->CPUTime += PMCPUTime() - PMStageCPU;
+		if (LMRecentPeakMemory() > S->PeakMemory)
+			S->PeakMemory = LMRecentPeakMemory();
+
+		PMCurStage = -1;
+	}
+
+/* Chiude la fase corrente ed avvia una nuova fase */
+void PMStage(const char * Name)
+	{
+		int I;
+
+		if (PMActive == False)
+			return;
+
+		PMEnd();
+
+		/* Verifica se la fase  gi presente */
+		for (I = 0;I < PMNStages;I++)
+			if (strcmp(PMStages[I].Name,Name) == 0)
+				break;
+
+		/* Aggiunge una nuova fase */
+		if (I == PMNStages)
+			{
+				if (PMNStages == PMMaxStages)
+					return;
+				memset(&PMStages[I],0,sizeof(PMStageType));
+				strncpy(PMStages[I].Name,Name,PMNameLen - 1);
+				PMNStages++;
+			}
+
+		PMCurStage = I;
+
+		/* Azzera il picco di memoria, dove supportato, in modo che il
+		valore rilevato alla fine della fase sia relativo alla fase stessa */
+		LMResetPeakMemory();
+		PMStageWall = PMTime();
+		PMStageCPU = PMCPUTime();
+	}
+
+/* Registra una FFT di dimensione N */
+void PMCountFft(const unsigned int N,const double Start)
+	{
+		PMStageType * S;
+		int C;
+
+		if (PMActive == False || PMCurStage < 0 || N == 0)
+			return;
+
+		S = &PMStages[PMCurStage];
+		S->FftTime += PMTime() - Start;
+		S->FftCount++;
+		S->FftPoints += N;
+
+		/* Stima convenzionale delle operazioni: 5 N log2(N) */
+		S->FftFlops += 5.0 * N * (log((double) N) / log(2.0));
+
+		/* Classe di dimensione, potenza di due inferiore o uguale a N */
+		for (C = 0;C < PMFftClasses - 1 && (N >> (C + 1)) > 0;C++);
+		S->FftSizes[C]++;
+	}
+
+/* Registra una convoluzione */
+void PMCountConvolve(const unsigned int NA,const unsigned int NB,
+	const double Start)
+	{
+		PMStageType * S;
+
+		if (PMActive == False || PMCurStage < 0)
+			return;
+
+		S = &PMStages[PMCurStage];
+		S->ConvTime += PMTime() - Start;
+		S->ConvCount++;
+		S->ConvSamples += (double) NA + (double) NB - 1;
+	}
+
+/* Scrive le classi di dimensione FFT */
+static void PMWriteSizes(FILE * RF,const PMStageType * S,const char * Fmt,
+	const char * Sep)
+	{
+		int C;
+		Boolean First;
+
+		First = True;
+		for (C = 0;C < PMFftClasses;C++)
+			if (S->FftSizes[C] > 0)
+				{
+					if (First == False)
+						fputs(Sep,RF);
+					fprintf(RF,Fmt,1UL << C,S->FftSizes[C]);
+					First = False;
+				}
+	}
+
+/* Salva il rapporto sul file indicato */
+Boolean PMWriteReport(const char * FName,const PMReportType RType)
+	{
+		FILE * RF;
+		PMStageType * S;
+		int I;
+
+		if ((RF = fopen(FName,"wt")) == NULL)
+			return False;
+
+		switch (RType)
+			{
+				case PMJson:
+					fputs("{\n  \"stages\": [\n",RF);
+					for (I = 0;I < PMNStages;I++)
+						{
+							S = &PMStages[I];
+							fprintf(RF,"    {\n      \"name\": \"%s\",\n",S->Name);
+							fprintf(RF,"      \"wall_s\": %.6f,\n      \"cpu_s\": %.6f,\n",
+								S->WallTime,S->CPUTime);
+							fprintf(RF,"      \"peak_rss_mb\": %.1f,\n",
+								((double) S->PeakMemory) / (1024.0 * 1024.0));
+							fprintf(RF,"      \"fft_count\": %lu,\n      \"fft_points\": %.0f,\n",
+								S->FftCount,S->FftPoints);
+							fprintf(RF,"      \"fft_mflop\": %.3f,\n      \"fft_s\": %.6f,\n",
+								S->FftFlops * 1.0e-6,S->FftTime);
+							fputs("      \"fft_sizes\": {",RF);
+							PMWriteSizes(RF,S," \"%lu\": %lu",",");
+							fputs(" },\n",RF);
+							fprintf(RF,"      \"conv_count\": %lu,\n      \"conv_samples\": %.0f,\n",
+								S->ConvCount,S->ConvSamples);
+							fprintf(RF,"      \"conv_s\": %.6f\n    }%s\n",S->ConvTime,
+								(I < PMNStages - 1) ? "," : "");
+						}
+					fputs("  ]\n}\n",RF);
+				break;
+
+				case PMCsv:
+					fputs("stage,wall_s,cpu_s,peak_rss_mb,fft_count,fft_points,"
+						"fft_mflop,fft_s,fft_sizes,conv_count,conv_samples,conv_s\n",RF);
+					for (I = 0;I < PMNStages;I++)
+						{
+							S = &PMStages[I];
+							fprintf(RF,"\"%s\",%.6f,%.6f,%.1f,%lu,%.0f,%.3f,%.6f,\"",S->Name,
+								S->WallTime,S->CPUTime,((double) S->PeakMemory) / (1024.0 * 1024.0),
+								S->FftCount,S->FftPoints,S->FftFlops * 1.0e-6,S->FftTime);
+							PMWriteSizes(RF,S,"%lux%lu",";");
+							fprintf(RF,"\",%lu,%.0f,%.6f\n",S->ConvCount,S->ConvSamples,
+								S->ConvTime);
+						}
+				break;
+			}
+
+		if (fclose(RF) != 0)
+			return False;
+
+		return True;
+	}
@@ -0,0 +1,68 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Misura delle prestazioni delle fasi di elaborazione */
+
+/* Per ogni fase vengono rilevati tempo reale e di CPU, picco di memoria,
+numero, dimensione, operazioni e tempo delle FFT e delle convoluzioni. Il
+rilevamento  attivo solo dopo la chiamata a PMInit, in caso contrario le
+funzioni di conteggio ritornano immediatamente. */
+
+#ifndef PerfMon_h
+	#define PerfMon_h
+
+	/* Inclusioni */
+	#include "boolean.h"
+
+	/* Formato del rapporto */
+	typedef enum { PMJson, PMCsv } PMReportType;
+
+	/* Attiva il rilevamento delle prestazioni */
+	void PMInit(void);
+
+	/* Verifica se il rilevamento  attivo */
+	Boolean PMEnabled(void);
+
+	/* Chiude la fase corrente ed avvia una nuova fase */
+	void PMStage(const char * Name);
+
+	/* Chiude la fase corrente */
+	void PMEnd(void);
+
+	/* Istante corrente in secondi, per la misura delle chiamate */
+	double PMTime(void);
+
+	/* Registra una FFT di dimensione N iniziata all'istante Start */
+	void PMCountFft(const unsigned int N,const double Start);
+
+	/* Registra una convoluzione tra segnali di lunghezza NA e NB
+	iniziata all'istante Start */
+	void PMCountConvolve(const unsigned int NA,const unsigned int NB,
+		const double Start);
+
+	/* Salva il rapporto sul file indicato */
+	Boolean PMWriteReport(const char * FName,const PMReportType RType);
+
+#endif
@@ -31,6 +31,8 @@
 #include "hd.h"
 #include "baselib.h"
 #include "dspwind.h"
+#include "dspalloc.h"
+#include "splitcpx.h"
 
 /* Memory leaks debugger */
 #ifdef DebugMLeaks
@@ -183,7 +185,7 @@ Boolean SpectralEnvelope(const DLReal * S,const int N,const int FS,
 		int * BL;
 
 		/* Alloca l'array per l'estrazione dello spettro */
-		if ((CSP = new DLComplex[2 * N]) == NULL)
+		if ((CSP = DSPComplexAlloc(2 * N)) == NULL)
 			return False;
 
 		/* Effettua il padding del segnale */
@@ -195,14 +197,14 @@ Boolean SpectralEnvelope(const DLReal * S,const int N,const int FS,
 		/* Calcola lo spettro del asegnale */
 		if (Fft(CSP,2 * N) == False)
 			{
-				delete[] CSP;
+				DSPFree(CSP);
 				return False;
 			}
 
 		/* Alloca l'array per l'estrazione dell'inviluppo */
-		if ((SP = new SEFloat[N + 1]) == NULL)
+		if ((SP = (SEFloat *) DSPAlloc((N + 1) * sizeof(SEFloat))) == NULL)
 			{
-				delete[] CSP;
+				DSPFree(CSP);
 				return False;
 			}
 
@@ -225,18 +227,18 @@ Boolean SpectralEnvelope(const DLReal * S,const int N,const int FS,
 			}
 
 		/* Dealloca l'array per l'estrazione dello spettro */
-		delete[] CSP;
+		DSPFree(CSP);
 
 		/* Alloca gli array per gli intervalli estrazione inviluppo */
-		if ((BU = new int[N]) == NULL)
+		if ((BU = (int *) DSPAlloc(N * sizeof(int))) == NULL)
 			{
-				delete[] SP;
+				DSPFree(SP);
 				return False;
 			}
-		if ((BL = new int[N]) == NULL)
+		if ((BL = (int *) DSPAlloc(N * sizeof(int))) == NULL)
 			{
-				delete[] BU;
-				delete[] SP;
+				DSPFree(BU);
+				DSPFree(SP);
 				return False;
 			}
 
@@ -302,11 +304,11 @@ Boolean SpectralEnvelope(const DLReal * S,const int N,const int FS,
 				}
 
 		/* Alloca l'array di supporto per l'estrazione dell'inviluppo */
-		if ((TSP = new SEFloat[N + 1]) == NULL)
+		if ((TSP = (SEFloat *) DSPAlloc((N + 1) * sizeof(SEFloat))) == NULL)
 			{
-				delete[] BU;
-				delete[] BL;
-				delete[] SP;
+				DSPFree(BU);
+				DSPFree(BL);
+				DSPFree(SP);
 				return False;
 			}
 
@@ -346,10 +348,10 @@ Boolean SpectralEnvelope(const DLReal * S,const int N,const int FS,
 			SE[I] = (DLReal) (NF * ((TSP[BU[I]] - TSP[BL[I]]) / (BU[I] - BL[I])));
 
 		/* Dealloca gli array temporanei */
-		delete[] BL;
-		delete[] BU;
-		delete[] TSP;
-		delete[] SP;
+		DSPFree(BL);
+		DSPFree(BU);
+		DSPFree(TSP);
+		DSPFree(SP);
 
 		/* Operazione completata */
 		return True;
@@ -431,10 +433,10 @@ Boolean MKSETargetFilter(const DLReal * S,const int N,const int FS,
 	const DLReal StartFreq,const DLReal EndFreq)
 	{
 		DLComplex * CSE;
+		SCSpectrum<DLReal> SCSE;
 		int I;
 		int J;
 		Boolean LogLimit;
-		DLReal CV;
 
 		/* Calcola l'inviluppo spettrale */
 		if (SpectralEnvelope(S,N,FS,BW,PDS,TF) == False)
@@ -478,19 +480,18 @@ Boolean MKSETargetFilter(const DLReal * S,const int N,const int FS,
 
 				/* Fase minima */
 				case MKSETFMinimumPhase:
-					/* Calcola i valori per il cepstrum */
+					/* Calcola i valori per il cepstrum, usando l'inviluppo
+					spettrale come memoria per il logaritmo */
 					LogLimit = False;
+					for (I = 0;I < N;I++)
+						if (TF[I] <= (DLReal) 0.0)
+							{
+								LogLimit = True;
+								TF[I] = DRCMinFloat;
+							}
+					VMLog(TF,TF,N);
 					for (I = 0,J = (2 * N) - 1;I < N;I++,J--)
-						{
-							CV = TF[I];
-							if (CV <= (DLReal) 0.0)
-								{
-									LogLimit = True;
-									CSE[I] = CSE[J] = (DLReal) -log(DRCMinFloat);
-								}
-							else
-								CSE[I] = CSE[J] = -std::log<DLReal>(CV);
-						}
+						CSE[I] = CSE[J] = -TF[I];
 
 					/* Verifica se si  raggiunto il limite */
 					if (LogLimit == True)
@@ -509,8 +510,15 @@ Boolean MKSETargetFilter(const DLReal * S,const int N,const int FS,
 					Fft(CSE,2 * N);
 
 					/* Effettua il calcolo dell'esponenziale */
-					for (I = 0;I < 2 * N;I++)
-						CSE[I] = std::exp<DLReal>(CSE[I]);
+					if (SCAlloc(SCSE,2 * N) == False)
+						{
+							delete[] CSE;
+							return False;
+						}
+					SCSplit(CSE,SCSE);
+					SCExp(SCSE);
+					SCMerge(SCSE,CSE);
+					SCFree(SCSE);
 
 					/* Determina la risposta del sistema a fase minima */
 					IFft(CSE,2 * N);
@@ -0,0 +1,206 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Ricampionamento polifase a rapporto razionale */
+
+/* Inclusioni */
+#include "resample.h"
+#include "tpool.h"
+
+/* Memory leaks debugger */
+#ifdef DebugMLeaks
+	#include "debug_new.h"
+#endif
+
+/* Estensione della banda passante rispetto alla frequenza di Nyquist
+minore ed attenuazione in banda oscura in dB */
+#define RSPassBand 0.907
+#define RSStopAtten 100.0
+
+/* Numero massimo di coefficienti della tabella polifase */
+#define RSMaxTable (16 * 1024 * 1024)
+
+/* Parametri del ricampionamento */
+typedef struct
+	{
+		const DLReal * In;
+		int InLen;
+		DLReal * Out;
+
+		/* Rapporto di sovracampionamento e sottocampionamento */
+		long long L;
+		long long M;
+
+		/* Posizione del primo campione di uscita, in unit di 1/L
+		campioni di ingresso */
+		long long Pos0;
+
+		/* Coefficienti polifase, K per ciascuna delle L fasi */
+		double * Tab;
+		int K;
+		int H;
+	}
+RSJobType;
+
+/* Massimo comune divisore */
+static long long RSGcd(long long A,long long B)
+	{
+		long long T;
+
+		while (B != 0)
+			{
+				T = A % B;
+				A = B;
+				B = T;
+			}
+		return A;
+	}
+
+/* Funzione di Bessel modificata di ordine zero */
+static double RSBesselI0(const double X)
+	{
+		double S = 1.0;
+		double T = 1.0;
+		double Q = X * X / 4.0;
+		int K;
+
+		for (K = 1;K < 200 && T > 1.0e-21 * S;K++)
+			{
+				T *= Q / ((double) K * K);
+				S += T;
+			}
+		return S;
+	}
+
+/* Calcola i campioni di uscita [Start,End) */
+static void RSJob(void * Arg,const unsigned int,
+	const unsigned int Start,const unsigned int End)
+	{
+		RSJobType * J = (RSJobType *) Arg;
+		const double * C;
+		long long Pos;
+		long long I0;
+		long long P;
+		double Sum;
+		int KS;
+		int KE;
+		int N;
+		int K;
+
+		for (N = (int) Start;N < (int) End;N++)
+			{
+				/* Posizione del campione di uscita, suddivisa in campione di
+				ingresso e fase */
+				Pos = J->Pos0 + N * J->M;
+				I0 = (Pos >= 0) ? Pos / J->L : -((-Pos + J->L - 1) / J->L);
+				P = Pos - I0 * J->L;
+				C = &J->Tab[P * J->K];
+
+				/* Campioni di ingresso I0 - H + 1 + K, limitati al segnale */
+				KS = 0;
+				if (I0 - J->H + 1 < 0)
+					KS = (int) (J->H - 1 - I0);
+				KE = J->K;
+				if (I0 - J->H + 1 + KE > J->InLen)
+					KE = (int) (J->InLen - (I0 - J->H + 1));
+
+				Sum = 0.0;
+				for (K = KS;K < KE;K++)
+					Sum += J->In[I0 - J->H + 1 + K] * C[K];
+				J->Out[N] = (DLReal) Sum;
+			}
+	}
+
+/* Ricampionamento polifase a rapporto razionale */
+Boolean PolyResample(const DLReal * In,const int InLen,const int InRate,
+	const int InAnchor,DLReal * Out,const int OutLen,const int OutRate,
+	const int OutAnchor)
+	{
+		RSJobType Job;
+		long long G;
+		double FC;
+		double DF;
+		double Beta;
+		double IB;
+		double T;
+		double X;
+		int P;
+		int K;
+
+		if (InLen <= 0 || OutLen <= 0 || InRate <= 0 || OutRate <= 0)
+			return False;
+
+		/* Rapporto di ricampionamento */
+		G = RSGcd(InRate,OutRate);
+		Job.L = OutRate / G;
+		Job.M = InRate / G;
+
+		/* Frequenza di taglio, al centro della banda di transizione, e
+		larghezza della banda di transizione in cicli per campione di
+		ingresso */
+		X = ((InRate < OutRate) ? InRate : OutRate) / (2.0 * InRate);
+		FC = X * (1.0 + RSPassBand) / 2.0;
+		DF = X * (1.0 - RSPassBand);
+
+		/* Lunghezza e parametro della finestra di Kaiser */
+		Beta = 0.1102 * (RSStopAtten - 8.7);
+		T = (RSStopAtten - 7.95) / (14.36 * DF) / 2.0;
+		Job.H = (int) ceil(T);
+		Job.K = 2 * Job.H;
+
+		/* Verifica la dimensione della tabella, che con rapporti di
+		ricampionamento non semplificabili diventerebbe eccessiva */
+		if (Job.L * Job.K > RSMaxTable)
+			return False;
+
+		/* Calcola i coefficienti delle fasi, la fase P ed il coefficiente K
+		corrispondono alla distanza P / L - (K - H + 1) dal campione di
+		ingresso */
+		Job.Tab = new double[Job.L * Job.K];
+		if (Job.Tab == NULL)
+			return False;
+		IB = 1.0 / RSBesselI0(Beta);
+		for (P = 0;P < Job.L;P++)
+			for (K = 0;K < Job.K;K++)
+				{
+					X = ((double) P) / Job.L - (K - Job.H + 1);
+					if (fabs(X) >= T)
+						Job.Tab[P * Job.K + K] = 0.0;
+					else
+						Job.Tab[P * Job.K + K] = 2.0 * FC *
+							((X == 0.0) ? 1.0 : sin(2.0 * M_PI * FC * X) / (2.0 * M_PI * FC * X)) *
+							RSBesselI0(Beta * sqrt(1.0 - (X / T) * (X / T))) * IB;
+				}
+
+		/* Calcola i campioni di uscita */
+		Job.In = In;
+		Job.InLen = InLen;
+		Job.Out = Out;
+		Job.Pos0 = ((long long) InAnchor) * Job.L - ((long long) OutAnchor) * Job.M;
+		TPParallelFor(RSJob,&Job,(unsigned int) OutLen,0);
+
+		delete[] Job.Tab;
+		return True;
+	}
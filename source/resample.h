@@ -0,0 +1,53 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Ricampionamento polifase a rapporto razionale */
+
+/* Il segnale viene ricampionato dalla frequenza InRate alla frequenza
+OutRate tramite un filtro sinc finestrato Kaiser, scomposto in
+L = OutRate / MCD(InRate,OutRate) fasi. La banda passante si estende fino
+al 90.7% della frequenza di Nyquist minore, cio 20 kHz a 44.1 kHz, con
+attenuazione in banda oscura di 100 dB. Ogni campione di uscita viene
+calcolato indipendentemente dagli altri ed il calcolo viene suddiviso fra
+i thread del pool di calcolo parallelo. */
+
+#ifndef Resample_h
+	#define Resample_h
+
+	/* Inclusioni */
+	#include "dsplib.h"
+
+	/* Ricampiona il segnale In di InLen campioni nel segnale Out di OutLen
+	campioni, ponendo il campione In[InAnchor] in Out[OutAnchor]. I campioni
+	di uscita che ricadono al di fuori del segnale di ingresso vengono
+	azzerati. Il segnale risultante interpola quello di ingresso, per
+	mantenere la risposta in frequenza di un filtro va moltiplicato per
+	InRate / OutRate. Ritorna False in caso di memoria insufficiente o di
+	parametri non validi. */
+	Boolean PolyResample(const DLReal * In,const int InLen,const int InRate,
+		const int InAnchor,DLReal * Out,const int OutLen,const int OutRate,
+		const int OutAnchor);
+
+#endif
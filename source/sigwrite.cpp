@@ -0,0 +1,250 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Scrittura asincrona dei segnali su disco */
+
+/* Inclusioni */
+#include "sigwrite.h"
+#include <string.h>
+
+/* Memory leaks debugger */
+#ifdef DebugMLeaks
+	#include "debug_new.h"
+#endif
+
+/* Controlla se  abilitata la scrittura asincrona */
+#ifdef UseAsyncWrite
+
+#include <pthread.h>
+
+/* Richiesta di scrittura accodata */
+typedef struct SWJobStruct
+	{
+		char * FName;
+		DRCFloat * Sig;
+		int SSize;
+		IFileType FType;
+		struct SWJobStruct * Next;
+	}
+SWJobType;
+
+/* Stato del thread di scrittura, protetto da SWMutex */
+static pthread_mutex_t SWMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t SWCond = PTHREAD_COND_INITIALIZER;
+static pthread_t SWThread;
+static Boolean SWRunning = False;
+static Boolean SWStopping = False;
+static Boolean SWFailed = False;
+static SWJobType * SWHead = NULL;
+static SWJobType * SWTail = NULL;
+static size_t SWPending = 0;
+static size_t SWQueueSize = 0;
+
+/* Dealloca una richiesta di scrittura */
+static void SWFreeJob(SWJobType * J)
+	{
+		delete[] J->FName;
+		delete[] J->Sig;
+		delete J;
+	}
+
+/* Thread di scrittura, le richieste restano in coda fino al termine
+della scrittura in modo che SWFlush ne attenda il completamento */
+static void * SWThreadMain(void *)
+	{
+		SWJobType * J;
+		Boolean Res;
+
+		pthread_mutex_lock(&SWMutex);
+		for (;;)
+			{
+				while (SWHead == NULL && SWStopping == False)
+					pthread_cond_wait(&SWCond,&SWMutex);
+				if (SWHead == NULL)
+					break;
+				J = SWHead;
+				pthread_mutex_unlock(&SWMutex);
+
+				Res = WriteSignal(J->FName,J->Sig,J->SSize,J->FType);
+				if (Res == False)
+					sputsp("Signal save failed: ",J->FName);
+
+				pthread_mutex_lock(&SWMutex);
+				if (Res == False)
+					SWFailed = True;
+				SWHead = J->Next;
+				if (SWHead == NULL)
+					SWTail = NULL;
+				SWPending -= J->SSize * sizeof(DRCFloat);
+				SWFreeJob(J);
+				pthread_cond_broadcast(&SWCond);
+			}
+		pthread_mutex_unlock(&SWMutex);
+
+		return(NULL);
+	}
+
+/* Verifica se una delle scritture accodate  fallita */
+static Boolean SWHasFailed(void)
+	{
+		Boolean Res;
+
+		pthread_mutex_lock(&SWMutex);
+		Res = SWFailed;
+		pthread_mutex_unlock(&SWMutex);
+
+		return(Res);
+	}
+
+/* Avvia il thread di scrittura */
+Boolean SWStart(const int QueueSize)
+	{
+		pthread_mutex_lock(&SWMutex);
+		SWQueueSize = ((size_t) QueueSize) * 1024 * 1024;
+		if (SWRunning == False)
+			{
+				SWStopping = False;
+				if (pthread_create(&SWThread,NULL,SWThreadMain,NULL) == 0)
+					SWRunning = True;
+			}
+		pthread_mutex_unlock(&SWMutex);
+
+		return(SWRunning);
+	}
+
+/* Accoda la scrittura del segnale indicato */
+Boolean SWWriteSignal(const char * FName,const DRCFloat * Src,const int SSize,
+	const IFileType FType)
+	{
+		SWJobType * J;
+		size_t Bytes;
+
+		/* Verifica se la scrittura asincrona  attiva */
+		if (SWRunning == False)
+			return(WriteSignal(FName,Src,SSize,FType));
+
+		/* Segnala subito l'errore di una scrittura precedente, in modo
+		che l'elaborazione venga interrotta come per la scrittura diretta */
+		if (SWHasFailed() == True)
+			return(False);
+
+		/* Copia nome e segnale, scrivendo direttamente se la memoria
+		non  sufficiente */
+		if ((J = new SWJobType) == NULL)
+			return(WriteSignal(FName,Src,SSize,FType));
+		J->FName = new char[strlen(FName) + 1];
+		J->Sig = new DRCFloat[(SSize > 0) ? SSize : 1];
+		if (J->FName == NULL || J->Sig == NULL)
+			{
+				SWFreeJob(J);
+				return(WriteSignal(FName,Src,SSize,FType));
+			}
+		strcpy(J->FName,FName);
+		memcpy(J->Sig,Src,SSize * sizeof(DRCFloat));
+		J->SSize = SSize;
+		J->FType = FType;
+		J->Next = NULL;
+		Bytes = SSize * sizeof(DRCFloat);
+
+		/* Attende lo spazio nella coda, un segnale pi grande della
+		coda viene comunque accettato a coda vuota */
+		pthread_mutex_lock(&SWMutex);
+		while (SWPending > 0 && SWPending + Bytes > SWQueueSize &&
+			SWFailed == False)
+			pthread_cond_wait(&SWCond,&SWMutex);
+		if (SWFailed == True)
+			{
+				pthread_mutex_unlock(&SWMutex);
+				SWFreeJob(J);
+				return(False);
+			}
+		if (SWTail == NULL)
+			SWHead = J;
+		else
+			SWTail->Next = J;
+		SWTail = J;
+		SWPending += Bytes;
+		pthread_cond_broadcast(&SWCond);
+		pthread_mutex_unlock(&SWMutex);
+
+		return(True);
+	}
+
+/* Attende il completamento delle scritture accodate */
+Boolean SWFlush(void)
+	{
+		Boolean Res;
+
+		pthread_mutex_lock(&SWMutex);
+		while (SWHead != NULL)
+			pthread_cond_wait(&SWCond,&SWMutex);
+		Res = (SWFailed == True) ? False : True;
+		SWFailed = False;
+		pthread_mutex_unlock(&SWMutex);
+
+		return(Res);
+	}
+
+/* Completa le scritture e termina il thread di scrittura */
+Boolean SWStop(void)
+	{
+		if (SWRunning == False)
+			return(True);
+
+		pthread_mutex_lock(&SWMutex);
+		SWStopping = True;
+		pthread_cond_broadcast(&SWCond);
+		pthread_mutex_unlock(&SWMutex);
+		pthread_join(SWThread,NULL);
+		SWRunning = False;
+
+		return(SWFlush());
+	}
+
+#else
+
+/* Versione sincrona */
+Boolean SWStart(const int)
+	{
+		return(False);
+	}
+
+Boolean SWWriteSignal(const char * FName,const DRCFloat * Src,const int SSize,
+	const IFileType FType)
+	{
+		return(WriteSignal(FName,Src,SSize,FType));
+	}
+
+Boolean SWFlush(void)
+	{
+		return(True);
+	}
+
+Boolean SWStop(void)
+	{
+		return(True);
+	}
+
+#endif
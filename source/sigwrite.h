@@ -0,0 +1,62 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Scrittura asincrona dei segnali su disco */
+
+/* I segnali di uscita e di debug vengono copiati in una coda di
+dimensione limitata e scritti su disco da un thread dedicato, a blocchi,
+in modo che l'elaborazione non resti in attesa del disco. Se la coda 
+piena la richiesta attende che si liberi lo spazio necessario. Un
+errore di scrittura viene segnalato dalla successiva richiesta di
+scrittura, in modo da interrompere subito l'elaborazione, oppure al
+completamento delle scritture accodate con SWFlush o SWStop. */
+
+#ifndef SigWrite_h
+	#define SigWrite_h
+
+	/* Inclusioni */
+	#include "baselib.h"
+
+	/* Avvia il thread di scrittura con una coda di QueueSize MB, se gi
+	avviato ne aggiorna solo la dimensione della coda */
+	Boolean SWStart(const int QueueSize);
+
+	/* Accoda la scrittura del segnale indicato, che viene copiato e pu
+	quindi essere modificato o deallocato al ritorno. Se la scrittura
+	asincrona non  attiva il segnale viene scritto direttamente.
+	Ritorna False se una delle scritture accodate in precedenza 
+	fallita */
+	Boolean SWWriteSignal(const char * FName,const DRCFloat * Src,const int SSize,
+		const IFileType FType);
+
+	/* Attende il completamento delle scritture accodate, ritorna False
+	se almeno una delle scritture  fallita */
+	Boolean SWFlush(void);
+
+	/* Completa le scritture accodate e termina il thread di scrittura,
+	ritorna False se almeno una delle scritture  fallita */
+	Boolean SWStop(void);
+
+#endif
@@ -29,6 +29,7 @@
 #include "slprefilt.h"
 #include "level.h"
 #include "baselib.h"
+#include "tpool.h"
 
 /* Memory leaks debugger */
 #ifdef DebugMLeaks
@@ -300,48 +301,262 @@ void FastLowPassFir(DLReal * Filter,const unsigned int Order,const DLReal Freq,
 			}
 	}
 
-/* Prefiltratura a bande tramite sliding lowpass di un segnale */
-void SLPreFilt(DLReal * InImp, const int IBS, const int FBS,
-	const int FilterLen, const int BandSplit, const DLReal WindowExponent,
-	const int SampleFreq, const DLReal StartFreq, const DLReal EndFreq,
-	int WindowGap, DLReal FSharpness, DLReal * OutImp,
-	const WindowType WType, const SLPPrefilteringType SLPType)
+/* Parametri della convoluzione sliding lowpass di un lato del segnale */
+typedef struct
 	{
-		/* Array filtro FIR */
-		DLReal * FIRFilter;
+		const DLReal * InImp;
+		DLReal * OutImp;
+		int IBS;
+		int NR;
+		int HNR;
+		int HIBS;
+		int HEFL;
+		DLReal FSharpness;
+		DLReal FilterBegin;
+		DLReal WindowExponent;
+		DLReal A;
+		DLReal Q;
+		DLReal B;
+		SLPPrefilteringType SLPType;
+		WindowType Side;
+
+		/* Primo campione, contato dal centro, del tratto elaborato */
+		int First;
 
-		/* Array finestratura filtro */
+		/* Array filtro FIR e finestratura, uno per thread */
+		DLReal * FIRFilter;
 		DLReal * FWin;
+		int EFL;
+	}
+SLPJobType;
 
-		/* Dimensione effettiva filtro FIR */
-		int EFL, HEFL;
+/* Frequenza di taglio per la dimensione finestra CWL */
+static DLReal SLPCutFreq(const SLPJobType * J,const int CWL)
+	{
+		DLReal BCut = J->FilterBegin;
+
+		/* Verifica il tipo di curva di prefiltratura */
+		switch (J->SLPType)
+			{
+				/* Proporzionale */
+				case SLPProportional:
+					/* Calcola la frequenza di taglio */
+					BCut = (DLReal) 1.0 / (J->A * pow(CWL + J->Q,J->WindowExponent));
+				break;
 
-		/* Dimensione corrente filtro FIR */
+				/* Bilineare */
+				case SLPBilinear:
+					/* Calcola la frequenza di taglio */
+					BCut = (DLReal) J->FilterBegin + (J->B * (((J->HIBS - CWL) / J->A) * (1 + J->Q)) /
+						(1 + ((J->HIBS - CWL) / J->A) * J->Q));
+				break;
+			}
+
+		return BCut;
+	}
+
+/* Convoluzione sliding lowpass dei campioni [Start,End) di un lato,
+contati dal centro verso l'estremo. La dimensione del filtro dipende
+solo dalla posizione del campione, per cui ogni blocco viene elaborato
+indipendentemente dagli altri ricalcolando all'inizio filtro e
+finestra, con risultati identici a quelli dell'elaborazione seriale */
+static void SLPConvolve(void * Arg,const unsigned int Thread,
+	const unsigned int Start,const unsigned int End)
+	{
+		SLPJobType * J = (SLPJobType *) Arg;
+
+		/* Array filtro FIR e finestratura del thread */
+		DLReal * FIRFilter = &J->FIRFilter[Thread * J->EFL];
+		DLReal * FWin = &J->FWin[Thread * J->HEFL];
+
+		/* Dimensione corrente filtro FIR e della finestra calcolata */
 		int CFL;
 		int CHFL;
 		int CFLM;
+		int WFL;
 
-		/* Dimensione attuale finestra */
+		/* Dimensione attuale ed effettiva finestra */
 		int CWL;
-
-		/* Dimensione effettiva finestra */
 		int EWL;
 
 		/* Indici convoluzione */
-		int I,J,IS,FS,EI;
-
-		/* Dimensioni blocco in uscita */
-		int NR,HNR;
+		int I,K,IS,FS,EI;
 
-		/* Posizione semiblocchi destro e sinistro */
+		/* Posizione campione in uscita */
 		int OCP;
 
+		/* Sommatoria filtratura */
+		DLReal Sum;
+
+		/* Variabili per il Kahan summation algorithm */
+		DLReal SC;
+		DLReal SY;
+		DLReal ST;
+
+		WFL = 0;
+		for (I = J->First + (int) Start;I < J->First + (int) End;I++)
+			{
+				/* Calcola la finestratura effettiva corrente */
+				CWL = J->HNR - I;
+				EWL = (int) floor(J->FSharpness * CWL);
+
+				/* Riduce il filtro se non sta all'interno della finestratura corrente */
+				if (J->HEFL < EWL)
+					CHFL = J->HEFL;
+				else
+					if (EWL > 1)
+						CHFL = EWL - 1;
+					else
+						CHFL = 1;
+				CFL	= 1 + (CHFL * 2);
+
+				/* Verifica se si tratta della convoluzione lowpass iniziale */
+				if (I < J->HNR - J->HIBS)
+					{
+						/* Ricalcola il filtro e la finestra */
+						if (CFL != WFL)
+							FastLowPassFir(FIRFilter,CFL,J->FilterBegin,FWin,0);
+					}
+				else
+					{
+						/* Ricalcola il filtro, usando la finestra corrente se possibile */
+						if (CFL != WFL)
+							FastLowPassFir(FIRFilter,CFL,SLPCutFreq(J,CWL),FWin,0);
+						else
+							FastLowPassFir(FIRFilter,CFL,SLPCutFreq(J,CWL),FWin,CFL);
+					}
+				WFL = CFL;
+
+				/* Imposta gli indici per il filtro completo o parziale */
+				CFLM = CFL;
+				FS = 0;
+				if (J->Side == WLeft)
+					{
+						OCP = I;
+						if (OCP - CHFL >= J->HEFL)
+							IS = OCP - (CHFL + J->HEFL);
+						else
+							{
+								IS = 0;
+								FS = (CHFL + J->HEFL) - OCP;
+							}
+					}
+				else
+					{
+						OCP = J->NR - 1 - I;
+						IS = OCP - (CHFL + J->HEFL);
+						if (OCP + CHFL >= J->HEFL + J->IBS)
+							CFLM = J->HEFL + J->IBS + CHFL - OCP;
+					}
+
+				/* Esegue la convoluzione, Kahan summation algorithm */
+				Sum = (DLReal) 0.0;
+				SC = (DLReal) 0.0;
+				for (K = FS,EI = IS;K < CFLM;K++,EI++)
+					{
+						SY = (J->InImp[EI] * FIRFilter[K]) - SC;
+						ST = Sum + SY;
+						SC = (ST - Sum) - SY;
+						Sum = ST;
+					}
+				J->OutImp[OCP] = Sum;
+			}
+	}
+
+/* Convoluzione dei campioni [First,Last) del lato corrente, suddivisa
+fra i thread disponibili */
+static void SLPConvolveRange(SLPJobType * J,const int First,const int Last)
+	{
+		if (Last > First)
+			{
+				J->First = First;
+				TPParallelFor(SLPConvolve,J,(unsigned int) (Last - First),0);
+			}
+	}
+
+/* Convoluzione lowpass iniziale e sliding lowpass del lato Side. Le
+bande vengono elaborate in sequenza, segnalando ciascuna prima della sua
+convoluzione, mentre i campioni di ogni banda sono suddivisi fra i
+thread disponibili */
+static void SLPConvolveSide(SLPJobType * J,const char Side,const DLReal BWidth,
+	const int SampleFreq,const int HFBS)
+	{
 		/* Numero banda corrente */
 		int Band;
 
-		/* Frequenza di taglio. */
+		/* Dimensione attuale finestra */
+		int CWL;
+
+		/* Inizio del tratto da elaborare */
+		int First;
+
+		/* Frequenza di taglio */
 		DLReal BCut;
 
+		/* Convoluzione lowpass iniziale */
+		printf("%c - Initial lowpass convolution...\n",Side);
+		fflush(stdout);
+		SLPConvolveRange(J,0,J->HNR - J->HIBS);
+
+		/* Imposta i parametri iniziali per la visualizzazione */
+		Band = 0;
+		First = J->HNR - J->HIBS;
+
+		/* Ciclo delle bande sliding lowpass */
+		for (CWL = J->HIBS;CWL > HFBS;CWL--)
+			{
+				/* Verifica visualizzazione stato prefiltratura */
+				BCut = SLPCutFreq(J,CWL);
+				if (BCut >= (DLReal) (J->FilterBegin * pow(BWidth,Band)))
+					{
+						/* Completa la banda precedente */
+						SLPConvolveRange(J,First,J->HNR - CWL);
+						First = J->HNR - CWL;
+
+						/* Segnala lo stato */
+						printf("%c - Band: %3d, %7.1f Hz, width: %6d, FIR, ",Side,(int) Band,
+							(double) (BCut * SampleFreq) / 2, CWL);
+
+						/* Passa alla banda successiva */
+						Band++;
+
+						/* Inizio convoluzione */
+						sputs("convolution...");
+					}
+			}
+
+		/* Completa l'ultima banda */
+		SLPConvolveRange(J,First,J->HNR - HFBS);
+
+		/* Segnala lo stato finale */
+		BCut = SLPCutFreq(J,CWL);
+		printf("F - Band: %3d, %7.1f Hz, width: %6d, FIR, ", (int) Band,
+			(double) (BCut * SampleFreq) / 2, CWL);
+		sputs("completed.");
+	}
+
+/* Prefiltratura a bande tramite sliding lowpass di un segnale */
+void SLPreFilt(DLReal * InImp, const int IBS, const int FBS,
+	const int FilterLen, const int BandSplit, const DLReal WindowExponent,
+	const int SampleFreq, const DLReal StartFreq, const DLReal EndFreq,
+	int WindowGap, DLReal FSharpness, DLReal * OutImp,
+	const WindowType WType, const SLPPrefilteringType SLPType)
+	{
+		/* Parametri della convoluzione */
+		SLPJobType Job;
+
+		/* Numero di thread di elaborazione */
+		unsigned int NT;
+
+		/* Dimensione effettiva filtro FIR */
+		int EFL, HEFL;
+
+		/* Indici copia */
+		int I,J,FS;
+
+		/* Dimensioni blocco in uscita */
+		int NR,HNR;
+
 		/* Larghezza banda */
 		DLReal BWidth;
 
@@ -350,20 +565,12 @@ void SLPreFilt(DLReal * InImp, const int IBS, const int FBS,
 		DLReal FilterEnd;
 
 		/* Coefficienti calcolo frequenza di taglio su finestra */
-		DLReal A;
-		DLReal Q;
-		DLReal B;
+		DLReal A = 0;
+		DLReal Q = 0;
+		DLReal B = 0;
 		int HFBS;
 		int HIBS;
 
-		/* Sommatoria filtratura */
-		DLReal Sum;
-
-		/* Variabili per il Kahan summation algorithm */
-		DLReal SC;
-		DLReal SY;
-		DLReal ST;
-
 		/* Calcola inizio e fine della prefiltratura */
 		FilterBegin = (2 * StartFreq) / SampleFreq;
 		FilterEnd = (2 * EndFreq) / SampleFreq;
@@ -386,13 +593,13 @@ void SLPreFilt(DLReal * InImp, const int IBS, const int FBS,
 		/* Calcola il centro dei semiblocchi */
 		HNR = NR / 2;
 
-		/* Alloca gli array temporanei */
-		FIRFilter = new DLReal[EFL];
-		FWin = new DLReal[HEFL];
+		/* Alloca gli array temporanei, uno per ogni thread */
+		NT = TPGetThreads();
+		Job.FIRFilter = new DLReal[NT * EFL];
+		Job.FWin = new DLReal[NT * HEFL];
 
 		/* Imposta i parametri iniziali per la visualizzazione */
 		BWidth = (DLReal) pow(2,1.0/BandSplit);
-		Band = 0;
 
 		/* Calcola le dimensioni finestratura effettive */
 		HFBS = FBS / 2;
@@ -421,374 +628,37 @@ void SLPreFilt(DLReal * InImp, const int IBS, const int FBS,
 				break;
 			}
 
+		/* Imposta i parametri della convoluzione */
+		Job.InImp = InImp;
+		Job.OutImp = OutImp;
+		Job.IBS = IBS;
+		Job.NR = NR;
+		Job.HNR = HNR;
+		Job.HIBS = HIBS;
+		Job.EFL = EFL;
+		Job.HEFL = HEFL;
+		Job.FSharpness = FSharpness;
+		Job.FilterBegin = FilterBegin;
+		Job.WindowExponent = WindowExponent;
+		Job.A = A;
+		Job.Q = Q;
+		Job.B = B;
+		Job.SLPType = SLPType;
+
 		/* Finestratura sinistra */
 		if ((WType == WLeft) || (WType == WFull))
 			{
-				/* Prepara gli indici per la convoluzione */
-				EWL = (int) floor(FSharpness * HNR);
-				CHFL = HEFL;
-
-				/* Verifica che il filtro stia all'interno della finestratura corrente */
-				if (CHFL >= EWL)
-					{
-						/* Ricalcola la dimensione del filtro */
-						if (EWL > 1)
-							CHFL = EWL - 1;
-						else
-							CHFL = 1;
-						CFL	= 1 + (CHFL * 2);
-					}
-				else
-					/* Usa la dimensione base */
-					CFL = EFL;
-
-				/* Ricalcola il filtro e la finestra */
-				FastLowPassFir(FIRFilter,CFL,FilterBegin,FWin,0);
-
-				/* Segnala lo stato */
-				sputs("L - Initial lowpass convolution...");
-
-				/* Ciclo di convoluzione lowpass iniziale */
-				for(I = 0,CWL = HNR,OCP = 0;I < (HNR - HIBS);I++,CWL--,OCP++)
-					{
-						/* Calcola la finestratura effettiva corrente */
-						EWL = (int) floor(FSharpness * CWL);
-
-						/* Verifica che il filtro stia all'interno della finestratura corrente */
-						if (CHFL >= EWL)
-							{
-								/* Ricalcola la dimensione del filtro */
-								if (EWL > 1)
-									CHFL = EWL - 1;
-								else
-									CHFL = 1;
-								CFL	= 1 + (CHFL * 2);
-
-								/* Ricalcola il filtro e la finestra */
-								FastLowPassFir(FIRFilter,CFL,FilterBegin,FWin,0);
-							}
-
-						/* Verifica se si pu utilizzare il filtro completo */
-						if (OCP - CHFL >= HEFL)
-							{
-								/* Imposta gli indici per il filtro completo */
-								CFLM = CFL;
-								IS = OCP - (CHFL + HEFL);
-								FS = 0;
-							}
-						else
-							{
-								/* Imposta gli indici per il filtro parziale */
-								CFLM = CFL;
-								IS = 0;
-								FS = (CHFL + HEFL) - OCP;
-							}
-
-						/* Esegue la convoluzione, Kahan summation algorithm */
-						Sum = (DLReal) 0.0;
-						SC = (DLReal) 0.0;
-						for (J = FS,EI = IS;J < CFLM;J++,EI++)
-							{
-								SY = (InImp[EI] * FIRFilter[J]) - SC;
-								ST = Sum + SY;
-								SC = (ST - Sum) - SY;
-								Sum = ST;
-							}
-						OutImp[OCP] = Sum;
-					}
-
-				/* Imposta i parametri iniziali per la visualizzazione */
-				Band = 0;
-
-				/* Ciclo di convoluzione sliding lowpass */
-				for(I = HNR - HIBS,CWL = HIBS,OCP = HNR - HIBS;I < (HNR - HFBS);I++,CWL--,OCP++)
-					{
-						/* Calcola la finestratura effettiva corrente */
-						EWL = (int) floor(FSharpness * CWL);
-
-						/* Verifica il tipo di curva di prefiltratura */
-						switch (SLPType)
-							{
-								/* Proporzionale */
-								case SLPProportional:
-									/* Calcola la frequenza di taglio */
-									BCut = (DLReal) 1.0 / (A * pow(CWL + Q,WindowExponent));
-								break;
-
-								/* Bilineare */
-								case SLPBilinear:
-									/* Calcola la frequenza di taglio */
-									BCut = (DLReal) FilterBegin + (B * (((HIBS - CWL) / A) * (1 + Q)) /
-										(1 + ((HIBS - CWL) / A) * Q));
-								break;
-							}
-
-						/* Verifica che il filtro stia all'interno della finestratura corrente */
-						if (CHFL >= EWL)
-							{
-								/* Ricalcola la dimensione del filtro */
-								if (EWL > 1)
-									CHFL = EWL - 1;
-								else
-									CHFL = 1;
-								CFL	= 1 + (CHFL * 2);
-
-								/* Ricalcola il filtro e la finestra */
-								FastLowPassFir(FIRFilter,CFL,BCut,FWin,0);
-							}
-						else
-							/* Ricalcola il filtro usando la finestra corrente */
-							FastLowPassFir(FIRFilter,CFL,BCut,FWin,CFL);
-
-						/* Verifica visualizzazione stato prefiltratura */
-						if (BCut >= (DLReal) (FilterBegin * pow(BWidth,Band)))
-							{
-								/* Segnala lo stato */
-								printf("L - Band: %3d, %7.1f Hz, width: %6d, FIR, ", (int) Band,
-									(double) (BCut * SampleFreq) / 2, CWL);
-
-								/* Passa alla banda successiva */
-								Band++;
-
-								/* Inizio convoluzione */
-								sputs("convolution...");
-							}
-
-						/* Verifica se si pu utilizzare il filtro completo */
-						if (OCP - CHFL >= HEFL)
-							{
-								/* Imposta gli indici per il filtro completo */
-								CFLM = CFL;
-								IS = OCP - (CHFL + HEFL);
-								FS = 0;
-							}
-						else
-							{
-								/* Imposta gli indici per il filtro parziale */
-								CFLM = CFL;
-								IS = 0;
-								FS = (CHFL + HEFL) - OCP;
-							}
-
-						/* Esegue la convoluzione, Kahan summation algorithm */
-						Sum = (DLReal) 0.0;
-						SC = (DLReal) 0.0;
-						for (J = FS,EI = IS;J < CFLM;J++,EI++)
-							{
-								SY = (InImp[EI] * FIRFilter[J]) - SC;
-								ST = Sum + SY;
-								SC = (ST - Sum) - SY;
-								Sum = ST;
-							}
-						OutImp[OCP] = Sum;
-					}
-
-				/* Verifica il tipo di curva di prefiltratura */
-				switch (SLPType)
-					{
-						/* Proporzionale */
-						case SLPProportional:
-							/* Calcola la frequenza di taglio */
-							BCut = (DLReal) 1.0 / (A * pow(CWL + Q,WindowExponent));
-						break;
-
-						/* Bilineare */
-						case SLPBilinear:
-							/* Calcola la frequenza di taglio */
-							BCut = (DLReal) FilterBegin + (B * (((HIBS - CWL) / A) * (1 + Q)) /
-								(1 + ((HIBS - CWL) / A) * Q));
-						break;
-					}
-
-				/* Segnala lo stato finale */
-				printf("F - Band: %3d, %7.1f Hz, width: %6d, FIR, ", (int) Band,
-					(double) (BCut * SampleFreq) / 2, CWL);
-				sputs("completed.");
+				/* Convoluzione lowpass iniziale e sliding lowpass */
+				Job.Side = WLeft;
+				SLPConvolveSide(&Job,'L',BWidth,SampleFreq,HFBS);
 			}
 
 		/* Effettua la convoluzione, lato destro */
 		if ((WType == WRight) || (WType == WFull))
 			{
-				/* Prepara gli indici per la convoluzione */
-				EWL = (int) floor(FSharpness * HNR);
-				CHFL = HEFL;
-
-				/* Verifica che il filtro stia all'interno della finestratura corrente */
-				if (CHFL >= EWL)
-					{
-						/* Ricalcola la dimensione del filtro */
-						if (EWL > 1)
-							CHFL = EWL - 1;
-						else
-							CHFL = 1;
-						CFL	= 1 + (CHFL * 2);
-					}
-				else
-					/* Usa la dimensione base */
-					CFL = EFL;
-
-				/* Ricalcola il filtro e la finestra */
-				FastLowPassFir(FIRFilter,CFL,FilterBegin,FWin,0);
-
-				/* Segnala lo stato */
-				sputs("R - Initial lowpass convolution...");
-
-				/* Ciclo di convoluzione lowpass iniziale */
-				for(I = 0,CWL = HNR,OCP = NR - 1;I < (HNR - HIBS);I++,CWL--,OCP--)
-					{
-						/* Calcola la finestratura effettiva corrente */
-						EWL = (int) floor(FSharpness * CWL);
-
-						/* Verifica che il filtro stia all'interno della finestratura corrente */
-						if (CHFL >= EWL)
-							{
-								/* Ricalcola la dimensione del filtro */
-								if (EWL > 1)
-									CHFL = EWL - 1;
-								else
-									CHFL = 1;
-								CFL	= 1 + (CHFL * 2);
-
-								/* Ricalcola il filtro e la finestra */
-								FastLowPassFir(FIRFilter,CFL,FilterBegin,FWin,0);
-							}
-
-						/* Verifica se si pu utilizzare il filtro completo */
-						if (OCP + CHFL < HEFL + IBS)
-							{
-								/* Imposta gli indici per il filtro completo */
-								CFLM = CFL;
-								IS = OCP - (CHFL + HEFL);
-								FS = 0;
-							}
-						else
-							{
-								/* Imposta gli indici per il filtro parziale */
-								CFLM = HEFL + IBS + CHFL - OCP;
-								IS = OCP - (CHFL + HEFL);
-								FS = 0;
-							}
-
-						/* Esegue la convoluzione, Kahan summation algorithm */
-						Sum = (DLReal) 0.0;
-						SC = (DLReal) 0.0;
-						for (J = FS,EI = IS;J < CFLM;J++,EI++)
-							{
-								SY = (InImp[EI] * FIRFilter[J]) - SC;
-								ST = Sum + SY;
-								SC = (ST - Sum) - SY;
-								Sum = ST;
-							}
-						OutImp[OCP] = Sum;
-					}
-
-				/* Imposta i parametri iniziali per la visualizzazione */
-				Band = 0;
-
-				/* Ciclo di convoluzione sliding lowpass */
-				for(I = HNR - HIBS,CWL = HIBS,OCP = NR - 1 - (HNR - HIBS);I < (HNR - HFBS);I++,CWL--,OCP--)
-					{
-						/* Calcola la finestratura effettiva corrente */
-						EWL = (int) floor(FSharpness * CWL);
-
-						/* Verifica il tipo di curva di prefiltratura */
-						switch (SLPType)
-							{
-								/* Proporzionale */
-								case SLPProportional:
-									/* Calcola la frequenza di taglio */
-									BCut = (DLReal) 1.0 / (A * pow(CWL + Q,WindowExponent));
-								break;
-
-								/* Bilineare */
-								case SLPBilinear:
-									/* Calcola la frequenza di taglio */
-									BCut = (DLReal) FilterBegin + (B * (((HIBS - CWL) / A) * (1 + Q)) /
-										(1 + ((HIBS - CWL) / A) * Q));
-								break;
-							}
-
-						/* Verifica che il filtro stia all'interno della finestratura corrente */
-						if (CHFL >= EWL)
-							{
-								/* Ricalcola la dimensione del filtro */
-								if (EWL > 1)
-									CHFL = EWL - 1;
-								else
-									CHFL = 1;
-								CFL	= 1 + (CHFL * 2);
-
-								/* Ricalcola il filtro e la finestra */
-								FastLowPassFir(FIRFilter,CFL,BCut,FWin,0);
-							}
-						else
-							/* Ricalcola il filtro usando la finestra corrente */
-							FastLowPassFir(FIRFilter,CFL,BCut,FWin,CFL);
-
-						/* Verifica visualizzazione stato prefiltratura */
-						if (BCut >= (DLReal) (FilterBegin * pow(BWidth,Band)))
-							{
-								/* Segnala lo stato */
-								printf("R - Band: %3d, %7.1f Hz, width: %6d, FIR, ", (int) Band,
-									(double) (BCut * SampleFreq) / 2, CWL);
-
-								/* Passa alla banda successiva */
-								Band++;
-
-								/* Inizio convoluzione */
-								sputs("convolution...");
-							}
-
-						/* Verifica se si pu utilizzare il filtro completo */
-						if (OCP + CHFL < HEFL + IBS)
-							{
-								/* Imposta gli indici per il filtro completo */
-								CFLM = CFL;
-								IS = OCP - (CHFL + HEFL);
-								FS = 0;
-							}
-						else
-							{
-								/* Imposta gli indici per il filtro parziale */
-								CFLM = HEFL + IBS + CHFL - OCP;
-								IS = OCP - (CHFL + HEFL);
-								FS = 0;
-							}
-
-						/* Esegue la convoluzione, Kahan summation algorithm */
-						Sum = (DLReal) 0.0;
-						SC = (DLReal) 0.0;
-						for (J = FS,EI = IS;J < CFLM;J++,EI++)
-							{
-								SY = (InImp[EI] * FIRFilter[J]) - SC;
-								ST = Sum + SY;
-								SC = (ST - Sum) - SY;
-								Sum = ST;
-							}
-						OutImp[OCP] = Sum;
-					}
-
-				/* Verifica il tipo di curva di prefiltratura */
-				switch (SLPType)
-					{
-						/* Proporzionale */
-						case SLPProportional:
-							/* Calcola la frequenza di taglio */
-							BCut = (DLReal) 1.0 / (A * pow(CWL + Q,WindowExponent));
-						break;
-
-						/* Bilineare */
-						case SLPBilinear:
-							/* Calcola la frequenza di taglio */
-							BCut = (DLReal) FilterBegin + (B * (((HIBS - CWL) / A) * (1 + Q)) /
-								(1 + ((HIBS - CWL) / A) * Q));
-						break;
-					}
-
-				/* Segnala lo stato finale */
-				printf("F - Band: %3d, %7.1f Hz, width: %6d, FIR, ", (int) Band,
-					(double) (BCut * SampleFreq) / 2, CWL);
-				sputs("completed.");
+				/* Convoluzione lowpass iniziale e sliding lowpass */
+				Job.Side = WRight;
+				SLPConvolveSide(&Job,'R',BWidth,SampleFreq,HFBS);
 			}
 
 		/* Segnala lo stato finale */
@@ -818,6 +688,6 @@ void SLPreFilt(DLReal * InImp, const int IBS, const int FBS,
 			}
 
 		/* Dealloca gli array intermedi */
-		delete[] FIRFilter;
-		delete[] FWin;
+		delete[] Job.FIRFilter;
+		delete[] Job.FWin;
 	}
@@ -0,0 +1,342 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Spettri in formato complesso separato (parte reale e immaginaria in
+vettori distinti) e relative operazioni elemento per elemento */
+
+/* Le routine FFT lavorano su vettori di std::complex, con parte reale e
+immaginaria alternate. Le elaborazioni nel dominio della frequenza
+separano prima le due parti con SCSplit, operano sui vettori separati e
+le ricompongono con SCMerge prima dell'antitrasformata. In questo modo i
+cicli sono privi di salti e di accessi alternati e vengono vettorizzati
+dal compilatore, senza le funzioni trascendenti di std::abs, std::arg e
+std::polar e senza la gestione NaN/Inf della divisione complessa C99.
+Logaritmo ed esponenziale sono calcolati con le funzioni di vecmath.h.
+Le funzioni sono modelli sul tipo floating point per l'uso con entrambe
+le precisioni di calcolo. */
+
+#ifndef SplitCpx_h
+	#define SplitCpx_h
+
+	/* Inclusioni */
+	#include "dsplib.h"
+	#include "dspalloc.h"
+	#include "vecmath.h"
+	#include <math.h>
+
+	/* Spettro in formato complesso separato di N punti */
+	template <class T>
+	struct SCSpectrum
+		{
+			T * Re;
+			T * Im;
+			int N;
+		};
+
+	/* Alloca lo spettro S di N punti */
+	template <class T>
+	Boolean SCAlloc(SCSpectrum<T> & S,const int N)
+		{
+			if ((S.Re = (T *) DSPAlloc(2 * N * sizeof(T))) == NULL)
+				return False;
+			S.Im = S.Re + N;
+			S.N = N;
+			return True;
+		}
+
+	/* Usa come memoria per lo spettro S di N punti quella del vettore
+	complesso X, il cui contenuto viene sovrascritto */
+	template <class T>
+	void SCAttach(SCSpectrum<T> & S,std::complex<T> * X,const int N)
+		{
+			S.Re = (T *) X;
+			S.Im = S.Re + N;
+			S.N = N;
+		}
+
+	/* Dealloca lo spettro S */
+	template <class T>
+	void SCFree(SCSpectrum<T> & S)
+		{
+			DSPFree(S.Re);
+			S.Re = NULL;
+			S.Im = NULL;
+		}
+
+	/* Separa il vettore complesso X nello spettro S */
+	template <class T>
+	void SCSplit(const std::complex<T> * X,SCSpectrum<T> & S)
+		{
+			const T * P = (const T *) X;
+			T * __restrict Re = S.Re;
+			T * __restrict Im = S.Im;
+			int I;
+
+			for (I = 0;I < S.N;I++)
+				{
+					Re[I] = P[2 * I];
+					Im[I] = P[2 * I + 1];
+				}
+		}
+
+	/* Ricompone lo spettro S nel vettore complesso X */
+	template <class T>
+	void SCMerge(const SCSpectrum<T> & S,std::complex<T> * X)
+		{
+			T * P = (T *) X;
+			const T * __restrict Re = S.Re;
+			const T * __restrict Im = S.Im;
+			int I;
+
+			for (I = 0;I < S.N;I++)
+				{
+					P[2 * I] = Re[I];
+					P[2 * I + 1] = Im[I];
+				}
+		}
+
+	/* Dimensione dei blocchi di elaborazione delle funzioni che
+	richiedono vettori temporanei */
+	#define SCBlockSize 256
+
+	/* Modulo dello spettro S */
+	template <class T>
+	void SCAbs(const SCSpectrum<T> & S,T * __restrict Abs)
+		{
+			const T * __restrict Re = S.Re;
+			const T * __restrict Im = S.Im;
+			int I;
+
+			for (I = 0;I < S.N;I++)
+				Abs[I] = (T) sqrt(Re[I] * Re[I] + Im[I] * Im[I]);
+		}
+
+	/* Quadrato del modulo dello spettro S */
+	template <class T>
+	void SCNorm(const SCSpectrum<T> & S,T * __restrict Nrm)
+		{
+			const T * __restrict Re = S.Re;
+			const T * __restrict Im = S.Im;
+			int I;
+
+			for (I = 0;I < S.N;I++)
+				Nrm[I] = Re[I] * Re[I] + Im[I] * Im[I];
+		}
+
+	/* Logaritmo del modulo dello spettro S, i moduli nulli assumono il
+	valore log(Floor). Ritorna True se il limite e' stato raggiunto. */
+	template <class T>
+	Boolean SCLogAbs(const SCSpectrum<T> & S,T * __restrict LAbs,const T Floor)
+		{
+			int I;
+			Boolean LogLimit;
+
+			SCAbs(S,LAbs);
+			LogLimit = False;
+			for (I = 0;I < S.N;I++)
+				if (LAbs[I] <= (T) 0.0)
+					{
+						LogLimit = True;
+						LAbs[I] = Floor;
+					}
+			VMLog(LAbs,LAbs,S.N);
+			return LogLimit;
+		}
+
+	/* Logaritmo del vettore reale X nel vettore complesso Y di N punti,
+	con parte immaginaria nulla. La seconda meta' della memoria di Y viene
+	usata per il calcolo del logaritmo prima dell'espansione. */
+	template <class T>
+	void SCRealLog(const T * X,std::complex<T> * Y,const int N)
+		{
+			T * L = ((T *) Y) + N;
+			int I;
+
+			VMLog(X,L,N);
+			for (I = 0;I < N;I++)
+				Y[I] = L[I];
+		}
+
+	/* Moltiplica lo spettro S per il guadagno reale G */
+	template <class T>
+	void SCScale(SCSpectrum<T> & S,const T * __restrict G)
+		{
+			T * __restrict Re = S.Re;
+			T * __restrict Im = S.Im;
+			int I;
+
+			for (I = 0;I < S.N;I++)
+				{
+					Re[I] *= G[I];
+					Im[I] *= G[I];
+				}
+		}
+
+	/* Porta il modulo dello spettro S da Abs a Lev mantenendo la fase,
+	gli elementi di modulo nullo assumono fase nulla */
+	template <class T>
+	void SCSetAbs(SCSpectrum<T> & S,const T * __restrict Abs,const T * __restrict Lev)
+		{
+			T * __restrict Re = S.Re;
+			T * __restrict Im = S.Im;
+			T G;
+			int I;
+
+			for (I = 0;I < S.N;I++)
+				{
+					G = Lev[I] / ((Abs[I] > (T) 0.0) ? Abs[I] : (T) 1.0);
+					Re[I] = (Abs[I] > (T) 0.0) ? Re[I] * G : Lev[I];
+					Im[I] = Im[I] * G;
+				}
+		}
+
+	/* Normalizza lo spettro S a modulo unitario, gli elementi di modulo
+	nullo assumono valore 1 */
+	template <class T>
+	void SCUnit(SCSpectrum<T> & S)
+		{
+			T * __restrict Re = S.Re;
+			T * __restrict Im = S.Im;
+			T Abs;
+			T G;
+			int I;
+
+			for (I = 0;I < S.N;I++)
+				{
+					Abs = (T) sqrt(Re[I] * Re[I] + Im[I] * Im[I]);
+					G = ((T) 1.0) / ((Abs > (T) 0.0) ? Abs : (T) 1.0);
+					Re[I] = (Abs > (T) 0.0) ? Re[I] * G : (T) 1.0;
+					Im[I] = Im[I] * G;
+				}
+		}
+
+	/* Prodotto O = A * B, O puo' coincidere con A o B */
+	template <class T>
+	void SCMul(const SCSpectrum<T> & A,const SCSpectrum<T> & B,SCSpectrum<T> & O)
+		{
+			T Re;
+			T Im;
+			int I;
+
+			for (I = 0;I < O.N;I++)
+				{
+					Re = A.Re[I] * B.Re[I] - A.Im[I] * B.Im[I];
+					Im = A.Re[I] * B.Im[I] + A.Im[I] * B.Re[I];
+					O.Re[I] = Re;
+					O.Im[I] = Im;
+				}
+		}
+
+	/* Prodotto O = A * coniugato(B), O puo' coincidere con A o B */
+	template <class T>
+	void SCConjMul(const SCSpectrum<T> & A,const SCSpectrum<T> & B,SCSpectrum<T> & O)
+		{
+			T Re;
+			T Im;
+			int I;
+
+			for (I = 0;I < O.N;I++)
+				{
+					Re = A.Re[I] * B.Re[I] + A.Im[I] * B.Im[I];
+					Im = A.Im[I] * B.Re[I] - A.Re[I] * B.Im[I];
+					O.Re[I] = Re;
+					O.Im[I] = Im;
+				}
+		}
+
+	/* Quoziente O = A / B, O puo' coincidere con A o B */
+	template <class T>
+	void SCDiv(const SCSpectrum<T> & A,const SCSpectrum<T> & B,SCSpectrum<T> & O)
+		{
+			T Re;
+			T Im;
+			T Den;
+			int I;
+
+			for (I = 0;I < O.N;I++)
+				{
+					Den = ((T) 1.0) / (B.Re[I] * B.Re[I] + B.Im[I] * B.Im[I]);
+					Re = (A.Re[I] * B.Re[I] + A.Im[I] * B.Im[I]) * Den;
+					Im = (A.Im[I] * B.Re[I] - A.Re[I] * B.Im[I]) * Den;
+					O.Re[I] = Re;
+					O.Im[I] = Im;
+				}
+		}
+
+	/* Inverso regolarizzato S = coniugato(S) / (|S|^2 + Reg + Eps),
+	con Reg eventualmente nullo */
+	template <class T>
+	void SCRegInverse(SCSpectrum<T> & S,const T * __restrict Reg,const T Eps)
+		{
+			T * __restrict Re = S.Re;
+			T * __restrict Im = S.Im;
+			T Den;
+			int I;
+
+			if (Reg == NULL)
+				for (I = 0;I < S.N;I++)
+					{
+						Den = ((T) 1.0) / (Re[I] * Re[I] + Im[I] * Im[I] + Eps);
+						Re[I] = Re[I] * Den;
+						Im[I] = -Im[I] * Den;
+					}
+			else
+				for (I = 0;I < S.N;I++)
+					{
+						Den = ((T) 1.0) / (Re[I] * Re[I] + Im[I] * Im[I] + Reg[I] + Eps);
+						Re[I] = Re[I] * Den;
+						Im[I] = -Im[I] * Den;
+					}
+		}
+
+	/* Esponenziale complesso S = exp(S), calcolato a blocchi per
+	contenere seno e coseno in vettori temporanei */
+	template <class T>
+	void SCExp(SCSpectrum<T> & S)
+		{
+			T Sin[SCBlockSize];
+			T Cos[SCBlockSize];
+			T * __restrict Re;
+			T * __restrict Im;
+			int B;
+			int L;
+			int I;
+
+			for (B = 0;B < S.N;B += SCBlockSize)
+				{
+					Re = &S.Re[B];
+					Im = &S.Im[B];
+					L = (S.N - B < SCBlockSize) ? S.N - B : SCBlockSize;
+					VMExp(Re,Re,L);
+					VMSinCos(Im,Sin,Cos,L);
+					for (I = 0;I < L;I++)
+						{
+							Im[I] = Re[I] * Sin[I];
+							Re[I] = Re[I] * Cos[I];
+						}
+				}
+		}
+
+#endif
@@ -0,0 +1,289 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Cache su disco dei risultati intermedi delle varie fasi di elaborazione */
+
+/* Inclusioni */
+#include "stagecache.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#ifdef _WIN32
+	#include <process.h>
+	#define getpid _getpid
+#else
+	#include <unistd.h>
+#endif
+
+/* Memory leaks debugger */
+#ifdef DebugMLeaks
+	#include "debug_new.h"
+#endif
+
+/* Costanti FNV-1a a 64 bit */
+#define SCFNVOffset 14695981039346656037ULL
+#define SCFNVPrime 1099511628211ULL
+
+/* Identificativo formato file di cache */
+#define SCMagic "DRCSC01"
+#define SCMagicLen 8
+
+/* Intestazione file di cache */
+typedef struct
+	{
+		char Magic[SCMagicLen];
+		SCKeyType Key;
+		int RealSize;
+		int SigLen;
+		int NParms;
+	}
+SCHeaderType;
+
+/* Valore iniziale della chiave */
+SCKeyType SCHashInit(void)
+	{
+		return SCFNVOffset;
+	}
+
+/* Aggiorna la chiave con un blocco di dati generico */
+SCKeyType SCHashData(SCKeyType Key,const void * Data,const size_t Size)
+	{
+		const unsigned char * P = (const unsigned char *) Data;
+		size_t I;
+
+		for (I = 0;I < Size;I++)
+			{
+				Key ^= (SCKeyType) P[I];
+				Key *= SCFNVPrime;
+			}
+
+		return Key;
+	}
+
+/* Aggiorna la chiave con un segnale */
+SCKeyType SCHashSignal(SCKeyType Key,const DLReal * Sig,const int SigLen)
+	{
+		Key = SCHashData(Key,&SigLen,sizeof(int));
+		return SCHashData(Key,Sig,SigLen * sizeof(DLReal));
+	}
+
+/* Verifica se il nome del parametro inizia con uno dei prefissi */
+static Boolean SCPrefixMatch(const char * PName,const char * Prefixes[])
+	{
+		int I;
+
+		for (I = 0;Prefixes[I] != NULL;I++)
+			if (strncmp(PName,Prefixes[I],strlen(Prefixes[I])) == 0)
+				return True;
+
+		return False;
+	}
+
+/* Verifica se il parametro indica un file di output, il cui nome o
+formato non influenza il risultato della fase */
+static Boolean SCOutputParm(const char * PName)
+	{
+		size_t L;
+
+		L = strlen(PName);
+		if (L >= 7 && strcmp(&PName[L - 7],"OutFile") == 0)
+			return True;
+		if (L >= 11 && strcmp(&PName[L - 11],"OutFileType") == 0)
+			return True;
+
+		return False;
+	}
+
+/* Aggiorna la chiave con i parametri di configurazione */
+SCKeyType SCHashCfg(SCKeyType Key,const CfgParameter * CfgParms,
+	const char * Prefixes[])
+	{
+		const char * S;
+		int I;
+
+		for (I = 0;CfgParms[I].PType != CfgEnd;I++)
+			{
+				/* Verifica se il parametro appartiene alle fasi richieste */
+				if (SCPrefixMatch(CfgParms[I].PName,Prefixes) == False ||
+					SCOutputParm(CfgParms[I].PName) == True)
+					continue;
+
+				/* Aggiunge il nome del parametro */
+				Key = SCHashData(Key,CfgParms[I].PName,strlen(CfgParms[I].PName) + 1);
+
+				/* Aggiunge il valore del parametro */
+				switch (CfgParms[I].PType)
+					{
+						case CfgString:
+							S = *((const char **) CfgParms[I].PValue);
+							if (S == NULL)
+								Key = SCHashData(Key,"",1);
+							else
+								Key = SCHashData(Key,S,strlen(S) + 1);
+						break;
+
+						case CfgBoolean:
+						case CfgInt:
+						case CfgUInt:
+							Key = SCHashData(Key,CfgParms[I].PValue,sizeof(int));
+						break;
+
+						case CfgLong:
+						case CfgULong:
+							Key = SCHashData(Key,CfgParms[I].PValue,sizeof(long));
+						break;
+
+						case CfgFloat:
+							Key = SCHashData(Key,CfgParms[I].PValue,sizeof(float));
+						break;
+
+						case CfgDouble:
+							Key = SCHashData(Key,CfgParms[I].PValue,sizeof(double));
+						break;
+
+						case CfgEnd:
+						break;
+					}
+			}
+
+		return Key;
+	}
+
+/* Determina il nome del file di cache */
+static char * SCFileName(const char * CacheDir,const char * Tag,const SCKeyType Key)
+	{
+		char * FName;
+		size_t L;
+
+		L = strlen(CacheDir) + strlen(Tag) + 32;
+		if ((FName = (char *) malloc(L)) == NULL)
+			return NULL;
+		snprintf(FName,L,"%s/%s-%016llx.dsc",CacheDir,Tag,Key);
+
+		return FName;
+	}
+
+/* Recupera un risultato dalla cache */
+DLReal * SCLoad(const char * CacheDir,const char * Tag,const SCKeyType Key,
+	int * SigLen,int * Parms,const int NParms)
+	{
+		SCHeaderType SCH;
+		char * FName;
+		FILE * IOF;
+		DLReal * Sig;
+
+		/* Apre il file di cache */
+		if ((FName = SCFileName(CacheDir,Tag,Key)) == NULL)
+			return NULL;
+		IOF = fopen(FName,"rb");
+		free(FName);
+		if (IOF == NULL)
+			return NULL;
+
+		/* Verifica l'intestazione */
+		if (fread(&SCH,sizeof(SCHeaderType),1,IOF) != 1 ||
+			memcmp(SCH.Magic,SCMagic,SCMagicLen) != 0 || SCH.Key != Key ||
+			SCH.RealSize != (int) sizeof(DLReal) || SCH.SigLen <= 0 ||
+			SCH.NParms != NParms)
+			{
+				fclose(IOF);
+				return NULL;
+			}
+
+		/* Alloca il segnale */
+		if ((Sig = new DLReal[SCH.SigLen]) == NULL)
+			{
+				fclose(IOF);
+				return NULL;
+			}
+
+		/* Legge i parametri ed il segnale */
+		if (fread(Parms,sizeof(int),NParms,IOF) != (size_t) NParms ||
+			fread(Sig,sizeof(DLReal),SCH.SigLen,IOF) != (size_t) SCH.SigLen)
+			{
+				delete[] Sig;
+				fclose(IOF);
+				return NULL;
+			}
+
+		/* Chiude il file */
+		fclose(IOF);
+
+		*SigLen = SCH.SigLen;
+		return Sig;
+	}
+
+/* Salva un risultato nella cache */
+Boolean SCStore(const char * CacheDir,const char * Tag,const SCKeyType Key,
+	const DLReal * Sig,const int SigLen,const int * Parms,const int NParms)
+	{
+		SCHeaderType SCH;
+		char * FName;
+		char * TName;
+		FILE * IOF;
+		Boolean Res;
+
+		/* Determina i nomi dei file */
+		if ((FName = SCFileName(CacheDir,Tag,Key)) == NULL)
+			return False;
+		if ((TName = (char *) malloc(strlen(FName) + 32)) == NULL)
+			{
+				free(FName);
+				return False;
+			}
+		sprintf(TName,"%s.%d.tmp",FName,(int) getpid());
+
+		/* Prepara l'intestazione */
+		memset(&SCH,0,sizeof(SCHeaderType));
+		memcpy(SCH.Magic,SCMagic,SCMagicLen);
+		SCH.Key = Key;
+		SCH.RealSize = (int) sizeof(DLReal);
+		SCH.SigLen = SigLen;
+		SCH.NParms = NParms;
+
+		/* Salva su un file temporaneo, rinominato solo a scrittura
+		completata per evitare risultati parziali in cache. Il nome
+		del file temporaneo dipende dal processo dato che pi
+		elaborazioni possono condividere la stessa cache. */
+		Res = False;
+		if ((IOF = fopen(TName,"wb")) != NULL)
+			{
+				if (fwrite(&SCH,sizeof(SCHeaderType),1,IOF) == 1 &&
+					fwrite(Parms,sizeof(int),NParms,IOF) == (size_t) NParms &&
+					fwrite(Sig,sizeof(DLReal),SigLen,IOF) == (size_t) SigLen)
+					Res = True;
+				if (fclose(IOF) != 0)
+					Res = False;
+				if (Res == True)
+					Res = (rename(TName,FName) == 0) ? True : False;
+				if (Res == False)
+					remove(TName);
+			}
+
+		free(TName);
+		free(FName);
+
+		return Res;
+	}
@@ -0,0 +1,70 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Cache su disco dei risultati intermedi delle varie fasi di elaborazione */
+
+/* Ogni risultato viene identificato da una chiave hash (FNV-1a a 64 bit)
+calcolata sul segnale in ingresso alla fase e sui parametri di configurazione
+letti dalla fase stessa e da quelle precedenti, identificati tramite i prefissi
+definiti in drccfg.h. Il file di cache contiene il segnale risultante ed un
+piccolo numero di parametri interi associati (posizione e lunghezza finestre). */
+
+#ifndef StageCache_h
+	#define StageCache_h
+
+	/* Inclusioni */
+	#include "dsplib.h"
+	#include "boolean.h"
+	#include "cfgparse.h"
+
+	/* Tipo chiave della cache */
+	typedef unsigned long long SCKeyType;
+
+	/* Valore iniziale della chiave */
+	SCKeyType SCHashInit(void);
+
+	/* Aggiorna la chiave con un blocco di dati generico */
+	SCKeyType SCHashData(SCKeyType Key,const void * Data,const size_t Size);
+
+	/* Aggiorna la chiave con un segnale */
+	SCKeyType SCHashSignal(SCKeyType Key,const DLReal * Sig,const int SigLen);
+
+	/* Aggiorna la chiave con i parametri di configurazione il cui nome
+	inizia con uno dei prefissi indicati. La lista di prefissi termina con NULL.
+	I parametri dei file di output (OutFile e OutFileType) vengono ignorati. */
+	SCKeyType SCHashCfg(SCKeyType Key,const CfgParameter * CfgParms,
+		const char * Prefixes[]);
+
+	/* Recupera un risultato dalla cache. Il segnale viene allocato con new[]
+	e la sua lunghezza ritornata in SigLen. Ritorna NULL se il risultato
+	non  presente o non  valido. */
+	DLReal * SCLoad(const char * CacheDir,const char * Tag,const SCKeyType Key,
+		int * SigLen,int * Parms,const int NParms);
+
+	/* Salva un risultato nella cache */
+	Boolean SCStore(const char * CacheDir,const char * Tag,const SCKeyType Key,
+		const DLReal * Sig,const int SigLen,const int * Parms,const int NParms);
+
+#endif
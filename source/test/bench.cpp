@@ -0,0 +1,839 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Micro benchmark delle funzioni DSP di DRC */
+
+/* Ogni funzione viene misurata con le dimensioni ricavate dai file di
+configurazione forniti, per ogni preset e frequenza di campionamento. Le
+frequenze di 176.4 e 192 kHz, prive di configurazione, vengono ricavate
+raddoppiando le dimensioni di quelle a 88.2 e 96 kHz. Per ogni misura
+vengono riportati il tempo per operazione, i campioni elaborati al secondo
+ed il numero di allocazioni per operazione, totali e non soddisfatte dal
+pool di DSPAlloc. */
+
+/* Inclusioni */
+#include "drc.h"
+#include "dsplib.h"
+#include "dspwind.h"
+#include "fft.h"
+#include "fftcodelet.h"
+#include "convol.h"
+#include "slprefilt.h"
+#include "bwprefilt.h"
+#include "hd.h"
+#include "toeplitz.h"
+#include "psychoacoustic.h"
+#include "fir.h"
+#include "baselib.h"
+#include "drccfg.h"
+#include "cfgparse.h"
+#include "dspalloc.h"
+#include "perfmon.h"
+#include "splitcpx.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <new>
+#ifdef _WIN32
+	#include <io.h>
+	#define dup _dup
+	#define fileno _fileno
+	#define BenchNullFile "NUL"
+#else
+	#include <unistd.h>
+	#define BenchNullFile "/dev/null"
+#endif
+
+/* Tempo minimo di misura predefinito, in secondi */
+#define BenchMinTime 0.5
+
+/* Numero massimo di filtri sul nome */
+#define BenchMaxFilters 16
+
+/* Numero di punti della risposta per GenericFir */
+#define BenchFirPoints 256
+
+/* Contatore delle allocazioni tramite new */
+static unsigned long BenchNewCount = 0;
+
+/* Operatori di allocazione con conteggio */
+void * operator new(size_t Size)
+	{
+		void * P;
+
+		BenchNewCount++;
+		if ((P = malloc(Size > 0 ? Size : 1)) == NULL)
+			throw std::bad_alloc();
+		return P;
+	}
+
+void * operator new[](size_t Size)
+	{
+		return operator new(Size);
+	}
+
+void operator delete(void * P) throw()
+	{
+		free(P);
+	}
+
+void operator delete[](void * P) throw()
+	{
+		free(P);
+	}
+
+void operator delete(void * P,size_t) throw()
+	{
+		free(P);
+	}
+
+void operator delete[](void * P,size_t) throw()
+	{
+		free(P);
+	}
+
+/* Dimensioni ricavate da un preset */
+typedef struct
+	{
+		const char * Preset;
+		int SampleRate;
+		int BCInitWindow;
+		int HDMultExponent;
+		int MPWindowGap;
+		int MPLowerWindow;
+		int MPUpperWindow;
+		DLReal MPStartFreq;
+		DLReal MPEndFreq;
+		DLReal MPWindowExponent;
+		int MPFilterLen;
+		DLReal MPFSharpness;
+		int MPBandSplit;
+		int MPHDMultExponent;
+		int MPPFFinalWindow;
+		int EPPFFinalWindow;
+		int PTReferenceWindow;
+		DLReal PTBandWidth;
+		DLReal PTPeakDetectionStrength;
+		int PSFilterLen;
+		int PSMultExponent;
+	}
+BenchSizesType;
+
+/* Stato della misura corrente */
+typedef struct
+	{
+		/* Tempo minimo di misura */
+		double MinTime;
+
+		/* Iterazioni eseguite, esclusa quella di riscaldamento */
+		long Iterations;
+
+		/* Istante di avvio e tempo trascorso */
+		double Start;
+		double Elapsed;
+
+		/* Campioni elaborati per operazione */
+		double Items;
+
+		/* Allocazioni all'avvio della misura */
+		unsigned long NewStart;
+		unsigned long DSPStart;
+		unsigned long ReuseStart;
+
+		/* Allocazioni durante la misura */
+		unsigned long NewCount;
+		unsigned long DSPCount;
+		unsigned long ReuseCount;
+
+		/* Esito della funzione misurata */
+		Boolean Failed;
+	}
+BenchStateType;
+
+/* Controllo del ciclo di misura, la prima iterazione e' di riscaldamento
+e non viene conteggiata */
+static Boolean BenchRunning(BenchStateType * BS)
+	{
+		DSPAllocStatsType DS;
+		double T;
+
+		DSPAllocGetStats(&DS);
+		T = PMTime();
+
+		/* Riscaldamento */
+		if (BS->Iterations < 0)
+			{
+				BS->Iterations = 0;
+				return True;
+			}
+
+		/* Avvio della misura */
+		if (BS->Iterations == 0 && BS->Start < 0)
+			{
+				BS->NewStart = BenchNewCount;
+				BS->DSPStart = DS.AllocCount;
+				BS->ReuseStart = DS.ReuseCount;
+				BS->Start = PMTime();
+				return True;
+			}
+
+		BS->Iterations++;
+		BS->Elapsed = T - BS->Start;
+		if (BS->Elapsed < BS->MinTime && BS->Failed == False)
+			return True;
+
+		BS->NewCount = BenchNewCount - BS->NewStart;
+		BS->DSPCount = DS.AllocCount - BS->DSPStart;
+		BS->ReuseCount = DS.ReuseCount - BS->ReuseStart;
+		return False;
+	}
+
+/* Segnale sintetico deterministico, rumore con decadimento esponenziale
+preceduto da un impulso, simile ad una risposta all'impulso ambientale */
+static void BenchSignal(DLReal * S,const int N,const int SampleRate)
+	{
+		unsigned int Seed;
+		DLReal Decay;
+		DLReal G;
+		int I;
+
+		/* Tempo di decadimento di 60 dB pari a circa 0.3 s */
+		Decay = (DLReal) exp(-6.9 / (0.3 * SampleRate));
+		Seed = 12345;
+		G = (DLReal) 0.1;
+		S[0] = (DLReal) 1.0;
+		for (I = 1;I < N;I++)
+			{
+				Seed = Seed * 1664525 + 1013904223;
+				S[I] = G * ((DLReal) ((int) (Seed >> 8) - (1 << 23)) / (DLReal) (1 << 23));
+				G *= Decay;
+			}
+	}
+
+/* Funzioni misurate */
+
+static void BenchFft(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		DLComplex * P;
+		int N;
+		int I;
+
+		N = SZ->MPLowerWindow;
+		if ((P = new DLComplex[N]) == NULL)
+			{
+				BS->Failed = True;
+				return;
+			}
+		for (I = 0;I < N;I++)
+			P[I] = (DLReal) 0.0;
+		P[0] = (DLReal) 1.0;
+
+		BS->Items = N;
+		while (BenchRunning(BS) == True)
+			if (Fft(P,N) == False)
+				BS->Failed = True;
+
+		delete[] P;
+	}
+
+/* Trasformate di tutte le lunghezze fino a FCMaxSize con trasformata
+espansa, alternate tra loro come nelle chiamate di LinearDelay e delle
+convoluzioni brevi */
+static void BenchSmallFft(BenchStateType * BS,const BenchSizesType *)
+	{
+		DLComplex P[FCMaxSize];
+		int N;
+		int I;
+
+		for (I = 0;I < FCMaxSize;I++)
+			P[I] = (DLReal) 0.0;
+		P[0] = (DLReal) 1.0;
+
+		BS->Items = 0;
+		for (N = 2;N <= FCMaxSize;N++)
+			if (FCAvailable(N) == True)
+				BS->Items += N;
+		while (BenchRunning(BS) == True)
+			for (N = 2;N <= FCMaxSize;N++)
+				if (FCAvailable(N) == True)
+					if (Fft(P,N) == False)
+						BS->Failed = True;
+	}
+
+static void BenchConvolve(BenchStateType * BS,const BenchSizesType * SZ,
+	const Boolean Overlap)
+	{
+		DLReal * A;
+		DLReal * B;
+		DLReal * R;
+		int NA;
+		int NB;
+
+		NA = SZ->MPLowerWindow;
+		NB = SZ->PSFilterLen;
+		A = new DLReal[NA];
+		B = new DLReal[NB];
+		R = new DLReal[NA + NB - 1];
+		if (A == NULL || B == NULL || R == NULL)
+			{
+				BS->Failed = True;
+				return;
+			}
+		BenchSignal(A,NA,SZ->SampleRate);
+		BenchSignal(B,NB,SZ->SampleRate);
+
+		BS->Items = NA + NB - 1;
+		while (BenchRunning(BS) == True)
+			if (Overlap == True)
+				{
+					if (OAFftConvolve(A,NA,B,NB,R) == False)
+						BS->Failed = True;
+				}
+			else
+				{
+					if (DFftConvolve(A,NA,B,NB,R) == False)
+						BS->Failed = True;
+				}
+
+		delete[] A;
+		delete[] B;
+		delete[] R;
+	}
+
+static void BenchDFftConvolve(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		BenchConvolve(BS,SZ,False);
+	}
+
+static void BenchOAFftConvolve(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		BenchConvolve(BS,SZ,True);
+	}
+
+static void BenchPreFilt(BenchStateType * BS,const BenchSizesType * SZ,
+	const Boolean SlidingLowpass)
+	{
+		DLReal * In;
+		DLReal * Out;
+		int OutLen;
+
+		OutLen = SZ->MPLowerWindow + SZ->MPFilterLen - 1;
+		In = new DLReal[SZ->MPLowerWindow];
+		Out = new DLReal[OutLen];
+		if (In == NULL || Out == NULL)
+			{
+				BS->Failed = True;
+				return;
+			}
+		BenchSignal(In,SZ->MPLowerWindow,SZ->SampleRate);
+
+		BS->Items = SZ->MPLowerWindow;
+		while (BenchRunning(BS) == True)
+			if (SlidingLowpass == True)
+				SLPreFilt(In,SZ->MPLowerWindow,SZ->MPUpperWindow,SZ->MPFilterLen,
+					SZ->MPBandSplit,SZ->MPWindowExponent,SZ->SampleRate,SZ->MPStartFreq,
+					SZ->MPEndFreq,SZ->MPWindowGap,SZ->MPFSharpness,Out,WRight,SLPBilinear);
+			else
+				BWPreFilt(In,SZ->MPLowerWindow,SZ->MPUpperWindow,SZ->MPFilterLen,
+					SZ->MPBandSplit,SZ->MPWindowExponent,SZ->SampleRate,SZ->MPStartFreq,
+					SZ->MPEndFreq,SZ->MPWindowGap,Out,WRight,BWPBilinear);
+
+		delete[] In;
+		delete[] Out;
+	}
+
+static void BenchSLPreFilt(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		BenchPreFilt(BS,SZ,True);
+	}
+
+static void BenchBWPreFilt(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		BenchPreFilt(BS,SZ,False);
+	}
+
+static void BenchCepstrumHD(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		DLReal * In;
+		DLReal * MP;
+		DLReal * EP;
+		int N;
+
+		/* Dimensioni come nella deconvoluzione omomorfa iniziale */
+		N = SZ->BCInitWindow;
+		In = new DLReal[N];
+		MP = new DLReal[2 * N];
+		EP = new DLReal[N];
+		if (In == NULL || MP == NULL || EP == NULL)
+			{
+				BS->Failed = True;
+				return;
+			}
+		BenchSignal(In,N,SZ->SampleRate);
+
+		BS->Items = N;
+		while (BenchRunning(BS) == True)
+			if (CepstrumHD(In,&MP[N / 2 - (1 - (N % 2))],EP,N,SZ->HDMultExponent) == False)
+				BS->Failed = True;
+
+		delete[] In;
+		delete[] MP;
+		delete[] EP;
+	}
+
+/* Logaritmo del modulo ed esponenziale complesso di uno spettro con le
+dimensioni della deconvoluzione omomorfa iniziale, con le funzioni
+vettorizzabili o con la libreria matematica standard */
+static void BenchLogExp(BenchStateType * BS,const BenchSizesType * SZ,const Boolean Libm)
+	{
+		SCSpectrum<DLReal> S;
+		DLReal * In;
+		DLReal * L;
+		int FS;
+		int I;
+
+		for (FS = 1;FS <= SZ->BCInitWindow;FS <<= 1);
+		FS *= 1 << SZ->HDMultExponent;
+		In = new DLReal[FS];
+		L = new DLReal[FS];
+		if (In == NULL || L == NULL || SCAlloc(S,FS) == False)
+			{
+				BS->Failed = True;
+				return;
+			}
+		BenchSignal(In,FS,SZ->SampleRate);
+
+		VMSetLibm(Libm);
+		BS->Items = FS;
+		while (BenchRunning(BS) == True)
+			{
+				for (I = 0;I < FS;I++)
+					{
+						S.Re[I] = In[I];
+						S.Im[I] = In[FS - 1 - I];
+					}
+				SCLogAbs(S,L,DRCMinFloat);
+				for (I = 0;I < FS;I++)
+					{
+						S.Re[I] = L[I];
+						S.Im[I] = In[I];
+					}
+				SCExp(S);
+			}
+		VMSetLibm(False);
+
+		delete[] In;
+		delete[] L;
+		SCFree(S);
+	}
+
+static void BenchVMLogExp(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		BenchLogExp(BS,SZ,False);
+	}
+
+static void BenchLibmLogExp(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		BenchLogExp(BS,SZ,True);
+	}
+
+static void BenchToeplitzSolve(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		DLReal * A;
+		DLReal * B;
+		DLReal * X;
+		int N;
+		int I;
+
+		/* Dimensioni come nell'inversione ai minimi quadrati */
+		N = SZ->MPPFFinalWindow + SZ->EPPFFinalWindow - 1;
+		A = new DLReal[N];
+		B = new DLReal[N];
+		X = new DLReal[N];
+		if (A == NULL || B == NULL || X == NULL)
+			{
+				BS->Failed = True;
+				return;
+			}
+		BenchSignal(A,N,SZ->SampleRate);
+		for (I = 0;I < N;I++)
+			B[N - 1 - I] = A[I];
+		if (AutoCorrelation(A,N) == False)
+			{
+				BS->Failed = True;
+				return;
+			}
+		for (I = N / 2;I < N;I++)
+			A[I] = 0;
+
+		BS->Items = N;
+		while (BenchRunning(BS) == True)
+			if (ToeplitzSolve(A,B,X,N) != 0)
+				BS->Failed = True;
+
+		delete[] A;
+		delete[] B;
+		delete[] X;
+	}
+
+static void BenchSpectralEnvelope(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		DLReal * S;
+		DLReal * SE;
+		int N;
+
+		N = SZ->PTReferenceWindow;
+		S = new DLReal[N];
+		SE = new DLReal[N];
+		if (S == NULL || SE == NULL)
+			{
+				BS->Failed = True;
+				return;
+			}
+		BenchSignal(S,N,SZ->SampleRate);
+
+		BS->Items = N;
+		while (BenchRunning(BS) == True)
+			if (SpectralEnvelope(S,N,SZ->SampleRate,SZ->PTBandWidth,
+				SZ->PTPeakDetectionStrength,SE) == False)
+				BS->Failed = True;
+
+		delete[] S;
+		delete[] SE;
+	}
+
+static void BenchGenericFir(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		DLReal * Filter;
+		DLReal F[BenchFirPoints];
+		DLReal M[BenchFirPoints];
+		DLReal P[BenchFirPoints];
+		int Is;
+		int I;
+
+		/* Risposta di riferimento su scala logaritmica con pendenza
+		e ondulazione, come un target di correzione tipico */
+		F[0] = 0;
+		M[0] = 1;
+		P[0] = 0;
+		for (I = 1;I < BenchFirPoints - 1;I++)
+			{
+				F[I] = (DLReal) (2.0 * 20.0 * pow(1000.0,(I - 1.0) / (BenchFirPoints - 3.0)) /
+					SZ->SampleRate);
+				M[I] = (DLReal) (pow(10.0,(-3.0 * I / BenchFirPoints +
+					sin(0.3 * I)) / 20.0));
+				P[I] = 0;
+			}
+		F[BenchFirPoints - 1] = 1;
+		M[BenchFirPoints - 1] = M[BenchFirPoints - 2];
+		P[BenchFirPoints - 1] = 0;
+
+		/* Dimensione di interpolazione come per il filtro PS */
+		for (Is = 1;Is <= SZ->PSFilterLen;Is <<= 1);
+		Is *= 1 << SZ->PSMultExponent;
+
+		if ((Filter = new DLReal[SZ->PSFilterLen]) == NULL)
+			{
+				BS->Failed = True;
+				return;
+			}
+
+		BS->Items = SZ->PSFilterLen;
+		while (BenchRunning(BS) == True)
+			if (GenericFir(Filter,SZ->PSFilterLen,F,M,P,BenchFirPoints,Is,
+				SplineLogarithmic) == False)
+				BS->Failed = True;
+
+		delete[] Filter;
+	}
+
+static void BenchWindow(BenchStateType * BS,const BenchSizesType * SZ)
+	{
+		DLReal * S;
+		DLReal * W;
+		int N;
+
+		N = SZ->BCInitWindow;
+		S = new DLReal[N];
+		W = new DLReal[N];
+		if (S == NULL || W == NULL)
+			{
+				BS->Failed = True;
+				return;
+			}
+		BenchSignal(S,N,SZ->SampleRate);
+
+		/* Finestrature ripetute sulla stessa dimensione, come nelle fasi
+		successive della correzione, su una copia del segnale per evitare
+		valori denormalizzati */
+		BS->Items = N;
+		while (BenchRunning(BS) == True)
+			{
+				memcpy(W,S,N * sizeof(DLReal));
+				BlackmanWindow(W,N);
+				SpacedBlackmanWindow(W,N,N / 2,WFull);
+				HalfBlackmanWindow(W,N,0,WRight);
+			}
+
+		delete[] S;
+		delete[] W;
+	}
+
+/* Elenco delle funzioni misurate */
+typedef struct
+	{
+		const char * Name;
+		void (* Bench)(BenchStateType * BS,const BenchSizesType * SZ);
+	}
+BenchDefType;
+
+static const BenchDefType BenchDefs[] =
+	{
+		{ "Fft", BenchFft },
+		{ "SmallFft", BenchSmallFft },
+		{ "DFftConvolve", BenchDFftConvolve },
+		{ "OAFftConvolve", BenchOAFftConvolve },
+		{ "SLPreFilt", BenchSLPreFilt },
+		{ "BWPreFilt", BenchBWPreFilt },
+		{ "CepstrumHD", BenchCepstrumHD },
+		{ "VMLogExp", BenchVMLogExp },
+		{ "LibmLogExp", BenchLibmLogExp },
+		{ "ToeplitzSolve", BenchToeplitzSolve },
+		{ "SpectralEnvelope", BenchSpectralEnvelope },
+		{ "GenericFir", BenchGenericFir },
+		{ "Window", BenchWindow },
+		{ NULL, NULL }
+	};
+
+/* Preset e frequenze di campionamento */
+static const char * BenchPresets[] =
+	{ "minimal", "soft", "normal", "strong", "extreme", "insane", "erb", NULL };
+
+typedef struct
+	{
+		int SampleRate;
+
+		/* Nome della configurazione e fattore di scala delle dimensioni */
+		const char * CfgRate;
+		int Scale;
+	}
+BenchRateType;
+
+static const BenchRateType BenchRates[] =
+	{
+		{ 44100, "44.1", 1 },
+		{ 48000, "48.0", 1 },
+		{ 88200, "88.2", 1 },
+		{ 96000, "96.0", 1 },
+		{ 176400, "88.2", 2 },
+		{ 192000, "96.0", 2 },
+		{ 0, NULL, 0 }
+	};
+
+/* Legge le dimensioni dal file di configurazione del preset */
+static Boolean BenchReadSizes(const char * CfgDir,const char * Preset,
+	const BenchRateType * Rate,BenchSizesType * SZ)
+	{
+		char CfgFile[1024];
+		int S;
+
+		snprintf(CfgFile,sizeof(CfgFile),"%s/%s kHz/%s-%s.drc",CfgDir,Rate->CfgRate,
+			Preset,Rate->CfgRate);
+		if (CfgParse(CfgFile,CfgParmsDef,CfgSimple) <= 0)
+			{
+				fprintf(stderr,"Config file '%s' parsing error: %s\n",CfgFile,
+					CfgGetLastErrorDsc());
+				CfgFree(CfgParmsDef);
+				return False;
+			}
+
+		S = Rate->Scale;
+		SZ->Preset = Preset;
+		SZ->SampleRate = Rate->SampleRate;
+		SZ->BCInitWindow = S * Cfg.BCInitWindow;
+		SZ->HDMultExponent = Cfg.HDMultExponent;
+		SZ->MPWindowGap = S * Cfg.MPWindowGap;
+		SZ->MPLowerWindow = S * Cfg.MPLowerWindow;
+		SZ->MPUpperWindow = S * Cfg.MPUpperWindow;
+		SZ->MPStartFreq = Cfg.MPStartFreq;
+		SZ->MPEndFreq = Cfg.MPEndFreq;
+		SZ->MPWindowExponent = Cfg.MPWindowExponent;
+		SZ->MPFilterLen = S * Cfg.MPFilterLen;
+		SZ->MPFSharpness = Cfg.MPFSharpness;
+		SZ->MPBandSplit = Cfg.MPBandSplit;
+		SZ->MPHDMultExponent = Cfg.MPHDMultExponent;
+		SZ->MPPFFinalWindow = S * Cfg.MPPFFinalWindow;
+		SZ->EPPFFinalWindow = S * Cfg.EPPFFinalWindow;
+		SZ->PTReferenceWindow = S * Cfg.PTReferenceWindow;
+		SZ->PTBandWidth = Cfg.PTBandWidth;
+		SZ->PTPeakDetectionStrength = Cfg.PTPeakDetectionStrength;
+
+		/* Mantiene la lunghezza dispari del filtro PS */
+		SZ->PSFilterLen = S * Cfg.PSFilterLen + (S - 1) * (Cfg.PSFilterLen % 2);
+		SZ->PSMultExponent = Cfg.PSMultExponent;
+
+		CfgFree(CfgParmsDef);
+		return True;
+	}
+
+/* Verifica se il nome soddisfa tutti i filtri */
+static Boolean BenchMatch(const char * Name,char * Filters[],const int NFilters)
+	{
+		int I;
+
+		for (I = 0;I < NFilters;I++)
+			if (strstr(Name,Filters[I]) == NULL)
+				return False;
+		return True;
+	}
+
+/* Programma principale */
+int main(int argc, char * argv[])
+	{
+		char * Filters[BenchMaxFilters];
+		int NFilters;
+		char * FilterList;
+		char * Tok;
+		const char * CfgDir;
+		double MinTime;
+		FILE * CF;
+		FILE * OF;
+		BenchSizesType SZ;
+		BenchStateType BS;
+		char Name[256];
+		int A;
+		int R;
+		int P;
+		int B;
+		int Fails;
+
+		/* Valori predefiniti */
+		CfgDir = "config";
+		MinTime = BenchMinTime;
+		NFilters = 0;
+		FilterList = NULL;
+		CF = NULL;
+
+		/* Parametri da linea di comando */
+		for (A = 1;A < argc;A++)
+			{
+				if (strncmp(argv[A],"--filter=",9) == 0)
+					FilterList = &argv[A][9];
+				else if (strncmp(argv[A],"--min-time=",11) == 0)
+					MinTime = atof(&argv[A][11]);
+				else if (strncmp(argv[A],"--config-dir=",13) == 0)
+					CfgDir = &argv[A][13];
+				else if (strncmp(argv[A],"--csv=",6) == 0)
+					{
+						if ((CF = fopen(&argv[A][6],"wt")) == NULL)
+							{
+								perror(&argv[A][6]);
+								return 1;
+							}
+					}
+				else
+					{
+						fprintf(stderr,"Usage: drcbench [--filter=text[,text...]] [--min-time=seconds]\n"
+							"                [--config-dir=dir] [--csv=file]\n\n"
+							"Benchmarks are named function/preset/rate, e.g. Fft/normal/44100.\n"
+							"Only the benchmarks whose name contains all the filter texts are run.\n");
+						return 1;
+					}
+			}
+
+		/* Suddivide l'elenco dei filtri */
+		if (FilterList != NULL)
+			for (Tok = strtok(FilterList,",");Tok != NULL && NFilters < BenchMaxFilters;
+				Tok = strtok(NULL,","))
+				Filters[NFilters++] = Tok;
+
+		/* I messaggi di avanzamento delle funzioni DSP vengono soppressi,
+		i risultati sono scritti su una copia dello standard output */
+		fflush(stdout);
+		if ((OF = fdopen(dup(fileno(stdout)),"wt")) == NULL ||
+			freopen(BenchNullFile,"wt",stdout) == NULL)
+			{
+				perror("stdout");
+				return 1;
+			}
+
+		fprintf(OF,"%-40s %14s %10s %12s %10s %12s\n","Benchmark","Time (ns)","Iterations",
+			"Msamples/s","Allocs/op","SysAllocs/op");
+		if (CF != NULL)
+			fputs("benchmark,ns_per_op,iterations,msamples_per_s,allocs_per_op,sys_allocs_per_op\n",CF);
+
+		Fails = 0;
+		for (B = 0;BenchDefs[B].Name != NULL;B++)
+			for (R = 0;BenchRates[R].SampleRate > 0;R++)
+				for (P = 0;BenchPresets[P] != NULL;P++)
+					{
+						snprintf(Name,sizeof(Name),"%s/%s/%d",BenchDefs[B].Name,BenchPresets[P],
+							BenchRates[R].SampleRate);
+						if (BenchMatch(Name,Filters,NFilters) == False)
+							continue;
+
+						if (BenchReadSizes(CfgDir,BenchPresets[P],&BenchRates[R],&SZ) == False)
+							{
+								Fails++;
+								continue;
+							}
+
+						/* Esegue la misura */
+						memset(&BS,0,sizeof(BS));
+						BS.MinTime = MinTime;
+						BS.Iterations = -1;
+						BS.Start = -1;
+						BS.Failed = False;
+						BenchDefs[B].Bench(&BS,&SZ);
+
+						if (BS.Failed == True || BS.Iterations <= 0)
+							{
+								fprintf(OF,"%-40s %14s\n",Name,"FAILED");
+								Fails++;
+								continue;
+							}
+
+						fprintf(OF,"%-40s %14.0f %10ld %12.3f %10.1f %12.1f\n",Name,
+							1.0e9 * BS.Elapsed / BS.Iterations,BS.Iterations,
+							1.0e-6 * BS.Items * BS.Iterations / BS.Elapsed,
+							((double) (BS.NewCount + BS.DSPCount)) / BS.Iterations,
+							((double) (BS.NewCount + BS.DSPCount - BS.ReuseCount)) / BS.Iterations);
+						fflush(OF);
+
+						if (CF != NULL)
+							fprintf(CF,"%s,%.0f,%ld,%.6f,%.3f,%.3f\n",Name,
+								1.0e9 * BS.Elapsed / BS.Iterations,BS.Iterations,
+								1.0e-6 * BS.Items * BS.Iterations / BS.Elapsed,
+								((double) (BS.NewCount + BS.DSPCount)) / BS.Iterations,
+								((double) (BS.NewCount + BS.DSPCount - BS.ReuseCount)) / BS.Iterations);
+					}
+
+		if (CF != NULL)
+			fclose(CF);
+		fclose(OF);
+
+		return (Fails > 0) ? 1 : 0;
+	}
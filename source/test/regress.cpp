@@ -0,0 +1,1969 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Test di regressione di DRC sulle configurazioni fornite */
+
+/* Per ogni preset e frequenza di campionamento viene generata una risposta
+all'impulso sintetica deterministica, viene eseguito DRC con il profilo
+delle prestazioni attivo e la risposta del filtro PS risultante viene
+confrontata, in modulo e fase, con quella di riferimento memorizzata nella
+directory test/golden. I tempi di esecuzione vengono confrontati con quelli
+di una esecuzione di riferimento precedente sulla stessa macchina. Il
+programma ritorna un valore diverso da zero se una risposta supera le
+tolleranze impostate o se il tempo di esecuzione aumenta oltre la soglia.
+
+Con l'opzione --derive viene invece verificata la derivazione dei filtri
+tramite BCDeriveRates: per ogni preset il filtro calcolato a 96 kHz viene
+ricampionato alle altre frequenze e confrontato con quello calcolato
+direttamente alla frequenza stessa, a meno di un guadagno costante e di un
+ritardo puro. Per confrontare i filtri a parit di
+misura, la risposta all'impulso usata alle altre frequenze  a sua volta
+ricampionata da quella a 96 kHz, dato che la coda di rumore della risposta
+sintetica cambia con la frequenza di campionamento. Dato che il ritardo del filtro ricavato
+ proporzionale a quello del filtro originale, mentre le configurazioni
+fornite scalano il ritardo per ottave, la fase viene confrontata a meno di
+un ritardo puro, stimato dalla posizione dei picchi e dalla pendenza della
+differenza di fase. Il guadagno viene invece escluso perch la misura
+ricampionata non ha contenuto nella parte alta della banda, che il filtro
+calcolato direttamente tende ad esaltare alterando la normalizzazione. */
+
+/* Inclusioni */
+#include "boolean.h"
+#include "perfmon.h"
+#include "resample.h"
+#include "dipknee.h"
+#include "tpool.h"
+#include <complex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+	#include <direct.h>
+	#define RGMkDir(D) _mkdir(D)
+	#define RGAbsPath(P) _fullpath(NULL,P,0)
+	#define RGChDir "cd /d"
+#else
+	#define RGMkDir(D) mkdir(D,0755)
+	#define RGAbsPath(P) realpath(P,NULL)
+	#define RGChDir "cd"
+#endif
+
+/* Tolleranze predefinite, modulo in dB, fase in gradi, tempo in percentuale */
+#define RGMagTol 0.1
+#define RGPhaseTol 1.0
+#define RGTimeTol 25.0
+
+/* Tolleranze nel confronto dei filtri ricavati, errori massimi rispetto
+al filtro di partenza ed errori quadratici medi predefiniti rispetto al
+filtro calcolato direttamente */
+#define RGDeriveSrcMagTol 0.01
+#define RGDeriveSrcPhaseTol 0.1
+#define RGDeriveMagTol 2.0
+#define RGDerivePhaseTol 15.0
+
+/* Livello minimo, rispetto al picco, dei punti confrontati in dB */
+#define RGFloor 60.0
+
+/* Tempo minimo sotto al quale il confronto dei tempi viene ignorato */
+#define RGMinTime 0.5
+
+/* Risoluzione della risposta in frazioni di ottava */
+#define RGOctaveSplit 12
+
+/* Numero massimo di punti della risposta */
+#define RGMaxPoints 512
+
+/* Numero massimo di fasi e di righe di riferimento */
+#define RGMaxStages 64
+#define RGMaxBaseline 4096
+
+/* Numero massimo di filtri sul nome */
+#define RGMaxFilters 16
+
+/* Lunghezza massima dei nomi file e delle righe */
+#define RGPathLen 1024
+#define RGLineLen 4096
+
+/* Lunghezza massima della linea di comando, che contiene fino a nove
+nomi file */
+#define RGCmdLen (10 * RGPathLen)
+
+/* Numero di coppie degli spettri casuali ed errori relativi massimi nel
+confronto dei nuclei di limitazione delle valli con le versioni originali */
+#define RGDKPairs 4096
+#define RGDKFloatTol 1.0e-5
+#define RGDKDoubleTol 1.0e-12
+
+/* Numero di valori della riduzione, numero di esecuzioni del grafo e
+iterazioni a vuoto di ogni task nelle verifiche del pool di thread */
+#define RGTPCount 100000
+#define RGTPGraphRuns 200
+#define RGTPSpin 2000
+#define RGTPTasks 4
+
+/* Preset e valori di PSNormFactor della verifica della condivisione
+delle fasi comuni in modalit sweep, con tutti i segnali intermedi
+salvati su file */
+#define RGSweepPreset "normal"
+#define RGSweepRuns 3
+
+/* Preset, opzioni ed errore relativo massimo della verifica del passaggio
+diretto dello spettro della convoluzione alla fase successiva. Con i
+moltiplicatori predefiniti il passaggio non conviene mai, per cui i
+moltiplicatori del peak limiting e del filtro a fase minima vengono
+azzerati e viene usato il filtro a fase lineare non finestrato */
+#define RGHandoffPreset "normal"
+#define RGHandoffOpts "--PLMultExponent=0 --MSMultExponent=0 --PSFilterType=L " \
+	"--PSOutWindow=0"
+#define RGHandoffTol 1.0e-6
+
+/* Pi greco */
+#define RGPi 3.14159265358979323846
+
+/* Fase rilevata dal profilo delle prestazioni */
+typedef struct
+	{
+		char Name[64];
+		double Wall;
+	}
+RGStageType;
+
+/* Risultato di una esecuzione */
+typedef struct
+	{
+		double Wall;
+		double PeakRSS;
+		int NStages;
+		RGStageType Stages[RGMaxStages];
+	}
+RGRunType;
+
+/* Riga del file dei tempi di riferimento */
+typedef struct
+	{
+		char Key[128];
+		double Wall;
+	}
+RGBaselineType;
+
+/* Risposta in frequenza */
+typedef struct
+	{
+		int NP;
+		long Peak;
+		double F[RGMaxPoints];
+		double Mag[RGMaxPoints];
+		double Phase[RGMaxPoints];
+	}
+RGResponseType;
+
+/* Preset e frequenze di campionamento */
+static const char * RGPresets[] =
+	{ "minimal", "soft", "normal", "strong", "extreme", "insane", "erb", NULL };
+
+typedef struct
+	{
+		int SampleRate;
+		const char * Name;
+	}
+RGRateType;
+
+static const RGRateType RGRates[] =
+	{
+		{ 44100, "44.1" },
+		{ 48000, "48.0" },
+		{ 88200, "88.2" },
+		{ 96000, "96.0" },
+		{ 0, NULL }
+	};
+
+static const char * RGSweepValues[RGSweepRuns] = { "1.0", "0.9", "0.8" };
+static const char * RGSweepDumps[] =
+	{ "HDMPOutFile", "HDEPOutFile", "MPPFOutFile", "EPPFOutFile", "PCOutFile",
+		"ISOutFile", NULL };
+
+/* Task dei grafi usati nella verifica del pool di thread */
+typedef struct
+	{
+		int Id;
+		int NDeps;
+		int Deps[2];
+	}
+RGTPNodeType;
+
+/* Tempi di riferimento */
+static RGBaselineType RGBaseline[RGMaxBaseline];
+static int RGNBaseline = 0;
+
+/* Genera la risposta all'impulso sintetica: impulso diretto, due
+riflessioni, quattro modi ambientali ed una coda di rumore con decadimento
+esponenziale, tutti dipendenti solo dalla frequenza di campionamento */
+static Boolean RGMakeIR(const char * FName,const int Rate)
+	{
+		static const double MF[4] = { 42.0, 67.0, 118.0, 230.0 };
+		static const double MT[4] = { 0.25, 0.18, 0.12, 0.08 };
+		static const double MA[4] = { 0.02, 0.015, 0.01, 0.008 };
+		FILE * OF;
+		float * IR;
+		unsigned int Seed;
+		double T;
+		double V;
+		int N;
+		int T0;
+		int I;
+		int K;
+
+		/* Lunghezza di 3 s con impulso centrato a 0.5 s */
+		N = 3 * Rate;
+		T0 = Rate / 2;
+		if ((IR = new float[N]) == NULL)
+			return False;
+		for (I = 0;I < N;I++)
+			IR[I] = 0;
+
+		IR[T0] = 1.0f;
+		IR[T0 + (int) (0.0031 * Rate)] += 0.5f;
+		IR[T0 + (int) (0.0073 * Rate)] -= 0.3f;
+
+		Seed = 12345;
+		for (I = T0;I < N;I++)
+			{
+				T = ((double) (I - T0)) / Rate;
+				V = 0;
+				for (K = 0;K < 4;K++)
+					V += MA[K] * exp(-T / MT[K]) * sin(2 * RGPi * MF[K] * T);
+				if (T > 0.001)
+					{
+						Seed = Seed * 1664525 + 1013904223;
+						V += 0.05 * exp(-T / 0.07) *
+							(((double) (Seed >> 8)) / (1 << 23) - 1.0);
+					}
+				IR[I] += (float) V;
+			}
+
+		if ((OF = fopen(FName,"wb")) == NULL)
+			{
+				delete[] IR;
+				return False;
+			}
+		if (fwrite(IR,sizeof(float),N,OF) != (size_t) N)
+			{
+				fclose(OF);
+				delete[] IR;
+				return False;
+			}
+		delete[] IR;
+		if (fclose(OF) != 0)
+			return False;
+		return True;
+	}
+
+/* Legge il profilo delle prestazioni in formato CSV */
+static Boolean RGReadProfile(const char * FName,RGRunType * Run)
+	{
+		FILE * PF;
+		char Line[RGLineLen];
+		char Name[64];
+		double Wall;
+		double CPU;
+		double RSS;
+
+		if ((PF = fopen(FName,"rt")) == NULL)
+			return False;
+
+		Run->NStages = 0;
+		Run->PeakRSS = 0;
+		while (fgets(Line,RGLineLen,PF) != NULL)
+			{
+				if (sscanf(Line,"\"%63[^\"]\",%lf,%lf,%lf",Name,&Wall,&CPU,&RSS) != 4)
+					continue;
+				if (RSS > Run->PeakRSS)
+					Run->PeakRSS = RSS;
+				if (Run->NStages < RGMaxStages)
+					{
+						strcpy(Run->Stages[Run->NStages].Name,Name);
+						Run->Stages[Run->NStages].Wall = Wall;
+						Run->NStages++;
+					}
+			}
+		fclose(PF);
+		return True;
+	}
+
+/* Calcola la risposta del filtro FName, a frazioni di ottava tra 20 Hz
+e 20 kHz, tramite DFT diretta sui singoli punti */
+static Boolean RGResponse(const char * FName,const int Rate,RGResponseType * R)
+	{
+		FILE * IF;
+		float * H;
+		long N;
+		long I;
+		double F;
+		double Re;
+		double Im;
+		double WR;
+		double WI;
+		double CR;
+		double CI;
+		double T;
+
+		if ((IF = fopen(FName,"rb")) == NULL)
+			return False;
+		fseek(IF,0,SEEK_END);
+		N = ftell(IF) / sizeof(float);
+		fseek(IF,0,SEEK_SET);
+		if (N <= 0 || (H = new float[N]) == NULL)
+			{
+				fclose(IF);
+				return False;
+			}
+		if (fread(H,sizeof(float),N,IF) != (size_t) N)
+			{
+				fclose(IF);
+				delete[] H;
+				return False;
+			}
+		fclose(IF);
+
+		/* Posizione del picco */
+		R->Peak = 0;
+		for (I = 1;I < N;I++)
+			if (fabs(H[I]) > fabs(H[R->Peak]))
+				R->Peak = I;
+
+		R->NP = 0;
+		for (F = 20.0;F <= 20000.0 && F < Rate / 2 && R->NP < RGMaxPoints;
+			F *= pow(2.0,1.0 / RGOctaveSplit))
+			{
+				/* Rotazione complessa per campione */
+				WR = cos(2 * RGPi * F / Rate);
+				WI = -sin(2 * RGPi * F / Rate);
+				CR = 1;
+				CI = 0;
+				Re = 0;
+				Im = 0;
+				for (I = 0;I < N;I++)
+					{
+						Re += H[I] * CR;
+						Im += H[I] * CI;
+						T = CR * WR - CI * WI;
+						CI = CR * WI + CI * WR;
+						CR = T;
+					}
+				R->F[R->NP] = F;
+				R->Mag[R->NP] = 10.0 * log10(Re * Re + Im * Im + 1.0e-30);
+				R->Phase[R->NP] = atan2(Im,Re) * 180.0 / RGPi;
+				R->NP++;
+			}
+
+		delete[] H;
+		return True;
+	}
+
+/* Salva la risposta di riferimento */
+static Boolean RGWriteGolden(const char * FName,const char * Name,const RGResponseType * R)
+	{
+		FILE * OF;
+		int I;
+
+		if ((OF = fopen(FName,"wt")) == NULL)
+			return False;
+		fprintf(OF,"# DRC regression golden response: %s\n",Name);
+		fputs("# Frequency (Hz), magnitude (dB), phase (degrees)\n",OF);
+		for (I = 0;I < R->NP;I++)
+			fprintf(OF,"%.4f %.6f %.6f\n",R->F[I],R->Mag[I],R->Phase[I]);
+		if (fclose(OF) != 0)
+			return False;
+		return True;
+	}
+
+/* Legge la risposta di riferimento */
+static Boolean RGReadGolden(const char * FName,RGResponseType * R)
+	{
+		FILE * IF;
+		char Line[RGLineLen];
+
+		if ((IF = fopen(FName,"rt")) == NULL)
+			return False;
+		R->NP = 0;
+		while (fgets(Line,RGLineLen,IF) != NULL && R->NP < RGMaxPoints)
+			if (Line[0] != '#' && sscanf(Line,"%lf %lf %lf",&R->F[R->NP],
+				&R->Mag[R->NP],&R->Phase[R->NP]) == 3)
+				R->NP++;
+		fclose(IF);
+		return True;
+	}
+
+/* Confronta le risposte, ignorando i punti sotto il livello minimo,
+ritorna False se i punti non corrispondono */
+static Boolean RGCompare(const RGResponseType * G,const RGResponseType * R,
+	const double Floor,double * MagErr,double * PhaseErr)
+	{
+		double Peak;
+		double E;
+		int I;
+
+		*MagErr = 0;
+		*PhaseErr = 0;
+		if (G->NP != R->NP || G->NP == 0)
+			return False;
+
+		Peak = G->Mag[0];
+		for (I = 1;I < G->NP;I++)
+			if (G->Mag[I] > Peak)
+				Peak = G->Mag[I];
+
+		for (I = 0;I < G->NP;I++)
+			{
+				if (fabs(G->F[I] - R->F[I]) > 1.0e-3 * G->F[I])
+					return False;
+				if (G->Mag[I] < Peak - Floor)
+					continue;
+				E = fabs(G->Mag[I] - R->Mag[I]);
+				if (E > *MagErr)
+					*MagErr = E;
+				E = fabs(fmod(G->Phase[I] - R->Phase[I] + 540.0,360.0) - 180.0);
+				if (E > *PhaseErr)
+					*PhaseErr = E;
+			}
+		return True;
+	}
+
+/* Confronta la risposta R del filtro ricavato, alla frequenza RRate, con
+la risposta G alla frequenza GRate, a meno di un guadagno costante e di un
+ritardo puro, ignorando i punti sotto il livello minimo. Il guadagno  la
+differenza media dei moduli in dB, il ritardo viene stimato dalla distanza
+tra i picchi dei due filtri, corretta con la pendenza della differenza di
+fase residua. Ritorna gli errori massimi, oppure gli errori quadratici
+medi se Rms, e False se i punti non corrispondono. */
+static Boolean RGDeriveCompare(const RGResponseType * G,const int GRate,
+	const RGResponseType * R,const int RRate,const double Floor,const Boolean Rms,
+	double * MagErr,double * PhaseErr)
+	{
+		double Diff[RGMaxPoints];
+		double Peak;
+		double SDF;
+		double SFF;
+		double SM;
+		double D;
+		double EM;
+		double EP;
+		int NM;
+		int I;
+
+		*MagErr = 0;
+		*PhaseErr = 0;
+		if (G->NP != R->NP || G->NP == 0)
+			return False;
+
+		Peak = G->Mag[0];
+		for (I = 1;I < G->NP;I++)
+			if (G->Mag[I] > Peak)
+				Peak = G->Mag[I];
+
+		/* Differenza di fase al netto della distanza tra i picchi */
+		SDF = 0;
+		SFF = 0;
+		SM = 0;
+		NM = 0;
+		for (I = 0;I < G->NP;I++)
+			{
+				if (fabs(G->F[I] - R->F[I]) > 1.0e-3 * G->F[I])
+					return False;
+				Diff[I] = G->Phase[I] - R->Phase[I] + 360.0 * G->F[I] *
+					(((double) G->Peak) / GRate - ((double) R->Peak) / RRate);
+				Diff[I] = fmod(fmod(Diff[I] + 180.0,360.0) + 360.0,360.0) - 180.0;
+				if (G->Mag[I] < Peak - Floor)
+					continue;
+				SDF += Diff[I] * G->F[I];
+				SFF += G->F[I] * G->F[I];
+				SM += G->Mag[I] - R->Mag[I];
+				NM++;
+			}
+		if (NM == 0)
+			return False;
+
+		/* Ritardo residuo ai minimi quadrati e guadagno medio */
+		D = (SFF > 0) ? SDF / SFF : 0;
+		SM /= NM;
+
+		for (I = 0;I < G->NP;I++)
+			{
+				if (G->Mag[I] < Peak - Floor)
+					continue;
+				EM = fabs(G->Mag[I] - R->Mag[I] - SM);
+				EP = fabs(Diff[I] - D * G->F[I]);
+				if (Rms == True)
+					{
+						*MagErr += EM * EM;
+						*PhaseErr += EP * EP;
+					}
+				else
+					{
+						if (EM > *MagErr)
+							*MagErr = EM;
+						if (EP > *PhaseErr)
+							*PhaseErr = EP;
+					}
+			}
+		if (Rms == True)
+			{
+				*MagErr = sqrt(*MagErr / NM);
+				*PhaseErr = sqrt(*PhaseErr / NM);
+			}
+		return True;
+	}
+
+/* Legge il file dei tempi di riferimento, ritorna False se assente */
+static Boolean RGReadBaseline(const char * FName)
+	{
+		FILE * IF;
+		char Line[RGLineLen];
+		char Preset[32];
+		char Rate[32];
+		char Stage[64];
+		double Wall;
+
+		RGNBaseline = 0;
+		if ((IF = fopen(FName,"rt")) == NULL)
+			return False;
+		while (fgets(Line,RGLineLen,IF) != NULL && RGNBaseline < RGMaxBaseline)
+			if (sscanf(Line,"%31[^,],%31[^,],\"%63[^\"]\",%lf",Preset,Rate,Stage,&Wall) == 4)
+				{
+					snprintf(RGBaseline[RGNBaseline].Key,sizeof(RGBaseline[RGNBaseline].Key),
+						"%s/%s/%s",Preset,Rate,Stage);
+					RGBaseline[RGNBaseline].Wall = Wall;
+					RGNBaseline++;
+				}
+		fclose(IF);
+		return True;
+	}
+
+/* Cerca il tempo di riferimento, ritorna un valore negativo se assente */
+static double RGBaselineWall(const char * Preset,const char * Rate,const char * Stage)
+	{
+		char Key[128];
+		int I;
+
+		snprintf(Key,sizeof(Key),"%s/%s/%s",Preset,Rate,Stage);
+		for (I = 0;I < RGNBaseline;I++)
+			if (strcmp(RGBaseline[I].Key,Key) == 0)
+				return RGBaseline[I].Wall;
+		return -1;
+	}
+
+/* Scrive le righe del rapporto, o dei tempi di riferimento, per una esecuzione */
+static void RGWriteTimes(FILE * OF,const char * Preset,const char * Rate,
+	const RGRunType * Run,const Boolean WithBaseline)
+	{
+		double BW;
+		int I;
+
+		if (WithBaseline == True)
+			{
+				BW = RGBaselineWall(Preset,Rate,"Total");
+				fprintf(OF,"%s,%s,\"Total\",%.6f,%.6f,%.1f\n",Preset,Rate,Run->Wall,BW,
+					Run->PeakRSS);
+				for (I = 0;I < Run->NStages;I++)
+					fprintf(OF,"%s,%s,\"%s\",%.6f,%.6f,\n",Preset,Rate,Run->Stages[I].Name,
+						Run->Stages[I].Wall,RGBaselineWall(Preset,Rate,Run->Stages[I].Name));
+			}
+		else
+			{
+				fprintf(OF,"%s,%s,\"Total\",%.6f\n",Preset,Rate,Run->Wall);
+				for (I = 0;I < Run->NStages;I++)
+					fprintf(OF,"%s,%s,\"%s\",%.6f\n",Preset,Rate,Run->Stages[I].Name,
+						Run->Stages[I].Wall);
+			}
+	}
+
+/* Verifica se il nome soddisfa tutti i filtri */
+static Boolean RGMatch(const char * Name,char * Filters[],const int NFilters)
+	{
+		int I;
+
+		for (I = 0;I < NFilters;I++)
+			if (strstr(Name,Filters[I]) == NULL)
+				return False;
+		return True;
+	}
+
+/* Genera la risposta all'impulso DstFile alla frequenza DstRate
+ricampionando quella sintetica alla frequenza SrcRate, salvata in SrcFile,
+mantenendo l'impulso a 0.5 s e la risposta in frequenza */
+static Boolean RGResampleIR(const char * SrcFile,const int SrcRate,const char * DstFile,
+	const int DstRate)
+	{
+		FILE * F;
+		DLReal * In;
+		DLReal * Out;
+		float * Buf;
+		int InLen;
+		int OutLen;
+		int I;
+
+		InLen = 3 * SrcRate;
+		OutLen = 3 * DstRate;
+		In = new DLReal[InLen];
+		Out = new DLReal[OutLen];
+		Buf = new float[(InLen > OutLen) ? InLen : OutLen];
+		if (In == NULL || Out == NULL || Buf == NULL)
+			return False;
+
+		if ((F = fopen(SrcFile,"rb")) == NULL || fread(Buf,sizeof(float),InLen,F) != (size_t) InLen)
+			{
+				if (F != NULL)
+					fclose(F);
+				delete[] In;
+				delete[] Out;
+				delete[] Buf;
+				return False;
+			}
+		fclose(F);
+		for (I = 0;I < InLen;I++)
+			In[I] = (DLReal) Buf[I];
+
+		if (PolyResample(In,InLen,SrcRate,SrcRate / 2,Out,OutLen,DstRate,DstRate / 2) == False)
+			{
+				delete[] In;
+				delete[] Out;
+				delete[] Buf;
+				return False;
+			}
+		for (I = 0;I < OutLen;I++)
+			Buf[I] = (float) (Out[I] * SrcRate / DstRate);
+		delete[] In;
+		delete[] Out;
+
+		if ((F = fopen(DstFile,"wb")) == NULL)
+			{
+				delete[] Buf;
+				return False;
+			}
+		if (fwrite(Buf,sizeof(float),OutLen,F) != (size_t) OutLen)
+			{
+				fclose(F);
+				delete[] Buf;
+				return False;
+			}
+		delete[] Buf;
+		if (fclose(F) != 0)
+			return False;
+		return True;
+	}
+
+/* Esegue DRC sul preset Preset alla frequenza di campionamento Rate con
+la risposta all'impulso IRFile aggiungendo le opzioni Opts, ritorna il
+tempo di esecuzione o un valore negativo in caso di errore */
+static double RGRunDrc(const char * Drc,const char * CfgDir,const char * TargetDir,
+	const char * IRFile,const char * Preset,const RGRateType * Rate,const char * PSFile,
+	const char * Opts,const char * LogFile)
+	{
+		char CfgFile[RGPathLen];
+		char TargetFile[RGPathLen];
+		char Cmd[RGCmdLen];
+		double Start;
+
+		snprintf(CfgFile,RGPathLen,"%s/%s kHz/%s-%s.drc",CfgDir,Rate->Name,Preset,
+			Rate->Name);
+		snprintf(TargetFile,RGPathLen,"%s/%s kHz/flat-%s.txt",TargetDir,Rate->Name,
+			Rate->Name);
+		if (snprintf(Cmd,sizeof(Cmd),"\"%s\" --BCInFile=\"%s\" --MCFilterType=M "
+			"--MCPointsFile=\"%s\" --PSPointsFile=\"%s\" --PSOutFile=\"%s\" %s "
+			"\"%s\" > \"%s\"",Drc,IRFile,TargetFile,TargetFile,PSFile,Opts,CfgFile,
+			LogFile) >= (int) sizeof(Cmd))
+			{
+				fprintf(stderr,"Command line too long for %s.\n",CfgFile);
+				return -1;
+			}
+		Start = PMTime();
+		if (system(Cmd) != 0)
+			return -1;
+		return PMTime() - Start;
+	}
+
+/* Conta le righe del file FName che contengono il testo Text */
+static int RGCountText(const char * FName,const char * Text)
+	{
+		FILE * F;
+		char Line[RGLineLen];
+		int N;
+
+		if ((F = fopen(FName,"rt")) == NULL)
+			return 0;
+		N = 0;
+		while (fgets(Line,sizeof(Line),F) != NULL)
+			if (strstr(Line,Text) != NULL)
+				N++;
+		fclose(F);
+		return N;
+	}
+
+/* Verifica se i due file hanno lo stesso contenuto */
+static Boolean RGSameFile(const char * A,const char * B)
+	{
+		FILE * FA;
+		FILE * FB;
+		int CA;
+		int CB;
+
+		if ((FA = fopen(A,"rb")) == NULL)
+			return False;
+		if ((FB = fopen(B,"rb")) == NULL)
+			{
+				fclose(FA);
+				return False;
+			}
+		do
+			{
+				CA = fgetc(FA);
+				CB = fgetc(FB);
+			}
+		while (CA == CB && CA != EOF);
+		fclose(FA);
+		fclose(FB);
+		return (CA == CB) ? True : False;
+	}
+
+/* Legge il segnale float FName, ritorna NULL in caso di errore */
+static float * RGReadSignal(const char * FName,long * Len)
+	{
+		FILE * F;
+		float * Sig;
+
+		if ((F = fopen(FName,"rb")) == NULL)
+			return NULL;
+		fseek(F,0,SEEK_END);
+		*Len = ftell(F) / (long) sizeof(float);
+		fseek(F,0,SEEK_SET);
+		if (*Len <= 0 || (Sig = new float[*Len]) == NULL)
+			{
+				fclose(F);
+				return NULL;
+			}
+		if (fread(Sig,sizeof(float),*Len,F) != (size_t) *Len)
+			{
+				fclose(F);
+				delete[] Sig;
+				return NULL;
+			}
+		fclose(F);
+		return Sig;
+	}
+
+/* Errore massimo del segnale A rispetto al segnale B, relativo al picco
+di B, ritorna False se i segnali mancano o hanno lunghezza diversa */
+static Boolean RGSignalError(const char * A,const char * B,double * Err)
+	{
+		float * SA;
+		float * SB;
+		long LA;
+		long LB;
+		long I;
+		double Peak;
+		double E;
+
+		SA = RGReadSignal(A,&LA);
+		SB = RGReadSignal(B,&LB);
+		if (SA == NULL || SB == NULL || LA != LB)
+			{
+				delete[] SA;
+				delete[] SB;
+				return False;
+			}
+		Peak = 0;
+		E = 0;
+		for (I = 0;I < LA;I++)
+			{
+				if (fabs(SB[I]) > Peak)
+					Peak = fabs(SB[I]);
+				if (fabs(SA[I] - SB[I]) > E)
+					E = fabs(SA[I] - SB[I]);
+			}
+		delete[] SA;
+		delete[] SB;
+		*Err = (Peak > 0) ? E / Peak : E;
+		return True;
+	}
+
+/* Verifica del passaggio diretto dello spettro della convoluzione al
+peak limiting ed all'estrazione del filtro a fase minima: i filtri PS e
+MS devono coincidere con quelli calcolati senza passaggio diretto,
+ritorna il numero di errori */
+static int RGHandoff(const char * Drc,const char * CfgDir,const char * TargetDir,
+	const char * WorkDir,char * Filters[],const int NFilters,FILE * RF)
+	{
+		const RGRateType * Rate;
+		char Name[64];
+		char IRFile[RGPathLen];
+		char PSFile[2][RGPathLen];
+		char MSFile[2][RGPathLen];
+		char LogFile[2][RGPathLen];
+		char Opts[RGPathLen];
+		const char * Status;
+		double PSErr;
+		double MSErr;
+		int Res;
+		int H;
+
+		Rate = &RGRates[0];
+		snprintf(Name,sizeof(Name),"handoff/%s/%s",RGHandoffPreset,Rate->Name);
+		if (RGMatch(Name,Filters,NFilters) == False)
+			return 0;
+
+		snprintf(IRFile,RGPathLen,"%s/ir-%s.pcm",WorkDir,Rate->Name);
+		if (RGMakeIR(IRFile,Rate->SampleRate) == False)
+			{
+				perror(IRFile);
+				return 1;
+			}
+
+		/* Esecuzione con e senza passaggio diretto dello spettro */
+		Status = "OK";
+		Res = 0;
+		for (H = 0;H < 2;H++)
+			{
+				snprintf(PSFile[H],RGPathLen,"%s/ps-handoff-%c.pcm",WorkDir,(H == 0) ? 'Y' : 'N');
+				snprintf(MSFile[H],RGPathLen,"%s/ms-handoff-%c.pcm",WorkDir,(H == 0) ? 'Y' : 'N');
+				snprintf(LogFile[H],RGPathLen,"%s/log-handoff-%c.txt",WorkDir,(H == 0) ? 'Y' : 'N');
+				snprintf(Opts,RGPathLen,RGHandoffOpts " --BCSpectrumHandoff=%c --MSOutFile=\"%s\"",
+					(H == 0) ? 'Y' : 'N',MSFile[H]);
+				remove(PSFile[H]);
+				remove(MSFile[H]);
+				if (RGRunDrc(Drc,CfgDir,TargetDir,IRFile,RGHandoffPreset,Rate,PSFile[H],Opts,
+					LogFile[H]) < 0)
+					{
+						Status = "DRC EXECUTION FAILED";
+						Res = 1;
+					}
+			}
+
+		/* Verifica che il passaggio diretto sia stato effettivamente usato */
+		PSErr = -1;
+		MSErr = -1;
+		if (Res == 0 &&
+			(RGCountText(LogFile[0],"Convolution spectrum handed to peak limiting.") == 0 ||
+			RGCountText(LogFile[0],"Convolution spectrum handed to MP filter extraction.") == 0))
+			{
+				Status = "NO HANDOFF";
+				Res = 1;
+			}
+		if (Res == 0)
+			{
+				if (RGSignalError(PSFile[0],PSFile[1],&PSErr) == False ||
+					RGSignalError(MSFile[0],MSFile[1],&MSErr) == False)
+					{
+						Status = "NO OUTPUT";
+						Res = 1;
+					}
+				else if (PSErr > RGHandoffTol || MSErr > RGHandoffTol)
+					{
+						Status = "MISMATCH";
+						Res = 1;
+					}
+			}
+
+		printf("%-32s PS error %9.3e, MS error %9.3e  %s\n\n",Name,PSErr,MSErr,Status);
+		fprintf(RF,"%-32s PS error %9.3e, MS error %9.3e  %s\n\n",Name,PSErr,MSErr,Status);
+		fflush(stdout);
+		return Res;
+	}
+
+/* Verifica della condivisione delle fasi comuni in modalit sweep con i
+segnali intermedi salvati su file: le elaborazioni successive alla prima
+devono recuperare il segnale invertito dalla cache e salvare gli stessi
+segnali intermedi della prima, ritorna il numero di errori */
+static int RGSweep(const char * Drc,const char * CfgDir,const char * TargetDir,
+	const char * WorkDir,char * Filters[],const int NFilters,FILE * RF)
+	{
+		const RGRateType * Rate;
+		char Name[64];
+		char SweepDir[RGPathLen];
+		char IRFile[RGPathLen];
+		char CfgFile[RGPathLen];
+		char TargetFile[RGPathLen];
+		char LogFile[RGPathLen];
+		char DumpFile[RGPathLen];
+		char RefFile[RGPathLen];
+		char Opts[RGPathLen];
+		char Cmd[RGCmdLen];
+		char * AbsDrc;
+		char * AbsIR;
+		char * AbsCfg;
+		char * AbsTarget;
+		const char * Status;
+		double Start;
+		double Wall;
+		int Hits;
+		int Res;
+		int D;
+		int I;
+
+		Rate = &RGRates[0];
+		snprintf(Name,sizeof(Name),"sweep/%s/%s",RGSweepPreset,Rate->Name);
+		if (RGMatch(Name,Filters,NFilters) == False)
+			return 0;
+
+		/* Le elaborazioni vengono eseguite nella directory della verifica,
+		dove vengono creati i file di log delle singole elaborazioni */
+		snprintf(SweepDir,RGPathLen,"%s/sweep",WorkDir);
+		RGMkDir(SweepDir);
+		snprintf(IRFile,RGPathLen,"%s/ir-%s.pcm",WorkDir,Rate->Name);
+		if (RGMakeIR(IRFile,Rate->SampleRate) == False)
+			{
+				perror(IRFile);
+				return 1;
+			}
+		snprintf(CfgFile,RGPathLen,"%s/%s kHz/%s-%s.drc",CfgDir,Rate->Name,RGSweepPreset,
+			Rate->Name);
+		snprintf(TargetFile,RGPathLen,"%s/%s kHz/flat-%s.txt",TargetDir,Rate->Name,
+			Rate->Name);
+		AbsDrc = RGAbsPath(Drc);
+		AbsIR = RGAbsPath(IRFile);
+		AbsCfg = RGAbsPath(CfgFile);
+		AbsTarget = RGAbsPath(TargetFile);
+
+		/* Segnali intermedi e valori dei parametri */
+		Opts[0] = '\0';
+		for (D = 0;RGSweepDumps[D] != NULL;D++)
+			snprintf(&Opts[strlen(Opts)],RGPathLen - strlen(Opts),"--%s=dump%d.pcm ",
+				RGSweepDumps[D],D);
+		snprintf(&Opts[strlen(Opts)],RGPathLen - strlen(Opts),"--PSNormFactor=");
+		for (I = 0;I < RGSweepRuns;I++)
+			snprintf(&Opts[strlen(Opts)],RGPathLen - strlen(Opts),"%s%s",(I > 0) ? "," : "",
+				RGSweepValues[I]);
+
+		/* Rimuove i risultati di una verifica precedente */
+		snprintf(LogFile,RGPathLen,"%s/sweep.txt",SweepDir);
+		remove(LogFile);
+		for (I = 0;I < RGSweepRuns;I++)
+			{
+				snprintf(LogFile,RGPathLen,"%s/PSNormFactor%s.log",SweepDir,RGSweepValues[I]);
+				remove(LogFile);
+				for (D = 0;RGSweepDumps[D] != NULL;D++)
+					{
+						snprintf(DumpFile,RGPathLen,"%s/dump%d-PSNormFactor%s.pcm",SweepDir,D,
+							RGSweepValues[I]);
+						remove(DumpFile);
+					}
+			}
+
+		Status = "OK";
+		Hits = 0;
+		Wall = 0;
+		Res = 0;
+		if (AbsDrc == NULL || AbsIR == NULL || AbsCfg == NULL || AbsTarget == NULL ||
+			snprintf(Cmd,sizeof(Cmd),RGChDir " \"%s\" && \"%s\" --BCInFile=\"%s\" "
+				"--MCFilterType=M --MCPointsFile=\"%s\" --PSPointsFile=\"%s\" "
+				"--PSOutFile=ps.pcm %s \"%s\" > sweep.txt",SweepDir,AbsDrc,AbsIR,AbsTarget,
+				AbsTarget,Opts,AbsCfg) >= (int) sizeof(Cmd))
+			{
+				Status = "NO COMMAND LINE";
+				Res = 1;
+			}
+		else
+			{
+				Start = PMTime();
+				if (system(Cmd) != 0)
+					{
+						Status = "DRC EXECUTION FAILED";
+						Res = 1;
+					}
+				Wall = PMTime() - Start;
+			}
+
+		/* Conta i recuperi dalla cache, riportati nei file di log delle
+		elaborazioni o direttamente nell'output se eseguite in sequenza */
+		if (Res == 0)
+			{
+				snprintf(LogFile,RGPathLen,"%s/sweep.txt",SweepDir);
+				Hits = RGCountText(LogFile,"Inverted signal recovered from cache.");
+				for (I = 0;I < RGSweepRuns;I++)
+					{
+						snprintf(LogFile,RGPathLen,"%s/PSNormFactor%s.log",SweepDir,
+							RGSweepValues[I]);
+						Hits += RGCountText(LogFile,"Inverted signal recovered from cache.");
+					}
+				if (Hits < RGSweepRuns - 1)
+					{
+						Status = "NO CACHE HIT";
+						Res = 1;
+					}
+			}
+
+		/* Confronta i segnali intermedi con quelli della prima elaborazione */
+		for (I = 1;I < RGSweepRuns && Res == 0;I++)
+			for (D = 0;RGSweepDumps[D] != NULL && Res == 0;D++)
+				{
+					snprintf(RefFile,RGPathLen,"%s/dump%d-PSNormFactor%s.pcm",SweepDir,D,
+						RGSweepValues[0]);
+					snprintf(DumpFile,RGPathLen,"%s/dump%d-PSNormFactor%s.pcm",SweepDir,D,
+						RGSweepValues[I]);
+					if (RGSameFile(RefFile,DumpFile) == False)
+						{
+							Status = "DUMP MISMATCH";
+							Res = 1;
+						}
+				}
+
+		free(AbsDrc);
+		free(AbsIR);
+		free(AbsCfg);
+		free(AbsTarget);
+
+		printf("%-32s %d runs, %d cache hits, %.3f s  %s\n\n",Name,RGSweepRuns,Hits,
+			Wall,Status);
+		fprintf(RF,"%-32s %d runs, %d cache hits, %.3f s  %s\n\n",Name,RGSweepRuns,Hits,
+			Wall,Status);
+		fflush(stdout);
+		return Res;
+	}
+
+/* Verifica dei filtri ricavati da quelli a 96 kHz, ritorna il numero di
+errori */
+static int RGDerive(const char * Drc,const char * CfgDir,const char * TargetDir,
+	const char * WorkDir,char * Filters[],const int NFilters,const double MagTol,
+	const double PhaseTol,const double Floor,FILE * RF)
+	{
+		const RGRateType * Src;
+		char Name[64];
+		char Opts[RGPathLen];
+		char SrcIRFile[RGPathLen];
+		char IRFile[RGPathLen];
+		char DPSFile[RGPathLen];
+		char DLogFile[RGPathLen];
+		char PSFile[RGPathLen];
+		char DerFile[RGPathLen];
+		char LogFile[RGPathLen];
+		RGResponseType Source;
+		RGResponseType Native;
+		RGResponseType Derived;
+		double DWall;
+		double Wall;
+		double SMagErr;
+		double SPhaseErr;
+		double MagErr;
+		double PhaseErr;
+		const char * Status;
+		int R;
+		int P;
+		int Runs;
+		int Fails;
+
+		/* Frequenza di riferimento, l'ultima dell'elenco */
+		for (R = 0;RGRates[R + 1].SampleRate > 0;R++);
+		Src = &RGRates[R];
+		snprintf(SrcIRFile,RGPathLen,"%s/ir-%s.pcm",WorkDir,Src->Name);
+
+		/* Elenco delle frequenze da ricavare */
+		Opts[0] = '\0';
+		for (R = 0;RGRates[R].SampleRate > 0;R++)
+			if (&RGRates[R] != Src)
+				snprintf(&Opts[strlen(Opts)],RGPathLen - strlen(Opts),"%s%d",
+					(Opts[0] == '\0') ? "--BCDeriveRates=" : ",",RGRates[R].SampleRate);
+
+		fprintf(RF,"%-16s %10s %10s %10s %10s %10s %10s  %s\n","Run","Native (s)",
+			"Source (s)","Src (dB)","Src phase","Nat (dB)","Nat phase","Status");
+		printf("%-16s %10s %10s %10s %10s %10s %10s  %s\n","Run","Native (s)",
+			"Source (s)","Src (dB)","Src phase","Nat (dB)","Nat phase","Status");
+
+		Runs = 0;
+		Fails = 0;
+		for (P = 0;RGPresets[P] != NULL;P++)
+			{
+				snprintf(Name,sizeof(Name),"%s/%s",RGPresets[P],Src->Name);
+				if (RGMatch(Name,Filters,NFilters) == False)
+					continue;
+
+				/* Filtro alla frequenza di riferimento e filtri ricavati */
+				snprintf(DPSFile,RGPathLen,"%s/ps-%s-%s-derive.pcm",WorkDir,RGPresets[P],
+					Src->Name);
+				snprintf(DLogFile,RGPathLen,"%s/log-%s-%s-derive.txt",WorkDir,RGPresets[P],
+					Src->Name);
+				if (RGMakeIR(SrcIRFile,Src->SampleRate) == False)
+					{
+						perror(SrcIRFile);
+						return Fails + 1;
+					}
+				if ((DWall = RGRunDrc(Drc,CfgDir,TargetDir,SrcIRFile,RGPresets[P],Src,
+					DPSFile,Opts,DLogFile)) < 0)
+					{
+						printf("%-16s DRC execution failed, see %s\n",Name,DLogFile);
+						fprintf(RF,"%-16s DRC execution failed, see %s\n",Name,DLogFile);
+						Fails++;
+						continue;
+					}
+
+				for (R = 0;RGRates[R].SampleRate > 0;R++)
+					{
+						if (&RGRates[R] == Src)
+							continue;
+						snprintf(Name,sizeof(Name),"%s/%s>%s",RGPresets[P],Src->Name,
+							RGRates[R].Name);
+
+						/* Filtro calcolato direttamente sulla misura ricampionata */
+						snprintf(IRFile,RGPathLen,"%s/ir-%s-derive.pcm",WorkDir,
+							RGRates[R].Name);
+						if (RGResampleIR(SrcIRFile,Src->SampleRate,IRFile,
+							RGRates[R].SampleRate) == False)
+							{
+								perror(IRFile);
+								return Fails + 1;
+							}
+						snprintf(PSFile,RGPathLen,"%s/ps-%s-%s-native.pcm",WorkDir,RGPresets[P],
+							RGRates[R].Name);
+						snprintf(LogFile,RGPathLen,"%s/log-%s-%s-native.txt",WorkDir,RGPresets[P],
+							RGRates[R].Name);
+						if ((Wall = RGRunDrc(Drc,CfgDir,TargetDir,IRFile,RGPresets[P],
+							&RGRates[R],PSFile,"",LogFile)) < 0)
+							{
+								printf("%-16s DRC execution failed, see %s\n",Name,LogFile);
+								fprintf(RF,"%-16s DRC execution failed, see %s\n",Name,LogFile);
+								Fails++;
+								continue;
+							}
+						Runs++;
+
+						/* Confronto del filtro ricavato con quello di partenza e con
+						quello calcolato direttamente */
+						snprintf(DerFile,RGPathLen,"%s/ps-%s-%s-derive-%d.pcm",WorkDir,
+							RGPresets[P],Src->Name,RGRates[R].SampleRate);
+						Status = "OK";
+						if (RGResponse(DPSFile,Src->SampleRate,&Source) == False ||
+							RGResponse(PSFile,RGRates[R].SampleRate,&Native) == False ||
+							RGResponse(DerFile,RGRates[R].SampleRate,&Derived) == False ||
+							RGDeriveCompare(&Source,Src->SampleRate,&Derived,RGRates[R].SampleRate,
+								Floor,False,&SMagErr,&SPhaseErr) == False ||
+							RGDeriveCompare(&Native,RGRates[R].SampleRate,&Derived,
+								RGRates[R].SampleRate,Floor,True,&MagErr,&PhaseErr) == False)
+							{
+								SMagErr = -1;
+								SPhaseErr = -1;
+								MagErr = -1;
+								PhaseErr = -1;
+								Status = "NO OUTPUT";
+								Fails++;
+							}
+						else if (SMagErr > RGDeriveSrcMagTol || SPhaseErr > RGDeriveSrcPhaseTol)
+							{
+								Status = "DERIVE ERROR";
+								Fails++;
+							}
+						else if (MagErr > MagTol || PhaseErr > PhaseTol)
+							{
+								Status = "MISMATCH";
+								Fails++;
+							}
+
+						fprintf(RF,"%-16s %10.3f %10.3f %10.4f %10.4f %10.4f %10.4f  %s\n",Name,
+							Wall,DWall,SMagErr,SPhaseErr,MagErr,PhaseErr,Status);
+						printf("%-16s %10.3f %10.3f %10.4f %10.4f %10.4f %10.4f  %s\n",Name,
+							Wall,DWall,SMagErr,SPhaseErr,MagErr,PhaseErr,Status);
+						fflush(stdout);
+					}
+			}
+
+		fprintf(RF,"\n%d runs, %d failures.\n",Runs,Fails);
+		printf("\n%d runs, %d failures.\n",Runs,Fails);
+		return Fails;
+	}
+
+/* Inversione con limitazione delle valli originale di lsconv, tramite
+modulo e fase, usata come riferimento per DKInvertHC */
+template <class T>
+static void RGDKRefInvert(T * X,const int N,const T MinLevel,const T DLStart)
+	{
+		T DLSLevel;
+		T DLLevel;
+		T DLGFactor;
+		T DLAbs;
+		T DLTheta;
+		int I;
+		int J;
+
+		/* Limitazione dei campioni continua e di Nyquist */
+		DLSLevel = (DLStart < (T) 1.0) ? MinLevel / DLStart : MinLevel;
+		DLGFactor = DLSLevel - MinLevel;
+		for (I = 0;I < 2;I++)
+			if (X[I] < DLSLevel)
+				{
+					if (DLStart < (T) 1.0)
+						{
+							DLLevel = (DLSLevel - X[I]) / DLGFactor;
+							DLLevel = DLLevel / (((T) 1.0) + DLLevel);
+							X[I] = ((T) 1.0) / (DLSLevel - DLGFactor * DLLevel);
+						}
+					else
+						X[I] = ((T) 1.0) / MinLevel;
+				}
+			else
+				X[I] = ((T) 1.0) / X[I];
+
+		for (I = 2,J = 3;I < N;I += 2,J += 2)
+			{
+				DLAbs = (T) hypot(X[I],X[J]);
+				if (DLStart >= (T) 1.0 || DLAbs <= (T) 0.0)
+					{
+						/* Troncatura guadagno */
+						if (DLAbs < MinLevel)
+							{
+								DLTheta = (T) atan2(X[J],X[I]);
+								DLAbs = ((T) 1.0) / MinLevel;
+								X[I] = DLAbs * (T) cos(-DLTheta);
+								X[J] = DLAbs * (T) sin(-DLTheta);
+								continue;
+							}
+					}
+				else if (DLAbs < DLSLevel)
+					{
+						/* Ginocchio morbido */
+						DLLevel = (DLSLevel - DLAbs) / DLGFactor;
+						DLLevel = DLLevel / (((T) 1.0) + DLLevel);
+						DLAbs = ((T) 1.0) / (DLSLevel - DLGFactor * DLLevel);
+						DLTheta = (T) atan2(X[J],X[I]);
+						X[I] = DLAbs * (T) cos(-DLTheta);
+						X[J] = DLAbs * (T) sin(-DLTheta);
+						continue;
+					}
+
+				/* Inversione e rinormalizzazione */
+				DLAbs = ((T) 1.0) / (DLAbs * DLAbs);
+				X[I] *= DLAbs;
+				X[J] *= -DLAbs;
+			}
+	}
+
+/* Limitazione delle valli originale di C1LPDipLimit, tramite modulo e
+fase, usata come riferimento per DKLimitPairs */
+template <class T>
+static void RGDKRefLimit(std::complex<T> * X,const int NP,const T MinLevel,const T DLStart)
+	{
+		T DLSLevel;
+		T DLLevel;
+		T DLGFactor;
+		T DLAbs;
+		int I;
+
+		if (DLStart >= (T) 1.0)
+			{
+				for (I = 0;I < NP;I++)
+					{
+						DLAbs = std::abs(X[I]);
+						if (DLAbs < MinLevel)
+							X[I] = std::polar<T>(MinLevel,std::arg<T>(X[I]));
+					}
+			}
+		else
+			{
+				DLSLevel = MinLevel / DLStart;
+				DLGFactor = DLSLevel - MinLevel;
+				for (I = 0;I < NP;I++)
+					{
+						DLAbs = std::abs(X[I]);
+						if (DLAbs < DLSLevel)
+							{
+								DLLevel = (DLSLevel - DLAbs) / DLGFactor;
+								DLLevel = DLLevel / (((T) 1.0) + DLLevel);
+								X[I] = std::polar<T>(DLSLevel - DLGFactor * DLLevel,
+									std::arg<T>(X[I]));
+							}
+					}
+			}
+	}
+
+/* Spettro casuale di NP coppie con moduli tra -80 dB e +14 dB, un bin
+nullo ogni 37 e componenti continua e di Nyquist Dc e Ny. I bin nulli
+sono zeri positivi: i nuclei assegnano loro fase nulla, mentre atan2
+restituirebbe pi greco per uno zero negativo */
+template <class T>
+static void RGDKSpectrum(T * X,const int NP,const T Dc,const T Ny,unsigned int * Seed)
+	{
+		double Mag;
+		double Phase;
+		int I;
+
+		for (I = 0;I < NP;I++)
+			{
+				*Seed = *Seed * 1664525 + 1013904223;
+				Mag = pow(10.0,-4.0 + 4.7 * ((double) (*Seed >> 8)) / (1 << 24));
+				*Seed = *Seed * 1664525 + 1013904223;
+				Phase = 2 * RGPi * ((double) (*Seed >> 8)) / (1 << 24);
+				if ((I % 37) == 36)
+					{
+						X[2 * I] = 0;
+						X[2 * I + 1] = 0;
+					}
+				else
+					{
+						X[2 * I] = (T) (Mag * cos(Phase));
+						X[2 * I + 1] = (T) (Mag * sin(Phase));
+					}
+			}
+		X[0] = Dc;
+		X[1] = Ny;
+	}
+
+/* Errore relativo massimo tra le coppie di X e quelle del riferimento R,
+le prime due componenti sono confrontate separatamente se Real e' True */
+template <class T>
+static double RGDKError(const T * X,const T * R,const int NP,const Boolean Real)
+	{
+		double E;
+		double M;
+		double Err;
+		int I;
+
+		Err = 0;
+		for (I = 0;I < NP;I++)
+			{
+				if (I == 0 && Real == True)
+					{
+						E = fabs((double) X[0] - R[0]) / fabs((double) R[0]);
+						M = fabs((double) X[1] - R[1]) / fabs((double) R[1]);
+						E = (M > E) ? M : E;
+					}
+				else
+					E = hypot((double) X[2 * I] - R[2 * I],(double) X[2 * I + 1] - R[2 * I + 1]) /
+						hypot((double) R[2 * I],(double) R[2 * I + 1]);
+				if (!(E <= Err))
+					Err = E;
+			}
+		return Err;
+	}
+
+/* Confronta DKInvertHC e DKLimitPairs con le versioni originali su
+spettri casuali, ritorna l'errore relativo massimo */
+template <class T>
+static double RGDKCheck(const T DLStart,const T Dc,const T Ny,const Boolean Invert)
+	{
+		static T X[2 * RGDKPairs];
+		static T R[2 * RGDKPairs];
+		unsigned int Seed;
+		int I;
+
+		Seed = 12345;
+		RGDKSpectrum(X,RGDKPairs,Dc,Ny,&Seed);
+		for (I = 0;I < 2 * RGDKPairs;I++)
+			R[I] = X[I];
+
+		if (Invert == True)
+			{
+				DKInvertHC(X,2 * RGDKPairs,(T) 0.01,DLStart);
+				RGDKRefInvert(R,2 * RGDKPairs,(T) 0.01,DLStart);
+			}
+		else
+			{
+				DKLimitPairs(X,RGDKPairs,(T) 0.01,DLStart);
+				RGDKRefLimit((std::complex<T> *) R,RGDKPairs,(T) 0.01,DLStart);
+			}
+		return RGDKError(X,R,RGDKPairs,Invert);
+	}
+
+/* Verifica dei nuclei di limitazione delle valli condivisi da DRC e
+lsconv, con ginocchio netto e morbido, precisione singola e doppia,
+componente continua negativa, nulla o positiva, ritorna il numero di
+verifiche fallite */
+static int RGDipKnee(FILE * RF)
+	{
+		static const char * Kernel[2] = { "limit", "invert" };
+		static const double Knee[2] = { 1.0, 0.5 };
+		static const double Dc[3] = { -0.5, 0.0, 2.0e-3 };
+		static const double Ny[3] = { 0.3, -1.0e-4, 0.0 };
+		char Name[64];
+		double E;
+		double Err;
+		double Tol;
+		const char * Status;
+		int Fails;
+		int K;
+		int S;
+		int D;
+		int P;
+
+		Fails = 0;
+		for (K = 0;K < 2;K++)
+			for (S = 0;S < 2;S++)
+				for (P = 0;P < 2;P++)
+					{
+						Err = 0;
+						for (D = 0;D < 3;D++)
+							{
+								if (P == 0)
+									E = RGDKCheck((float) Knee[S],(float) Dc[D],(float) Ny[D],(K == 1) ? True : False);
+								else
+									E = RGDKCheck(Knee[S],Dc[D],Ny[D],(K == 1) ? True : False);
+								if (!(E <= Err))
+									Err = E;
+							}
+						Tol = (P == 0) ? RGDKFloatTol : RGDKDoubleTol;
+						Status = "OK";
+						if (!(Err <= Tol))
+							{
+								Status = "MISMATCH";
+								Fails++;
+							}
+						snprintf(Name,sizeof(Name),"dipknee/%s/%s/%s",Kernel[K],
+							(S == 0) ? "hard" : "soft",(P == 0) ? "float" : "double");
+						printf("%-32s max relative error %9.3e  %s\n",Name,Err,Status);
+						fprintf(RF,"%-32s max relative error %9.3e  %s\n",Name,Err,Status);
+					}
+		printf("\n");
+		fprintf(RF,"\n");
+		return Fails;
+	}
+
+/* Numero di thread delle verifiche del pool */
+static const unsigned int RGTPThreads[] = { 1, 2, 4, 8, 0 };
+
+/* Stato dei task dei grafi, ogni task scrive solo i propri elementi */
+static volatile int RGTPDone[RGTPTasks];
+static volatile int RGTPBad[RGTPTasks];
+
+/* Lavoro della verifica della riduzione, somma i valori [Start,End) */
+static double RGTPSum(void * Arg,const unsigned int,const unsigned int Start,
+	const unsigned int End)
+	{
+		const double * X = (const double *) Arg;
+		double Sum;
+		unsigned int I;
+
+		Sum = 0.0;
+		for (I = Start;I < End;I++)
+			Sum += X[I];
+		return Sum;
+	}
+
+/* Task dei grafi, verifica che le dipendenze siano gi state eseguite
+e che il task non sia eseguito pi volte */
+static void RGTPTask(void * Arg,const unsigned int)
+	{
+		const RGTPNodeType * N = (const RGTPNodeType *) Arg;
+		volatile double Spin;
+		int I;
+
+		for (I = 0;I < N->NDeps;I++)
+			if (RGTPDone[N->Deps[I]] == 0)
+				RGTPBad[N->Id] = 1;
+		if (RGTPDone[N->Id] != 0)
+			RGTPBad[N->Id] = 1;
+		for (I = 0,Spin = 0;I < RGTPSpin;I++)
+			Spin = Spin + I;
+		RGTPDone[N->Id] = 1;
+	}
+
+/* Crea il grafo con i task Nodes, ritorna NULL in caso di errore */
+static TPGraphType * RGTPGraph(RGTPNodeType * Nodes)
+	{
+		TPGraphType * G;
+		int K;
+		int D;
+
+		if ((G = TPGraphCreate()) == NULL)
+			return NULL;
+		for (K = 0;K < RGTPTasks;K++)
+			if (TPGraphAdd(G,RGTPTask,&Nodes[K]) != K)
+				{
+					TPGraphFree(G);
+					return NULL;
+				}
+		for (K = 0;K < RGTPTasks;K++)
+			for (D = 0;D < Nodes[K].NDeps;D++)
+				if (TPGraphDepends(G,K,Nodes[K].Deps[D]) == False)
+					{
+						TPGraphFree(G);
+						return NULL;
+					}
+		return G;
+	}
+
+/* Esegue il grafo G, ritorna il valore di TPGraphRun, il numero di task
+eseguiti in Done ed il numero di task eseguiti prima delle dipendenze o
+pi volte in Bad */
+static Boolean RGTPGraphRun(TPGraphType * G,int * Done,int * Bad)
+	{
+		Boolean Res;
+		int K;
+
+		for (K = 0;K < RGTPTasks;K++)
+			{
+				RGTPDone[K] = 0;
+				RGTPBad[K] = 0;
+			}
+		Res = TPGraphRun(G);
+		for (K = 0;K < RGTPTasks;K++)
+			{
+				*Done += RGTPDone[K];
+				*Bad += RGTPBad[K];
+			}
+		return Res;
+	}
+
+/* Verifica del pool di thread: la riduzione in modalit deterministica
+deve dare lo stesso risultato con qualunque numero di thread, un grafo a
+diamante deve essere eseguito nell'ordine delle dipendenze ed un grafo
+con un ciclo deve essere rifiutato senza eseguire alcun task, ritorna il
+numero di verifiche fallite */
+static int RGThreadPool(FILE * RF)
+	{
+		/* Grafo a diamante 0 -> 1, 2 -> 3 e ciclo 0 -> 1 -> 2 -> 0 con il
+		task 3 indipendente */
+		RGTPNodeType Diamond[RGTPTasks] =
+			{ { 0, 0, { 0, 0 } }, { 1, 1, { 0, 0 } }, { 2, 1, { 0, 0 } }, { 3, 2, { 1, 2 } } };
+		RGTPNodeType Cycle[RGTPTasks] =
+			{ { 0, 1, { 2, 0 } }, { 1, 1, { 0, 0 } }, { 2, 1, { 1, 0 } }, { 3, 0, { 0, 0 } } };
+		TPGraphType * DG;
+		TPGraphType * CG;
+		double * X;
+		double Ref;
+		double Sum;
+		char Name[64];
+		const char * Status;
+		unsigned int Seed;
+		int Fails;
+		int Done;
+		int Bad;
+		int T;
+		int I;
+
+		/* Valori di ampiezza molto diversa, in modo che la somma dipenda
+		dall'ordine delle operazioni */
+		if ((X = new double[RGTPCount]) == NULL)
+			return 1;
+		Seed = 12345;
+		for (I = 0;I < RGTPCount;I++)
+			{
+				Seed = Seed * 1103515245 + 12345;
+				X[I] = ((double) (Seed >> 8) / 16777216.0 - 0.5) *
+					pow(10.0,(double) (I % 13) - 6.0);
+			}
+
+		DG = RGTPGraph(Diamond);
+		CG = RGTPGraph(Cycle);
+		if (DG == NULL || CG == NULL)
+			{
+				TPGraphFree(DG);
+				TPGraphFree(CG);
+				delete[] X;
+				return 1;
+			}
+
+		Fails = 0;
+		Ref = 0;
+		TPSetDeterministic(True);
+		for (T = 0;RGTPThreads[T] > 0;T++)
+			{
+				TPSetThreads(RGTPThreads[T],TPAffinityNone);
+
+				/* Riduzione deterministica */
+				Sum = TPParallelReduce(RGTPSum,X,RGTPCount,0);
+				if (T == 0)
+					Ref = Sum;
+				Status = (Sum == Ref) ? "OK" : "MISMATCH";
+				if (Sum != Ref)
+					Fails++;
+				snprintf(Name,sizeof(Name),"tpool/reduce/%u",RGTPThreads[T]);
+				printf("%-32s sum %.17g, %u threads  %s\n",Name,Sum,TPGetThreads(),Status);
+				fprintf(RF,"%-32s sum %.17g, %u threads  %s\n",Name,Sum,TPGetThreads(),Status);
+
+				/* Grafo a diamante */
+				Status = "OK";
+				for (I = 0,Done = 0,Bad = 0;I < RGTPGraphRuns;I++)
+					if (RGTPGraphRun(DG,&Done,&Bad) == False)
+						Bad++;
+				if (Done != RGTPTasks * RGTPGraphRuns || Bad > 0)
+					{
+						Status = "WRONG ORDER";
+						Fails++;
+					}
+				snprintf(Name,sizeof(Name),"tpool/diamond/%u",RGTPThreads[T]);
+				printf("%-32s %d tasks run, %d out of order  %s\n",Name,Done,Bad,Status);
+				fprintf(RF,"%-32s %d tasks run, %d out of order  %s\n",Name,Done,Bad,Status);
+
+				/* Grafo con un ciclo */
+				Done = 0;
+				Bad = 0;
+				Status = "OK";
+				if (RGTPGraphRun(CG,&Done,&Bad) == True || Done > 0)
+					{
+						Status = "NOT REJECTED";
+						Fails++;
+					}
+				snprintf(Name,sizeof(Name),"tpool/cycle/%u",RGTPThreads[T]);
+				printf("%-32s %d tasks run  %s\n",Name,Done,Status);
+				fprintf(RF,"%-32s %d tasks run  %s\n",Name,Done,Status);
+			}
+		printf("\n");
+		fprintf(RF,"\n");
+
+		TPStop();
+		TPSetDeterministic(False);
+		TPGraphFree(DG);
+		TPGraphFree(CG);
+		delete[] X;
+		return Fails;
+	}
+
+/* Programma principale */
+int main(int argc, char * argv[])
+	{
+		const char * Drc;
+		const char * CfgDir;
+		const char * TargetDir;
+		const char * GoldenDir;
+		const char * WorkDir;
+		const char * BaselineFile;
+		char * FilterList;
+		char * Filters[RGMaxFilters];
+		char * Tok;
+		int NFilters;
+		double MagTol;
+		double PhaseTol;
+		double TimeTol;
+		double Floor;
+		Boolean Update;
+		Boolean Derive;
+		char Name[64];
+		char IRFile[RGPathLen];
+		char CfgFile[RGPathLen];
+		char TargetFile[RGPathLen];
+		char PSFile[RGPathLen];
+		char TCFile[RGPathLen];
+		char ProfFile[RGPathLen];
+		char LogFile[RGPathLen];
+		char GoldenFile[RGPathLen];
+		char ReportFile[RGPathLen];
+		char TimesFile[RGPathLen];
+		char DefBaseline[RGPathLen];
+		char Cmd[RGCmdLen];
+		FILE * RF;
+		FILE * TF;
+		FILE * BF;
+		RGRunType Run;
+		RGResponseType Golden;
+		RGResponseType Resp;
+		double Start;
+		double MagErr;
+		double PhaseErr;
+		double BW;
+		const char * Status;
+		int A;
+		int R;
+		int P;
+		int Runs;
+		int Fails;
+		int DKFails;
+		int SWFails;
+		int TPFails;
+		int HOFails;
+		int NoBase;
+		Boolean HasBaseline;
+
+		/* Valori predefiniti */
+		Drc = "./drc";
+		CfgDir = "config";
+		TargetDir = "target";
+		GoldenDir = "test/golden";
+		WorkDir = "regress";
+		BaselineFile = NULL;
+		FilterList = NULL;
+		NFilters = 0;
+		MagTol = -1;
+		PhaseTol = -1;
+		TimeTol = RGTimeTol;
+		Floor = RGFloor;
+		Update = False;
+		Derive = False;
+
+		/* Parametri da linea di comando */
+		for (A = 1;A < argc;A++)
+			{
+				if (strncmp(argv[A],"--drc=",6) == 0)
+					Drc = &argv[A][6];
+				else if (strncmp(argv[A],"--config-dir=",13) == 0)
+					CfgDir = &argv[A][13];
+				else if (strncmp(argv[A],"--target-dir=",13) == 0)
+					TargetDir = &argv[A][13];
+				else if (strncmp(argv[A],"--golden-dir=",13) == 0)
+					GoldenDir = &argv[A][13];
+				else if (strncmp(argv[A],"--work-dir=",11) == 0)
+					WorkDir = &argv[A][11];
+				else if (strncmp(argv[A],"--baseline=",11) == 0)
+					BaselineFile = &argv[A][11];
+				else if (strncmp(argv[A],"--filter=",9) == 0)
+					FilterList = &argv[A][9];
+				else if (strncmp(argv[A],"--mag-tol=",10) == 0)
+					MagTol = atof(&argv[A][10]);
+				else if (strncmp(argv[A],"--phase-tol=",12) == 0)
+					PhaseTol = atof(&argv[A][12]);
+				else if (strncmp(argv[A],"--time-tol=",11) == 0)
+					TimeTol = atof(&argv[A][11]);
+				else if (strncmp(argv[A],"--floor=",8) == 0)
+					Floor = atof(&argv[A][8]);
+				else if (strcmp(argv[A],"--update") == 0)
+					Update = True;
+				else if (strcmp(argv[A],"--derive") == 0)
+					Derive = True;
+				else
+					{
+						fprintf(stderr,"Usage: drcregress [--drc=program] [--config-dir=dir] [--target-dir=dir]\n"
+							"                  [--golden-dir=dir] [--work-dir=dir] [--baseline=file]\n"
+							"                  [--filter=text[,text...]] [--mag-tol=dB] [--phase-tol=degrees]\n"
+							"                  [--time-tol=percent] [--floor=dB] [--update] [--derive]\n\n"
+							"Runs are named preset/rate, e.g. normal/44.1. Only the runs whose name\n"
+							"contains all the filter texts are executed. --update stores the current\n"
+							"responses as golden references and the current times as baseline.\n"
+							"--derive compares the filters derived from the 96 kHz runs through\n"
+							"BCDeriveRates with the ones computed at the native sample rates.\n");
+						return 1;
+					}
+			}
+
+		/* Suddivide l'elenco dei filtri */
+		if (FilterList != NULL)
+			for (Tok = strtok(FilterList,",");Tok != NULL && NFilters < RGMaxFilters;
+				Tok = strtok(NULL,","))
+				Filters[NFilters++] = Tok;
+
+		/* Tolleranze predefinite */
+		if (MagTol < 0)
+			MagTol = (Derive == True) ? RGDeriveMagTol : RGMagTol;
+		if (PhaseTol < 0)
+			PhaseTol = (Derive == True) ? RGDerivePhaseTol : RGPhaseTol;
+
+		/* Directory di lavoro e file di uscita */
+		RGMkDir(WorkDir);
+		snprintf(ReportFile,RGPathLen,"%s/report.txt",WorkDir);
+
+		/* Verifica dei filtri ricavati */
+		if (Derive == True)
+			{
+				if ((RF = fopen(ReportFile,"wt")) == NULL)
+					{
+						perror(ReportFile);
+						return 1;
+					}
+				Fails = RGDerive(Drc,CfgDir,TargetDir,WorkDir,Filters,NFilters,MagTol,
+					PhaseTol,Floor,RF);
+				fclose(RF);
+				printf("Report: %s\n",ReportFile);
+				return (Fails > 0) ? 1 : 0;
+			}
+
+		if (BaselineFile == NULL)
+			{
+				snprintf(DefBaseline,RGPathLen,"%s/baseline.csv",WorkDir);
+				BaselineFile = DefBaseline;
+			}
+		HasBaseline = False;
+		if (Update == False)
+			HasBaseline = RGReadBaseline(BaselineFile);
+		snprintf(TimesFile,RGPathLen,"%s/times.csv",WorkDir);
+		if ((RF = fopen(ReportFile,"wt")) == NULL || (TF = fopen(TimesFile,"wt")) == NULL)
+			{
+				perror(WorkDir);
+				return 1;
+			}
+		BF = NULL;
+		if (Update == True)
+			{
+				RGMkDir(GoldenDir);
+				if ((BF = fopen(BaselineFile,"wt")) == NULL)
+					{
+						perror(BaselineFile);
+						return 1;
+					}
+				fputs("preset,rate,stage,wall_s\n",BF);
+			}
+		fputs("preset,rate,stage,wall_s,baseline_wall_s,peak_rss_mb\n",TF);
+
+		/* Verifica dei nuclei di limitazione delle valli */
+		DKFails = RGDipKnee(RF);
+
+		/* Verifica del pool di thread */
+		TPFails = RGThreadPool(RF);
+
+		/* Verifica della condivisione delle fasi comuni in modalit sweep */
+		SWFails = RGSweep(Drc,CfgDir,TargetDir,WorkDir,Filters,NFilters,RF);
+
+		/* Verifica del passaggio diretto dello spettro della convoluzione */
+		HOFails = RGHandoff(Drc,CfgDir,TargetDir,WorkDir,Filters,NFilters,RF);
+
+		fprintf(RF,"%-16s %10s %10s %7s %10s %10s %10s  %s\n","Run","Time (s)","Base (s)",
+			"Ratio","RSS (MB)","Mag (dB)","Phase","Status");
+		printf("%-16s %10s %10s %7s %10s %10s %10s  %s\n","Run","Time (s)","Base (s)",
+			"Ratio","RSS (MB)","Mag (dB)","Phase","Status");
+
+		/* Senza tempi di riferimento il confronto dei tempi non viene eseguito */
+		if (Update == False && HasBaseline == False)
+			{
+				printf("Warning: no timing baseline in %s, run times are not checked.\n",
+					BaselineFile);
+				fprintf(RF,"Warning: no timing baseline in %s, run times are not checked.\n",
+					BaselineFile);
+			}
+
+		Runs = 0;
+		Fails = DKFails + TPFails + SWFails + HOFails;
+		NoBase = 0;
+		for (R = 0;RGRates[R].SampleRate > 0;R++)
+			{
+				/* Risposta sintetica per la frequenza di campionamento */
+				snprintf(IRFile,RGPathLen,"%s/ir-%s.pcm",WorkDir,RGRates[R].Name);
+
+				for (P = 0;RGPresets[P] != NULL;P++)
+					{
+						snprintf(Name,sizeof(Name),"%s/%s",RGPresets[P],RGRates[R].Name);
+						if (RGMatch(Name,Filters,NFilters) == False)
+							continue;
+
+						if (RGMakeIR(IRFile,RGRates[R].SampleRate) == False)
+							{
+								perror(IRFile);
+								return 1;
+							}
+
+						snprintf(CfgFile,RGPathLen,"%s/%s kHz/%s-%s.drc",CfgDir,
+							RGRates[R].Name,RGPresets[P],RGRates[R].Name);
+						snprintf(TargetFile,RGPathLen,"%s/%s kHz/flat-%s.txt",TargetDir,
+							RGRates[R].Name,RGRates[R].Name);
+						snprintf(PSFile,RGPathLen,"%s/ps-%s-%s.pcm",WorkDir,RGPresets[P],
+							RGRates[R].Name);
+						snprintf(TCFile,RGPathLen,"%s/tc-%s-%s.pcm",WorkDir,RGPresets[P],
+							RGRates[R].Name);
+						snprintf(ProfFile,RGPathLen,"%s/profile-%s-%s.csv",WorkDir,RGPresets[P],
+							RGRates[R].Name);
+						snprintf(LogFile,RGPathLen,"%s/log-%s-%s.txt",WorkDir,RGPresets[P],
+							RGRates[R].Name);
+						snprintf(GoldenFile,RGPathLen,"%s/%s-%s.txt",GoldenDir,RGPresets[P],
+							RGRates[R].Name);
+
+						/* Esegue DRC */
+						if (snprintf(Cmd,sizeof(Cmd),"\"%s\" --BCInFile=\"%s\" --MCFilterType=M "
+							"--MCPointsFile=\"%s\" --PSPointsFile=\"%s\" --PSOutFile=\"%s\" "
+							"--TCOutFile=\"%s\" --BCProfileOutFile=\"%s\" --BCProfileOutType=C "
+							"\"%s\" > \"%s\"",Drc,IRFile,TargetFile,TargetFile,PSFile,TCFile,
+							ProfFile,CfgFile,LogFile) >= (int) sizeof(Cmd))
+							{
+								printf("%-16s Command line too long\n",Name);
+								fprintf(RF,"%-16s Command line too long\n",Name);
+								Fails++;
+								continue;
+							}
+						remove(PSFile);
+						remove(ProfFile);
+						Start = PMTime();
+						if (system(Cmd) != 0)
+							{
+								printf("%-16s DRC execution failed, see %s\n",Name,LogFile);
+								fprintf(RF,"%-16s DRC execution failed, see %s\n",Name,LogFile);
+								Fails++;
+								continue;
+							}
+						Run.Wall = PMTime() - Start;
+						Runs++;
+
+						if (RGReadProfile(ProfFile,&Run) == False ||
+							RGResponse(PSFile,RGRates[R].SampleRate,&Resp) == False)
+							{
+								printf("%-16s DRC output missing, see %s\n",Name,LogFile);
+								fprintf(RF,"%-16s DRC output missing, see %s\n",Name,LogFile);
+								Fails++;
+								continue;
+							}
+
+						/* Aggiornamento dei riferimenti */
+						if (Update == True)
+							{
+								if (RGWriteGolden(GoldenFile,Name,&Resp) == False)
+									{
+										perror(GoldenFile);
+										return 1;
+									}
+								RGWriteTimes(BF,RGPresets[P],RGRates[R].Name,&Run,False);
+								MagErr = 0;
+								PhaseErr = 0;
+								BW = Run.Wall;
+								Status = "UPDATED";
+							}
+						else
+							{
+								/* Confronto con la risposta di riferimento */
+								BW = RGBaselineWall(RGPresets[P],RGRates[R].Name,"Total");
+								Status = "OK";
+								if (RGReadGolden(GoldenFile,&Golden) == False ||
+									RGCompare(&Golden,&Resp,Floor,&MagErr,&PhaseErr) == False)
+									{
+										MagErr = -1;
+										PhaseErr = -1;
+										Status = "NO GOLDEN";
+										Fails++;
+									}
+								else if (MagErr > MagTol || PhaseErr > PhaseTol)
+									{
+										Status = "MISMATCH";
+										Fails++;
+									}
+								else if (BW > RGMinTime && Run.Wall > BW * (1.0 + TimeTol / 100.0))
+									{
+										Status = "SLOWER";
+										Fails++;
+									}
+								else if (BW < 0)
+									{
+										Status = "OK, NO BASELINE";
+										NoBase++;
+									}
+							}
+
+						RGWriteTimes(TF,RGPresets[P],RGRates[R].Name,&Run,True);
+						fprintf(RF,"%-16s %10.3f %10.3f %7.3f %10.1f %10.4f %10.4f  %s\n",Name,
+							Run.Wall,BW,(BW > 0) ? Run.Wall / BW : 0.0,Run.PeakRSS,MagErr,PhaseErr,
+							Status);
+						printf("%-16s %10.3f %10.3f %7.3f %10.1f %10.4f %10.4f  %s\n",Name,
+							Run.Wall,BW,(BW > 0) ? Run.Wall / BW : 0.0,Run.PeakRSS,MagErr,PhaseErr,
+							Status);
+						fflush(stdout);
+					}
+			}
+
+		fprintf(RF,"\n%d runs, %d failures.\n",Runs,Fails);
+		printf("\n%d runs, %d failures. Report: %s, stage times: %s\n",Runs,Fails,
+			ReportFile,TimesFile);
+		if (NoBase > 0)
+			{
+				fprintf(RF,"Warning: %d runs without timing baseline, times not checked.\n",
+					NoBase);
+				printf("Warning: %d runs without timing baseline, times not checked.\n",
+					NoBase);
+			}
+		fclose(RF);
+		fclose(TF);
+		if (BF != NULL)
+			fclose(BF);
+
+		return (Fails > 0) ? 1 : 0;
+	}
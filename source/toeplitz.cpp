@@ -32,21 +32,23 @@
 	#include "debug_new.h"
 #endif
 
-int ToeplitzSolve(const DLReal * A, const DLReal * B, DLReal * X, int N)
+/* Risoluzione con il metodo di Levinson, modello sul tipo floating point */
+template <class T>
+static int TToeplitzSolve(const T * A, const T * B, T * X, int N)
 	{
   	int I, J, K;
-  	DLReal PError;
-  	DLReal RC;
-  	DLReal Tmp;
-  	DLReal Sum;
-  	DLReal * TA;
+  	T PError;
+  	T RC;
+  	T Tmp;
+  	T Sum;
+  	T * TA;
 
   	PError = A[0];
   	if (PError <= 0)
    		return 1;
 
 		/* Alloca un arrya temporaneo */
- 		if ((TA = new DLReal[N]) == NULL)
+ 		if ((TA = new T[N]) == NULL)
  			return 1;
 
   	X[0] = B[0] / PError;
@@ -98,3 +100,36 @@ int ToeplitzSolve(const DLReal * A, const DLReal * B, DLReal * X, int N)
 
 	  return 0;
 	}
+
+int ToeplitzSolve(const DLReal * A, const DLReal * B, DLReal * X, int N)
+	{
+		return TToeplitzSolve<DLReal>(A,B,X,N);
+	}
+
+/* Versione con precisione di calcolo Prec */
+int ToeplitzSolve(const DLReal * A, const DLReal * B, DLReal * X, int N,
+	const DLPrecisionType Prec)
+	{
+		DLAltReal * AA;
+		int Res;
+		int I;
+
+		if (DLUseAltReal(Prec) == False)
+			return TToeplitzSolve<DLReal>(A,B,X,N);
+
+		/* Alloca gli array nella precisione alternativa */
+		if ((AA = new DLAltReal[3 * N]) == NULL)
+			return 1;
+		for (I = 0;I < N;I++)
+			{
+				AA[I] = A[I];
+				AA[N + I] = B[I];
+			}
+
+		if ((Res = TToeplitzSolve<DLAltReal>(AA,&AA[N],&AA[2 * N],N)) == 0)
+			for (I = 0;I < N;I++)
+				X[I] = (DLReal) AA[2 * N + I];
+
+		delete[] AA;
+		return Res;
+	}
@@ -38,4 +38,8 @@ classico metodo di Levinson. Ritorna 0 in caso di successo, 1 altrimenti. */
 
 	int ToeplitzSolve(const DLReal * A, const DLReal * B, DLReal * X, int N);
 
+	/* Versione con precisione di calcolo Prec */
+	int ToeplitzSolve(const DLReal * A, const DLReal * B, DLReal * X, int N,
+		const DLPrecisionType Prec);
+
 #endif
@@ -0,0 +1,896 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Pool di thread condiviso per il calcolo parallelo */
+
+/* Inclusioni */
+#include "tpool.h"
+#include "drc.h"
+#include <stdlib.h>
+
+/* Memory leaks debugger */
+#ifdef DebugMLeaks
+	#include "debug_new.h"
+#endif
+
+/* Task di un grafo */
+typedef struct
+	{
+		TPTaskType Task;
+		void * Arg;
+
+		/* Task che dipendono da questo */
+		int * Succ;
+		int NSucc;
+		int SuccSize;
+
+		/* Numero di dipendenze */
+		unsigned int NDeps;
+	}
+TPGraphTaskType;
+
+struct TPGraphStruct
+	{
+		TPGraphTaskType * Tasks;
+		int NTasks;
+		int Size;
+	};
+
+/* Modalit deterministica */
+static Boolean TPDeterministic = False;
+
+/* Dimensione dei blocchi per un'elaborazione su Count indici con NT thread,
+in modalit deterministica indipendente dal numero di thread */
+static unsigned int TPGrain(const unsigned int Count,const unsigned int Grain,
+	const unsigned int NT)
+	{
+		unsigned int G;
+
+		if (Grain > 0)
+			return(Grain);
+		if (TPDeterministic == True)
+			G = (Count + 63) / 64;
+		else
+			G = Count / (8 * NT);
+		return((G > 0) ? G : 1);
+	}
+
+/* Verifica le dipendenze del grafo, ritorna False in presenza di un ciclo */
+static Boolean TPGraphCheck(const TPGraphType * G)
+	{
+		unsigned int * Deps;
+		int * Ready;
+		int NReady;
+		int Done;
+		int K;
+		int S;
+
+		if (G->NTasks == 0)
+			return(True);
+		if ((Deps = (unsigned int *) malloc(G->NTasks * sizeof(unsigned int))) == NULL)
+			return(False);
+		if ((Ready = (int *) malloc(G->NTasks * sizeof(int))) == NULL)
+			{
+				free(Deps);
+				return(False);
+			}
+
+		NReady = 0;
+		for (K = 0;K < G->NTasks;K++)
+			{
+				Deps[K] = G->Tasks[K].NDeps;
+				if (Deps[K] == 0)
+					Ready[NReady++] = K;
+			}
+		for (Done = 0;Done < NReady;Done++)
+			{
+				K = Ready[Done];
+				for (S = 0;S < G->Tasks[K].NSucc;S++)
+					if (--Deps[G->Tasks[K].Succ[S]] == 0)
+						Ready[NReady++] = G->Tasks[K].Succ[S];
+			}
+
+		free(Deps);
+		free(Ready);
+		return((Done == G->NTasks) ? True : False);
+	}
+
+/* Controlla se  abilitato il pool di thread */
+#ifdef UseThreadPool
+
+#include <pthread.h>
+#include <sched.h>
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <unistd.h>
+#endif
+
+/* Intervallo di blocchi o di task */
+typedef struct
+	{
+		unsigned int Lo;
+		unsigned int Hi;
+	}
+TPRangeType;
+
+/* Coda di lavoro di un thread, il thread proprietario elabora gli
+intervalli dalla fine della coda, gli altri sottraggono lavoro
+dall'inizio */
+typedef struct
+	{
+		pthread_mutex_t Mutex;
+		TPRangeType * Items;
+		unsigned int Size;
+		unsigned int Head;
+		unsigned int Tail;
+	}
+TPQueueType;
+
+/* Elaborazione parallela in corso */
+typedef struct
+	{
+		/* Lavoro su intervalli di indici */
+		TPJobType Job;
+		TPReduceJobType RJob;
+		void * Arg;
+		unsigned int Count;
+		unsigned int Grain;
+		double * Partial;
+
+		/* Grafo di task ed il relativo numero di dipendenze rimanenti */
+		TPGraphType * G;
+		unsigned int * Pending;
+
+		/* Blocchi o task completati e totali */
+		volatile unsigned int Done;
+		unsigned int Total;
+	}
+TPRegionType;
+
+/* Stato del pool */
+static unsigned int TPThreads = 1;
+static TPAffinityType TPAffinity = TPAffinityNone;
+static pthread_t TPThread[TPMaxThreads];
+static TPQueueType TPQueue[TPMaxThreads];
+
+/* Sincronizzazione con i thread in attesa */
+static pthread_mutex_t TPMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t TPStartCond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t TPDoneCond = PTHREAD_COND_INITIALIZER;
+static TPRegionType * TPRegion = NULL;
+static unsigned int TPGeneration = 0;
+static unsigned int TPThreadGeneration[TPMaxThreads];
+static unsigned int TPActive = 0;
+static Boolean TPExit = False;
+
+/* Impedisce l'esecuzione contemporanea di due elaborazioni parallele,
+quelle richieste durante un'elaborazione vengono eseguite in modo seriale */
+static pthread_mutex_t TPRunMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Affinit originale del thread chiamante */
+#ifdef __linux__
+	static cpu_set_t TPCallerMask;
+	static Boolean TPCallerMaskSet = False;
+#endif
+
+/* Numero di processori disponibili */
+static unsigned int TPCPUCount(void)
+	{
+		#ifdef _WIN32
+			SYSTEM_INFO SI;
+
+			GetSystemInfo(&SI);
+			return((unsigned int) SI.dwNumberOfProcessors);
+		#else
+			long NC = sysconf(_SC_NPROCESSORS_ONLN);
+
+			return((NC > 0) ? (unsigned int) NC : 1);
+		#endif
+	}
+
+/* Assegna il thread corrente ad un processore, consecutivi con
+l'affinit compatta, distribuiti uniformemente con quella sparsa */
+static void TPBind(const unsigned int Thread)
+	{
+		#ifdef __linux__
+			cpu_set_t S;
+			unsigned int NC;
+			unsigned int C;
+
+			if (TPAffinity == TPAffinityNone)
+				return;
+			NC = TPCPUCount();
+			if (TPAffinity == TPAffinityCompact)
+				C = Thread % NC;
+			else
+				C = (unsigned int) ((((unsigned long long) Thread) * NC / TPThreads) % NC);
+			CPU_ZERO(&S);
+			CPU_SET(C,&S);
+			pthread_setaffinity_np(pthread_self(),sizeof(S),&S);
+		#endif
+	}
+
+/* Aggiunge un intervallo alla coda del thread */
+static void TPPush(const unsigned int Thread,const unsigned int Lo,const unsigned int Hi)
+	{
+		TPQueueType * Q = &TPQueue[Thread];
+
+		pthread_mutex_lock(&Q->Mutex);
+		Q->Items[Q->Tail].Lo = Lo;
+		Q->Items[Q->Tail].Hi = Hi;
+		Q->Tail++;
+		pthread_mutex_unlock(&Q->Mutex);
+	}
+
+/* Estrae un blocco dalla fine della coda del thread */
+static Boolean TPPop(const unsigned int Thread,unsigned int * U)
+	{
+		TPQueueType * Q = &TPQueue[Thread];
+		TPRangeType * R;
+		Boolean Res = False;
+
+		pthread_mutex_lock(&Q->Mutex);
+		if (Q->Tail > Q->Head)
+			{
+				R = &Q->Items[Q->Tail - 1];
+				*U = R->Lo++;
+				if (R->Lo == R->Hi)
+					Q->Tail--;
+				if (Q->Tail == Q->Head)
+					Q->Head = Q->Tail = 0;
+				Res = True;
+			}
+		pthread_mutex_unlock(&Q->Mutex);
+
+		return(Res);
+	}
+
+/* Sottrae lavoro dall'inizio della coda degli altri thread, met di un
+intervallo di pi blocchi o un intero intervallo */
+static Boolean TPSteal(const unsigned int Thread)
+	{
+		TPQueueType * Q;
+		TPRangeType * R;
+		unsigned int V;
+		unsigned int T;
+		unsigned int Lo;
+		unsigned int Hi;
+		Boolean Res;
+
+		for (V = 1;V < TPThreads;V++)
+			{
+				T = (Thread + V) % TPThreads;
+				Q = &TPQueue[T];
+				Res = False;
+				pthread_mutex_lock(&Q->Mutex);
+				if (Q->Tail > Q->Head)
+					{
+						R = &Q->Items[Q->Head];
+						Hi = R->Hi;
+						if (Hi - R->Lo > 1)
+							{
+								Lo = R->Lo + (Hi - R->Lo) / 2;
+								R->Hi = Lo;
+							}
+						else
+							{
+								Lo = R->Lo;
+								Q->Head++;
+								if (Q->Tail == Q->Head)
+									Q->Head = Q->Tail = 0;
+							}
+						Res = True;
+					}
+				pthread_mutex_unlock(&Q->Mutex);
+				if (Res == True)
+					{
+						TPPush(Thread,Lo,Hi);
+						return(True);
+					}
+			}
+
+		return(False);
+	}
+
+/* Esegue un blocco o un task */
+static void TPRunUnit(TPRegionType * R,const unsigned int Thread,const unsigned int U)
+	{
+		TPGraphTaskType * K;
+		unsigned int Start;
+		unsigned int End;
+		double V;
+		int S;
+
+		if (R->G == NULL)
+			{
+				Start = U * R->Grain;
+				End = (Start + R->Grain < R->Count) ? Start + R->Grain : R->Count;
+				if (R->Job != NULL)
+					R->Job(R->Arg,Thread,Start,End);
+				else
+					{
+						V = R->RJob(R->Arg,Thread,Start,End);
+						if (TPDeterministic == True)
+							R->Partial[U] = V;
+						else
+							R->Partial[Thread] += V;
+					}
+			}
+		else
+			{
+				/* Esegue il task e rende disponibili quelli che ne
+				dipendevano solo da esso */
+				K = &R->G->Tasks[U];
+				K->Task(K->Arg,Thread);
+				for (S = 0;S < K->NSucc;S++)
+					if (__sync_sub_and_fetch(&R->Pending[K->Succ[S]],1) == 0)
+						TPPush(Thread,K->Succ[S],K->Succ[S] + 1);
+			}
+
+		__sync_add_and_fetch(&R->Done,1);
+	}
+
+/* Ciclo di elaborazione di un thread fino al completamento */
+static void TPWork(TPRegionType * R,const unsigned int Thread)
+	{
+		unsigned int U;
+
+		for (;;)
+			{
+				if (TPPop(Thread,&U) == True)
+					TPRunUnit(R,Thread,U);
+				else
+					if (TPSteal(Thread) == False)
+						{
+							if (__sync_add_and_fetch(&R->Done,0) == R->Total)
+								break;
+							sched_yield();
+						}
+			}
+	}
+
+/* Thread del pool in attesa delle elaborazioni */
+static void * TPThreadMain(void * P)
+	{
+		unsigned int Thread = (unsigned int) (size_t) P;
+		unsigned int Gen;
+		TPRegionType * R;
+
+		TPBind(Thread);
+
+		pthread_mutex_lock(&TPMutex);
+		Gen = TPThreadGeneration[Thread];
+		for (;;)
+			{
+				while (TPGeneration == Gen && TPExit == False)
+					pthread_cond_wait(&TPStartCond,&TPMutex);
+				if (TPExit == True)
+					break;
+				Gen = TPGeneration;
+				R = TPRegion;
+				pthread_mutex_unlock(&TPMutex);
+
+				TPWork(R,Thread);
+
+				pthread_mutex_lock(&TPMutex);
+				if (--TPActive == 0)
+					pthread_cond_signal(&TPDoneCond);
+			}
+		pthread_mutex_unlock(&TPMutex);
+
+		return(NULL);
+	}
+
+/* Prepara le code per Size intervalli per thread */
+static Boolean TPQueueReserve(const unsigned int Size)
+	{
+		TPRangeType * Items;
+		unsigned int T;
+
+		for (T = 0;T < TPThreads;T++)
+			{
+				TPQueue[T].Head = TPQueue[T].Tail = 0;
+				if (TPQueue[T].Size < Size)
+					{
+						if ((Items = (TPRangeType *) realloc(TPQueue[T].Items,
+							Size * sizeof(TPRangeType))) == NULL)
+							return(False);
+						TPQueue[T].Items = Items;
+						TPQueue[T].Size = Size;
+					}
+			}
+
+		return(True);
+	}
+
+/* Esegue l'elaborazione con tutti i thread del pool */
+static void TPRun(TPRegionType * R)
+	{
+		pthread_mutex_lock(&TPMutex);
+		TPRegion = R;
+		TPActive = TPThreads - 1;
+		TPGeneration++;
+		pthread_cond_broadcast(&TPStartCond);
+		pthread_mutex_unlock(&TPMutex);
+
+		TPWork(R,0);
+
+		pthread_mutex_lock(&TPMutex);
+		while (TPActive > 0)
+			pthread_cond_wait(&TPDoneCond,&TPMutex);
+		TPRegion = NULL;
+		pthread_mutex_unlock(&TPMutex);
+	}
+
+/* Imposta il numero di thread */
+Boolean TPSetThreads(const unsigned int Threads,const TPAffinityType Affinity)
+	{
+		unsigned int NT;
+		unsigned int T;
+
+		NT = (Threads == 0) ? TPCPUCount() : Threads;
+		if (NT > TPMaxThreads)
+			NT = TPMaxThreads;
+		if (NT == TPThreads && Affinity == TPAffinity)
+			return(True);
+
+		TPStop();
+		TPAffinity = Affinity;
+		if (NT <= 1)
+			return(True);
+
+		/* Inizializza le code */
+		for (T = 0;T < NT;T++)
+			{
+				pthread_mutex_init(&TPQueue[T].Mutex,NULL);
+				TPQueue[T].Items = NULL;
+				TPQueue[T].Size = 0;
+			}
+		TPThreads = NT;
+		if (TPQueueReserve(4) == False)
+			{
+				TPThreads = 1;
+				return(False);
+			}
+
+		/* Assegna il thread chiamante, salvandone l'affinit originale */
+		#ifdef __linux__
+			if (Affinity != TPAffinityNone)
+				if (pthread_getaffinity_np(pthread_self(),sizeof(TPCallerMask),&TPCallerMask) == 0)
+					TPCallerMaskSet = True;
+		#endif
+		TPBind(0);
+
+		/* Avvia i thread, che attendono l'elaborazione successiva a
+		quella corrente */
+		for (T = 1;T < NT;T++)
+			TPThreadGeneration[T] = TPGeneration;
+		for (T = 1;T < NT;T++)
+			if (pthread_create(&TPThread[T],NULL,TPThreadMain,(void *) (size_t) T) != 0)
+				break;
+		TPThreads = T;
+
+		return((T == NT) ? True : False);
+	}
+
+/* Numero di thread in uso */
+unsigned int TPGetThreads(void)
+	{
+		return(TPThreads);
+	}
+
+/* Termina i thread del pool */
+void TPStop(void)
+	{
+		unsigned int T;
+
+		if (TPThreads > 1)
+			{
+				pthread_mutex_lock(&TPMutex);
+				TPExit = True;
+				pthread_cond_broadcast(&TPStartCond);
+				pthread_mutex_unlock(&TPMutex);
+				for (T = 1;T < TPThreads;T++)
+					pthread_join(TPThread[T],NULL);
+				TPExit = False;
+
+				for (T = 0;T < TPThreads;T++)
+					{
+						free(TPQueue[T].Items);
+						pthread_mutex_destroy(&TPQueue[T].Mutex);
+					}
+			}
+		TPThreads = 1;
+
+		/* Ripristina l'affinit del thread chiamante */
+		#ifdef __linux__
+			if (TPCallerMaskSet == True)
+				{
+					pthread_setaffinity_np(pthread_self(),sizeof(TPCallerMask),&TPCallerMask);
+					TPCallerMaskSet = False;
+				}
+		#endif
+	}
+
+/* Esegue Job sugli indici [0,Count) */
+void TPParallelFor(TPJobType Job,void * Arg,const unsigned int Count,
+	const unsigned int Grain)
+	{
+		TPRegionType R;
+		unsigned int NC;
+		unsigned int T;
+		unsigned int Lo;
+		unsigned int Hi;
+
+		if (Count == 0)
+			return;
+
+		/* Elaborazione seriale senza thread o durante un'altra elaborazione */
+		if (TPThreads <= 1 || pthread_mutex_trylock(&TPRunMutex) != 0)
+			{
+				Job(Arg,0,0,Count);
+				return;
+			}
+
+		R.Job = Job;
+		R.RJob = NULL;
+		R.Arg = Arg;
+		R.Count = Count;
+		R.Grain = TPGrain(Count,Grain,TPThreads);
+		R.Partial = NULL;
+		R.G = NULL;
+		R.Pending = NULL;
+		R.Done = 0;
+		R.Total = NC = (Count + R.Grain - 1) / R.Grain;
+
+		/* Suddivide i blocchi tra i thread */
+		TPQueueReserve(4);
+		for (T = 0;T < TPThreads;T++)
+			{
+				Lo = (unsigned int) (((unsigned long long) NC * T) / TPThreads);
+				Hi = (unsigned int) (((unsigned long long) NC * (T + 1)) / TPThreads);
+				if (Hi > Lo)
+					TPPush(T,Lo,Hi);
+			}
+		TPRun(&R);
+
+		pthread_mutex_unlock(&TPRunMutex);
+	}
+
+/* Esegue Job sugli indici [0,Count) e somma i risultati parziali */
+double TPParallelReduce(TPReduceJobType Job,void * Arg,const unsigned int Count,
+	const unsigned int Grain)
+	{
+		TPRegionType R;
+		unsigned int NC;
+		unsigned int T;
+		unsigned int U;
+		unsigned int Lo;
+		unsigned int Hi;
+		double Sum;
+
+		if (Count == 0)
+			return(0.0);
+
+		R.Grain = TPGrain(Count,Grain,TPThreads);
+		NC = (Count + R.Grain - 1) / R.Grain;
+
+		/* Elaborazione seriale, sugli stessi blocchi di quella
+		parallela per ottenere in modalit deterministica lo stesso
+		risultato */
+		if (TPThreads <= 1 || pthread_mutex_trylock(&TPRunMutex) != 0)
+			{
+				if (TPDeterministic == False)
+					return(Job(Arg,0,0,Count));
+				Sum = 0.0;
+				for (U = 0;U < NC;U++)
+					{
+						Lo = U * R.Grain;
+						Hi = (Lo + R.Grain < Count) ? Lo + R.Grain : Count;
+						Sum += Job(Arg,0,Lo,Hi);
+					}
+				return(Sum);
+			}
+
+		/* Risultati parziali per blocco o per thread */
+		T = (TPDeterministic == True) ? NC : TPThreads;
+		if ((R.Partial = (double *) malloc(T * sizeof(double))) == NULL)
+			{
+				pthread_mutex_unlock(&TPRunMutex);
+				return(Job(Arg,0,0,Count));
+			}
+		for (U = 0;U < T;U++)
+			R.Partial[U] = 0.0;
+
+		R.Job = NULL;
+		R.RJob = Job;
+		R.Arg = Arg;
+		R.Count = Count;
+		R.G = NULL;
+		R.Pending = NULL;
+		R.Done = 0;
+		R.Total = NC;
+
+		TPQueueReserve(4);
+		for (T = 0;T < TPThreads;T++)
+			{
+				Lo = (unsigned int) (((unsigned long long) NC * T) / TPThreads);
+				Hi = (unsigned int) (((unsigned long long) NC * (T + 1)) / TPThreads);
+				if (Hi > Lo)
+					TPPush(T,Lo,Hi);
+			}
+		TPRun(&R);
+
+		pthread_mutex_unlock(&TPRunMutex);
+
+		/* Combina i risultati parziali in ordine */
+		Sum = 0.0;
+		T = (TPDeterministic == True) ? NC : TPThreads;
+		for (U = 0;U < T;U++)
+			Sum += R.Partial[U];
+		free(R.Partial);
+
+		return(Sum);
+	}
+
+/* Esegue il grafo in modo seriale, in ordine topologico */
+static Boolean TPGraphRunSerial(TPGraphType * G);
+
+/* Esegue i task del grafo */
+Boolean TPGraphRun(TPGraphType * G)
+	{
+		TPRegionType R;
+		unsigned int * Pending;
+		int K;
+		unsigned int T;
+
+		if (TPGraphCheck(G) == False)
+			return(False);
+		if (G->NTasks == 0)
+			return(True);
+
+		if (TPThreads <= 1 || pthread_mutex_trylock(&TPRunMutex) != 0)
+			return(TPGraphRunSerial(G));
+
+		if ((Pending = (unsigned int *) malloc(G->NTasks * sizeof(unsigned int))) == NULL ||
+			TPQueueReserve(G->NTasks) == False)
+			{
+				free(Pending);
+				pthread_mutex_unlock(&TPRunMutex);
+				return(TPGraphRunSerial(G));
+			}
+
+		R.Job = NULL;
+		R.RJob = NULL;
+		R.Arg = NULL;
+		R.Count = 0;
+		R.Grain = 1;
+		R.Partial = NULL;
+		R.G = G;
+		R.Pending = Pending;
+		R.Done = 0;
+		R.Total = G->NTasks;
+
+		/* Distribuisce tra i thread i task senza dipendenze */
+		for (K = 0,T = 0;K < G->NTasks;K++)
+			{
+				Pending[K] = G->Tasks[K].NDeps;
+				if (Pending[K] == 0)
+					{
+						TPPush(T,K,K + 1);
+						T = (T + 1) % TPThreads;
+					}
+			}
+		TPRun(&R);
+
+		pthread_mutex_unlock(&TPRunMutex);
+		free(Pending);
+
+		return(True);
+	}
+
+#else
+
+/* Versione seriale */
+Boolean TPSetThreads(const unsigned int Threads,const TPAffinityType Affinity)
+	{
+		return((Threads == 1) ? True : False);
+	}
+
+unsigned int TPGetThreads(void)
+	{
+		return(1);
+	}
+
+void TPStop(void)
+	{
+	}
+
+void TPParallelFor(TPJobType Job,void * Arg,const unsigned int Count,
+	const unsigned int Grain)
+	{
+		if (Count > 0)
+			Job(Arg,0,0,Count);
+	}
+
+double TPParallelReduce(TPReduceJobType Job,void * Arg,const unsigned int Count,
+	const unsigned int Grain)
+	{
+		unsigned int G;
+		unsigned int Lo;
+		unsigned int Hi;
+		double Sum;
+
+		if (Count == 0)
+			return(0.0);
+		if (TPDeterministic == False)
+			return(Job(Arg,0,0,Count));
+		G = TPGrain(Count,Grain,1);
+		Sum = 0.0;
+		for (Lo = 0;Lo < Count;Lo = Hi)
+			{
+				Hi = (Lo + G < Count) ? Lo + G : Count;
+				Sum += Job(Arg,0,Lo,Hi);
+			}
+		return(Sum);
+	}
+
+static Boolean TPGraphRunSerial(TPGraphType * G);
+
+Boolean TPGraphRun(TPGraphType * G)
+	{
+		if (TPGraphCheck(G) == False)
+			return(False);
+		return(TPGraphRunSerial(G));
+	}
+
+#endif
+
+/* Imposta la modalit deterministica */
+void TPSetDeterministic(const Boolean Deterministic)
+	{
+		TPDeterministic = Deterministic;
+	}
+
+/* Verifica se  attiva la modalit deterministica */
+Boolean TPGetDeterministic(void)
+	{
+		return(TPDeterministic);
+	}
+
+/* Esegue il grafo in modo seriale, in ordine topologico */
+static Boolean TPGraphRunSerial(TPGraphType * G)
+	{
+		unsigned int * Deps;
+		int * Ready;
+		int NReady;
+		int Done;
+		int K;
+		int S;
+
+		if ((Deps = (unsigned int *) malloc(G->NTasks * sizeof(unsigned int))) == NULL)
+			return(False);
+		if ((Ready = (int *) malloc(G->NTasks * sizeof(int))) == NULL)
+			{
+				free(Deps);
+				return(False);
+			}
+
+		NReady = 0;
+		for (K = 0;K < G->NTasks;K++)
+			{
+				Deps[K] = G->Tasks[K].NDeps;
+				if (Deps[K] == 0)
+					Ready[NReady++] = K;
+			}
+		for (Done = 0;Done < NReady;Done++)
+			{
+				K = Ready[Done];
+				G->Tasks[K].Task(G->Tasks[K].Arg,0);
+				for (S = 0;S < G->Tasks[K].NSucc;S++)
+					if (--Deps[G->Tasks[K].Succ[S]] == 0)
+						Ready[NReady++] = G->Tasks[K].Succ[S];
+			}
+
+		free(Deps);
+		free(Ready);
+		return(True);
+	}
+
+/* Crea un grafo di task vuoto */
+TPGraphType * TPGraphCreate(void)
+	{
+		TPGraphType * G;
+
+		if ((G = (TPGraphType *) malloc(sizeof(TPGraphType))) == NULL)
+			return(NULL);
+		G->Tasks = NULL;
+		G->NTasks = 0;
+		G->Size = 0;
+		return(G);
+	}
+
+/* Aggiunge un task al grafo */
+int TPGraphAdd(TPGraphType * G,TPTaskType Task,void * Arg)
+	{
+		TPGraphTaskType * Tasks;
+		TPGraphTaskType * K;
+
+		if (G->NTasks == G->Size)
+			{
+				if ((Tasks = (TPGraphTaskType *) realloc(G->Tasks,
+					(2 * G->Size + 8) * sizeof(TPGraphTaskType))) == NULL)
+					return(-1);
+				G->Tasks = Tasks;
+				G->Size = 2 * G->Size + 8;
+			}
+
+		K = &G->Tasks[G->NTasks];
+		K->Task = Task;
+		K->Arg = Arg;
+		K->Succ = NULL;
+		K->NSucc = 0;
+		K->SuccSize = 0;
+		K->NDeps = 0;
+
+		return(G->NTasks++);
+	}
+
+/* Imposta l'esecuzione del task Task dopo il task Dep */
+Boolean TPGraphDepends(TPGraphType * G,const int Task,const int Dep)
+	{
+		TPGraphTaskType * D;
+		int * Succ;
+
+		if (Task < 0 || Task >= G->NTasks || Dep < 0 || Dep >= G->NTasks)
+			return(False);
+
+		D = &G->Tasks[Dep];
+		if (D->NSucc == D->SuccSize)
+			{
+				if ((Succ = (int *) realloc(D->Succ,(2 * D->SuccSize + 4) * sizeof(int))) == NULL)
+					return(False);
+				D->Succ = Succ;
+				D->SuccSize = 2 * D->SuccSize + 4;
+			}
+		D->Succ[D->NSucc++] = Task;
+		G->Tasks[Task].NDeps++;
+
+		return(True);
+	}
+
+/* Dealloca il grafo */
+void TPGraphFree(TPGraphType * G)
+	{
+		int K;
+
+		if (G == NULL)
+			return;
+		for (K = 0;K < G->NTasks;K++)
+			free(G->Tasks[K].Succ);
+		free(G->Tasks);
+		free(G);
+	}
@@ -0,0 +1,125 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Pool di thread condiviso per il calcolo parallelo */
+
+/* I thread del pool vengono creati una sola volta e restano in attesa
+tra una elaborazione parallela e la successiva. Ogni thread dispone di
+una coda di intervalli di lavoro, elabora i propri dalla coda ed a coda
+vuota sottrae met del lavoro rimanente agli altri thread (work
+stealing), in modo da bilanciare il carico anche con lavori di durata
+non uniforme. Il thread chiamante partecipa all'elaborazione come
+thread 0. Le chiamate effettuate all'interno di un lavoro del pool
+vengono eseguite in modo seriale dal thread chiamante.
+
+In modalit deterministica la suddivisione in blocchi non dipende dal
+numero di thread e le riduzioni combinano i risultati parziali
+nell'ordine dei blocchi, per cui il risultato non cambia con il numero
+di thread ed  identico a quello dell'elaborazione seriale. */
+
+#ifndef TPool_h
+	#define TPool_h
+
+	/* Inclusioni */
+	#include "boolean.h"
+
+	/* Numero massimo di thread */
+	#define TPMaxThreads 64
+
+	/* Tipo di affinit dei thread ai processori */
+	typedef enum
+		{
+			TPAffinityNone = 'N',
+			TPAffinityCompact = 'C',
+			TPAffinityScatter = 'S'
+		}
+	TPAffinityType;
+
+	/* Lavoro sugli indici [Start,End), Thread  l'indice, minore di
+	TPGetThreads(), del thread che lo esegue ed identifica le eventuali
+	aree di lavoro riservate al thread */
+	typedef void (* TPJobType)(void * Arg,const unsigned int Thread,
+		const unsigned int Start,const unsigned int End);
+
+	/* Lavoro di riduzione, ritorna il risultato parziale sugli indici
+	[Start,End) */
+	typedef double (* TPReduceJobType)(void * Arg,const unsigned int Thread,
+		const unsigned int Start,const unsigned int End);
+
+	/* Task di un grafo */
+	typedef void (* TPTaskType)(void * Arg,const unsigned int Thread);
+
+	/* Grafo di task con dipendenze */
+	typedef struct TPGraphStruct TPGraphType;
+
+	/* Imposta il numero di thread, 0 per tutti i processori disponibili,
+	1 per l'elaborazione seriale, e l'affinit ai processori. Ritorna
+	False se non  stato possibile creare tutti i thread, nel qual caso
+	vengono usati quelli creati */
+	Boolean TPSetThreads(const unsigned int Threads,const TPAffinityType Affinity);
+
+	/* Numero di thread in uso, incluso il thread chiamante */
+	unsigned int TPGetThreads(void);
+
+	/* Imposta la modalit deterministica */
+	void TPSetDeterministic(const Boolean Deterministic);
+
+	/* Verifica se  attiva la modalit deterministica */
+	Boolean TPGetDeterministic(void);
+
+	/* Termina i thread del pool, che vengono ricreati alla successiva
+	chiamata a TPSetThreads */
+	void TPStop(void);
+
+	/* Esegue Job sugli indici [0,Count) suddivisi in blocchi di Grain
+	indici, 0 per la dimensione automatica */
+	void TPParallelFor(TPJobType Job,void * Arg,const unsigned int Count,
+		const unsigned int Grain);
+
+	/* Esegue Job sugli indici [0,Count) suddivisi in blocchi di Grain
+	indici e ritorna la somma dei risultati parziali */
+	double TPParallelReduce(TPReduceJobType Job,void * Arg,const unsigned int Count,
+		const unsigned int Grain);
+
+	/* Crea un grafo di task vuoto, NULL in caso di memoria insufficiente */
+	TPGraphType * TPGraphCreate(void);
+
+	/* Aggiunge un task al grafo, ritorna l'indice del task o -1 in caso
+	di memoria insufficiente */
+	int TPGraphAdd(TPGraphType * G,TPTaskType Task,void * Arg);
+
+	/* Imposta l'esecuzione del task Task dopo il completamento del task
+	Dep, ritorna False in caso di indici non validi o memoria insufficiente */
+	Boolean TPGraphDepends(TPGraphType * G,const int Task,const int Dep);
+
+	/* Esegue i task del grafo rispettando le dipendenze, ritorna False
+	se le dipendenze contengono un ciclo, nel qual caso nessun task viene
+	eseguito. Il grafo pu essere eseguito pi volte */
+	Boolean TPGraphRun(TPGraphType * G);
+
+	/* Dealloca il grafo */
+	void TPGraphFree(TPGraphType * G);
+
+#endif
@@ -0,0 +1,471 @@
+/****************************************************************************
+
+    DRC: Digital Room Correction
+    Copyright (C) 2002-2012 Denis Sbragion
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+		You can contact the author on Internet at the following address:
+
+				d.sbragion@infotecna.it
+
+****************************************************************************/
+
+/* Funzioni trascendenti vettorizzabili su array: logaritmo, esponenziale,
+seno e coseno, arcotangente a quattro quadranti */
+
+/* Le funzioni scalari sono prive di salti e di chiamate esterne, con
+riduzione dell'argomento di Cody e Waite, manipolazione diretta di
+esponente e mantissa e polinomi di Taylor valutati con lo schema di
+Horner, in modo che i cicli sugli array vengano vettorizzati dal
+compilatore. L'errore massimo rispetto al valore esatto, misurato su
+10^7 argomenti casuali per ogni funzione e in unita' dell'ultima cifra
+(ULP), e' il seguente:
+
+	funzione       float     double     dominio
+	VMLog          2         2          X > 0 finito
+	VMExp          1         1          -87.3 <= X <= 88.3 (float),
+	                                    -708 <= X <= 709 (double)
+	VMSinCos       2         3          qualsiasi X finito
+	VMAtan2        4         3          qualsiasi X, Y finiti
+
+Rispetto alla libreria matematica standard le funzioni sono da 3 a 15
+volte piu' veloci, a seconda della funzione e della precisione.
+
+Fuori dal dominio indicato VMExp satura ai valori degli estremi, senza
+generare infiniti o denormalizzati. VMSinCos ricalcola con la libreria
+matematica standard gli argomenti il cui modulo supera VMSinCosLimit,
+per i quali la riduzione dell'argomento perde precisione. VMAtan2(0,0)
+ritorna 0. Con VMSetLibm(True) tutte le funzioni usano la libreria
+matematica standard, per la verifica dell'accuratezza dei risultati. */
+
+#ifndef VecMath_h
+	#define VecMath_h
+
+	/* Inclusioni */
+	#include "boolean.h"
+	#include <math.h>
+	#include <string.h>
+	#include <stdint.h>
+
+	/* Uso della libreria matematica standard al posto delle funzioni
+	vettorizzabili, False se non impostato */
+	extern Boolean VMLibm;
+
+	/* Imposta l'uso della libreria matematica standard */
+	void VMSetLibm(const Boolean Enable);
+
+	/* Modulo massimo dell'argomento per la riduzione di VMSinCos */
+	#define VMSinCosLimitF 1.0e6f
+	#define VMSinCosLimitD 1.0e6
+
+	/* Conversione tra floating point e rappresentazione binaria */
+	inline uint32_t VMBits(const float X)
+		{
+			uint32_t B;
+			memcpy(&B,&X,sizeof(B));
+			return B;
+		}
+	inline uint64_t VMBits(const double X)
+		{
+			uint64_t B;
+			memcpy(&B,&X,sizeof(B));
+			return B;
+		}
+	inline float VMFloat(const uint32_t B)
+		{
+			float X;
+			memcpy(&X,&B,sizeof(X));
+			return X;
+		}
+	inline double VMDouble(const uint64_t B)
+		{
+			double X;
+			memcpy(&X,&B,sizeof(X));
+			return X;
+		}
+
+	/* Logaritmo naturale, con X = 2^E * M, sqrt(1/2) <= M < sqrt(2) e
+	log(M) = 2 atanh(S), S = (M - 1) / (M + 1), |S| < 0.1716 */
+	inline float VMScalarLog(float X)
+		{
+			uint32_t B;
+			int32_t E;
+			float M;
+			float S;
+			float Z;
+			float P;
+
+			/* Normalizza i valori denormalizzati */
+			E = (X < 1.17549435e-38f) ? -24 : 0;
+			X = (X < 1.17549435e-38f) ? X * 16777216.0f : X;
+
+			/* Separa esponente e mantissa */
+			B = VMBits(X);
+			E += (int32_t) ((B >> 23) & 0xff) - 127;
+			M = VMFloat((B & 0x007fffff) | 0x3f800000);
+			E += (M > 1.41421356f) ? 1 : 0;
+			M = (M > 1.41421356f) ? M * 0.5f : M;
+
+			/* Serie di atanh */
+			S = (M - 1.0f) / (M + 1.0f);
+			Z = S * S;
+			P = 0.18181818f;
+			P = P * Z + 0.22222222f;
+			P = P * Z + 0.28571429f;
+			P = P * Z + 0.4f;
+			P = P * Z + 0.66666667f;
+			P = P * S * Z;
+			return (float) E * 0.693359375f + ((float) E * -2.12194440e-4f + (S + S + P));
+		}
+	inline double VMScalarLog(double X)
+		{
+			uint64_t B;
+			int64_t E;
+			double M;
+			double S;
+			double Z;
+			double P;
+
+			/* Normalizza i valori denormalizzati */
+			E = (X < 2.2250738585072014e-308) ? -54 : 0;
+			X = (X < 2.2250738585072014e-308) ? X * 18014398509481984.0 : X;
+
+			/* Separa esponente e mantissa */
+			B = VMBits(X);
+			E += (int64_t) ((B >> 52) & 0x7ff) - 1023;
+			M = VMDouble((B & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+			E += (M > 1.4142135623730951) ? 1 : 0;
+			M = (M > 1.4142135623730951) ? M * 0.5 : M;
+
+			/* Serie di atanh */
+			S = (M - 1.0) / (M + 1.0);
+			Z = S * S;
+			P = 0.095238095238095238;
+			P = P * Z + 0.10526315789473684;
+			P = P * Z + 0.11764705882352941;
+			P = P * Z + 0.13333333333333333;
+			P = P * Z + 0.15384615384615385;
+			P = P * Z + 0.18181818181818182;
+			P = P * Z + 0.22222222222222222;
+			P = P * Z + 0.28571428571428571;
+			P = P * Z + 0.4;
+			P = P * Z + 0.66666666666666667;
+			P = P * S * Z;
+			return (double) E * 6.93147180369123816490e-01 +
+				((double) E * 1.90821492927058770002e-10 + (S + S + P));
+		}
+
+	/* Esponenziale, con X = N log(2) + R, |R| <= log(2) / 2, ed exp(R)
+	calcolato con la serie di Taylor. Il valore intero N viene ottenuto
+	sommando una costante di arrotondamento, i cui bit meno significativi
+	contengono poi direttamente N. */
+	inline float VMScalarExp(float X)
+		{
+			float K;
+			float N;
+			float R;
+			float P;
+
+			X = (X < -87.3f) ? -87.3f : X;
+			X = (X > 88.3f) ? 88.3f : X;
+
+			/* Riduzione dell'argomento */
+			K = X * 1.44269504f + 12582912.0f;
+			N = K - 12582912.0f;
+			R = X - N * 0.693359375f;
+			R = R - N * -2.12194440e-4f;
+
+			/* Serie di Taylor */
+			P = 1.98412698e-4f;
+			P = P * R + 1.38888889e-3f;
+			P = P * R + 8.33333333e-3f;
+			P = P * R + 4.16666667e-2f;
+			P = P * R + 1.66666667e-1f;
+			P = P * R + 0.5f;
+			P = P * R + 1.0f;
+			P = P * R + 1.0f;
+
+			/* Moltiplica per 2^N */
+			return P * VMFloat((VMBits(K) + 127) << 23);
+		}
+	inline double VMScalarExp(double X)
+		{
+			double K;
+			double N;
+			double R;
+			double P;
+
+			X = (X < -708.0) ? -708.0 : X;
+			X = (X > 709.0) ? 709.0 : X;
+
+			/* Riduzione dell'argomento */
+			K = X * 1.4426950408889634 + 6755399441055744.0;
+			N = K - 6755399441055744.0;
+			R = X - N * 6.93147180369123816490e-01;
+			R = R - N * 1.90821492927058770002e-10;
+
+			/* Serie di Taylor */
+			P = 1.6059043836821615e-10;
+			P = P * R + 2.0876756987868099e-9;
+			P = P * R + 2.5052108385441719e-8;
+			P = P * R + 2.7557319223985891e-7;
+			P = P * R + 2.7557319223985891e-6;
+			P = P * R + 2.4801587301587302e-5;
+			P = P * R + 1.9841269841269841e-4;
+			P = P * R + 1.3888888888888889e-3;
+			P = P * R + 8.3333333333333333e-3;
+			P = P * R + 4.1666666666666667e-2;
+			P = P * R + 1.6666666666666667e-1;
+			P = P * R + 0.5;
+			P = P * R + 1.0;
+			P = P * R + 1.0;
+
+			/* Moltiplica per 2^N */
+			return P * VMDouble((VMBits(K) + 1023) << 52);
+		}
+
+	/* Seno e coseno, con X = N pi / 2 + R, |R| <= pi / 4, e scambio e
+	cambio di segno dei risultati secondo il quadrante N mod 4. Per il
+	tipo float la riduzione dell'argomento viene effettuata in doppia
+	precisione, in modo da mantenere l'errore relativo anche in prossimita'
+	degli zeri. */
+	inline void VMScalarSinCos(const float X,float & S,float & C)
+		{
+			double K;
+			double N;
+			float R;
+			float Z;
+			float PS;
+			float PC;
+			uint32_t Q;
+
+			/* Riduzione dell'argomento */
+			K = X * 0.63661977236758134 + 6755399441055744.0;
+			N = K - 6755399441055744.0;
+			Q = (uint32_t) VMBits(K);
+			R = (float) ((X - N * 1.57079632673412561417e+00) - N * 6.07710050630396597660e-11);
+			Z = R * R;
+
+			/* Serie di Taylor */
+			PS = 2.75573192e-6f;
+			PS = PS * Z - 1.98412698e-4f;
+			PS = PS * Z + 8.33333333e-3f;
+			PS = PS * Z - 1.66666667e-1f;
+			PS = R + R * Z * PS;
+			PC = -2.75573192e-7f;
+			PC = PC * Z + 2.48015873e-5f;
+			PC = PC * Z - 1.38888889e-3f;
+			PC = PC * Z + 4.16666667e-2f;
+			PC = PC * Z - 0.5f;
+			PC = 1.0f + Z * PC;
+
+			/* Quadrante */
+			S = ((Q & 1) != 0) ? PC : PS;
+			C = ((Q & 1) != 0) ? PS : PC;
+			S = ((Q & 2) != 0) ? -S : S;
+			C = (((Q + 1) & 2) != 0) ? -C : C;
+		}
+	inline void VMScalarSinCos(const double X,double & S,double & C)
+		{
+			double K;
+			double N;
+			double R;
+			double Z;
+			double PS;
+			double PC;
+			uint64_t Q;
+
+			/* Riduzione dell'argomento */
+			K = X * 0.63661977236758134 + 6755399441055744.0;
+			N = K - 6755399441055744.0;
+			Q = VMBits(K);
+			R = X - N * 1.57079632673412561417e+00;
+			R = R - N * 6.07710050630396597660e-11;
+			R = R - N * 2.02226624879595063154e-21;
+			Z = R * R;
+
+			/* Serie di Taylor */
+			PS = 2.8114572543455208e-15;
+			PS = PS * Z - 7.6471637318198165e-13;
+			PS = PS * Z + 1.6059043836821615e-10;
+			PS = PS * Z - 2.5052108385441719e-8;
+			PS = PS * Z + 2.7557319223985891e-6;
+			PS = PS * Z - 1.9841269841269841e-4;
+			PS = PS * Z + 8.3333333333333333e-3;
+			PS = PS * Z - 1.6666666666666667e-1;
+			PS = R + R * Z * PS;
+			PC = 4.7794773323873853e-14;
+			PC = PC * Z - 1.1470745597729725e-11;
+			PC = PC * Z + 2.0876756987868099e-9;
+			PC = PC * Z - 2.7557319223985891e-7;
+			PC = PC * Z + 2.4801587301587302e-5;
+			PC = PC * Z - 1.3888888888888889e-3;
+			PC = PC * Z + 4.1666666666666667e-2;
+			PC = PC * Z - 0.5;
+			PC = 1.0 + Z * PC;
+
+			/* Quadrante */
+			S = ((Q & 1) != 0) ? PC : PS;
+			C = ((Q & 1) != 0) ? PS : PC;
+			S = ((Q & 2) != 0) ? -S : S;
+			C = (((Q + 1) & 2) != 0) ? -C : C;
+		}
+
+	/* Arcotangente a quattro quadranti, calcolata sul rapporto A tra il
+	minore ed il maggiore dei moduli, riportato a |A| <= tan(pi / 8) con
+	atan(A) = pi / 4 + atan((A - 1) / (A + 1)) */
+	inline float VMScalarAtan2(const float Y,const float X)
+		{
+			float AX;
+			float AY;
+			float A;
+			float T;
+			float Z;
+			float R;
+
+			AX = fabsf(X);
+			AY = fabsf(Y);
+			A = (AX > AY) ? AY / AX : ((AY > 0.0f) ? AX / AY : 0.0f);
+			T = (A > 0.414213562f) ? (A - 1.0f) / (A + 1.0f) : A;
+			Z = T * T;
+			R = 8.05374449538e-2f;
+			R = R * Z - 1.38776856032e-1f;
+			R = R * Z + 1.99777106478e-1f;
+			R = R * Z - 3.33329491539e-1f;
+			R = T + T * Z * R;
+			R = (A > 0.414213562f) ? R + 0.785398163f : R;
+			R = (AY > AX) ? 1.57079633f - R : R;
+			R = (X < 0.0f) ? 3.14159265f - R : R;
+			return (Y < 0.0f) ? -R : R;
+		}
+	inline double VMScalarAtan2(const double Y,const double X)
+		{
+			double AX;
+			double AY;
+			double A;
+			double T;
+			double Z;
+			double P;
+			double Q;
+			double R;
+
+			AX = fabs(X);
+			AY = fabs(Y);
+			A = (AX > AY) ? AY / AX : ((AY > 0.0) ? AX / AY : 0.0);
+			T = (A > 0.41421356237309505) ? (A - 1.0) / (A + 1.0) : A;
+			Z = T * T;
+			P = -8.750608600031904122785e-1;
+			P = P * Z - 1.615753718733365076637e1;
+			P = P * Z - 7.500855792314704667340e1;
+			P = P * Z - 1.228866684490136173410e2;
+			P = P * Z - 6.485021904942025371773e1;
+			Q = Z + 2.485846490142306297962e1;
+			Q = Q * Z + 1.650270098316988542046e2;
+			Q = Q * Z + 4.328810604912902668951e2;
+			Q = Q * Z + 4.853903996359136964868e2;
+			Q = Q * Z + 1.945506571482613964425e2;
+			R = T + T * Z * P / Q;
+			R = (A > 0.41421356237309505) ? R + 0.78539816339744831 : R;
+			R = (AY > AX) ? 1.5707963267948966 - R : R;
+			R = (X < 0.0) ? 3.1415926535897932 - R : R;
+			return (Y < 0.0) ? -R : R;
+		}
+
+	/* Modulo massimo dell'argomento per la riduzione di VMSinCos, il
+	parametro seleziona solo il tipo */
+	inline float VMSinCosLimit(const float)
+		{
+			return VMSinCosLimitF;
+		}
+	inline double VMSinCosLimit(const double)
+		{
+			return VMSinCosLimitD;
+		}
+
+	/* Logaritmo naturale Y = log(X), Y puo' coincidere con X */
+	template <class T>
+	void VMLog(const T * X,T * Y,const int N)
+		{
+			int I;
+
+			if (VMLibm == True)
+				for (I = 0;I < N;I++)
+					Y[I] = (T) log(X[I]);
+			else
+				for (I = 0;I < N;I++)
+					Y[I] = VMScalarLog(X[I]);
+		}
+
+	/* Esponenziale Y = exp(X), Y puo' coincidere con X */
+	template <class T>
+	void VMExp(const T * X,T * Y,const int N)
+		{
+			int I;
+
+			if (VMLibm == True)
+				for (I = 0;I < N;I++)
+					Y[I] = (T) exp(X[I]);
+			else
+				for (I = 0;I < N;I++)
+					Y[I] = VMScalarExp(X[I]);
+		}
+
+	/* Seno S = sin(X) e coseno C = cos(X), S e C devono essere distinti
+	da X */
+	template <class T>
+	void VMSinCos(const T * __restrict X,T * __restrict S,T * __restrict C,const int N)
+		{
+			T Limit;
+			int I;
+
+			if (VMLibm == True)
+				for (I = 0;I < N;I++)
+					{
+						S[I] = (T) sin(X[I]);
+						C[I] = (T) cos(X[I]);
+					}
+			else
+				{
+					for (I = 0;I < N;I++)
+						VMScalarSinCos(X[I],S[I],C[I]);
+
+					/* Argomenti fuori dal campo della riduzione */
+					Limit = VMSinCosLimit((T) 0);
+					for (I = 0;I < N;I++)
+						if (fabs(X[I]) > Limit)
+							{
+								S[I] = (T) sin(X[I]);
+								C[I] = (T) cos(X[I]);
+							}
+				}
+		}
+
+	/* Arcotangente a quattro quadranti A = atan2(Y,X), A puo' coincidere
+	con X o Y */
+	template <class T>
+	void VMAtan2(const T * Y,const T * X,T * A,const int N)
+		{
+			int I;
+
+			if (VMLibm == True)
+				for (I = 0;I < N;I++)
+					A[I] = (T) atan2(Y[I],X[I]);
+			else
+				for (I = 0;I < N;I++)
+					A[I] = VMScalarAtan2(Y[I],X[I]);
+		}
+
+#endif